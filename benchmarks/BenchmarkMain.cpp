@@ -0,0 +1,41 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "version.h"
+#include <benchmark/benchmark.h>
+
+// The plugin version is added to the benchmark context, so that the JSON
+// results of different releases can be told apart.
+int main(int argc, char** argv)
+{
+	benchmark::Initialize(&argc, argv);
+
+	if (benchmark::ReportUnrecognizedArguments(argc, argv))
+	{
+		return 1;
+	}
+
+	benchmark::AddCustomContext("plugin_version", PLUGIN_VERSION_STR);
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+
+	return 0;
+}
@@ -0,0 +1,138 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "Crc32c.h"
+#include "GameExecutableFingerprint.h"
+#include "TestDirectory.h"
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	// The size of the game's .text section.
+	constexpr size_t kCodeSize = 5 * 1024 * 1024;
+
+	const std::vector<uint8_t>& GetCodeBuffer()
+	{
+		static const std::vector<uint8_t> buffer = []()
+		{
+			std::vector<uint8_t> data(kCodeSize);
+			std::mt19937 random(641);
+
+			for (uint8_t& value : data)
+			{
+				value = static_cast<uint8_t>(random());
+			}
+
+			return data;
+		}();
+
+		return buffer;
+	}
+
+	template <typename T>
+	void Write(std::string& file, size_t offset, T value)
+	{
+		std::memcpy(file.data() + offset, &value, sizeof(value));
+	}
+
+	// An executable file that only has a .text section of the game's code size.
+	std::string CreateExecutableFile()
+	{
+		constexpr size_t kNtHeadersOffset = 0x80;
+		constexpr size_t kOptionalHeaderOffset = kNtHeadersOffset + 24;
+		constexpr size_t kSectionTableOffset = kOptionalHeaderOffset + 224;
+		constexpr size_t kTextFileOffset = 0x400;
+
+		std::string file(kTextFileOffset + kCodeSize, '\0');
+
+		Write<uint16_t>(file, 0, 0x5A4D);
+		Write<uint32_t>(file, 0x3C, kNtHeadersOffset);
+		Write<uint32_t>(file, kNtHeadersOffset, 0x00004550);
+		Write<uint16_t>(file, kNtHeadersOffset + 4, 0x014C);
+		Write<uint16_t>(file, kNtHeadersOffset + 6, 1);
+		Write<uint16_t>(file, kNtHeadersOffset + 20, 224);
+		Write<uint16_t>(file, kOptionalHeaderOffset, 0x010B);
+
+		std::memcpy(file.data() + kSectionTableOffset, ".text", 5);
+		Write<uint32_t>(file, kSectionTableOffset + 8, kCodeSize);
+		Write<uint32_t>(file, kSectionTableOffset + 12, 0x1000);
+		Write<uint32_t>(file, kSectionTableOffset + 16, kCodeSize);
+		Write<uint32_t>(file, kSectionTableOffset + 20, kTextFileOffset);
+
+		std::memcpy(file.data() + kTextFileOffset, GetCodeBuffer().data(), kCodeSize);
+
+		return file;
+	}
+
+	void BM_Crc32cCompute(benchmark::State& state)
+	{
+		const Crc32cMode mode = static_cast<Crc32cMode>(state.range(0));
+
+		if (mode > Crc32c::GetBestMode())
+		{
+			state.SkipWithError("The CPU does not support this CRC-32C mode.");
+			return;
+		}
+
+		const std::vector<uint8_t>& buffer = GetCodeBuffer();
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(Crc32c::Compute(buffer.data(), buffer.size(), 0, mode));
+		}
+
+		state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(buffer.size()));
+	}
+
+	// Reads and hashes the code section of an executable file, the file is in the
+	// operating system's cache after the first iteration.
+	void BM_ComputeGameExecutableFingerprint(benchmark::State& state)
+	{
+		TestDirectory directory;
+		const std::filesystem::path path = directory.WriteFile("SimCity 4.exe", CreateExecutableFile());
+
+		for (auto _ : state)
+		{
+			GameExecutableFingerprint fingerprint{};
+
+			if (!ComputeGameExecutableFingerprint(path, fingerprint))
+			{
+				state.SkipWithError("Failed to compute the fingerprint.");
+				break;
+			}
+
+			benchmark::DoNotOptimize(fingerprint);
+		}
+
+		state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(kCodeSize));
+	}
+}
+
+BENCHMARK(BM_Crc32cCompute)
+	->ArgName("mode")
+	->Arg(static_cast<int64_t>(Crc32cMode::Software))
+	->Arg(static_cast<int64_t>(Crc32cMode::SSE42))
+	->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ComputeGameExecutableFingerprint)->Unit(benchmark::kMicrosecond);
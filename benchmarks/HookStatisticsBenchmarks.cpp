@@ -0,0 +1,98 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "HookStatistics.h"
+#include <benchmark/benchmark.h>
+
+namespace
+{
+	// A stand-in for the original function that a hook calls.
+	int HookedFunction(int value)
+	{
+		benchmark::DoNotOptimize(value);
+		return value + 1;
+	}
+
+	// The baseline for BM_HookCallScope, a hook that does not record its statistics.
+	void BM_HookCallWithoutStatistics(benchmark::State& state)
+	{
+		int value = 0;
+
+		for (auto _ : state)
+		{
+			value = HookedFunction(value);
+		}
+
+		benchmark::DoNotOptimize(value);
+	}
+
+	// The cost that the statistics add to every hooked call: two performance counter
+	// reads, the call counters and the duration histogram.
+	void BM_HookCallScope(benchmark::State& state)
+	{
+		static HookStatistics statistics("BM_HookCallScope");
+		int value = 0;
+
+		for (auto _ : state)
+		{
+			HookCallScope scope(statistics);
+			value = HookedFunction(value);
+		}
+
+		benchmark::DoNotOptimize(value);
+
+		if (state.thread_index() == 0)
+		{
+			FrameTimeHistogram::Snapshot snapshot;
+			statistics.TakeDurationSnapshot(snapshot);
+		}
+	}
+
+	void BM_HookStatisticsRecordCall(benchmark::State& state)
+	{
+		static HookStatistics activeFilterStatistics("BM_HookStatisticsRecordCall/filter:1");
+		static HookStatistics retiredFilterStatistics("BM_HookStatisticsRecordCall/filter:0");
+
+		const bool filterActive = state.range(0) != 0;
+		HookStatistics& statistics = filterActive ? activeFilterStatistics : retiredFilterStatistics;
+
+		if (!filterActive)
+		{
+			statistics.RetireFilter();
+		}
+
+		for (auto _ : state)
+		{
+			statistics.RecordCall(100);
+		}
+
+		if (state.thread_index() == 0)
+		{
+			FrameTimeHistogram::Snapshot snapshot;
+			statistics.TakeDurationSnapshot(snapshot);
+		}
+	}
+}
+
+BENCHMARK(BM_HookCallWithoutStatistics);
+BENCHMARK(BM_HookCallScope)->ThreadRange(1, 4);
+// The filter argument is 1 when the hook's filter is active, the filtered call count is only updated then.
+BENCHMARK(BM_HookStatisticsRecordCall)->ArgName("filter")->Arg(1)->Arg(0)->ThreadRange(1, 4);
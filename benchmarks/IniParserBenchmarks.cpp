@@ -0,0 +1,111 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "IniParser.h"
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#ifdef SC4GRAPHICSOPTIONS_HAVE_BOOST_PROPERTY_TREE
+#include "boost/property_tree/ini_parser.hpp"
+#include "boost/property_tree/ptree.hpp"
+#endif // SC4GRAPHICSOPTIONS_HAVE_BOOST_PROPERTY_TREE
+
+// Compares IniParser with the boost::property_tree INI parser that Settings::Load used before.
+namespace
+{
+	const std::filesystem::path kShippedFilePath = SC4GRAPHICSOPTIONS_SOURCE_DIR "/SC4GraphicsOptions.ini";
+
+	std::string ReadShippedFile()
+	{
+		std::ifstream stream(kShippedFilePath, std::ifstream::in | std::ifstream::binary);
+
+		return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	}
+
+	void BM_IniParser_Parse(benchmark::State& state)
+	{
+		const std::string text = ReadShippedFile();
+
+		for (auto _ : state)
+		{
+			IniParser parser(text);
+			IniEntry entry{};
+
+			while (parser.Next(entry))
+			{
+				benchmark::DoNotOptimize(entry);
+			}
+		}
+
+		state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+	}
+
+#ifdef SC4GRAPHICSOPTIONS_HAVE_BOOST_PROPERTY_TREE
+	void BM_BoostPropertyTree_Parse(benchmark::State& state)
+	{
+		const std::string text = ReadShippedFile();
+
+		for (auto _ : state)
+		{
+			std::istringstream stream(text);
+			boost::property_tree::ptree tree;
+
+			boost::property_tree::ini_parser::read_ini(stream, tree);
+			benchmark::DoNotOptimize(tree);
+		}
+
+		state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+	}
+
+	// The file read and the value lookups that the boost based Settings::Load performed,
+	// compare with BM_SettingsLoad_ShippedFile.
+	void BM_BoostPropertyTree_Load(benchmark::State& state)
+	{
+		for (auto _ : state)
+		{
+			boost::property_tree::ptree tree;
+
+			std::ifstream stream(kShippedFilePath);
+			boost::property_tree::ini_parser::read_ini(stream, tree);
+
+			benchmark::DoNotOptimize(tree.get<bool>("GraphicsOptions.EnableIntroVideo"));
+			benchmark::DoNotOptimize(tree.get<bool>("GraphicsOptions.PauseGameOnFocusLoss"));
+			benchmark::DoNotOptimize(tree.get<bool>("GraphicsOptions.ForceDrawOnScroll", false));
+			benchmark::DoNotOptimize(tree.get<std::string>("GraphicsOptions.Driver"));
+			benchmark::DoNotOptimize(tree.get<uint32_t>("GraphicsOptions.WindowWidth"));
+			benchmark::DoNotOptimize(tree.get<uint32_t>("GraphicsOptions.WindowHeight"));
+			benchmark::DoNotOptimize(tree.get<uint32_t>("GraphicsOptions.ColorDepth"));
+			benchmark::DoNotOptimize(tree.get<std::string>("GraphicsOptions.WindowMode"));
+		}
+	}
+#endif // SC4GRAPHICSOPTIONS_HAVE_BOOST_PROPERTY_TREE
+}
+
+BENCHMARK(BM_IniParser_Parse);
+
+#ifdef SC4GRAPHICSOPTIONS_HAVE_BOOST_PROPERTY_TREE
+BENCHMARK(BM_BoostPropertyTree_Parse);
+BENCHMARK(BM_BoostPropertyTree_Load);
+#endif // SC4GRAPHICSOPTIONS_HAVE_BOOST_PROPERTY_TREE
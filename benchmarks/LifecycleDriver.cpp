@@ -0,0 +1,450 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// Runs the director's framework lifecycle against a fake game and reports the time and
+// the memory allocations of each stage, so that the startup overhead can be compared
+// between releases.
+//
+// The director itself depends on the game's GZCOM interfaces, each stage calls the
+// GraphicsOptionsStartup function that the director calls in that stage:
+// OnStart          - the director's constructor: logger, flight recorder and settings.
+// PreFrameWorkInit - the process scheduling options, the video preferences, the graphics options
+//                    and the intro video switch.
+// PreAppInit       - the check of the options that the game's graphics system is using, and the frame pacer.
+// PostAppInit      - the ForceDrawOnScroll options, the [RenderProperties] section, the auto-tune start,
+//                    stopping the startup timeline sampling and writing the startup trace.
+// PostAppShutdown  - restoring the process scheduling options, stopping the flight recorder and the logger.
+//
+// The default settings file, LifecycleDriver.ini, enables the render property work.
+//
+// SC4GraphicsOptionsLifecycleDriver [--iterations=<count>] [--settings=<path>] [--json=<path>]
+
+#include "FakeSC4GameServices.h"
+#include "FramePacer.h"
+#include "GraphicsOptionsStartup.h"
+#include "Platform.h"
+#include "ProcessSchedulingPolicy.h"
+#include "RenderOptionsController.h"
+#include "Settings.h"
+#include "TestDirectory.h"
+#include "version.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+	// Counts the allocations of every thread, including the logger's and the flight
+	// recorder's background threads.
+	std::atomic<uint64_t> s_AllocationCount(0);
+	std::atomic<uint64_t> s_AllocatedBytes(0);
+
+	void* Allocate(size_t size)
+	{
+		s_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+		s_AllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+		void* const memory = std::malloc(size != 0 ? size : 1);
+
+		if (!memory)
+		{
+			throw std::bad_alloc();
+		}
+
+		return memory;
+	}
+
+	enum class Stage : size_t
+	{
+		OnStart = 0,
+		PreFrameWorkInit,
+		PreAppInit,
+		PostAppInit,
+		PostAppShutdown
+	};
+
+	constexpr size_t kStageCount = 5;
+
+	constexpr std::array<const char*, kStageCount> kStageNames =
+	{
+		"OnStart",
+		"PreFrameWorkInit",
+		"PreAppInit",
+		"PostAppInit",
+		"PostAppShutdown",
+	};
+
+	struct StageSample
+	{
+		uint64_t nanoseconds;
+		uint64_t allocationCount;
+		uint64_t allocatedBytes;
+	};
+
+	struct StageSummary
+	{
+		double meanMicroseconds;
+		double p50Microseconds;
+		double p99Microseconds;
+		double maxMicroseconds;
+		double meanAllocationCount;
+		uint64_t maxAllocationCount;
+		double meanAllocatedBytes;
+	};
+
+	// The state that the director keeps between the stages.
+	struct Director
+	{
+		Director(const std::filesystem::path& folderPath, const std::filesystem::path& settingsFilePath)
+			: folderPath(folderPath),
+			  settingsFilePath(settingsFilePath),
+			  settings(),
+			  game(),
+			  processSchedulingControls(),
+			  processScheduling(processSchedulingControls),
+			  framePacerClock(),
+			  framePacer(),
+			  renderOptions()
+		{
+		}
+
+		std::filesystem::path folderPath;
+		std::filesystem::path settingsFilePath;
+		Settings settings;
+		FakeSC4GameServices game;
+		PlatformProcessSchedulingControls processSchedulingControls;
+		ProcessSchedulingPolicy processScheduling;
+		SystemFramePacerClock framePacerClock;
+		std::unique_ptr<FramePacer> framePacer;
+		RenderOptionsController renderOptions;
+	};
+
+	class StageTimer
+	{
+	public:
+
+		StageTimer(std::vector<StageSample>& samples)
+			: samples(samples),
+			  allocationCount(s_AllocationCount.load(std::memory_order_relaxed)),
+			  allocatedBytes(s_AllocatedBytes.load(std::memory_order_relaxed)),
+			  startTime(Platform::GetPerformanceCounter())
+		{
+		}
+
+		~StageTimer()
+		{
+			const int64_t elapsedTicks = Platform::GetPerformanceCounter() - startTime;
+
+			samples.push_back(StageSample
+			{
+				static_cast<uint64_t>((static_cast<double>(elapsedTicks) * 1e9) / static_cast<double>(Platform::GetPerformanceFrequency())),
+				s_AllocationCount.load(std::memory_order_relaxed) - allocationCount,
+				s_AllocatedBytes.load(std::memory_order_relaxed) - allocatedBytes
+			});
+		}
+
+		StageTimer(const StageTimer&) = delete;
+		StageTimer& operator=(const StageTimer&) = delete;
+
+	private:
+
+		std::vector<StageSample>& samples;
+		uint64_t allocationCount;
+		uint64_t allocatedBytes;
+		int64_t startTime;
+	};
+
+	void OnStart(Director& director)
+	{
+		director.settings = Settings();
+
+		GraphicsOptionsStartup::OnStart(director.folderPath, director.settingsFilePath, director.settings);
+	}
+
+	void PreFrameWorkInit(Director& director)
+	{
+		director.game = FakeSC4GameServices();
+
+		SC4VideoOptions videoOptions{};
+
+		GraphicsOptionsStartup::PreFrameWorkInit(director.settings, director.game, director.processScheduling, videoOptions);
+	}
+
+	void PreAppInit(Director& director)
+	{
+		director.framePacer = GraphicsOptionsStartup::PreAppInit(director.settings, director.game, director.framePacerClock);
+	}
+
+	void PostAppInit(Director& director)
+	{
+		GraphicsOptionsStartup::PostAppInit(director.settings, director.game, director.renderOptions, director.folderPath);
+	}
+
+	void PostAppShutdown(Director& director)
+	{
+		director.framePacer.reset();
+		director.renderOptions = RenderOptionsController();
+
+		GraphicsOptionsStartup::PostAppShutdown(director.processScheduling);
+	}
+
+	void RunLifecycle(Director& director, std::array<std::vector<StageSample>, kStageCount>& samples)
+	{
+		{
+			StageTimer timer(samples[static_cast<size_t>(Stage::OnStart)]);
+			OnStart(director);
+		}
+		{
+			StageTimer timer(samples[static_cast<size_t>(Stage::PreFrameWorkInit)]);
+			PreFrameWorkInit(director);
+		}
+		{
+			StageTimer timer(samples[static_cast<size_t>(Stage::PreAppInit)]);
+			PreAppInit(director);
+		}
+		{
+			StageTimer timer(samples[static_cast<size_t>(Stage::PostAppInit)]);
+			PostAppInit(director);
+		}
+		{
+			StageTimer timer(samples[static_cast<size_t>(Stage::PostAppShutdown)]);
+			PostAppShutdown(director);
+		}
+	}
+
+	StageSummary Summarize(std::vector<StageSample> samples)
+	{
+		StageSummary summary{};
+
+		if (samples.empty())
+		{
+			return summary;
+		}
+
+		uint64_t totalNanoseconds = 0;
+		uint64_t totalAllocationCount = 0;
+		uint64_t totalAllocatedBytes = 0;
+
+		for (const StageSample& sample : samples)
+		{
+			totalNanoseconds += sample.nanoseconds;
+			totalAllocationCount += sample.allocationCount;
+			totalAllocatedBytes += sample.allocatedBytes;
+			summary.maxAllocationCount = std::max(summary.maxAllocationCount, sample.allocationCount);
+		}
+
+		std::sort(
+			samples.begin(),
+			samples.end(),
+			[](const StageSample& lhs, const StageSample& rhs) { return lhs.nanoseconds < rhs.nanoseconds; });
+
+		const double count = static_cast<double>(samples.size());
+
+		summary.meanMicroseconds = static_cast<double>(totalNanoseconds) / count / 1000.0;
+		summary.p50Microseconds = static_cast<double>(samples[(samples.size() - 1) / 2].nanoseconds) / 1000.0;
+		summary.p99Microseconds = static_cast<double>(samples[((samples.size() - 1) * 99) / 100].nanoseconds) / 1000.0;
+		summary.maxMicroseconds = static_cast<double>(samples.back().nanoseconds) / 1000.0;
+		summary.meanAllocationCount = static_cast<double>(totalAllocationCount) / count;
+		summary.meanAllocatedBytes = static_cast<double>(totalAllocatedBytes) / count;
+
+		return summary;
+	}
+
+	void PrintSummaries(const std::array<StageSummary, kStageCount>& summaries, uint64_t iterations)
+	{
+		std::printf("SC4GraphicsOptions v%s, %llu lifecycle runs\n\n", PLUGIN_VERSION_STR, static_cast<unsigned long long>(iterations));
+		std::printf(
+			"%-18s %10s %10s %10s %10s %12s %10s %12s\n",
+			"Stage",
+			"mean us",
+			"p50 us",
+			"p99 us",
+			"max us",
+			"allocs/run",
+			"max allocs",
+			"bytes/run");
+
+		for (size_t i = 0; i < kStageCount; i++)
+		{
+			const StageSummary& summary = summaries[i];
+
+			std::printf(
+				"%-18s %10.2f %10.2f %10.2f %10.2f %12.1f %10llu %12.0f\n",
+				kStageNames[i],
+				summary.meanMicroseconds,
+				summary.p50Microseconds,
+				summary.p99Microseconds,
+				summary.maxMicroseconds,
+				summary.meanAllocationCount,
+				static_cast<unsigned long long>(summary.maxAllocationCount),
+				summary.meanAllocatedBytes);
+		}
+	}
+
+	bool WriteJson(const std::filesystem::path& path, const std::array<StageSummary, kStageCount>& summaries, uint64_t iterations)
+	{
+		std::ofstream stream(path, std::ofstream::out | std::ofstream::trunc);
+
+		if (!stream)
+		{
+			return false;
+		}
+
+		stream << "{\n  \"plugin_version\": \"" << PLUGIN_VERSION_STR << "\",\n"
+			<< "  \"iterations\": " << iterations << ",\n"
+			<< "  \"stages\": [\n";
+
+		for (size_t i = 0; i < kStageCount; i++)
+		{
+			const StageSummary& summary = summaries[i];
+
+			stream << "    { \"name\": \"" << kStageNames[i] << '"'
+				<< ", \"mean_us\": " << summary.meanMicroseconds
+				<< ", \"p50_us\": " << summary.p50Microseconds
+				<< ", \"p99_us\": " << summary.p99Microseconds
+				<< ", \"max_us\": " << summary.maxMicroseconds
+				<< ", \"mean_allocations\": " << summary.meanAllocationCount
+				<< ", \"max_allocations\": " << summary.maxAllocationCount
+				<< ", \"mean_allocated_bytes\": " << summary.meanAllocatedBytes
+				<< " }" << (i + 1 < kStageCount ? ",\n" : "\n");
+		}
+
+		stream << "  ]\n}\n";
+
+		return static_cast<bool>(stream.flush());
+	}
+
+	void PrintUsage()
+	{
+		std::cerr << "Usage: SC4GraphicsOptionsLifecycleDriver [--iterations=<count>] [--settings=<path>] [--json=<path>]\n";
+	}
+}
+
+void* operator new(size_t size)
+{
+	return Allocate(size);
+}
+
+void* operator new[](size_t size)
+{
+	return Allocate(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+
+int main(int argc, char** argv)
+{
+	uint64_t iterations = 1000;
+	std::filesystem::path settingsFilePath = SC4GRAPHICSOPTIONS_LIFECYCLE_SETTINGS_FILE;
+	std::filesystem::path jsonFilePath;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string_view argument = argv[i];
+
+		if (argument.starts_with("--iterations="))
+		{
+			const std::string_view value = argument.substr(13);
+			const std::from_chars_result result = std::from_chars(value.data(), value.data() + value.size(), iterations);
+
+			if (result.ec != std::errc() || result.ptr != value.data() + value.size() || iterations == 0)
+			{
+				PrintUsage();
+				return 1;
+			}
+		}
+		else if (argument.starts_with("--settings="))
+		{
+			settingsFilePath = argument.substr(11);
+		}
+		else if (argument.starts_with("--json="))
+		{
+			jsonFilePath = argument.substr(7);
+		}
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	std::array<std::vector<StageSample>, kStageCount> samples;
+
+	for (std::vector<StageSample>& stageSamples : samples)
+	{
+		stageSamples.reserve(static_cast<size_t>(iterations));
+	}
+
+	{
+		TestDirectory directory;
+		Director director(directory.GetPath(), settingsFilePath);
+
+		for (uint64_t i = 0; i < iterations; i++)
+		{
+			RunLifecycle(director, samples);
+		}
+	}
+
+	std::array<StageSummary, kStageCount> summaries{};
+
+	for (size_t i = 0; i < kStageCount; i++)
+	{
+		summaries[i] = Summarize(samples[i]);
+	}
+
+	PrintSummaries(summaries, iterations);
+
+	if (!jsonFilePath.empty() && !WriteJson(jsonFilePath, summaries, iterations))
+	{
+		std::cerr << "Failed to write " << jsonFilePath << ".\n";
+		return 1;
+	}
+
+	return 0;
+}
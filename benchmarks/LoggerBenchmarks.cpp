@@ -0,0 +1,212 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "Logger.h"
+#include "TestDirectory.h"
+#include <benchmark/benchmark.h>
+#include <cstdarg>
+#include <cstdio>
+#include <memory>
+
+namespace
+{
+	constexpr size_t kMaxLogFileSize = 64 * 1024 * 1024;
+
+	// The arguments are the log level, whether the level is enabled and the LogWriteMode.
+	// The Info level is always enabled. Release builds compile out the Trace level,
+	// so its enabled case measures the same level check as the disabled case.
+	void LoggerArguments(benchmark::internal::Benchmark* benchmark)
+	{
+		benchmark->ArgNames({ "level", "enabled", "async" });
+
+		for (int64_t level = static_cast<int64_t>(LogLevel::Info); level <= static_cast<int64_t>(LogLevel::Trace); level++)
+		{
+			for (int64_t async = 0; async <= 1; async++)
+			{
+				benchmark->Args({ level, 1, async });
+
+				if (level != static_cast<int64_t>(LogLevel::Info))
+				{
+					benchmark->Args({ level, 0, async });
+				}
+			}
+		}
+	}
+
+	// Initializes the logger with a level that enables or disables the benchmark's level,
+	// and shuts it down when the benchmark ends.
+	class ScopedBenchmarkLogger
+	{
+	public:
+
+		explicit ScopedBenchmarkLogger(const benchmark::State& state)
+			: directory(),
+			  level(static_cast<LogLevel>(state.range(0)))
+		{
+			const bool enabled = state.range(1) != 0;
+			const LogWriteMode writeMode = state.range(2) != 0 ? LogWriteMode::Asynchronous : LogWriteMode::Synchronous;
+
+			const LogLevel loggerLevel = enabled ? LogLevel::Trace : static_cast<LogLevel>(static_cast<int32_t>(level) - 1);
+
+			Logger::GetInstance().Init(
+				directory.GetPath() / "SC4GraphicsOptions.log",
+				loggerLevel,
+				true,
+				writeMode,
+				kMaxLogFileSize,
+				0);
+		}
+
+		~ScopedBenchmarkLogger()
+		{
+			Logger::GetInstance().Shutdown();
+		}
+
+		LogLevel GetLevel() const
+		{
+			return level;
+		}
+
+	private:
+
+		TestDirectory directory;
+		LogLevel level;
+	};
+
+	void BM_LoggerWriteLine(benchmark::State& state)
+	{
+		ScopedBenchmarkLogger scopedLogger(state);
+		Logger& logger = Logger::GetInstance();
+		const LogLevel level = scopedLogger.GetLevel();
+
+		for (auto _ : state)
+		{
+			logger.WriteLine(LogCategory::General, level, "The game's video preferences have been set.");
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	// The printf-style formatting that WriteLineFormatted used before it took std::format strings,
+	// the baseline for BM_LoggerWriteLineFormatted.
+	void WriteLineVarargs(Logger& logger, LogCategory category, LogLevel level, const char* const format, ...)
+	{
+		if (!logger.IsEnabled(category, level))
+		{
+			return;
+		}
+
+		va_list args;
+		va_start(args, format);
+
+		va_list argsCopy;
+		va_copy(argsCopy, args);
+
+		const int formattedStringLength = std::vsnprintf(nullptr, 0, format, argsCopy);
+
+		va_end(argsCopy);
+
+		if (formattedStringLength > 0)
+		{
+			const size_t formattedStringLengthWithNull = static_cast<size_t>(formattedStringLength) + 1;
+
+			std::unique_ptr<char[]> buffer = std::make_unique_for_overwrite<char[]>(formattedStringLengthWithNull);
+
+			std::vsnprintf(buffer.get(), formattedStringLengthWithNull, format, args);
+
+			logger.WriteLine(category, level, buffer.get());
+		}
+
+		va_end(args);
+	}
+
+	void BM_LoggerWriteLineVarargs(benchmark::State& state)
+	{
+		ScopedBenchmarkLogger scopedLogger(state);
+		Logger& logger = Logger::GetInstance();
+		const LogLevel level = scopedLogger.GetLevel();
+
+		const int width = 1920;
+		const int height = 1080;
+		const double milliseconds = 16.6667;
+
+		for (auto _ : state)
+		{
+			WriteLineVarargs(
+				logger,
+				LogCategory::General,
+				level,
+				"Set the window size to %dx%d, the frame took %.2f ms.",
+				width,
+				height,
+				milliseconds);
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void BM_LoggerWriteLineFormatted(benchmark::State& state)
+	{
+		ScopedBenchmarkLogger scopedLogger(state);
+		Logger& logger = Logger::GetInstance();
+		const LogLevel level = scopedLogger.GetLevel();
+
+		const int width = 1920;
+		const int height = 1080;
+		const double milliseconds = 16.6667;
+
+		for (auto _ : state)
+		{
+			logger.WriteLineFormatted(
+				LogCategory::General,
+				level,
+				"Set the window size to {}x{}, the frame took {:.2f} ms.",
+				width,
+				height,
+				milliseconds);
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	// LOG_DEBUG also records the event in the flight recorder, even when the Debug level is disabled.
+	void BM_LogDebugMacro(benchmark::State& state)
+	{
+		ScopedBenchmarkLogger scopedLogger(state);
+
+		const uint32_t address = 0x887738;
+
+		for (auto _ : state)
+		{
+			LOG_DEBUG(LogCategory::General, "Patched the code at 0x{:08X}.", address);
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+}
+
+BENCHMARK(BM_LoggerWriteLine)->Apply(LoggerArguments);
+BENCHMARK(BM_LoggerWriteLineVarargs)->Apply(LoggerArguments);
+BENCHMARK(BM_LoggerWriteLineFormatted)->Apply(LoggerArguments);
+BENCHMARK(BM_LogDebugMacro)
+	->ArgNames({ "level", "enabled", "async" })
+	->Args({ static_cast<int64_t>(LogLevel::Debug), 1, 0 })
+	->Args({ static_cast<int64_t>(LogLevel::Debug), 0, 0 });
@@ -0,0 +1,199 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "Settings.h"
+#include "SettingsSchema.h"
+#include "TestDirectory.h"
+#include <benchmark/benchmark.h>
+#include <array>
+#include <string>
+
+namespace
+{
+	void BM_FindSettingIndex(benchmark::State& state)
+	{
+		for (auto _ : state)
+		{
+			for (const SettingDefinition& definition : kSettingDefinitions)
+			{
+				benchmark::DoNotOptimize(FindSettingIndex(definition.section, definition.key));
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kSettingCount));
+	}
+
+	void BM_SettingsLoad_ShippedFile(benchmark::State& state)
+	{
+		const std::filesystem::path path = SC4GRAPHICSOPTIONS_SOURCE_DIR "/SC4GraphicsOptions.ini";
+
+		for (auto _ : state)
+		{
+			Settings settings;
+			settings.Load(path);
+			benchmark::DoNotOptimize(settings);
+		}
+	}
+
+	// Thousands of keys that the plugin does not use, spread over many sections.
+	std::string CreateUnknownKeysFile()
+	{
+		std::string text;
+
+		for (int i = 0; i < 10000; i++)
+		{
+			if ((i % 200) == 0)
+			{
+				text += "[Section" + std::to_string(i / 200) + "]\r\n";
+			}
+
+			text += "Key" + std::to_string(i) + "=Value" + std::to_string(i) + "\r\n";
+		}
+
+		return text;
+	}
+
+	// Very long comment lines and values, and long runs of whitespace around a value.
+	// Settings::Load rejects files that are larger than 1 MiB.
+	std::string CreateLongLinesFile()
+	{
+		const std::string comment = "; " + std::string(64 * 1024, 'x') + "\r\n";
+		std::string text = "[GraphicsOptions]\r\n";
+
+		for (int i = 0; i < 12; i++)
+		{
+			text += comment;
+		}
+
+		text += "Driver=" + std::string(4096, ' ') + "DirectX" + std::string(4096, ' ') + "\r\n";
+		text += "WindowWidth=" + std::string(64 * 1024, '9') + "\r\n";
+
+		return text;
+	}
+
+	// Every known setting repeated with an invalid value, each of them is reported.
+	std::string CreateInvalidValuesFile()
+	{
+		std::string text;
+
+		for (int i = 0; i < 100; i++)
+		{
+			for (const SettingDefinition& definition : kSettingDefinitions)
+			{
+				text += "[";
+				text += definition.section;
+				text += "]\n";
+				text += definition.key;
+				text += "=not a valid value\n";
+			}
+		}
+
+		return text;
+	}
+
+	// A single comment line without a line break, just below the 1 MiB file size limit.
+	std::string CreateSingleLineFile()
+	{
+		return "; " + std::string((1024 * 1024) - 64, 'D');
+	}
+
+	template <typename CreateFile>
+	void BM_SettingsLoad_Generated(benchmark::State& state, CreateFile createFile)
+	{
+		TestDirectory directory;
+
+		const std::string contents = createFile();
+		const std::filesystem::path path = directory.WriteFile("SC4GraphicsOptions.ini", contents);
+
+		for (auto _ : state)
+		{
+			Settings settings;
+			settings.Load(path);
+			benchmark::DoNotOptimize(settings);
+		}
+
+		state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(contents.size()));
+	}
+
+	struct EnumValue
+	{
+		size_t settingIndex;
+		std::string_view text;
+	};
+
+	constexpr size_t kDriverIndex = GetSettingIndex("GraphicsOptions", "Driver");
+	constexpr size_t kWindowModeIndex = GetSettingIndex("GraphicsOptions", "WindowMode");
+
+	// The documented values, the aliases, values in a different case and invalid values.
+	constexpr std::array<EnumValue, 10> kEnumValues =
+	{
+		EnumValue{ kDriverIndex, "DirectX" },
+		EnumValue{ kDriverIndex, "OpenGL" },
+		EnumValue{ kDriverIndex, "SCGL" },
+		EnumValue{ kDriverIndex, "software" },
+		EnumValue{ kDriverIndex, "Vulkan" },
+		EnumValue{ kWindowModeIndex, "Windowed" },
+		EnumValue{ kWindowModeIndex, "FullScreen" },
+		EnumValue{ kWindowModeIndex, "BorderlessFullScreen" },
+		EnumValue{ kWindowModeIndex, "Borderless" },
+		EnumValue{ kWindowModeIndex, "Maximized" },
+	};
+
+	void BM_ParseSettingValue_Enums(benchmark::State& state)
+	{
+		for (auto _ : state)
+		{
+			for (const EnumValue& item : kEnumValues)
+			{
+				uint32_t value = 0;
+
+				benchmark::DoNotOptimize(ParseSettingValue(kSettingDefinitions[item.settingIndex], item.text, value));
+				benchmark::DoNotOptimize(value);
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kEnumValues.size()));
+	}
+
+	void BM_GetSettingValueName_WindowMode(benchmark::State& state)
+	{
+		const SettingDefinition& definition = kSettingDefinitions[kWindowModeIndex];
+
+		for (auto _ : state)
+		{
+			for (uint32_t value = 0; value < 3; value++)
+			{
+				benchmark::DoNotOptimize(GetSettingValueName(definition, value));
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations() * 3);
+	}
+}
+
+BENCHMARK(BM_FindSettingIndex);
+BENCHMARK(BM_SettingsLoad_ShippedFile);
+BENCHMARK_CAPTURE(BM_SettingsLoad_Generated, UnknownKeys, CreateUnknownKeysFile);
+BENCHMARK_CAPTURE(BM_SettingsLoad_Generated, LongLines, CreateLongLinesFile);
+BENCHMARK_CAPTURE(BM_SettingsLoad_Generated, InvalidValues, CreateInvalidValuesFile);
+BENCHMARK_CAPTURE(BM_SettingsLoad_Generated, SingleLine, CreateSingleLineFile);
+BENCHMARK(BM_ParseSettingValue_Enums);
+BENCHMARK(BM_GetSettingValueName_WindowMode);
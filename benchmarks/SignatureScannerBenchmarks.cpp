@@ -0,0 +1,87 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SignatureScanner.h"
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+	// Larger than the game's .text section, which is about 5 MiB.
+	constexpr size_t kBufferSize = 8 * 1024 * 1024;
+
+	// A pattern with wildcards like the ones that the patch sites use,
+	// the first anchor byte is common in x86 code.
+	constexpr const char* kPattern = "8B 44 24 ?? 6A 10 50 E8 ?? ?? ?? ?? 83 C4 08";
+	constexpr uint8_t kPatternBytes[] = { 0x8B, 0x44, 0x24, 0x0C, 0x6A, 0x10, 0x50, 0xE8, 0x01, 0x02, 0x03, 0x04, 0x83, 0xC4, 0x08 };
+
+	// Random data with the pattern at the end of the buffer, so the whole buffer is scanned.
+	const std::vector<uint8_t>& GetScanBuffer()
+	{
+		static const std::vector<uint8_t> buffer = []()
+		{
+			std::vector<uint8_t> data(kBufferSize);
+			std::mt19937 random(20260);
+			std::uniform_int_distribution<int> distribution(0, 255);
+
+			for (uint8_t& value : data)
+			{
+				value = static_cast<uint8_t>(distribution(random));
+			}
+
+			std::memcpy(data.data() + data.size() - sizeof(kPatternBytes), kPatternBytes, sizeof(kPatternBytes));
+
+			return data;
+		}();
+
+		return buffer;
+	}
+
+	void BM_SignatureScannerFind(benchmark::State& state)
+	{
+		const SignatureScannerMode mode = static_cast<SignatureScannerMode>(state.range(0));
+
+		if (mode > SignatureScanner::GetBestMode())
+		{
+			state.SkipWithError("The CPU does not support this scanner mode.");
+			return;
+		}
+
+		const std::vector<uint8_t>& buffer = GetScanBuffer();
+		const BytePattern pattern(kPattern);
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(SignatureScanner::Find(buffer.data(), buffer.size(), pattern, 0, mode));
+		}
+
+		state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(buffer.size()));
+	}
+}
+
+BENCHMARK(BM_SignatureScannerFind)
+	->ArgName("mode")
+	->Arg(static_cast<int64_t>(SignatureScannerMode::Scalar))
+	->Arg(static_cast<int64_t>(SignatureScannerMode::SSE2))
+	->Arg(static_cast<int64_t>(SignatureScannerMode::AVX2))
+	->Unit(benchmark::kMicrosecond);
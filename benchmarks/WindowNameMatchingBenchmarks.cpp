@@ -0,0 +1,82 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SC4WindowNameMatching.h"
+#include <benchmark/benchmark.h>
+#include <array>
+
+namespace
+{
+	// The game's main window is created once, most CreateWindowExA calls that
+	// the hook sees are for other windows.
+	constexpr std::array<const char*, 8> kWindowNames =
+	{
+		"GDriverWindow--DirectX",
+		"GDriverWindow--OpenGL",
+		"GDriverWindow--Software",
+		"GDriverWindow--Direct3",
+		"SimCity 4",
+		"Default IME",
+		"MSCTFIME UI",
+		"A window name that is much longer than any of the game's window names",
+	};
+
+	constexpr std::array<const char*, 8> kClassNames =
+	{
+		"GDriverClass--DirectX",
+		"GDriverClass--OpenGL",
+		"GDriverClass--Software",
+		"GDriverClass--Direct3",
+		"SimCity 4",
+		"IME",
+		"MSCTFIME UI",
+		"A class name that is much longer than any of the game's class names",
+	};
+
+	void BM_IsSC4AppWindowName(benchmark::State& state)
+	{
+		for (auto _ : state)
+		{
+			for (const char* name : kWindowNames)
+			{
+				benchmark::DoNotOptimize(IsSC4AppWindowName(name));
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kWindowNames.size()));
+	}
+
+	void BM_IsSC4AppWindowClassName(benchmark::State& state)
+	{
+		for (auto _ : state)
+		{
+			for (const char* name : kClassNames)
+			{
+				benchmark::DoNotOptimize(IsSC4AppWindowClassName(name));
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kClassNames.size()));
+	}
+}
+
+BENCHMARK(BM_IsSC4AppWindowName);
+BENCHMARK(BM_IsSC4AppWindowClassName);
@@ -0,0 +1,120 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "IniParser.h"
+#include "SettingsSchema.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string_view>
+
+// Parses the input as an INI file and decodes the known settings.
+// The parser must either return entries that satisfy the checks below or throw an
+// IniParseError, any other outcome (a crash, another exception or a failed check) is a bug.
+namespace
+{
+	void Check(bool condition)
+	{
+		if (!condition)
+		{
+			std::abort();
+		}
+	}
+
+	bool IsWithin(std::string_view text, std::string_view part)
+	{
+		return part.empty()
+			|| (part.data() >= text.data() && (part.data() + part.size()) <= (text.data() + text.size()));
+	}
+
+	bool IsTrimmed(std::string_view value)
+	{
+		constexpr std::string_view kWhitespace = " \t";
+
+		return value.empty()
+			|| (kWhitespace.find(value.front()) == std::string_view::npos
+				&& kWhitespace.find(value.back()) == std::string_view::npos);
+	}
+
+	void CheckEntry(std::string_view text, const IniEntry& entry, uint32_t previousLine)
+	{
+		Check(!entry.key.empty());
+		Check(IsWithin(text, entry.section) && IsWithin(text, entry.key) && IsWithin(text, entry.value));
+		Check(IsTrimmed(entry.section) && IsTrimmed(entry.key) && IsTrimmed(entry.value));
+		Check(entry.key.find('\n') == std::string_view::npos);
+		Check(entry.value.find('\n') == std::string_view::npos);
+		Check(entry.line > previousLine && entry.column >= 1);
+	}
+
+	void DecodeSetting(const IniEntry& entry)
+	{
+		const size_t index = FindSettingIndex(entry.section, entry.key);
+
+		if (index == kInvalidSettingIndex)
+		{
+			return;
+		}
+
+		const SettingDefinition& definition = kSettingDefinitions[index];
+		uint32_t value = 0;
+
+		const SettingParseResult result = ParseSettingValue(definition, entry.value, value);
+
+		if (definition.type == SettingType::Enum)
+		{
+			// A parsed enumeration value always has a name.
+			Check(result != SettingParseResult::Success || !GetSettingValueName(definition, value).empty());
+		}
+		else
+		{
+			// Invalid values are replaced by the default value, and out of range values are clamped.
+			const bool disabled = value == 0 && (definition.flags & kSettingFlagsZeroDisables) != 0;
+
+			Check(disabled || (value >= definition.minValue && value <= definition.maxValue));
+		}
+	}
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	const std::string_view text(reinterpret_cast<const char*>(data), size);
+
+	try
+	{
+		IniParser parser(text);
+		IniEntry entry{};
+		uint32_t previousLine = 0;
+
+		while (parser.Next(entry))
+		{
+			CheckEntry(text, entry, previousLine);
+			DecodeSetting(entry);
+
+			previousLine = entry.line;
+		}
+	}
+	catch (const IniParseError& e)
+	{
+		Check(e.GetLine() >= 1 && e.GetColumn() >= 1);
+	}
+
+	return 0;
+}
@@ -0,0 +1,203 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// Runs a libFuzzer target without libFuzzer, for compilers that do not support -fsanitize=fuzzer.
+//
+// Usage: <fuzzer> [--iterations=N] [--seed=N] <file or folder>...
+//
+// Each input file is run as-is, then the driver runs N inputs that are made by randomly
+// mutating and splicing the input files. The mutations are deterministic for a given seed.
+// If the fuzz target aborts, the input is written to crash-input in the current folder.
+
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace
+{
+	constexpr size_t kMaxInputSize = 64 * 1024;
+
+	// Bytes that are significant to the INI syntax are more likely to find bugs than random bytes.
+	constexpr std::string_view kInterestingBytes = "[]=;#\r\n \t\xEF\xBB\xBF";
+
+	void AddInputFile(const std::filesystem::path& path, std::vector<std::string>& inputs)
+	{
+		std::ifstream stream(path, std::ifstream::in | std::ifstream::binary);
+
+		inputs.emplace_back(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	}
+
+	const std::string* s_CurrentInput = nullptr;
+
+	void WriteCrashInput(int signal)
+	{
+		if (s_CurrentInput)
+		{
+			if (std::FILE* file = std::fopen("crash-input", "wb"))
+			{
+				std::fwrite(s_CurrentInput->data(), 1, s_CurrentInput->size(), file);
+				std::fclose(file);
+			}
+
+			std::fputs("The fuzz target failed, the input was written to crash-input.\n", stderr);
+		}
+
+		std::signal(signal, SIG_DFL);
+		std::raise(signal);
+	}
+
+	void RunInput(const std::string& input)
+	{
+		s_CurrentInput = &input;
+		LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+		s_CurrentInput = nullptr;
+	}
+
+	std::string Mutate(const std::vector<std::string>& inputs, std::mt19937& random)
+	{
+		std::uniform_int_distribution<size_t> inputDistribution(0, inputs.size() - 1);
+		std::string input = inputs[inputDistribution(random)];
+
+		const uint32_t mutationCount = std::uniform_int_distribution<uint32_t>(1, 8)(random);
+
+		for (uint32_t i = 0; i < mutationCount; i++)
+		{
+			const size_t position = std::uniform_int_distribution<size_t>(0, input.size())(random);
+			const char interestingByte = kInterestingBytes[std::uniform_int_distribution<size_t>(0, kInterestingBytes.size() - 1)(random)];
+			const char randomByte = static_cast<char>(std::uniform_int_distribution<int>(0, 255)(random));
+
+			switch (std::uniform_int_distribution<int>(0, 5)(random))
+			{
+			case 0:
+				input.insert(position, 1, interestingByte);
+				break;
+			case 1:
+				input.insert(position, 1, randomByte);
+				break;
+			case 2:
+				if (position < input.size())
+				{
+					input[position] = interestingByte;
+				}
+				break;
+			case 3:
+				if (position < input.size())
+				{
+					const size_t length = std::uniform_int_distribution<size_t>(1, 16)(random);
+					input.erase(position, length);
+				}
+				break;
+			case 4:
+			{
+				// Splice part of another input.
+				const std::string& other = inputs[inputDistribution(random)];
+
+				if (!other.empty())
+				{
+					const size_t start = std::uniform_int_distribution<size_t>(0, other.size() - 1)(random);
+					const size_t length = std::uniform_int_distribution<size_t>(1, other.size() - start)(random);
+
+					input.insert(position, other, start, length);
+				}
+				break;
+			}
+			case 5:
+				input.resize(position);
+				break;
+			}
+		}
+
+		if (input.size() > kMaxInputSize)
+		{
+			input.resize(kMaxInputSize);
+		}
+
+		return input;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	uint64_t iterations = 0;
+	uint32_t seed = 1;
+	std::vector<std::string> inputs;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string_view argument = argv[i];
+
+		if (argument.starts_with("--iterations="))
+		{
+			iterations = std::stoull(std::string(argument.substr(13)));
+		}
+		else if (argument.starts_with("--seed="))
+		{
+			seed = static_cast<uint32_t>(std::stoul(std::string(argument.substr(7))));
+		}
+		else if (std::filesystem::is_directory(argument))
+		{
+			for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(argument))
+			{
+				if (entry.is_regular_file())
+				{
+					AddInputFile(entry.path(), inputs);
+				}
+			}
+		}
+		else
+		{
+			AddInputFile(argument, inputs);
+		}
+	}
+
+	std::signal(SIGABRT, WriteCrashInput);
+	std::signal(SIGSEGV, WriteCrashInput);
+
+	if (inputs.empty())
+	{
+		inputs.emplace_back();
+	}
+
+	for (const std::string& input : inputs)
+	{
+		RunInput(input);
+	}
+
+	std::mt19937 random(seed);
+
+	for (uint64_t i = 0; i < iterations; i++)
+	{
+		RunInput(Mutate(inputs, random));
+	}
+
+	std::printf("Ran %zu input file(s) and %llu mutated input(s).\n", inputs.size(), static_cast<unsigned long long>(iterations));
+
+	return 0;
+}
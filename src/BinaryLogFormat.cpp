@@ -0,0 +1,679 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "BinaryLogFormat.h"
+#include <charconv>
+#include <cstring>
+
+namespace
+{
+	template <typename T>
+	bool ReadValue(const uint8_t*& data, const uint8_t* end, T& value)
+	{
+		if (static_cast<size_t>(end - data) < sizeof(T))
+		{
+			return false;
+		}
+
+		std::memcpy(&value, data, sizeof(T));
+		data += sizeof(T);
+
+		return true;
+	}
+
+	// A std::format standard format specification:
+	// [[fill]align][sign][#][0][width][.precision][type]
+	struct FormatSpec
+	{
+		char fill = ' ';
+		// '<', '>' or '^', 0 uses the default alignment of the argument type.
+		char align = 0;
+		char sign = '-';
+		bool alternateForm = false;
+		bool zeroPad = false;
+		size_t width = 0;
+		int precision = -1;
+		char type = 0;
+	};
+
+	bool IsAlignment(char c)
+	{
+		return c == '<' || c == '>' || c == '^';
+	}
+
+	bool ParseNumber(std::string_view text, size_t& i, size_t& value)
+	{
+		const char* const first = text.data() + i;
+		const std::from_chars_result result = std::from_chars(first, text.data() + text.size(), value);
+
+		if (result.ec != std::errc() || result.ptr == first)
+		{
+			return false;
+		}
+
+		i += static_cast<size_t>(result.ptr - first);
+		return true;
+	}
+
+	// Returns false for the specifications that the decoder does not support,
+	// e.g. widths that are read from another argument. Those are formatted without
+	// the specification.
+	bool ParseFormatSpec(std::string_view text, FormatSpec& spec)
+	{
+		size_t i = 0;
+
+		if (text.size() >= 2 && IsAlignment(text[1]))
+		{
+			spec.fill = text[0];
+			spec.align = text[1];
+			i = 2;
+		}
+		else if (!text.empty() && IsAlignment(text[0]))
+		{
+			spec.align = text[0];
+			i = 1;
+		}
+
+		if (i < text.size() && (text[i] == '+' || text[i] == '-' || text[i] == ' '))
+		{
+			spec.sign = text[i++];
+		}
+
+		if (i < text.size() && text[i] == '#')
+		{
+			spec.alternateForm = true;
+			i++;
+		}
+
+		if (i < text.size() && text[i] == '0')
+		{
+			spec.zeroPad = true;
+			i++;
+		}
+
+		if (i < text.size() && text[i] >= '1' && text[i] <= '9' && !ParseNumber(text, i, spec.width))
+		{
+			return false;
+		}
+
+		if (i < text.size() && text[i] == '.')
+		{
+			i++;
+
+			size_t precision = 0;
+
+			if (!ParseNumber(text, i, precision) || precision > 1000)
+			{
+				return false;
+			}
+
+			spec.precision = static_cast<int>(precision);
+		}
+
+		if (i < text.size())
+		{
+			spec.type = text[i++];
+		}
+
+		return i == text.size();
+	}
+
+	void AppendPadded(
+		std::string& output,
+		std::string_view prefix,
+		std::string_view text,
+		const FormatSpec& spec,
+		char defaultAlignment)
+	{
+		const size_t length = prefix.size() + text.size();
+		const size_t padding = spec.width > length ? spec.width - length : 0;
+		const char alignment = spec.align != 0 ? spec.align : defaultAlignment;
+		const size_t paddingBefore = alignment == '>' ? padding : alignment == '^' ? padding / 2 : 0;
+
+		output.append(paddingBefore, spec.fill);
+		output.append(prefix);
+		output.append(text);
+		output.append(padding - paddingBefore, spec.fill);
+	}
+
+	void AppendPadded(std::string& output, std::string_view text, const FormatSpec& spec, char defaultAlignment)
+	{
+		AppendPadded(output, std::string_view(), text, spec, defaultAlignment);
+	}
+
+	// Appends a number that has been converted to text, the prefix is the sign and base prefix.
+	// The 0 flag pads the number with zeros between the prefix and the digits.
+	void AppendNumber(std::string& output, std::string_view prefix, std::string_view digits, const FormatSpec& spec)
+	{
+		const size_t length = prefix.size() + digits.size();
+
+		if (spec.zeroPad && spec.align == 0 && length < spec.width)
+		{
+			output.append(prefix);
+			output.append(spec.width - length, '0');
+			output.append(digits);
+		}
+		else
+		{
+			AppendPadded(output, prefix, digits, spec, '>');
+		}
+	}
+
+	std::string_view GetSignPrefix(bool negative, const FormatSpec& spec)
+	{
+		if (negative)
+		{
+			return "-";
+		}
+
+		switch (spec.sign)
+		{
+		case '+':
+			return "+";
+		case ' ':
+			return " ";
+		default:
+			return {};
+		}
+	}
+
+	bool IsIntegerType(char type)
+	{
+		switch (type)
+		{
+		case 'b':
+		case 'B':
+		case 'c':
+		case 'd':
+		case 'o':
+		case 'x':
+		case 'X':
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	void AppendInteger(std::string& output, uint64_t magnitude, bool negative, const FormatSpec& spec)
+	{
+		if (spec.type == 'c')
+		{
+			const char value = static_cast<char>(magnitude);
+
+			AppendPadded(output, std::string_view(&value, 1), spec, '<');
+			return;
+		}
+
+		int base = 10;
+		std::string_view basePrefix;
+
+		switch (spec.type)
+		{
+		case 'b':
+			base = 2;
+			basePrefix = "0b";
+			break;
+		case 'B':
+			base = 2;
+			basePrefix = "0B";
+			break;
+		case 'o':
+			base = 8;
+			basePrefix = magnitude != 0 ? "0" : "";
+			break;
+		case 'x':
+			base = 16;
+			basePrefix = "0x";
+			break;
+		case 'X':
+			base = 16;
+			basePrefix = "0X";
+			break;
+		}
+
+		char digits[72]{};
+		char* const digitsEnd = std::to_chars(digits, digits + sizeof(digits), magnitude, base).ptr;
+
+		if (spec.type == 'X' || spec.type == 'B')
+		{
+			for (char* c = digits; c < digitsEnd; c++)
+			{
+				if (*c >= 'a' && *c <= 'z')
+				{
+					*c = static_cast<char>(*c - ('a' - 'A'));
+				}
+			}
+		}
+
+		const std::string_view sign = GetSignPrefix(negative, spec);
+
+		char prefix[4]{};
+		size_t prefixLength = sign.copy(prefix, sign.size());
+
+		if (spec.alternateForm)
+		{
+			prefixLength += basePrefix.copy(prefix + prefixLength, basePrefix.size());
+		}
+
+		AppendNumber(
+			output,
+			std::string_view(prefix, prefixLength),
+			std::string_view(digits, static_cast<size_t>(digitsEnd - digits)),
+			spec);
+	}
+
+	void AppendSignedInteger(std::string& output, int64_t value, const FormatSpec& spec)
+	{
+		// The magnitude of INT64_MIN does not fit in an int64_t.
+		const uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+
+		AppendInteger(output, magnitude, value < 0, spec);
+	}
+
+	void AppendDouble(std::string& output, double value, const FormatSpec& spec)
+	{
+		char buffer[512]{};
+		char* const bufferEnd = buffer + sizeof(buffer);
+		std::to_chars_result result{};
+
+		const int precision = spec.precision >= 0 ? spec.precision : 6;
+
+		switch (spec.type)
+		{
+		case 'f':
+		case 'F':
+			result = std::to_chars(buffer, bufferEnd, value, std::chars_format::fixed, precision);
+			break;
+		case 'e':
+		case 'E':
+			result = std::to_chars(buffer, bufferEnd, value, std::chars_format::scientific, precision);
+			break;
+		case 'g':
+		case 'G':
+			result = std::to_chars(buffer, bufferEnd, value, std::chars_format::general, precision);
+			break;
+		case 'a':
+		case 'A':
+			result = spec.precision >= 0
+				? std::to_chars(buffer, bufferEnd, value, std::chars_format::hex, spec.precision)
+				: std::to_chars(buffer, bufferEnd, value, std::chars_format::hex);
+			break;
+		default:
+			// Without a precision or type std::format uses the shortest representation.
+			result = spec.precision >= 0
+				? std::to_chars(buffer, bufferEnd, value, std::chars_format::general, spec.precision)
+				: std::to_chars(buffer, bufferEnd, value);
+			break;
+		}
+
+		if (result.ec != std::errc())
+		{
+			result = std::to_chars(buffer, bufferEnd, value);
+		}
+
+		if (spec.type == 'F' || spec.type == 'E' || spec.type == 'G' || spec.type == 'A')
+		{
+			for (char* c = buffer; c < result.ptr; c++)
+			{
+				if (*c >= 'a' && *c <= 'z')
+				{
+					*c = static_cast<char>(*c - ('a' - 'A'));
+				}
+			}
+		}
+
+		std::string_view digits(buffer, static_cast<size_t>(result.ptr - buffer));
+		const bool negative = !digits.empty() && digits[0] == '-';
+
+		if (negative)
+		{
+			digits.remove_prefix(1);
+		}
+
+		AppendNumber(output, GetSignPrefix(negative, spec), digits, spec);
+	}
+
+	void AppendArgument(std::string& output, const BinaryLogFormat::Argument& argument, const FormatSpec& spec)
+	{
+		using BinaryLogFormat::ArgumentType;
+
+		switch (argument.type)
+		{
+		case ArgumentType::Bool:
+			if (IsIntegerType(spec.type))
+			{
+				AppendInteger(output, argument.boolValue ? 1 : 0, false, spec);
+			}
+			else
+			{
+				AppendPadded(output, argument.boolValue ? "true" : "false", spec, '<');
+			}
+			break;
+		case ArgumentType::Char:
+			if (IsIntegerType(spec.type) && spec.type != 'c')
+			{
+				AppendInteger(output, static_cast<unsigned char>(argument.charValue), false, spec);
+			}
+			else
+			{
+				AppendPadded(output, std::string_view(&argument.charValue, 1), spec, '<');
+			}
+			break;
+		case ArgumentType::Int64:
+			AppendSignedInteger(output, argument.int64Value, spec);
+			break;
+		case ArgumentType::UInt64:
+			AppendInteger(output, argument.uint64Value, false, spec);
+			break;
+		case ArgumentType::Double:
+			AppendDouble(output, argument.doubleValue, spec);
+			break;
+		case ArgumentType::String:
+		{
+			std::string_view value = argument.stringValue;
+
+			// The precision is the maximum number of characters.
+			if (spec.precision >= 0 && value.size() > static_cast<size_t>(spec.precision))
+			{
+				value = value.substr(0, static_cast<size_t>(spec.precision));
+			}
+
+			AppendPadded(output, value, spec, '<');
+			break;
+		}
+		}
+	}
+
+	// Finds the '}' that closes a replacement field, skipping nested fields such as
+	// the dynamic width in "{:{}}".
+	size_t FindReplacementFieldEnd(std::string_view format, size_t start)
+	{
+		size_t depth = 0;
+
+		for (size_t i = start; i < format.size(); i++)
+		{
+			if (format[i] == '{')
+			{
+				depth++;
+			}
+			else if (format[i] == '}')
+			{
+				if (depth == 0)
+				{
+					return i;
+				}
+
+				depth--;
+			}
+		}
+
+		return std::string_view::npos;
+	}
+}
+
+bool BinaryLogFormat::DecodeArguments(const uint8_t* data, size_t length, std::vector<Argument>& arguments)
+{
+	arguments.clear();
+
+	const uint8_t* const end = data + length;
+
+	while (data < end)
+	{
+		Argument argument{};
+		argument.type = static_cast<ArgumentType>(*data++);
+
+		bool result = false;
+
+		switch (argument.type)
+		{
+		case ArgumentType::Bool:
+		{
+			uint8_t value = 0;
+			result = ReadValue(data, end, value);
+			argument.boolValue = value != 0;
+			break;
+		}
+		case ArgumentType::Char:
+			result = ReadValue(data, end, argument.charValue);
+			break;
+		case ArgumentType::Int64:
+			result = ReadValue(data, end, argument.int64Value);
+			break;
+		case ArgumentType::UInt64:
+			result = ReadValue(data, end, argument.uint64Value);
+			break;
+		case ArgumentType::Double:
+			result = ReadValue(data, end, argument.doubleValue);
+			break;
+		case ArgumentType::String:
+		{
+			uint16_t stringLength = 0;
+
+			if (ReadValue(data, end, stringLength) && static_cast<size_t>(end - data) >= stringLength)
+			{
+				argument.stringValue = std::string_view(reinterpret_cast<const char*>(data), stringLength);
+				data += stringLength;
+				result = true;
+			}
+			break;
+		}
+		}
+
+		if (!result)
+		{
+			return false;
+		}
+
+		arguments.push_back(std::move(argument));
+	}
+
+	return true;
+}
+
+std::string BinaryLogFormat::FormatEventMessage(std::string_view format, const std::vector<Argument>& arguments)
+{
+	std::string output;
+	output.reserve(format.size() + (arguments.size() * 8));
+
+	AppendEventMessage(output, format, arguments);
+
+	return output;
+}
+
+void BinaryLogFormat::AppendEventMessage(std::string& output, std::string_view format, const std::vector<Argument>& arguments)
+{
+	size_t nextArgumentIndex = 0;
+	size_t i = 0;
+
+	while (i < format.size())
+	{
+		const char c = format[i];
+
+		if (c == '{')
+		{
+			if ((i + 1) < format.size() && format[i + 1] == '{')
+			{
+				output.push_back('{');
+				i += 2;
+				continue;
+			}
+
+			const size_t fieldEnd = FindReplacementFieldEnd(format, i + 1);
+
+			if (fieldEnd == std::string_view::npos)
+			{
+				// Copy the malformed replacement field as-is.
+				output.append(format.substr(i));
+				break;
+			}
+
+			const std::string_view field = format.substr(i + 1, fieldEnd - (i + 1));
+			const size_t specStart = field.find(':');
+			const std::string_view argumentIdField = field.substr(0, specStart);
+
+			FormatSpec spec{};
+
+			if (specStart != std::string_view::npos && !ParseFormatSpec(field.substr(specStart + 1), spec))
+			{
+				spec = FormatSpec{};
+			}
+
+			size_t argumentIndex = nextArgumentIndex;
+
+			if (!argumentIdField.empty())
+			{
+				std::from_chars(argumentIdField.data(), argumentIdField.data() + argumentIdField.size(), argumentIndex);
+			}
+			else
+			{
+				nextArgumentIndex++;
+			}
+
+			if (argumentIndex < arguments.size())
+			{
+				AppendArgument(output, arguments[argumentIndex], spec);
+			}
+			else
+			{
+				output.append("<missing>");
+			}
+
+			i = fieldEnd + 1;
+		}
+		else if (c == '}' && (i + 1) < format.size() && format[i + 1] == '}')
+		{
+			output.push_back('}');
+			i += 2;
+		}
+		else
+		{
+			output.push_back(c);
+			i++;
+		}
+	}
+}
+
+const char* BinaryLogFormat::GetLogLevelName(uint8_t level)
+{
+	switch (level)
+	{
+	case 0:
+		return "Info";
+	case 1:
+		return "Error";
+	case 2:
+		return "Debug";
+	case 3:
+		return "Trace";
+	default:
+		return "Unknown";
+	}
+}
+
+BinaryLogFormat::Reader::Reader(const uint8_t* data, size_t size)
+	: data(data),
+	  size(size),
+	  offset(0),
+	  formatStrings()
+{
+}
+
+bool BinaryLogFormat::Reader::ReadFileHeader(uint32_t& version)
+{
+	const uint8_t* position = data;
+	const uint8_t* const end = data + size;
+
+	if (size < kFileHeaderSize || std::memcmp(data, kFileSignature, sizeof(kFileSignature)) != 0)
+	{
+		return false;
+	}
+
+	position += sizeof(kFileSignature);
+	ReadValue(position, end, version);
+	offset = kFileHeaderSize;
+
+	return true;
+}
+
+BinaryLogFormat::ReadResult BinaryLogFormat::Reader::ReadEvent(Event& event)
+{
+	const uint8_t* const end = data + size;
+
+	while (offset < size)
+	{
+		const size_t recordOffset = offset;
+		const uint8_t* position = data + offset;
+		const RecordType recordType = static_cast<RecordType>(*position++);
+
+		if (recordType == RecordType::FormatString)
+		{
+			uint32_t id = 0;
+			uint16_t length = 0;
+
+			if (!ReadValue(position, end, id)
+				|| !ReadValue(position, end, length)
+				|| static_cast<size_t>(end - position) < length)
+			{
+				return ReadResult::TruncatedRecord;
+			}
+
+			formatStrings[id].assign(reinterpret_cast<const char*>(position), length);
+			offset = static_cast<size_t>((position + length) - data);
+		}
+		else if (recordType == RecordType::Event)
+		{
+			uint16_t argumentDataLength = 0;
+
+			event.offset = recordOffset;
+
+			if (!ReadValue(position, end, event.level)
+				|| !ReadValue(position, end, event.category)
+				|| !ReadValue(position, end, argumentDataLength)
+				|| !ReadValue(position, end, event.formatStringID)
+				|| !ReadValue(position, end, event.systemTime)
+				|| !ReadValue(position, end, event.microsecondsSinceLoad)
+				|| static_cast<size_t>(end - position) < argumentDataLength)
+			{
+				return ReadResult::TruncatedRecord;
+			}
+
+			event.argumentsValid = DecodeArguments(position, argumentDataLength, event.arguments);
+			offset = static_cast<size_t>((position + argumentDataLength) - data);
+
+			const auto formatString = formatStrings.find(event.formatStringID);
+
+			event.format = formatString != formatStrings.end() ? &formatString->second : nullptr;
+
+			return ReadResult::Event;
+		}
+		else
+		{
+			return ReadResult::UnknownRecordType;
+		}
+	}
+
+	return ReadResult::EndOfFile;
+}
+
+size_t BinaryLogFormat::Reader::GetOffset() const
+{
+	return offset;
+}
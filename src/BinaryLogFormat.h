@@ -0,0 +1,163 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// The binary log (.blog) file format.
+// This file is shared with the log decoder tool, it must not depend on any Windows headers.
+//
+// The file starts with the 8 byte signature followed by a 32-bit version number.
+// The remainder of the file is a sequence of records, all values are stored in little-endian
+// byte order.
+//
+// FormatString record:
+//   RecordType::FormatString (uint8_t)
+//   format string id (uint32_t)
+//   format string length (uint16_t)
+//   format string bytes, the string is not null-terminated
+//
+// Event record:
+//   RecordType::Event (uint8_t)
+//   log level (uint8_t)
+//   log category (uint8_t)
+//   argument data length (uint16_t)
+//   format string id (uint32_t)
+//   system time, in 100-nanosecond intervals since January 1, 1601 UTC (uint64_t)
+//   microseconds since the DLL was loaded (uint64_t)
+//   argument data
+//
+// The argument data is a sequence of ArgumentType values, each followed by the argument value.
+// String arguments store their length as a uint16_t followed by the string bytes.
+namespace BinaryLogFormat
+{
+	constexpr char kFileSignature[8] = { 'S', 'C', '4', 'G', 'O', 'B', 'L', 'G' };
+	constexpr uint32_t kFileVersion = 2;
+
+	constexpr size_t kFileHeaderSize = sizeof(kFileSignature) + sizeof(uint32_t);
+	constexpr size_t kFormatStringRecordHeaderSize = 7;
+	constexpr size_t kEventRecordHeaderSize = 25;
+
+	constexpr size_t kMaxArgumentDataLength = 4096;
+	constexpr size_t kMaxStringArgumentLength = 1024;
+
+	enum class RecordType : uint8_t
+	{
+		FormatString = 1,
+		Event = 2
+	};
+
+	enum class ArgumentType : uint8_t
+	{
+		Bool = 1,
+		Char = 2,
+		Int64 = 3,
+		UInt64 = 4,
+		Double = 5,
+		String = 6
+	};
+
+	struct Argument
+	{
+		ArgumentType type;
+		bool boolValue;
+		char charValue;
+		int64_t int64Value;
+		uint64_t uint64Value;
+		double doubleValue;
+		// Points into the argument data that the argument was decoded from.
+		std::string_view stringValue;
+	};
+
+	// Decodes the argument data of an event record.
+	// Returns false if the data is malformed.
+	bool DecodeArguments(const uint8_t* data, size_t length, std::vector<Argument>& arguments);
+
+	// Formats an event message.
+	// This supports the std::format syntax that the plugin uses: {} replacement fields, optionally
+	// with an argument index and a standard format specification (fill, alignment, sign, #, 0,
+	// width, precision and type, e.g. {:08X} or {:.2f}), and the {{ and }} escapes.
+	// Widths and precisions that are read from another argument are not supported.
+	std::string FormatEventMessage(std::string_view format, const std::vector<Argument>& arguments);
+
+	// Appends the formatted event message to the output.
+	// This does not allocate if the output has enough capacity. DecodeArguments reuses
+	// the capacity of its arguments vector, so the flight recorder can format events
+	// in its crash handler without allocating.
+	void AppendEventMessage(std::string& output, std::string_view format, const std::vector<Argument>& arguments);
+
+	const char* GetLogLevelName(uint8_t level);
+
+	struct Event
+	{
+		// The offset of the record in the file.
+		size_t offset;
+		uint8_t level;
+		uint8_t category;
+		uint32_t formatStringID;
+		uint64_t systemTime;
+		uint64_t microsecondsSinceLoad;
+		// The format string, or nullptr if the file does not define the format string id.
+		const std::string* format;
+		// False if the argument data is malformed, the arguments before the malformed data are kept.
+		// The string arguments point into the data that the reader was created with.
+		bool argumentsValid;
+		std::vector<Argument> arguments;
+	};
+
+	enum class ReadResult
+	{
+		Event = 0,
+		EndOfFile,
+		// A truncated record at the end of the file is expected if the game crashed.
+		TruncatedRecord,
+		UnknownRecordType
+	};
+
+	// Reads the records of a binary log that is in memory.
+	// The reader keeps the format string records, only the events are returned.
+	class Reader
+	{
+	public:
+
+		Reader(const uint8_t* data, size_t size);
+
+		// Reads the file signature and version.
+		// Returns false if the data does not start with the binary log signature.
+		bool ReadFileHeader(uint32_t& version);
+
+		ReadResult ReadEvent(Event& event);
+
+		size_t GetOffset() const;
+
+	private:
+
+		const uint8_t* data;
+		size_t size;
+		size_t offset;
+		std::unordered_map<uint32_t, std::string> formatStrings;
+	};
+}
@@ -0,0 +1,116 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "BinaryLogWriter.h"
+#include "LogTimeStamp.h"
+
+namespace
+{
+	template <typename T>
+	void WriteValue(uint8_t*& position, const T& value)
+	{
+		std::memcpy(position, &value, sizeof(T));
+		position += sizeof(T);
+	}
+}
+
+BinaryLogWriter::BinaryLogWriter(const std::filesystem::path& path)
+	: mutex(),
+	  stream(path, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc),
+	  formatStringIDs(),
+	  nextFormatStringID(0)
+{
+	if (stream)
+	{
+		stream.write(BinaryLogFormat::kFileSignature, sizeof(BinaryLogFormat::kFileSignature));
+		stream.write(reinterpret_cast<const char*>(&BinaryLogFormat::kFileVersion), sizeof(BinaryLogFormat::kFileVersion));
+	}
+}
+
+bool BinaryLogWriter::IsOpen() const
+{
+	return stream.is_open();
+}
+
+void BinaryLogWriter::Flush()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	stream.flush();
+}
+
+void BinaryLogWriter::WriteEvent(
+	LogCategory category,
+	LogLevel level,
+	std::string_view format,
+	const BinaryLogEventArguments& arguments)
+{
+	const LogTimeStamp timeStamp = LogTimeStamp::Now();
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (!stream)
+	{
+		return;
+	}
+
+	uint8_t header[BinaryLogFormat::kEventRecordHeaderSize]{};
+	uint8_t* position = header;
+
+	WriteValue(position, static_cast<uint8_t>(BinaryLogFormat::RecordType::Event));
+	WriteValue(position, static_cast<uint8_t>(level));
+	WriteValue(position, static_cast<uint8_t>(category));
+	WriteValue(position, arguments.GetLength());
+	WriteValue(position, GetFormatStringID(format));
+	WriteValue(position, timeStamp.GetSystemTime());
+	WriteValue(position, timeStamp.GetMicrosecondsSinceLoad());
+
+	stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+	stream.write(reinterpret_cast<const char*>(arguments.GetData()), arguments.GetLength());
+}
+
+uint32_t BinaryLogWriter::GetFormatStringID(std::string_view format)
+{
+	const auto existing = formatStringIDs.find(format.data());
+
+	if (existing != formatStringIDs.end())
+	{
+		return existing->second;
+	}
+
+	const uint32_t id = nextFormatStringID++;
+	formatStringIDs.emplace(format.data(), id);
+
+	// The format string definition is written before the first event that uses it.
+	const uint16_t length = static_cast<uint16_t>(format.size() < UINT16_MAX ? format.size() : UINT16_MAX);
+
+	uint8_t header[BinaryLogFormat::kFormatStringRecordHeaderSize]{};
+	uint8_t* position = header;
+
+	WriteValue(position, static_cast<uint8_t>(BinaryLogFormat::RecordType::FormatString));
+	WriteValue(position, id);
+	WriteValue(position, length);
+
+	stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+	stream.write(format.data(), length);
+
+	return id;
+}
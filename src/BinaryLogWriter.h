@@ -0,0 +1,186 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include "BinaryLogFormat.h"
+#include "LogCategory.h"
+#include "LogLevel.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+// Stores the raw bytes of the arguments for a binary log event.
+// Strings are truncated to fit in the buffer, other arguments that do not fit
+// are discarded and the decoder shows them as missing.
+template <size_t Capacity>
+class BinaryLogArgumentBuffer
+{
+public:
+
+	BinaryLogArgumentBuffer() : length(0)
+	{
+	}
+
+	void Clear()
+	{
+		length = 0;
+	}
+
+	template <typename T>
+	void Add(const T& value)
+	{
+		using BinaryLogFormat::ArgumentType;
+
+		if constexpr (std::is_same_v<T, bool>)
+		{
+			const uint8_t byte = value ? 1 : 0;
+
+			AddValue(ArgumentType::Bool, &byte, sizeof(byte));
+		}
+		else if constexpr (std::is_same_v<T, char>)
+		{
+			AddValue(ArgumentType::Char, &value, sizeof(value));
+		}
+		else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+		{
+			const int64_t int64Value = value;
+
+			AddValue(ArgumentType::Int64, &int64Value, sizeof(int64Value));
+		}
+		else if constexpr (std::is_integral_v<T>)
+		{
+			const uint64_t uint64Value = value;
+
+			AddValue(ArgumentType::UInt64, &uint64Value, sizeof(uint64Value));
+		}
+		else if constexpr (std::is_floating_point_v<T>)
+		{
+			const double doubleValue = value;
+
+			AddValue(ArgumentType::Double, &doubleValue, sizeof(doubleValue));
+		}
+		else if constexpr (std::is_pointer_v<T>)
+		{
+			static_assert(std::is_convertible_v<T, const char*>, "Unsupported binary log argument type.");
+
+			AddString(value ? std::string_view(value) : std::string_view("(null)"));
+		}
+		else
+		{
+			static_assert(std::is_convertible_v<const T&, std::string_view>, "Unsupported binary log argument type.");
+
+			AddString(std::string_view(value));
+		}
+	}
+
+	const uint8_t* GetData() const
+	{
+		return data;
+	}
+
+	uint16_t GetLength() const
+	{
+		return static_cast<uint16_t>(length);
+	}
+
+private:
+
+	void AddValue(BinaryLogFormat::ArgumentType type, const void* value, size_t valueSize)
+	{
+		if ((length + 1 + valueSize) <= sizeof(data))
+		{
+			data[length] = static_cast<uint8_t>(type);
+			std::memcpy(data + length + 1, value, valueSize);
+			length += 1 + valueSize;
+		}
+	}
+
+	void AddString(std::string_view value)
+	{
+		constexpr size_t kStringHeaderSize = 1 + sizeof(uint16_t);
+
+		if ((length + kStringHeaderSize) <= sizeof(data))
+		{
+			const size_t available = sizeof(data) - length - kStringHeaderSize;
+
+			size_t truncatedLength = value.size() < available ? value.size() : available;
+
+			if (truncatedLength > BinaryLogFormat::kMaxStringArgumentLength)
+			{
+				truncatedLength = BinaryLogFormat::kMaxStringArgumentLength;
+			}
+
+			const uint16_t stringLength = static_cast<uint16_t>(truncatedLength);
+
+			data[length] = static_cast<uint8_t>(BinaryLogFormat::ArgumentType::String);
+			std::memcpy(data + length + 1, &stringLength, sizeof(stringLength));
+			std::memcpy(data + length + 1 + sizeof(stringLength), value.data(), stringLength);
+			length += 1 + sizeof(stringLength) + stringLength;
+		}
+	}
+
+	uint8_t data[Capacity];
+	size_t length;
+};
+
+using BinaryLogEventArguments = BinaryLogArgumentBuffer<BinaryLogFormat::kMaxArgumentDataLength>;
+
+// Writes log events as fixed-layout binary records, the formatting is
+// performed later by the log decoder tool.
+class BinaryLogWriter
+{
+public:
+
+	explicit BinaryLogWriter(const std::filesystem::path& path);
+
+	bool IsOpen() const;
+
+	template <typename... Args>
+	void Write(LogCategory category, LogLevel level, std::string_view format, const Args&... args)
+	{
+		BinaryLogEventArguments arguments;
+		(arguments.Add(args), ...);
+
+		WriteEvent(category, level, format, arguments);
+	}
+
+	void Flush();
+
+private:
+
+	void WriteEvent(
+		LogCategory category,
+		LogLevel level,
+		std::string_view format,
+		const BinaryLogEventArguments& arguments);
+
+	uint32_t GetFormatStringID(std::string_view format);
+
+	std::mutex mutex;
+	std::ofstream stream;
+	// The format strings are compile-time constants, so they are interned by address.
+	std::unordered_map<const char*, uint32_t> formatStringIDs;
+	uint32_t nextFormatStringID;
+};
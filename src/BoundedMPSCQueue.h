@@ -0,0 +1,135 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// A fixed-capacity lock-free queue that supports multiple producer threads
+// and a single consumer thread.
+// This is based on Dmitry Vyukov's bounded MPMC queue, each cell has a sequence
+// number that tells the producers and the consumer whether it is free or filled.
+template <typename T, size_t Capacity>
+class BoundedMPSCQueue
+{
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2.");
+
+public:
+
+	BoundedMPSCQueue() : enqueuePosition(0), dequeuePosition(0)
+	{
+		for (size_t i = 0; i < Capacity; i++)
+		{
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	BoundedMPSCQueue(const BoundedMPSCQueue&) = delete;
+	BoundedMPSCQueue& operator=(const BoundedMPSCQueue&) = delete;
+
+	// Claims a free cell and calls writer(T&) to fill it.
+	// Returns false without calling writer if the queue is full.
+	// This method can be called from any thread.
+	template <typename Writer>
+	bool TryPush(Writer&& writer)
+	{
+		Cell* cell = nullptr;
+		size_t position = enqueuePosition.load(std::memory_order_relaxed);
+
+		while (true)
+		{
+			cell = &cells[position & kIndexMask];
+			const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+			if (difference == 0)
+			{
+				if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (difference < 0)
+			{
+				// The consumer has not released this cell yet, the queue is full.
+				return false;
+			}
+			else
+			{
+				// Another producer claimed this cell first.
+				position = enqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		writer(cell->value);
+		cell->sequence.store(position + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	// Calls reader(T&) with the oldest filled cell and releases it.
+	// Returns false if the queue is empty.
+	// This method must only be called from the consumer thread.
+	template <typename Reader>
+	bool TryPop(Reader&& reader)
+	{
+		const size_t position = dequeuePosition;
+		Cell& cell = cells[position & kIndexMask];
+		const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+
+		if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1) < 0)
+		{
+			return false;
+		}
+
+		reader(cell.value);
+		cell.sequence.store(position + Capacity, std::memory_order_release);
+		dequeuePosition = position + 1;
+
+		return true;
+	}
+
+	// Returns true if the next cell the consumer would read has not been filled.
+	// This method must only be called from the consumer thread.
+	bool IsEmpty() const
+	{
+		const size_t position = dequeuePosition;
+		const size_t sequence = cells[position & kIndexMask].sequence.load(std::memory_order_acquire);
+
+		return static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1) < 0;
+	}
+
+private:
+
+	static constexpr size_t kIndexMask = Capacity - 1;
+
+	struct Cell
+	{
+		std::atomic<size_t> sequence;
+		T value;
+	};
+
+	std::array<Cell, Capacity> cells;
+	alignas(64) std::atomic<size_t> enqueuePosition;
+	alignas(64) size_t dequeuePosition;
+};
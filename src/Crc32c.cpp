@@ -0,0 +1,200 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "Crc32c.h"
+#include <array>
+#include <cstring>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define CRC32C_X86 1
+#include <nmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define CRC32C_TARGET(name)
+#else
+#define CRC32C_TARGET(name) __attribute__((target(name)))
+#endif // _MSC_VER
+#endif
+
+namespace
+{
+	// The reversed form of the Castagnoli polynomial.
+	constexpr uint32_t kPolynomial = 0x82F63B78;
+
+	// The tables for the slicing-by-8 algorithm, table N processes the byte
+	// that is N positions before the end of an 8 byte block.
+	using Crc32cTables = std::array<std::array<uint32_t, 256>, 8>;
+
+	constexpr Crc32cTables CreateTables()
+	{
+		Crc32cTables tables{};
+
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			uint32_t crc = i;
+
+			for (int bit = 0; bit < 8; bit++)
+			{
+				crc = (crc & 1) != 0 ? (crc >> 1) ^ kPolynomial : crc >> 1;
+			}
+
+			tables[0][i] = crc;
+		}
+
+		for (size_t table = 1; table < tables.size(); table++)
+		{
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				const uint32_t previous = tables[table - 1][i];
+
+				tables[table][i] = (previous >> 8) ^ tables[0][previous & 0xFF];
+			}
+		}
+
+		return tables;
+	}
+
+	constexpr Crc32cTables kTables = CreateTables();
+
+	uint32_t ComputeSoftware(const uint8_t* data, size_t size, uint32_t crc)
+	{
+		while (size >= 8)
+		{
+			uint32_t low = 0;
+			uint32_t high = 0;
+			std::memcpy(&low, data, sizeof(low));
+			std::memcpy(&high, data + 4, sizeof(high));
+
+			// The bytes are read in little endian order.
+			low ^= crc;
+
+			crc = kTables[7][low & 0xFF]
+				^ kTables[6][(low >> 8) & 0xFF]
+				^ kTables[5][(low >> 16) & 0xFF]
+				^ kTables[4][low >> 24]
+				^ kTables[3][high & 0xFF]
+				^ kTables[2][(high >> 8) & 0xFF]
+				^ kTables[1][(high >> 16) & 0xFF]
+				^ kTables[0][high >> 24];
+
+			data += 8;
+			size -= 8;
+		}
+
+		while (size > 0)
+		{
+			crc = (crc >> 8) ^ kTables[0][(crc ^ *data) & 0xFF];
+			data++;
+			size--;
+		}
+
+		return crc;
+	}
+
+#ifdef CRC32C_X86
+	CRC32C_TARGET("sse4.2")
+	uint32_t ComputeSSE42(const uint8_t* data, size_t size, uint32_t crc)
+	{
+#if defined(_M_X64) || defined(__x86_64__)
+		uint64_t crc64 = crc;
+
+		while (size >= 8)
+		{
+			uint64_t value = 0;
+			std::memcpy(&value, data, sizeof(value));
+
+			crc64 = _mm_crc32_u64(crc64, value);
+			data += 8;
+			size -= 8;
+		}
+
+		crc = static_cast<uint32_t>(crc64);
+#endif
+
+		while (size >= 4)
+		{
+			uint32_t value = 0;
+			std::memcpy(&value, data, sizeof(value));
+
+			crc = _mm_crc32_u32(crc, value);
+			data += 4;
+			size -= 4;
+		}
+
+		while (size > 0)
+		{
+			crc = _mm_crc32_u8(crc, *data);
+			data++;
+			size--;
+		}
+
+		return crc;
+	}
+
+	bool CpuSupportsSSE42()
+	{
+#ifdef _MSC_VER
+		int cpuInfo[4] = {};
+
+		__cpuid(cpuInfo, 1);
+
+		constexpr int kSSE42Bit = 1 << 20;
+
+		return (cpuInfo[2] & kSSE42Bit) != 0;
+#else
+		return __builtin_cpu_supports("sse4.2");
+#endif // _MSC_VER
+	}
+#endif // CRC32C_X86
+}
+
+Crc32cMode Crc32c::GetBestMode()
+{
+#ifdef CRC32C_X86
+	static const Crc32cMode bestMode = CpuSupportsSSE42() ? Crc32cMode::SSE42 : Crc32cMode::Software;
+
+	return bestMode;
+#else
+	return Crc32cMode::Software;
+#endif // CRC32C_X86
+}
+
+uint32_t Crc32c::Compute(const void* data, size_t size, uint32_t previous)
+{
+	return Compute(data, size, previous, GetBestMode());
+}
+
+uint32_t Crc32c::Compute(const void* data, size_t size, uint32_t previous, Crc32cMode mode)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	const uint32_t crc = ~previous;
+
+	switch (mode)
+	{
+#ifdef CRC32C_X86
+	case Crc32cMode::SSE42:
+		return ~ComputeSSE42(bytes, size, crc);
+#endif // CRC32C_X86
+	case Crc32cMode::Software:
+	default:
+		return ~ComputeSoftware(bytes, size, crc);
+	}
+}
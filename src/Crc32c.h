@@ -0,0 +1,42 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+enum class Crc32cMode : int32_t
+{
+	Software = 0,
+	SSE42
+};
+
+// The CRC-32C (Castagnoli) checksum, this uses the SSE 4.2 CRC32 instruction when the CPU supports it.
+namespace Crc32c
+{
+	// Returns the fastest mode that the CPU supports.
+	Crc32cMode GetBestMode();
+
+	// The previous value allows a checksum to be computed in several parts, it is 0 for the first part.
+	uint32_t Compute(const void* data, size_t size, uint32_t previous = 0);
+
+	uint32_t Compute(const void* data, size_t size, uint32_t previous, Crc32cMode mode);
+}
@@ -0,0 +1,172 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "DisplayModeCache.h"
+#include "Logger.h"
+#include "StartupTimeline.h"
+#include <algorithm>
+#include <tuple>
+
+namespace
+{
+	uint32_t AbsoluteDifference(uint32_t lhs, uint32_t rhs)
+	{
+		return lhs > rhs ? lhs - rhs : rhs - lhs;
+	}
+
+	bool IsSameSizeAndDepth(const Platform::DisplayMode& lhs, const Platform::DisplayMode& rhs)
+	{
+		return lhs.width == rhs.width
+			&& lhs.height == rhs.height
+			&& lhs.bitsPerPixel == rhs.bitsPerPixel;
+	}
+
+	// Returns true if the candidate is a better match for the request than the current best mode.
+	bool IsBetterMatch(
+		const Platform::DisplayMode& candidate,
+		const Platform::DisplayMode& best,
+		const DisplayModeRequest& request)
+	{
+		const uint32_t candidateDistance = AbsoluteDifference(candidate.width, request.width)
+			+ AbsoluteDifference(candidate.height, request.height);
+		const uint32_t bestDistance = AbsoluteDifference(best.width, request.width)
+			+ AbsoluteDifference(best.height, request.height);
+
+		if (candidateDistance != bestDistance)
+		{
+			return candidateDistance < bestDistance;
+		}
+
+		// Prefer a mode that is not larger than the requested size, e.g. for a
+		// request of 1300x700 the game UI fits in 1280x720 but not in 1320x720.
+		const bool candidateFits = candidate.width <= request.width && candidate.height <= request.height;
+		const bool bestFits = best.width <= request.width && best.height <= request.height;
+
+		if (candidateFits != bestFits)
+		{
+			return candidateFits;
+		}
+
+		return candidate.refreshRate > best.refreshRate;
+	}
+}
+
+DisplayModeSelection SelectDisplayMode(const Platform::DisplayModeList& list, const DisplayModeRequest& request)
+{
+	const Platform::DisplayMode requestedMode{ request.width, request.height, request.bitsPerPixel, 0 };
+
+	if (IsSameSizeAndDepth(list.currentMode, requestedMode))
+	{
+		return DisplayModeSelection{ list.currentMode, DisplayModeMatch::Desktop };
+	}
+
+	const Platform::DisplayMode* best = nullptr;
+
+	for (const Platform::DisplayMode& mode : list.modes)
+	{
+		if (mode.bitsPerPixel == request.bitsPerPixel
+			&& mode.width >= request.minWidth
+			&& mode.height >= request.minHeight
+			&& (!best || IsBetterMatch(mode, *best, request)))
+		{
+			best = &mode;
+		}
+	}
+
+	if (!best)
+	{
+		return DisplayModeSelection{ requestedMode, DisplayModeMatch::None };
+	}
+
+	if (IsSameSizeAndDepth(*best, list.currentMode))
+	{
+		// The closest mode is the desktop mode, using its refresh rate avoids a mode change.
+		return DisplayModeSelection{ list.currentMode, DisplayModeMatch::Desktop };
+	}
+
+	const DisplayModeMatch match = best->width == request.width && best->height == request.height
+		? DisplayModeMatch::Exact
+		: DisplayModeMatch::Closest;
+
+	return DisplayModeSelection{ *best, match };
+}
+
+DisplayModeCache& DisplayModeCache::GetInstance()
+{
+	static DisplayModeCache instance;
+
+	return instance;
+}
+
+DisplayModeCache::DisplayModeCache()
+	: mutex(),
+	  primaryModeList(),
+	  hasPrimaryModeList(false),
+	  enumerated(false)
+{
+}
+
+const Platform::DisplayModeList* DisplayModeCache::GetPrimaryDisplayModes()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (!enumerated)
+	{
+		StartupTimelinePhase phase("EnumerateDisplayModes");
+
+		enumerated = true;
+
+		Platform::DisplayModeList& list = primaryModeList;
+
+		if (Platform::EnumeratePrimaryDisplayModes(list))
+		{
+			// Drivers often report the same mode several times, e.g. once for each scaling option.
+			std::sort(
+				list.modes.begin(),
+				list.modes.end(),
+				[](const Platform::DisplayMode& lhs, const Platform::DisplayMode& rhs)
+				{
+					return std::tie(lhs.width, lhs.height, lhs.bitsPerPixel, lhs.refreshRate)
+						< std::tie(rhs.width, rhs.height, rhs.bitsPerPixel, rhs.refreshRate);
+				});
+			list.modes.erase(
+				std::unique(
+					list.modes.begin(),
+					list.modes.end(),
+					[](const Platform::DisplayMode& lhs, const Platform::DisplayMode& rhs)
+					{
+						return IsSameSizeAndDepth(lhs, rhs) && lhs.refreshRate == rhs.refreshRate;
+					}),
+				list.modes.end());
+
+			hasPrimaryModeList = true;
+
+			LOG_DEBUG(
+				LogCategory::Settings,
+				"Found {} display modes for the {} monitor on {}.",
+				list.modes.size(),
+				list.monitorName,
+				list.adapterName);
+		}
+	}
+
+	return hasPrimaryModeList ? &primaryModeList : nullptr;
+}
@@ -0,0 +1,80 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include "Platform.h"
+#include <mutex>
+
+enum class DisplayModeMatch : int32_t
+{
+	// The monitor has no mode with the requested color depth and a usable size.
+	None = 0,
+	// The requested mode is the desktop mode, the game does not need to change the display mode.
+	Desktop,
+	// The monitor supports the requested size and color depth.
+	Exact,
+	// The requested size is not supported, the closest supported size is used.
+	Closest
+};
+
+struct DisplayModeRequest
+{
+	uint32_t width;
+	uint32_t height;
+	uint32_t bitsPerPixel;
+	// The smallest size that the game supports.
+	uint32_t minWidth;
+	uint32_t minHeight;
+};
+
+struct DisplayModeSelection
+{
+	Platform::DisplayMode mode;
+	DisplayModeMatch match;
+};
+
+// Selects the full screen display mode for the request from a monitor's mode list.
+//
+// The desktop mode is preferred when it matches the request, because it avoids a slow mode change.
+// Otherwise the mode with the requested color depth that has the smallest size difference is
+// selected, using the highest refresh rate that the monitor supports at that size.
+DisplayModeSelection SelectDisplayMode(const Platform::DisplayModeList& list, const DisplayModeRequest& request);
+
+// Enumerates the primary monitor's display modes once and caches them,
+// enumerating the modes can take tens of milliseconds with some drivers.
+class DisplayModeCache
+{
+public:
+
+	static DisplayModeCache& GetInstance();
+
+	// Returns the primary monitor's display modes, or nullptr if they cannot be enumerated.
+	const Platform::DisplayModeList* GetPrimaryDisplayModes();
+
+private:
+
+	DisplayModeCache();
+
+	std::mutex mutex;
+	Platform::DisplayModeList primaryModeList;
+	bool hasPrimaryModeList;
+	bool enumerated;
+};
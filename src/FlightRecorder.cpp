@@ -0,0 +1,278 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "FlightRecorder.h"
+
+namespace
+{
+	// The argument data of an entry holds at most one argument per two bytes.
+	constexpr size_t kMaxArgumentCount = 48;
+	// The dump lines are formatted in a preallocated buffer, this is much larger than
+	// the messages that the plugin logs.
+	constexpr size_t kLineBufferCapacity = 16 * 1024;
+
+	std::filesystem::path GetReasonDumpFilePath(const std::filesystem::path& path, const char* reason)
+	{
+		std::filesystem::path reasonPath = path.parent_path();
+
+		std::filesystem::path fileName = path.stem();
+		fileName += ".";
+		fileName += reason;
+		fileName += path.extension();
+
+		reasonPath /= fileName;
+
+		return reasonPath;
+	}
+}
+
+FlightRecorder& FlightRecorder::GetInstance()
+{
+	static FlightRecorder instance;
+
+	return instance;
+}
+
+FlightRecorder::FlightRecorder()
+	: shutdownDumpFilePath(),
+	  errorDumpFilePath(),
+	  crashDumpFilePath(),
+	  dumpWorkspace(),
+	  crashWorkspace(),
+	  initialized(false),
+	  errorDumpRequested(false),
+	  errorDumpPending(false),
+	  errorDumpEndIndex(0),
+	  dumpThreadWakeupCount(0),
+	  dumpThreadStopRequested(false),
+	  dumpThread(),
+	  nextIndex(0),
+	  entries()
+{
+}
+
+FlightRecorder::~FlightRecorder()
+{
+	StopDumpThread();
+}
+
+FlightRecorder::DumpWorkspace::DumpWorkspace()
+	: inUse(false),
+	  entry(),
+	  arguments(),
+	  line(),
+	  timeStampFormatter(),
+	  file()
+{
+	arguments.reserve(kMaxArgumentCount);
+	line.reserve(kLineBufferCapacity);
+}
+
+void FlightRecorder::Init(const std::filesystem::path& path)
+{
+	if (initialized.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	shutdownDumpFilePath = path;
+	errorDumpFilePath = GetReasonDumpFilePath(path, "Error");
+	crashDumpFilePath = GetReasonDumpFilePath(path, "Crash");
+
+	if (!dumpWorkspace)
+	{
+		dumpWorkspace = std::make_unique<DumpWorkspace>();
+		crashWorkspace = std::make_unique<DumpWorkspace>();
+	}
+
+	errorDumpRequested.store(false, std::memory_order_relaxed);
+	errorDumpPending.store(false, std::memory_order_relaxed);
+	dumpThreadStopRequested.store(false, std::memory_order_relaxed);
+	dumpThread = std::thread(&FlightRecorder::DumpThreadProc, this);
+
+	initialized.store(true, std::memory_order_release);
+	Platform::SetCrashCallback(DumpOnCrash);
+}
+
+void FlightRecorder::Shutdown()
+{
+	if (!initialized.exchange(false, std::memory_order_acq_rel))
+	{
+		return;
+	}
+
+	StopDumpThread();
+
+	WriteDump(shutdownDumpFilePath, "shutdown", nextIndex.load(std::memory_order_acquire), *dumpWorkspace);
+}
+
+void FlightRecorder::RequestErrorDump()
+{
+	if (!initialized.load(std::memory_order_acquire)
+		|| errorDumpRequested.exchange(true, std::memory_order_acq_rel))
+	{
+		return;
+	}
+
+	errorDumpEndIndex.store(nextIndex.load(std::memory_order_acquire), std::memory_order_relaxed);
+	errorDumpPending.store(true, std::memory_order_release);
+
+	dumpThreadWakeupCount.fetch_add(1, std::memory_order_release);
+	dumpThreadWakeupCount.notify_one();
+}
+
+void FlightRecorder::DumpOnCrash()
+{
+	FlightRecorder& instance = GetInstance();
+
+	if (!instance.initialized.load(std::memory_order_acquire)
+		|| instance.crashWorkspace->inUse.exchange(true, std::memory_order_acquire))
+	{
+		return;
+	}
+
+	instance.WriteDump(
+		instance.crashDumpFilePath,
+		"unhandled exception",
+		instance.nextIndex.load(std::memory_order_acquire),
+		*instance.crashWorkspace);
+
+	instance.crashWorkspace->inUse.store(false, std::memory_order_release);
+}
+
+void FlightRecorder::DumpThreadProc()
+{
+	while (true)
+	{
+		const uint32_t observedWakeupCount = dumpThreadWakeupCount.load(std::memory_order_acquire);
+
+		if (errorDumpPending.exchange(false, std::memory_order_acquire))
+		{
+			WriteDump(
+				errorDumpFilePath,
+				"error",
+				errorDumpEndIndex.load(std::memory_order_relaxed),
+				*dumpWorkspace);
+		}
+
+		if (dumpThreadStopRequested.load(std::memory_order_acquire))
+		{
+			break;
+		}
+
+		dumpThreadWakeupCount.wait(observedWakeupCount, std::memory_order_acquire);
+	}
+}
+
+void FlightRecorder::StopDumpThread()
+{
+	if (dumpThread.joinable())
+	{
+		dumpThreadStopRequested.store(true, std::memory_order_release);
+		dumpThreadWakeupCount.fetch_add(1, std::memory_order_release);
+		dumpThreadWakeupCount.notify_one();
+
+		dumpThread.join();
+
+		// An error that was logged while the thread was stopping.
+		if (errorDumpPending.exchange(false, std::memory_order_acquire))
+		{
+			WriteDump(
+				errorDumpFilePath,
+				"error",
+				errorDumpEndIndex.load(std::memory_order_relaxed),
+				*dumpWorkspace);
+		}
+	}
+}
+
+void FlightRecorder::WriteDump(
+	const std::filesystem::path& path,
+	const char* reason,
+	uint32_t endIndex,
+	DumpWorkspace& workspace)
+{
+	Platform::OutputFile& file = workspace.file;
+
+	if (!file.Create(path))
+	{
+		return;
+	}
+
+	std::string& line = workspace.line;
+
+	line.assign("Flight recorder dump, reason: ");
+	line.append(reason);
+	line.push_back('\n');
+	file.Write(line.data(), line.size());
+
+	const uint32_t startIndex = endIndex > kCapacity ? endIndex - static_cast<uint32_t>(kCapacity) : 0;
+
+	Entry& entryCopy = workspace.entry;
+
+	for (uint32_t index = startIndex; index < endIndex; index++)
+	{
+		const Entry& entry = entries[index & kIndexMask];
+
+		const uint32_t expectedSequence = (index * 2) + 2;
+
+		if (entry.sequence.load(std::memory_order_acquire) != expectedSequence)
+		{
+			// The entry is being written or it has been overwritten by a newer event.
+			continue;
+		}
+
+		entryCopy.category = entry.category;
+		entryCopy.level = entry.level;
+		entryCopy.format = entry.format;
+		entryCopy.formatLength = entry.formatLength;
+		entryCopy.timeStamp = entry.timeStamp;
+		entryCopy.arguments = entry.arguments;
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		if (entry.sequence.load(std::memory_order_relaxed) != expectedSequence)
+		{
+			continue;
+		}
+
+		BinaryLogFormat::DecodeArguments(
+			entryCopy.arguments.GetData(),
+			entryCopy.arguments.GetLength(),
+			workspace.arguments);
+
+		line.assign(workspace.timeStampFormatter.Format(entryCopy.timeStamp));
+		line.push_back('[');
+		line.append(BinaryLogFormat::GetLogLevelName(static_cast<uint8_t>(entryCopy.level)));
+		line.append("] [");
+		line.append(GetLogCategoryName(entryCopy.category));
+		line.append("] ");
+		BinaryLogFormat::AppendEventMessage(
+			line,
+			std::string_view(entryCopy.format, entryCopy.formatLength),
+			workspace.arguments);
+		line.push_back('\n');
+
+		file.Write(line.data(), line.size());
+	}
+
+	file.Close();
+}
@@ -0,0 +1,144 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include "BinaryLogWriter.h"
+#include "LogCategory.h"
+#include "LogLevel.h"
+#include "LogTimeStamp.h"
+#include "Platform.h"
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// An always-on in-memory ring buffer of the most recent Debug and Trace log events.
+//
+// Recording an event only copies the time stamp, the format string pointer and the
+// raw argument bytes into the ring, the formatting is deferred until the ring is dumped.
+//
+// Each dump reason has its own file, e.g. SC4GraphicsOptions.FlightRecorder.Error.log:
+// - The first Error level event of the session is dumped on a background thread, later
+//   errors do not overwrite it.
+// - An unhandled exception is dumped synchronously by the crash handler, the dump uses
+//   buffers that are allocated by Init.
+// - The shutdown dump is written by Shutdown.
+class FlightRecorder
+{
+public:
+
+	static FlightRecorder& GetInstance();
+
+	// Sets the dump file path, starts the error dump thread and installs the crash handler.
+	// The error and crash dumps are written next to the shutdown dump, with the reason
+	// added to the file name.
+	void Init(const std::filesystem::path& shutdownDumpFilePath);
+
+	// Writes the shutdown dump and stops the error dump thread, a pending error dump
+	// is written first.
+	void Shutdown();
+
+	// Records an event, this can be called from any thread.
+	// The format string must be a string literal, the recorder only stores its address.
+	template <typename... Args>
+	void Record(LogCategory category, LogLevel level, std::string_view format, const Args&... args)
+	{
+		const uint32_t index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+		Entry& entry = entries[index & kIndexMask];
+
+		// The sequence number is odd while the entry is being written, this allows
+		// a dump to skip entries that are modified while it is reading them.
+		entry.sequence.store((index * 2) + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		entry.timeStamp = LogTimeStamp::Now();
+		entry.category = category;
+		entry.level = level;
+		entry.format = format.data();
+		entry.formatLength = static_cast<uint32_t>(format.size());
+		entry.arguments.Clear();
+		(entry.arguments.Add(args), ...);
+
+		entry.sequence.store((index * 2) + 2, std::memory_order_release);
+	}
+
+	// Dumps the events that were recorded before this call on the error dump thread.
+	// Only the first error of the session is dumped.
+	void RequestErrorDump();
+
+private:
+
+	FlightRecorder();
+	~FlightRecorder();
+
+	static constexpr size_t kCapacity = 1024;
+	static constexpr size_t kIndexMask = kCapacity - 1;
+	static constexpr size_t kMaxArgumentDataLength = 96;
+
+	struct Entry
+	{
+		std::atomic<uint32_t> sequence;
+		LogCategory category;
+		LogLevel level;
+		uint32_t formatLength;
+		const char* format;
+		LogTimeStamp timeStamp;
+		BinaryLogArgumentBuffer<kMaxArgumentDataLength> arguments;
+	};
+
+	// The buffers that a dump uses, they are allocated when the recorder is
+	// initialized so that the crash handler does not allocate memory.
+	struct DumpWorkspace
+	{
+		DumpWorkspace();
+
+		std::atomic<bool> inUse;
+		Entry entry;
+		std::vector<BinaryLogFormat::Argument> arguments;
+		std::string line;
+		LogTimeStampFormatter timeStampFormatter;
+		Platform::OutputFile file;
+	};
+
+	static void DumpOnCrash();
+
+	void DumpThreadProc();
+	void StopDumpThread();
+	void WriteDump(const std::filesystem::path& path, const char* reason, uint32_t endIndex, DumpWorkspace& workspace);
+
+	std::filesystem::path shutdownDumpFilePath;
+	std::filesystem::path errorDumpFilePath;
+	std::filesystem::path crashDumpFilePath;
+	std::unique_ptr<DumpWorkspace> dumpWorkspace;
+	std::unique_ptr<DumpWorkspace> crashWorkspace;
+	std::atomic<bool> initialized;
+	std::atomic<bool> errorDumpRequested;
+	std::atomic<bool> errorDumpPending;
+	std::atomic<uint32_t> errorDumpEndIndex;
+	std::atomic<uint32_t> dumpThreadWakeupCount;
+	std::atomic<bool> dumpThreadStopRequested;
+	std::thread dumpThread;
+	std::atomic<uint32_t> nextIndex;
+	Entry entries[kCapacity];
+};
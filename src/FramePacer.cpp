@@ -0,0 +1,154 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "FramePacer.h"
+#include "Platform.h"
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+	constexpr int64_t kMinSpinMicroseconds = 200;
+	constexpr int64_t kInitialSpinMicroseconds = 500;
+	constexpr int64_t kMaxSpinMicroseconds = 2000;
+
+	// The weight of a new measurement in the moving averages is 1 / kAverageWeight.
+	constexpr int64_t kAverageWeight = 8;
+
+	int64_t MicrosecondsToTicks(int64_t microseconds, int64_t frequency)
+	{
+		return (microseconds * frequency) / 1000000;
+	}
+
+	void UpdateAverage(int64_t& average, int64_t value)
+	{
+		average += (value - average) / kAverageWeight;
+	}
+}
+
+int64_t SystemFramePacerClock::GetCounter()
+{
+	return Platform::GetPerformanceCounter();
+}
+
+int64_t SystemFramePacerClock::GetFrequency()
+{
+	return Platform::GetPerformanceFrequency();
+}
+
+void SystemFramePacerClock::Sleep(int64_t ticks)
+{
+	Platform::SleepFor(ticks);
+}
+
+void SystemFramePacerClock::Pause()
+{
+	std::this_thread::yield();
+}
+
+FramePacer::FramePacer(FramePacerClock& clock, uint32_t maxFrameRate)
+	: clock(clock),
+	  frameInterval(clock.GetFrequency() / std::max<uint32_t>(maxFrameRate, 1)),
+	  minSpinThreshold(MicrosecondsToTicks(kMinSpinMicroseconds, clock.GetFrequency())),
+	  maxSpinThreshold(MicrosecondsToTicks(kMaxSpinMicroseconds, clock.GetFrequency())),
+	  spinThreshold(MicrosecondsToTicks(kInitialSpinMicroseconds, clock.GetFrequency())),
+	  averageOversleep(0),
+	  averageFrameCost(0),
+	  nextDeadline(0),
+	  lastPresentCounter(0)
+{
+}
+
+void FramePacer::WaitForNextFrame()
+{
+	const int64_t now = clock.GetCounter();
+
+	if (lastPresentCounter == 0)
+	{
+		// The first frame starts the schedule.
+		nextDeadline = now;
+	}
+	else
+	{
+		const int64_t frameCost = now - lastPresentCounter;
+
+		if (averageFrameCost == 0)
+		{
+			averageFrameCost = frameCost;
+		}
+		else
+		{
+			UpdateAverage(averageFrameCost, frameCost);
+		}
+
+		// A game that cannot reach the frame rate limit is paced at its average frame cost.
+		nextDeadline += std::max(frameInterval, averageFrameCost);
+
+		if (now >= nextDeadline)
+		{
+			// The frame took longer than the interval, start a new schedule from this frame.
+			nextDeadline = now;
+		}
+		else
+		{
+			WaitUntil(nextDeadline, now);
+		}
+	}
+
+	lastPresentCounter = clock.GetCounter();
+}
+
+void FramePacer::SetMaxFrameRate(uint32_t maxFrameRate)
+{
+	frameInterval = clock.GetFrequency() / std::max<uint32_t>(maxFrameRate, 1);
+}
+
+int64_t FramePacer::GetSpinThreshold() const
+{
+	return spinThreshold;
+}
+
+int64_t FramePacer::GetAverageFrameCost() const
+{
+	return averageFrameCost;
+}
+
+void FramePacer::WaitUntil(int64_t deadline, int64_t now)
+{
+	const int64_t sleepTicks = deadline - spinThreshold - now;
+
+	if (sleepTicks > 0)
+	{
+		clock.Sleep(sleepTicks);
+
+		const int64_t oversleep = std::max<int64_t>(clock.GetCounter() - (now + sleepTicks), 0);
+
+		UpdateAverage(averageOversleep, oversleep);
+
+		// Spin for twice the typical oversleep, so that a late wake up rarely misses the deadline.
+		spinThreshold = std::clamp((2 * averageOversleep) + minSpinThreshold, minSpinThreshold, maxSpinThreshold);
+	}
+
+	while (clock.GetCounter() < deadline)
+	{
+		clock.Pause();
+	}
+}
@@ -0,0 +1,101 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include <cstdint>
+
+// The time source that the frame pacer uses, this allows the pacing logic to
+// be tested with a simulated clock.
+class FramePacerClock
+{
+public:
+
+	virtual ~FramePacerClock() = default;
+
+	// Returns the current time in ticks.
+	virtual int64_t GetCounter() = 0;
+
+	// Returns the number of ticks per second.
+	virtual int64_t GetFrequency() = 0;
+
+	// Sleeps for at least the specified number of ticks, the OS may wake the thread later.
+	virtual void Sleep(int64_t ticks) = 0;
+
+	// Called in each iteration of the spin wait.
+	virtual void Pause() = 0;
+};
+
+// A clock that uses the performance counter and a high-resolution timer.
+class SystemFramePacerClock : public FramePacerClock
+{
+public:
+
+	int64_t GetCounter() override;
+
+	int64_t GetFrequency() override;
+
+	void Sleep(int64_t ticks) override;
+
+	void Pause() override;
+};
+
+// Limits the game's frame rate by delaying each present until the next frame's deadline.
+//
+// The wait sleeps until shortly before the deadline and spins for the rest, the spin
+// time adapts to how much the timer oversleeps. The deadlines are a fixed interval apart
+// so the frames are evenly spaced. When the game's average frame cost is longer than the
+// interval the deadlines are spaced by the frame cost instead, so that the faster frames
+// do not present early and bunch up with the slower ones. A frame that misses its deadline
+// restarts the schedule instead of letting the following frames catch up, which would
+// bunch them together.
+class FramePacer
+{
+public:
+
+	FramePacer(FramePacerClock& clock, uint32_t maxFrameRate);
+
+	// Waits until the next frame should be presented, this is called before the game presents a frame.
+	void WaitForNextFrame();
+
+	// Changes the frame rate limit, the next deadline is the new interval after the previous one.
+	// The oversleep and frame cost measurements are kept.
+	void SetMaxFrameRate(uint32_t maxFrameRate);
+
+	// The time that the pacer spins before a deadline, in clock ticks.
+	int64_t GetSpinThreshold() const;
+
+	// The average time the game takes to render a frame, excluding the pacer's wait, in clock ticks.
+	int64_t GetAverageFrameCost() const;
+
+private:
+
+	void WaitUntil(int64_t deadline, int64_t now);
+
+	FramePacerClock& clock;
+	int64_t frameInterval;
+	const int64_t minSpinThreshold;
+	const int64_t maxSpinThreshold;
+	int64_t spinThreshold;
+	int64_t averageOversleep;
+	int64_t averageFrameCost;
+	int64_t nextDeadline;
+	int64_t lastPresentCounter;
+};
@@ -0,0 +1,218 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "FrameTimeHistogram.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <format>
+
+namespace
+{
+	double MicrosecondsToMilliseconds(uint64_t value)
+	{
+		return static_cast<double>(value) / 1000.0;
+	}
+}
+
+FrameTimeHistogram::Snapshot::Snapshot()
+	: counts(),
+	  totalCount(0),
+	  maxValue(0)
+{
+}
+
+uint64_t FrameTimeHistogram::Snapshot::GetTotalCount() const
+{
+	return totalCount;
+}
+
+uint64_t FrameTimeHistogram::Snapshot::GetMaxValue() const
+{
+	return maxValue;
+}
+
+double FrameTimeHistogram::Snapshot::GetMeanValue() const
+{
+	if (totalCount == 0)
+	{
+		return 0.0;
+	}
+
+	double total = 0.0;
+
+	for (size_t i = 0; i < kBucketCount; i++)
+	{
+		if (counts[i] != 0)
+		{
+			// Use the middle of the bucket, the lower bound is one past the previous bucket's upper bound.
+			const uint64_t lowerBound = i > 0 ? GetBucketUpperBound(i - 1) + 1 : 0;
+			const uint64_t upperBound = GetBucketUpperBound(i);
+
+			total += static_cast<double>(counts[i]) * (static_cast<double>(lowerBound + upperBound) / 2.0);
+		}
+	}
+
+	return total / static_cast<double>(totalCount);
+}
+
+uint64_t FrameTimeHistogram::Snapshot::GetValueAtPercentile(double percentile) const
+{
+	if (totalCount == 0)
+	{
+		return 0;
+	}
+
+	const double clampedPercentile = std::clamp(percentile, 0.0, 100.0);
+	const uint64_t targetCount = std::max<uint64_t>(
+		1,
+		static_cast<uint64_t>(std::ceil((clampedPercentile / 100.0) * static_cast<double>(totalCount))));
+
+	uint64_t runningCount = 0;
+
+	for (size_t i = 0; i < kBucketCount; i++)
+	{
+		runningCount += counts[i];
+
+		if (runningCount >= targetCount)
+		{
+			// The bucket's upper bound can be larger than any recorded value.
+			return std::min(GetBucketUpperBound(i), maxValue);
+		}
+	}
+
+	return maxValue;
+}
+
+void FrameTimeHistogram::Snapshot::Add(uint64_t value, uint64_t count)
+{
+	const uint64_t clampedValue = std::min(value, kMaxTrackableValue);
+
+	counts[GetBucketIndex(clampedValue)] += count;
+	totalCount += count;
+	maxValue = std::max(maxValue, clampedValue);
+}
+
+void FrameTimeHistogram::Snapshot::Merge(const Snapshot& other)
+{
+	for (size_t i = 0; i < kBucketCount; i++)
+	{
+		counts[i] += other.counts[i];
+	}
+
+	totalCount += other.totalCount;
+	maxValue = std::max(maxValue, other.maxValue);
+}
+
+FrameTimeHistogram::FrameTimeHistogram()
+	: counts(),
+	  maxValue(0)
+{
+}
+
+void FrameTimeHistogram::Record(uint64_t microseconds)
+{
+	const uint64_t value = std::min(microseconds, kMaxTrackableValue);
+
+	counts[GetBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+
+	uint64_t currentMax = maxValue.load(std::memory_order_relaxed);
+
+	while (value > currentMax && !maxValue.compare_exchange_weak(currentMax, value, std::memory_order_relaxed))
+	{
+	}
+}
+
+void FrameTimeHistogram::TakeSnapshot(Snapshot& snapshot)
+{
+	snapshot.counts.fill(0);
+	snapshot.totalCount = 0;
+	snapshot.maxValue = maxValue.exchange(0, std::memory_order_relaxed);
+
+	for (size_t i = 0; i < kBucketCount; i++)
+	{
+		const uint32_t count = counts[i].exchange(0, std::memory_order_relaxed);
+
+		snapshot.counts[i] = count;
+		snapshot.totalCount += count;
+	}
+
+	if (snapshot.totalCount > 0)
+	{
+		// A value can be counted before its maximum is published, so the
+		// maximum is also bounded by the highest non-empty bucket.
+		for (size_t i = kBucketCount; i > 0; i--)
+		{
+			if (snapshot.counts[i - 1] != 0)
+			{
+				const uint64_t lowerBound = i > 1 ? GetBucketUpperBound(i - 2) + 1 : 0;
+
+				snapshot.maxValue = std::max(snapshot.maxValue, lowerBound);
+				break;
+			}
+		}
+	}
+}
+
+size_t FrameTimeHistogram::GetBucketIndex(uint64_t value)
+{
+	if (value < (2 * kSubBucketCount))
+	{
+		return static_cast<size_t>(value);
+	}
+
+	// Shift the value so that it is in the [kSubBucketCount, 2 * kSubBucketCount) range.
+	const uint32_t shift = static_cast<uint32_t>(std::bit_width(value)) - (kSubBucketBits + 1);
+	const uint64_t subBucket = (value >> shift) - kSubBucketCount;
+
+	return static_cast<size_t>((2 * kSubBucketCount) + ((shift - 1) * kSubBucketCount) + subBucket);
+}
+
+uint64_t FrameTimeHistogram::GetBucketUpperBound(size_t index)
+{
+	if (index < (2 * kSubBucketCount))
+	{
+		return static_cast<uint64_t>(index);
+	}
+
+	const size_t offset = index - (2 * kSubBucketCount);
+	const uint32_t shift = static_cast<uint32_t>(offset / kSubBucketCount) + 1;
+	const uint64_t subBucket = (offset % kSubBucketCount) + kSubBucketCount;
+
+	return ((subBucket + 1) << shift) - 1;
+}
+
+std::string FormatFrameTimeReport(const FrameTimeHistogram::Snapshot& snapshot, double intervalSeconds)
+{
+	const uint64_t frameCount = snapshot.GetTotalCount();
+	const double framesPerSecond = intervalSeconds > 0.0 ? static_cast<double>(frameCount) / intervalSeconds : 0.0;
+
+	return std::format(
+		"Frame times over {:.1f}s: {} frames ({:.1f} FPS), mean {:.2f}ms, p50 {:.2f}ms, p95 {:.2f}ms, p99 {:.2f}ms, max {:.2f}ms.",
+		intervalSeconds,
+		frameCount,
+		framesPerSecond,
+		snapshot.GetMeanValue() / 1000.0,
+		MicrosecondsToMilliseconds(snapshot.GetValueAtPercentile(50.0)),
+		MicrosecondsToMilliseconds(snapshot.GetValueAtPercentile(95.0)),
+		MicrosecondsToMilliseconds(snapshot.GetValueAtPercentile(99.0)),
+		MicrosecondsToMilliseconds(snapshot.GetMaxValue()));
+}
@@ -0,0 +1,99 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// A log-linear (HDR) histogram of frame times in microseconds.
+//
+// Values below 128 microseconds are counted exactly, larger values are counted
+// in 64 sub-buckets per power of two, which keeps the error below 1.6%.
+// Values above 67 seconds are counted as 67 seconds.
+//
+// Recording a value is a single relaxed atomic increment, so the game thread
+// is never blocked by the reporting code.
+class FrameTimeHistogram
+{
+	static constexpr uint32_t kSubBucketBits = 6;
+	static constexpr uint32_t kSubBucketCount = 1 << kSubBucketBits;
+	static constexpr uint32_t kMaxValueBits = 26;
+
+public:
+
+	static constexpr uint64_t kMaxTrackableValue = (uint64_t(1) << kMaxValueBits) - 1;
+	static constexpr size_t kBucketCount = (2 * kSubBucketCount) + ((kMaxValueBits - kSubBucketBits - 1) * kSubBucketCount);
+
+	class Snapshot
+	{
+	public:
+
+		Snapshot();
+
+		uint64_t GetTotalCount() const;
+
+		// Returns the largest value that was recorded, in microseconds.
+		uint64_t GetMaxValue() const;
+
+		double GetMeanValue() const;
+
+		// Returns the value that the specified percentage (0-100) of the recorded
+		// values are less than or equal to, in microseconds.
+		// The result is the upper bound of the bucket that contains the value.
+		uint64_t GetValueAtPercentile(double percentile) const;
+
+		void Add(uint64_t value, uint64_t count);
+
+		void Merge(const Snapshot& other);
+
+	private:
+
+		friend class FrameTimeHistogram;
+
+		std::array<uint64_t, kBucketCount> counts;
+		uint64_t totalCount;
+		uint64_t maxValue;
+	};
+
+	FrameTimeHistogram();
+
+	void Record(uint64_t microseconds);
+
+	// Moves the recorded values into the snapshot and resets the histogram.
+	// Values that are recorded while this runs are either included in the
+	// snapshot or kept for the next one, they are never lost.
+	void TakeSnapshot(Snapshot& snapshot);
+
+	static size_t GetBucketIndex(uint64_t value);
+
+	static uint64_t GetBucketUpperBound(size_t index);
+
+private:
+
+	std::array<std::atomic<uint32_t>, kBucketCount> counts;
+	std::atomic<uint64_t> maxValue;
+};
+
+// Formats the percentiles of a snapshot as a single log line.
+std::string FormatFrameTimeReport(const FrameTimeHistogram::Snapshot& snapshot, double intervalSeconds);
@@ -0,0 +1,145 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "FrameTimeTelemetry.h"
+#include "Logger.h"
+#include "Platform.h"
+
+namespace
+{
+	double TicksToSeconds(int64_t ticks, int64_t frequency)
+	{
+		return static_cast<double>(ticks) / static_cast<double>(frequency);
+	}
+}
+
+FrameTimeTelemetry& FrameTimeTelemetry::GetInstance()
+{
+	static FrameTimeTelemetry instance;
+
+	return instance;
+}
+
+FrameTimeTelemetry::FrameTimeTelemetry()
+	: histogram(),
+	  intervalSnapshot(),
+	  sessionSnapshot(),
+	  performanceFrequency(Platform::GetPerformanceFrequency()),
+	  reportIntervalTicks(0),
+	  lastPresentCounter(0),
+	  intervalStartCounter(0),
+	  sessionStartCounter(0),
+	  running(false)
+{
+}
+
+void FrameTimeTelemetry::Start(uint32_t reportIntervalSeconds)
+{
+	if (!running)
+	{
+		running = true;
+		reportIntervalTicks = static_cast<int64_t>(reportIntervalSeconds) * performanceFrequency;
+		lastPresentCounter = 0;
+		intervalStartCounter = 0;
+		sessionStartCounter = 0;
+	}
+}
+
+void FrameTimeTelemetry::Stop()
+{
+	if (running)
+	{
+		running = false;
+
+		if (lastPresentCounter != 0)
+		{
+			// Add the frames since the last interval report to the session.
+			histogram.TakeSnapshot(intervalSnapshot);
+			sessionSnapshot.Merge(intervalSnapshot);
+
+			Logger::GetInstance().WriteLineFormatted(
+				LogCategory::Telemetry,
+				LogLevel::Info,
+				"Session {}",
+				FormatFrameTimeReport(
+					sessionSnapshot,
+					TicksToSeconds(lastPresentCounter - sessionStartCounter, performanceFrequency)));
+		}
+	}
+}
+
+bool FrameTimeTelemetry::IsRunning() const
+{
+	return running;
+}
+
+void FrameTimeTelemetry::SetReportInterval(uint32_t reportIntervalSeconds)
+{
+	reportIntervalTicks = static_cast<int64_t>(reportIntervalSeconds) * performanceFrequency;
+}
+
+void FrameTimeTelemetry::OnFramePresented()
+{
+	if (running)
+	{
+		RecordFrame(Platform::GetPerformanceCounter());
+	}
+}
+
+void FrameTimeTelemetry::RecordFrame(int64_t presentCounter)
+{
+	if (lastPresentCounter == 0)
+	{
+		// The first frame starts the measurement.
+		sessionStartCounter = presentCounter;
+		intervalStartCounter = presentCounter;
+	}
+	else
+	{
+		const int64_t elapsedTicks = presentCounter - lastPresentCounter;
+
+		if (elapsedTicks > 0)
+		{
+			histogram.Record(static_cast<uint64_t>((elapsedTicks * 1000000) / performanceFrequency));
+		}
+
+		if (reportIntervalTicks > 0 && (presentCounter - intervalStartCounter) >= reportIntervalTicks)
+		{
+			ReportInterval(presentCounter);
+		}
+	}
+
+	lastPresentCounter = presentCounter;
+}
+
+void FrameTimeTelemetry::ReportInterval(int64_t currentCounter)
+{
+	histogram.TakeSnapshot(intervalSnapshot);
+	sessionSnapshot.Merge(intervalSnapshot);
+
+	Logger::GetInstance().WriteLineFormatted(
+		LogCategory::Telemetry,
+		LogLevel::Info,
+		"{}",
+		FormatFrameTimeReport(intervalSnapshot, TicksToSeconds(currentCounter - intervalStartCounter, performanceFrequency)));
+
+	intervalStartCounter = currentCounter;
+}
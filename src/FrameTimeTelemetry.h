@@ -0,0 +1,65 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include "FrameTimeHistogram.h"
+#include <cstdint>
+
+// Collects the time between the frames that the game presents, and logs
+// the frame time percentiles at a fixed interval and when the game exits.
+class FrameTimeTelemetry
+{
+public:
+
+	static FrameTimeTelemetry& GetInstance();
+
+	void Start(uint32_t reportIntervalSeconds);
+
+	// Logs the report for the whole session.
+	void Stop();
+
+	bool IsRunning() const;
+
+	// Changes the report interval, this must be called on the thread that presents the frames.
+	void SetReportInterval(uint32_t reportIntervalSeconds);
+
+	// Called by the present hooks after the game has presented a frame.
+	void OnFramePresented();
+
+	// Records a frame that was presented at the specified performance counter value.
+	void RecordFrame(int64_t presentCounter);
+
+private:
+
+	FrameTimeTelemetry();
+
+	void ReportInterval(int64_t currentCounter);
+
+	FrameTimeHistogram histogram;
+	FrameTimeHistogram::Snapshot intervalSnapshot;
+	FrameTimeHistogram::Snapshot sessionSnapshot;
+	int64_t performanceFrequency;
+	int64_t reportIntervalTicks;
+	int64_t lastPresentCounter;
+	int64_t intervalStartCounter;
+	int64_t sessionStartCounter;
+	bool running;
+};
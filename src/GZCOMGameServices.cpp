@@ -0,0 +1,215 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "GZCOMGameServices.h"
+#include "cGZDisplayMetrics.h"
+#include "cIGZApp.h"
+#include "cIGZCmdLine.h"
+#include "cIGZFrameWork.h"
+#include "cIGZGDriver.h"
+#include "cIGZGraphicSystem.h"
+#include "cIGZGraphicSystem2.h"
+#include "cISC4RenderProperties.h"
+#include "cRZBaseString.h"
+#include "GZServPtrs.h"
+#include "SC4Preferences.h"
+
+GZCOMRenderProperties::GZCOMRenderProperties(cISC4RenderProperties* pRenderProperties)
+	: pRenderProperties(pRenderProperties)
+{
+}
+
+int32_t GZCOMRenderProperties::BoolPropertyIDFromName(const char* name)
+{
+	return pRenderProperties->BoolPropertyIDFromName(name);
+}
+
+int32_t GZCOMRenderProperties::IntPropertyIDFromName(const char* name)
+{
+	return pRenderProperties->IntPropertyIDFromName(name);
+}
+
+bool GZCOMRenderProperties::GetBoolValue(int32_t id)
+{
+	return pRenderProperties->GetBoolValue(id);
+}
+
+int32_t GZCOMRenderProperties::GetIntValue(int32_t id)
+{
+	return pRenderProperties->GetIntValue(id);
+}
+
+void GZCOMRenderProperties::SetBoolValue(int32_t id, bool value)
+{
+	pRenderProperties->SetBoolValue(id, value);
+}
+
+void GZCOMRenderProperties::SetIntValue(int32_t id, int32_t value)
+{
+	pRenderProperties->SetIntValue(id, value);
+}
+
+GZCOMGameServices::GZCOMGameServices(cIGZFrameWork* pFramework)
+	: pFramework(pFramework),
+	  pSC4App(),
+	  renderProperties()
+{
+	cIGZApp* const pApp = pFramework->Application();
+
+	if (pApp)
+	{
+		pApp->QueryInterface(GZIID_cISC4App, pSC4App.AsPPVoid());
+	}
+}
+
+bool GZCOMGameServices::GetVideoPreferences(SC4VideoOptions& options)
+{
+	if (!pSC4App)
+	{
+		return false;
+	}
+
+	const SC4VideoPreferences& videoPrefs = pSC4App->GetPreferences()->videoPreferences;
+
+	options.width = videoPrefs.width;
+	options.height = videoPrefs.height;
+	options.bitDepth = videoPrefs.bitDepth;
+	options.fullScreen = videoPrefs.bFullScreen != 0;
+	options.driverType = static_cast<uint8_t>(videoPrefs.driverType);
+
+	return true;
+}
+
+void GZCOMGameServices::SaveVideoPreferences(const SC4VideoOptions& options)
+{
+	if (pSC4App)
+	{
+		SC4VideoPreferences& videoPrefs = pSC4App->GetPreferences()->videoPreferences;
+
+		videoPrefs.width = options.width;
+		videoPrefs.height = options.height;
+		videoPrefs.bitDepth = options.bitDepth;
+		videoPrefs.bFullScreen = options.fullScreen;
+		videoPrefs.driverType = options.driverType;
+
+		pSC4App->SavePreferences();
+	}
+}
+
+void GZCOMGameServices::EnableFullGamePauseOnAppFocusLoss(bool enable)
+{
+	if (pSC4App)
+	{
+		pSC4App->EnableFullGamePauseOnAppFocusLoss(enable);
+	}
+}
+
+void GZCOMGameServices::SetDesiredGameResolution(uint32_t width, uint32_t height, uint32_t bitDepth, bool windowed)
+{
+	cIGZGraphicSystemPtr pGS;
+
+	if (pGS)
+	{
+		cGZDisplayMetrics metrics{};
+		metrics.width = width;
+		metrics.height = height;
+		metrics.bitDepth = bitDepth;
+
+		pGS->PreInitSetDesiredGameResolution(metrics);
+		pGS->PreInitSetWindowedMode(windowed);
+	}
+}
+
+void GZCOMGameServices::SetDefaultDriverClassID(uint32_t driverClassID)
+{
+	cIGZGraphicSystem2Ptr pGS2;
+
+	if (pGS2)
+	{
+		pGS2->SetDefaultDriverClassID(driverClassID);
+	}
+}
+
+bool GZCOMGameServices::GetGameMetrics(SC4GameMetrics& metrics)
+{
+	cIGZGraphicSystemPtr pGS;
+
+	if (!pGS)
+	{
+		return false;
+	}
+
+	cGZDisplayMetrics gameMetrics{};
+	pGS->GetGameMetrics(gameMetrics);
+
+	metrics.width = gameMetrics.width;
+	metrics.height = gameMetrics.height;
+	metrics.bitDepth = gameMetrics.bitDepth;
+	metrics.fullScreen = pGS->IsFullScreenMode();
+
+	return true;
+}
+
+bool GZCOMGameServices::GetDriverClassID(uint32_t& driverClassID)
+{
+	cIGZGraphicSystem2Ptr pGS2;
+
+	if (pGS2)
+	{
+		cIGZGDriver* pDriver = pGS2->GetGDriver();
+
+		if (pDriver)
+		{
+			driverClassID = pDriver->GetGZCLSID();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool GZCOMGameServices::IsCommandLineSwitchPresent(const char* name)
+{
+	return pFramework->CommandLine()->IsSwitchPresent(cRZBaseString(name));
+}
+
+void GZCOMGameServices::AppendCommandLineArgument(const char* argument)
+{
+	cIGZCmdLine* pCmdLine = pFramework->CommandLine();
+
+	pCmdLine->InsertArgument(cRZBaseString(argument), pCmdLine->argc());
+}
+
+ISC4RenderProperties* GZCOMGameServices::GetRenderProperties()
+{
+	// The game creates its render properties when the application is initialized.
+	if (!renderProperties && pSC4App)
+	{
+		cISC4RenderProperties* const pRenderProperties = pSC4App->GetRenderProperties();
+
+		if (pRenderProperties)
+		{
+			renderProperties = std::make_unique<GZCOMRenderProperties>(pRenderProperties);
+		}
+	}
+
+	return renderProperties.get();
+}
@@ -0,0 +1,87 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include "SC4GameServices.h"
+#include "cISC4App.h"
+#include "cRZAutoRefCount.h"
+#include <memory>
+
+class cIGZFrameWork;
+class cISC4RenderProperties;
+
+// Implements the render properties with the game's cISC4RenderProperties interface.
+class GZCOMRenderProperties final : public ISC4RenderProperties
+{
+public:
+
+	explicit GZCOMRenderProperties(cISC4RenderProperties* pRenderProperties);
+
+	int32_t BoolPropertyIDFromName(const char* name) override;
+
+	int32_t IntPropertyIDFromName(const char* name) override;
+
+	bool GetBoolValue(int32_t id) override;
+
+	int32_t GetIntValue(int32_t id) override;
+
+	void SetBoolValue(int32_t id, bool value) override;
+
+	void SetIntValue(int32_t id, int32_t value) override;
+
+private:
+
+	cISC4RenderProperties* pRenderProperties;
+};
+
+// Implements the game services with the game's GZCOM interfaces.
+class GZCOMGameServices final : public ISC4GameServices
+{
+public:
+
+	explicit GZCOMGameServices(cIGZFrameWork* pFramework);
+
+	bool GetVideoPreferences(SC4VideoOptions& options) override;
+
+	void SaveVideoPreferences(const SC4VideoOptions& options) override;
+
+	void EnableFullGamePauseOnAppFocusLoss(bool enable) override;
+
+	void SetDesiredGameResolution(uint32_t width, uint32_t height, uint32_t bitDepth, bool windowed) override;
+
+	void SetDefaultDriverClassID(uint32_t driverClassID) override;
+
+	bool GetGameMetrics(SC4GameMetrics& metrics) override;
+
+	bool GetDriverClassID(uint32_t& driverClassID) override;
+
+	bool IsCommandLineSwitchPresent(const char* name) override;
+
+	void AppendCommandLineArgument(const char* argument) override;
+
+	ISC4RenderProperties* GetRenderProperties() override;
+
+private:
+
+	cIGZFrameWork* pFramework;
+	cRZAutoRefCount<cISC4App> pSC4App;
+	std::unique_ptr<GZCOMRenderProperties> renderProperties;
+};
@@ -0,0 +1,227 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "GameExecutableFingerprint.h"
+#include "Crc32c.h"
+#include "IniParser.h"
+#include "PEImage.h"
+#include "StartupTimeline.h"
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+	// The PE headers and the section table are at the start of the file,
+	// they are usually 1 KiB or less.
+	constexpr size_t kMaxHeaderSize = 4096;
+	constexpr size_t kReadBufferSize = 64 * 1024;
+
+	constexpr uint32_t kCacheFileVersion = 2;
+
+	bool ParseUInt64(std::string_view text, uint64_t& value)
+	{
+		const char* const first = text.data();
+		const char* const last = first + text.size();
+		const std::from_chars_result result = std::from_chars(first, last, value);
+
+		return result.ec == std::errc() && result.ptr == last && first != last;
+	}
+
+	bool ParseInt64(std::string_view text, int64_t& value)
+	{
+		const char* const first = text.data();
+		const char* const last = first + text.size();
+		const std::from_chars_result result = std::from_chars(first, last, value);
+
+		return result.ec == std::errc() && result.ptr == last && first != last;
+	}
+}
+
+bool ComputeGameExecutableFingerprint(const std::filesystem::path& executablePath, GameExecutableFingerprint& fingerprint)
+{
+	StartupTimelinePhase phase("ComputeGameExecutableFingerprint");
+
+	std::ifstream stream(executablePath, std::ifstream::in | std::ifstream::binary);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> buffer(kReadBufferSize);
+
+	stream.read(reinterpret_cast<char*>(buffer.data()), kMaxHeaderSize);
+
+	PEImage headers;
+
+	if (!headers.Load(buffer.data(), static_cast<size_t>(stream.gcount())))
+	{
+		return false;
+	}
+
+	const PESection* section = headers.FindSection(".text");
+
+	if (!section || section->sizeOfRawData == 0)
+	{
+		return false;
+	}
+
+	stream.clear();
+
+	if (!stream.seekg(section->pointerToRawData))
+	{
+		return false;
+	}
+
+	uint32_t crc = 0;
+	size_t remaining = section->sizeOfRawData;
+
+	while (remaining > 0)
+	{
+		const size_t readSize = std::min(remaining, buffer.size());
+
+		if (!stream.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(readSize)))
+		{
+			return false;
+		}
+
+		crc = Crc32c::Compute(buffer.data(), readSize, crc);
+		remaining -= readSize;
+	}
+
+	fingerprint.codeSize = section->sizeOfRawData;
+	fingerprint.codeCrc32c = crc;
+
+	return true;
+}
+
+bool LoadGameExecutableFingerprintCache(
+	const std::filesystem::path& path,
+	const GameExecutableFileInfo& fileInfo,
+	GameExecutableFingerprint& fingerprint)
+{
+	std::ifstream stream(path, std::ifstream::in | std::ifstream::binary);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	std::stringstream buffer;
+	buffer << stream.rdbuf();
+	const std::string text = buffer.str();
+
+	uint64_t version = 0;
+	uint64_t fileSize = 0;
+	int64_t lastWriteTime = 0;
+	uint64_t codeSize = 0;
+	uint64_t codeCrc32c = 0;
+	uint32_t valueCount = 0;
+
+	try
+	{
+		IniParser parser(text);
+		IniEntry entry{};
+
+		while (parser.Next(entry))
+		{
+			bool parsed = true;
+
+			if (IniEqualsIgnoreCase(entry.key, "Version"))
+			{
+				parsed = ParseUInt64(entry.value, version);
+			}
+			else if (IniEqualsIgnoreCase(entry.key, "FileSize"))
+			{
+				parsed = ParseUInt64(entry.value, fileSize);
+			}
+			else if (IniEqualsIgnoreCase(entry.key, "LastWriteTime"))
+			{
+				parsed = ParseInt64(entry.value, lastWriteTime);
+			}
+			else if (IniEqualsIgnoreCase(entry.key, "CodeSize"))
+			{
+				parsed = ParseUInt64(entry.value, codeSize);
+			}
+			else if (IniEqualsIgnoreCase(entry.key, "CodeCrc32c"))
+			{
+				parsed = ParseUInt64(entry.value, codeCrc32c);
+			}
+			else
+			{
+				continue;
+			}
+
+			if (!parsed)
+			{
+				return false;
+			}
+
+			valueCount++;
+		}
+	}
+	catch (const IniParseError&)
+	{
+		return false;
+	}
+
+	if (valueCount != 5
+		|| version != kCacheFileVersion
+		|| fileSize != fileInfo.size
+		|| lastWriteTime != fileInfo.lastWriteTime
+		|| codeSize > UINT32_MAX
+		|| codeCrc32c > UINT32_MAX)
+	{
+		return false;
+	}
+
+	fingerprint.codeSize = static_cast<uint32_t>(codeSize);
+	fingerprint.codeCrc32c = static_cast<uint32_t>(codeCrc32c);
+
+	return true;
+}
+
+bool SaveGameExecutableFingerprintCache(
+	const std::filesystem::path& path,
+	const GameExecutableFileInfo& fileInfo,
+	const GameExecutableFingerprint& fingerprint)
+{
+	std::ofstream stream(path, std::ofstream::out | std::ofstream::trunc);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	stream << "; The fingerprint of the game executable that SC4GraphicsOptions computed.\n"
+		<< "; It is computed again when the executable changes.\n"
+		<< "[GameExecutable]\n"
+		<< "Version=" << kCacheFileVersion << '\n'
+		<< "FileSize=" << fileInfo.size << '\n'
+		<< "LastWriteTime=" << fileInfo.lastWriteTime << '\n'
+		<< "CodeSize=" << fingerprint.codeSize << '\n'
+		<< "CodeCrc32c=" << fingerprint.codeCrc32c << '\n';
+
+	return static_cast<bool>(stream.flush());
+}
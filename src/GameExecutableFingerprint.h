@@ -0,0 +1,57 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include <cstdint>
+#include <filesystem>
+
+// Identifies a game executable by the CRC-32C of its code section in the executable file.
+struct GameExecutableFingerprint
+{
+	uint32_t codeSize;
+	uint32_t codeCrc32c;
+
+	bool operator==(const GameExecutableFingerprint& other) const = default;
+};
+
+// Hashes the .text section's data in the executable file.
+// The file is read instead of the mapped image because other plugins may have
+// already patched the game's code in memory.
+// Returns false if the file cannot be read or does not have a .text section.
+bool ComputeGameExecutableFingerprint(const std::filesystem::path& executablePath, GameExecutableFingerprint& fingerprint);
+
+// The size and last write time of the executable file, a cached fingerprint
+// is only used if the file has not changed since it was computed.
+struct GameExecutableFileInfo
+{
+	uint64_t size;
+	int64_t lastWriteTime;
+};
+
+bool LoadGameExecutableFingerprintCache(
+	const std::filesystem::path& path,
+	const GameExecutableFileInfo& fileInfo,
+	GameExecutableFingerprint& fingerprint);
+
+bool SaveGameExecutableFingerprintCache(
+	const std::filesystem::path& path,
+	const GameExecutableFileInfo& fileInfo,
+	const GameExecutableFingerprint& fingerprint);
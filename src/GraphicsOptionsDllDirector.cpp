@@ -19,42 +19,48 @@
  *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
-#include "version.h"
+#include "FramePacer.h"
+#include "FrameTimeTelemetry.h"
+#include "GraphicsOptionsStartup.h"
+#include "GZCOMGameServices.h"
+#include "HookRegistry.h"
 #include "Logger.h"
+#include "MemoryPatchTransaction.h"
+#include "PatchSiteResolver.h"
+#include "Platform.h"
+#include "ProcessSchedulingPolicy.h"
+#include "RenderOptionsController.h"
 #include "SC4GDriverCLSIDDefs.h"
+#include "SC4PresentHooks.h"
 #include "SC4VersionDetection.h"
 #include "SC4WindowCreationHooks.h"
 #include "Settings.h"
-#include "cGZDisplayMetrics.h"
+#include "SettingsFileWatcher.h"
+#include "SettingsReload.h"
+#include "StartupTimeline.h"
 #include "cGZDisplayTiming.h"
 #include "cGZGPixelFormatDesc.h"
 #include "cIGZApp.h"
-#include "cIGZCmdLine.h"
 #include "cIGZCOM.h"
 #include "cIGZFrameWork.h"
 #include "cIGZFrameWorkW32.h"
-#include "cIGZGraphicSystem.h"
-#include "cIGZGraphicSystem2.h"
 #include "cIGZMessageServer2.h"
 #include "cIGZString.h"
 #include "cISC4App.h"
-#include "cISC4RenderProperties.h"
 #include "cRZMessage2COMDirector.h"
 #include "cRZMessage2Standard.h"
 #include "cRZAutoRefCount.h"
-#include "cRZBaseString.h"
 #include "GZCLSIDDefs.h"
-#include "GZServPtrs.h"
-#include "SC4Preferences.h"
 
 #include "sGDMode.h"
-#include "cIGZGDriver.h"
 
 #include <array>
 #include <filesystem>
 #include <fstream>
 #include <memory>
 #include <map>
+#include <mutex>
+#include <span>
 #include <string>
 #include <Windows.h>
 #include "wil/resource.h"
@@ -63,7 +69,13 @@
 static constexpr uint32_t kGraphicsOptionsDirectorID = 0x50A4C948;
 
 static constexpr std::string_view PluginConfigFileName = "SC4GraphicsOptions.ini";
-static constexpr std::string_view PluginLogFileName = "SC4GraphicsOptions.log";
+static constexpr std::string_view PluginPatchSiteCacheFileName = "SC4GraphicsOptions.PatchSites.ini";
+
+static constexpr size_t kPauseGameOnFocusLossIndex = GetSettingIndex("GraphicsOptions", "PauseGameOnFocusLoss");
+static constexpr size_t kForceDrawOnScrollIndex = GetSettingIndex("GraphicsOptions", "ForceDrawOnScroll");
+static constexpr size_t kMaxFrameRateIndex = GetSettingIndex("GraphicsOptions", "MaxFrameRate");
+static constexpr size_t kFirstLogLevelIndex = GetSettingIndex("Logging", kLogCategoryNames[0]);
+static constexpr size_t kReportIntervalSecondsIndex = GetSettingIndex("Telemetry", "ReportIntervalSeconds");
 
 namespace
 {
@@ -86,40 +98,40 @@ namespace
 		return GetModuleFolderPath(nullptr);
 	}
 
-	bool DriverTypesMatch(uint8_t existingDriverType, const SC4GDriverDescription& newDriverType)
+	// Replaces the DirectX driver's hard-coded full screen color depth of 16 with 32.
+	// The signature is generated from the version 641 executable with the SignatureGenerator tool:
+	// SignatureGenerator "SimCity 4.exe" 0x887738
+	// Until a signature has been generated and verified against the game's executables, the site
+	// is only located using the address from the version 641 executable.
+	constexpr PatchSiteDefinition kFullScreen32BitColorDepthPatches[] =
 	{
-		bool existingDriverIsHardware = existingDriverType != 0;
-
-		return existingDriverIsHardware == newDriverType.IsHardwareDriver();
-	}
-
-	bool WindowModesMatch(bool isFullScreen, SC4WindowMode windowMode)
+		{
+			"FullScreenColorDepth",
+			".text",
+			nullptr,
+			0,
+			641,
+			0x887738,
+			"10",
+			"20"
+		},
+	};
+
+	const char* GetPatchSiteSourceName(PatchSiteSource source)
 	{
-		switch (windowMode)
+		switch (source)
 		{
-		case SC4WindowMode::Windowed:
-		case SC4WindowMode::BorderlessFullScreen:
-			return !isFullScreen;
-		case SC4WindowMode::FullScreen:
-			return isFullScreen;
+		case PatchSiteSource::Cache:
+			return "the patch site cache";
+		case PatchSiteSource::Signature:
+			return "a signature scan";
+		case PatchSiteSource::KnownAddress:
+			return "the known address";
+		case PatchSiteSource::NotFound:
 		default:
-			return false;
+			return "nothing";
 		}
 	}
-
-	void OverwriteMemory(uintptr_t address, uint8_t newValue)
-	{
-		DWORD oldProtect;
-		// Allow the executable memory to be written to.
-		THROW_IF_WIN32_BOOL_FALSE(VirtualProtect(
-			reinterpret_cast<LPVOID>(address),
-			sizeof(newValue),
-			PAGE_EXECUTE_READWRITE,
-			&oldProtect));
-
-		// Patch the memory at the specified address.
-		*((uint8_t*)address) = newValue;
-	}
 }
 
 class GraphicsOptionsDllDirector : public cRZCOMDllDirector
@@ -127,27 +139,27 @@ class GraphicsOptionsDllDirector : public cRZCOMDllDirector
 public:
 
 	GraphicsOptionsDllDirector()
+		: settingsFilePath(),
+		  settings(),
+		  framePacerClock(),
+		  framePacer(),
+		  renderGameServices(),
+		  renderOptions(),
+		  settingsWatcher(),
+		  pendingSettingsMutex(),
+		  pendingSettings(),
+		  hasPendingSettings(false),
+		  processSchedulingControls(),
+		  processScheduling(processSchedulingControls)
 	{
-		std::filesystem::path dllFolderPath = GetDllFolderPath();
-
-		std::filesystem::path configFilePath = dllFolderPath;
-		configFilePath /= PluginConfigFileName;
+		StartupTimelinePhase phase("GraphicsOptionsDllDirector");
 
-		std::filesystem::path logFilePath = dllFolderPath;
-		logFilePath /= PluginLogFileName;
+		std::filesystem::path dllFolderPath = GetDllFolderPath();
 
-		Logger& logger = Logger::GetInstance();
-		logger.Init(logFilePath, LogLevel::Error);
-		logger.WriteLogFileHeader("SC4GraphicsOptions v" PLUGIN_VERSION_STR);
+		settingsFilePath = dllFolderPath;
+		settingsFilePath /= PluginConfigFileName;
 
-		try
-		{
-			settings.Load(configFilePath);
-		}
-		catch (const std::exception& e)
-		{
-			logger.WriteLine(LogLevel::Error, e.what());
-		}
+		GraphicsOptionsStartup::OnStart(dllFolderPath, settingsFilePath, settings);
 	}
 
 	uint32_t GetDirectorID() const
@@ -157,69 +169,53 @@ public:
 
 	bool PreFrameWorkInit()
 	{
-		cIGZFrameWork* const pFramework = RZGetFrameWork();
+		StartupTimelinePhase phase("PreFrameWorkInit");
 
-		cIGZApp* const pApp = pFramework->Application();
+		const SC4VersionDetection& versionDetection = SC4VersionDetection::GetInstance();
 
-		if (pApp)
-		{
-			cRZAutoRefCount<cISC4App> pSC4App;
+		LOG_DEBUG(
+			LogCategory::General,
+			"Game version {}, large address aware: {}.",
+			versionDetection.GetGameVersion(),
+			versionDetection.IsLargeAddressAware());
 
-			if (pApp->QueryInterface(GZIID_cISC4App, pSC4App.AsPPVoid()))
-			{
-				SC4Preferences* prefs = pSC4App->GetPreferences();
-				SC4VideoPreferences& videoPrefs = prefs->videoPreferences;
-
-				uint32_t windowWidth = settings.GetWindowWidth();
-				uint32_t windowHeight = settings.GetWindowHeight();
-				uint32_t colorDepth = settings.GetColorDepth();
-				SC4WindowMode windowMode = settings.GetWindowMode();
-				const SC4GDriverDescription& driver = settings.GetGDriverDescription();
-
-				if (videoPrefs.width != windowWidth
-					|| videoPrefs.height != windowHeight
-					|| videoPrefs.bitDepth != colorDepth
-					|| !WindowModesMatch(videoPrefs.bFullScreen != 0, windowMode)
-					|| !DriverTypesMatch(videoPrefs.driverType, driver))
-				{
-					videoPrefs.width = windowWidth;
-					videoPrefs.height = windowHeight;
-					videoPrefs.bitDepth = colorDepth;
-					videoPrefs.bFullScreen = windowMode == SC4WindowMode::FullScreen;
+		GameExecutableFingerprint executableFingerprint{};
 
-					// The game preferences UI treats the driver type as a Boolean, where a value
-					// of 1 indicates hardware rendering and a value of 0 indicates software rendering.
-					// Unlike the base game, we consider OpenGL to be hardware rendering.
-					videoPrefs.driverType = driver.IsHardwareDriver() ? 1 : 0;
-
-					pSC4App->SavePreferences();
-				}
+		if (versionDetection.GetExecutableFingerprint(executableFingerprint))
+		{
+			LOG_DEBUG(
+				LogCategory::General,
+				"Game executable code CRC-32C: 0x{:08X}, size: {} bytes.",
+				executableFingerprint.codeCrc32c,
+				executableFingerprint.codeSize);
+		}
 
-				pSC4App->EnableFullGamePauseOnAppFocusLoss(settings.PauseGameOnFocusLoss());
+		GZCOMGameServices game(RZGetFrameWork());
+		SC4VideoOptions videoOptions{};
 
-				switch (windowMode)
-				{
-				case SC4WindowMode::BorderlessFullScreen:
-					SC4WindowCreationHooks::Install(windowMode);
-					break;
-				}
+		if (GraphicsOptionsStartup::PreFrameWorkInit(settings, game, processScheduling, videoOptions))
+		{
+			const SC4WindowMode windowMode = settings.GetWindowMode();
 
-				CheckDirectX7ResolutionLimit(videoPrefs.width, videoPrefs.height);
-				FixFullScreen32BitColorDepth();
-				SetGraphicsOptions();
+			switch (windowMode)
+			{
+			case SC4WindowMode::BorderlessFullScreen:
+				SC4WindowCreationHooks::Install(windowMode);
+				break;
 			}
-		}
 
-		if (!settings.EnableIntroVideo())
-		{
-			// Add the command line argument to disable the intro videos
-			// that the game plays on startup.
-			cIGZCmdLine* pCmdLine = pFramework->CommandLine();
-			int argCount = pCmdLine->argc();
+			CheckDirectX7ResolutionLimit(videoOptions.width, videoOptions.height);
+			FixFullScreen32BitColorDepth();
 
-			if (!pCmdLine->IsSwitchPresent(cRZBaseString("Intro")))
+			if (settings.EnableFrameTimeTelemetry())
 			{
-				pCmdLine->InsertArgument(cRZBaseString("-Intro:off"), argCount);
+				FrameTimeTelemetry::GetInstance().Start(settings.GetTelemetryReportInterval());
+			}
+
+			if (UsePresentHooks())
+			{
+				// The hooks must be installed before the game initializes its graphics driver.
+				SC4PresentHooks::Install(settings.GetGDriverDescription());
 			}
 		}
 
@@ -228,6 +224,8 @@ public:
 
 	bool PreAppInit()
 	{
+		StartupTimelinePhase phase("PreAppInit");
+
 		switch (settings.GetWindowMode())
 		{
 		case SC4WindowMode::BorderlessFullScreen:
@@ -235,69 +233,59 @@ public:
 			break;
 		}
 
-		// This checks to ensure that the game is using the options that
-		// we requested in PreFrameWorkInit.
-		VerifyGraphicsOptions();
+		GZCOMGameServices game(RZGetFrameWork());
+		framePacer = GraphicsOptionsStartup::PreAppInit(settings, game, framePacerClock);
+
+		if (framePacer)
+		{
+			SC4PresentHooks::SetFramePacer(framePacer.get());
+		}
 
 		return true;
 	}
 
 	bool PostAppInit()
 	{
-		if (settings.ForceDrawOnScroll())
-		{
-			bool result = false;
+		// The render properties are used until the game shuts down.
+		renderGameServices = std::make_unique<GZCOMGameServices>(RZGetFrameWork());
 
-			cIGZApp* const pApp = mpFrameWork->Application();
+		GraphicsOptionsStartup::PostAppInit(settings, *renderGameServices, renderOptions, settingsFilePath.parent_path());
 
-			if (pApp)
-			{
-				cRZAutoRefCount<cISC4App> pSC4App;
+		bool usePresentCallback = renderOptions.IsAutoTuning();
 
-				if (pApp->QueryInterface(GZIID_cISC4App, pSC4App.AsPPVoid()))
-				{
-					cISC4RenderProperties* pRenderProperties = pSC4App->GetRenderProperties();
-
-					if (pRenderProperties)
-					{
-						// The ForceDrawOnScroll setting overrides a few render options for graphics cards with
-						// "slow partial depth buffer copies" that are commented out in the standard version of Graphics Rules.sgr.
-						// The comments in that file indicate that Maxis only observed this issue with a subset of older ATI Radeon
-						// cards, but complaints from users indicate it affects other graphics cards as well.
-
-						const int32_t noPartialBackingStoreKey = pRenderProperties->BoolPropertyIDFromName("NoPartialBackingStoreCopies");
-						const int32_t dirtyRectMergeFramesKey = pRenderProperties->IntPropertyIDFromName("DirtyRectMergeFrames");
-						const int32_t cursorTypeIndex = pRenderProperties->IntPropertyIDFromName("CursorType");
-
-						if (noPartialBackingStoreKey != -1 && dirtyRectMergeFramesKey != -1 && cursorTypeIndex != -1)
-						{
-							constexpr int32_t kCursorType_BlackAndWhite = 0;
-
-							// All of thse values are copied from Graphics Rules.sgr.
-							// Setting the NoPartialBackingStoreCopies option to true activates a special low-impact scrolling mode.
-							pRenderProperties->SetBoolValue(noPartialBackingStoreKey, true);
-							// This should reduce the number of dirty rects the game uses.
-							pRenderProperties->SetIntValue(dirtyRectMergeFramesKey, 8);
-							// Use a black & white cursor due to color cursors not working well on the affected cards.
-							pRenderProperties->SetIntValue(cursorTypeIndex, kCursorType_BlackAndWhite);
-							result = true;
-						}
-					}
-				}
+		if (settings.HotReload())
+		{
+			// The reloaded settings are applied on the game thread before it presents a frame.
+			if (settingsWatcher.Start(settingsFilePath, OnSettingsFileChanged, this))
+			{
+				usePresentCallback = true;
 			}
+		}
 
-			Logger& logger = Logger::GetInstance();
+		if (usePresentCallback)
+		{
+			SC4PresentHooks::SetPresentCallback(OnPresent, this);
+		}
 
-			if (result)
-			{
-				logger.WriteLine(LogLevel::Info, "Set the ForceDrawOnScroll rendering options.");
-			}
-			else
-			{
-				logger.WriteLine(LogLevel::Info, "Failed to set the ForceDrawOnScroll rendering options.");
-			}
+		return true;
+	}
+
+	bool PostAppShutdown()
+	{
+		if (UsePresentHooks())
+		{
+			settingsWatcher.Stop();
+			SC4PresentHooks::SetPresentCallback(nullptr, nullptr);
+			SC4PresentHooks::SetFramePacer(nullptr);
+			SC4PresentHooks::Remove();
+			FrameTimeTelemetry::GetInstance().Stop();
 		}
 
+		renderGameServices.reset();
+
+		HookRegistry::GetInstance().ReportStatistics();
+		GraphicsOptionsStartup::PostAppShutdown(processScheduling);
+
 		return true;
 	}
 
@@ -320,6 +308,184 @@ public:
 
 private:
 
+	bool UsePresentHooks() const
+	{
+		// The hot reload uses the present hooks to apply the settings on the game thread,
+		// and to start or stop the frame pacer. The render options auto-tune uses them
+		// to measure the frame times.
+		return settings.EnableFrameTimeTelemetry()
+			|| settings.GetMaxFrameRate() != 0
+			|| settings.HotReload()
+			|| settings.AutoTuneRenderOptions();
+	}
+
+	static void OnSettingsFileChanged(void* context)
+	{
+		static_cast<GraphicsOptionsDllDirector*>(context)->LoadPendingSettings();
+	}
+
+	static void OnPresent(void* context)
+	{
+		GraphicsOptionsDllDirector* director = static_cast<GraphicsOptionsDllDirector*>(context);
+
+		director->ApplyPendingSettings();
+
+		if (director->renderOptions.IsAutoTuning())
+		{
+			director->renderOptions.OnPresent(Platform::GetPerformanceCounter(), Platform::GetPerformanceFrequency());
+		}
+	}
+
+	// Called on the settings watcher thread.
+	void LoadPendingSettings()
+	{
+		std::unique_ptr<Settings> updated = std::make_unique<Settings>();
+
+		try
+		{
+			updated->Load(settingsFilePath);
+		}
+		catch (const std::exception& e)
+		{
+			Logger::GetInstance().WriteLine(LogCategory::Settings, LogLevel::Error, e.what());
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(pendingSettingsMutex);
+
+		pendingSettings = std::move(updated);
+		hasPendingSettings.store(true, std::memory_order_release);
+	}
+
+	// Called on the game thread before a frame is presented.
+	void ApplyPendingSettings()
+	{
+		if (!hasPendingSettings.load(std::memory_order_acquire))
+		{
+			return;
+		}
+
+		std::unique_ptr<Settings> updated;
+
+		{
+			std::lock_guard<std::mutex> lock(pendingSettingsMutex);
+
+			updated = std::move(pendingSettings);
+			hasPendingSettings.store(false, std::memory_order_relaxed);
+		}
+
+		if (!updated)
+		{
+			return;
+		}
+
+		Logger& logger = Logger::GetInstance();
+
+		const SettingsDiff diff = DiffSettings(settings, *updated);
+
+		for (size_t index : diff.runtimeChanges)
+		{
+			const SettingDefinition& definition = kSettingDefinitions[index];
+			const uint32_t value = updated->GetValue(index);
+
+			settings.SetValue(index, value);
+			ApplyRuntimeSetting(index);
+
+			logger.WriteLineFormatted(
+				LogCategory::Settings,
+				LogLevel::Info,
+				"Applied the reloaded {}.{} setting: {}.",
+				definition.section,
+				definition.key,
+				FormatSettingValue(definition, value));
+		}
+
+		for (size_t index : diff.deferredChanges)
+		{
+			const SettingDefinition& definition = kSettingDefinitions[index];
+
+			logger.WriteLineFormatted(
+				LogCategory::Settings,
+				LogLevel::Info,
+				"The reloaded {}.{} setting ({}) will be applied when the game is restarted.",
+				definition.section,
+				definition.key,
+				FormatSettingValue(definition, updated->GetValue(index)));
+		}
+
+		if (updated->GetRenderPropertyOverrides() != settings.GetRenderPropertyOverrides())
+		{
+			settings.SetRenderPropertyOverrides(updated->GetRenderPropertyOverrides());
+			renderOptions.OnRenderPropertyOverridesChanged(settings);
+		}
+		else if (diff.IsEmpty())
+		{
+			LOG_DEBUG(LogCategory::Settings, "The reloaded settings file has no changes.");
+		}
+	}
+
+	static std::string FormatSettingValue(const SettingDefinition& definition, uint32_t value)
+	{
+		const std::string_view valueName = GetSettingValueName(definition, value);
+
+		return valueName.empty() ? std::to_string(value) : std::string(valueName);
+	}
+
+	void ApplyRuntimeSetting(size_t index)
+	{
+		if (index == kPauseGameOnFocusLossIndex)
+		{
+			cIGZApp* const pApp = mpFrameWork->Application();
+
+			if (pApp)
+			{
+				cRZAutoRefCount<cISC4App> pSC4App;
+
+				if (pApp->QueryInterface(GZIID_cISC4App, pSC4App.AsPPVoid()))
+				{
+					pSC4App->EnableFullGamePauseOnAppFocusLoss(settings.PauseGameOnFocusLoss());
+				}
+			}
+		}
+		else if (index == kForceDrawOnScrollIndex)
+		{
+			renderOptions.OnForceDrawOnScrollChanged(settings);
+		}
+		else if (index == kMaxFrameRateIndex)
+		{
+			const uint32_t maxFrameRate = settings.GetMaxFrameRate();
+
+			// This runs on the game thread before the present hook calls the frame pacer,
+			// so the pacer can be safely changed or destroyed.
+			if (maxFrameRate == 0)
+			{
+				SC4PresentHooks::SetFramePacer(nullptr);
+				framePacer.reset();
+			}
+			else if (framePacer)
+			{
+				framePacer->SetMaxFrameRate(maxFrameRate);
+			}
+			else
+			{
+				framePacer = std::make_unique<FramePacer>(framePacerClock, maxFrameRate);
+				SC4PresentHooks::SetFramePacer(framePacer.get());
+			}
+
+			renderOptions.OnMaxFrameRateChanged(settings);
+		}
+		else if (index >= kFirstLogLevelIndex && index < kFirstLogLevelIndex + kLogCategoryCount)
+		{
+			const LogCategory category = static_cast<LogCategory>(index - kFirstLogLevelIndex);
+
+			Logger::GetInstance().SetLogLevel(category, settings.GetLogLevel(category));
+		}
+		else if (index == kReportIntervalSecondsIndex)
+		{
+			FrameTimeTelemetry::GetInstance().SetReportInterval(settings.GetTelemetryReportInterval());
+		}
+	}
+
 	void CheckDirectX7ResolutionLimit(uint32_t width, uint32_t height)
 	{
 		if (settings.IsUsingGDriver(kSCGDriverDirectX))
@@ -345,6 +511,7 @@ private:
 				{
 					Logger& logger = Logger::GetInstance();
 					logger.WriteLine(
+						LogCategory::Render,
 						LogLevel::Info,
 						"Warning: A DirectX wrapper is required for the resolution you are using.");
 				}
@@ -354,6 +521,8 @@ private:
 
 	void FixFullScreen32BitColorDepth()
 	{
+		StartupTimelinePhase phase("FixFullScreen32BitColorDepth");
+
 		// Maxis hard-coded the DirectX driver to use 16-bit color depth when in full screen mode, so we patch the
 		// game's memory to fix that.
 		// This fix is based on the patched SimCity 4 executable at https://github.com/dege-diosg/dgVoodoo2/issues/3
@@ -362,128 +531,114 @@ private:
 			&& settings.GetWindowMode() == SC4WindowMode::FullScreen
 			&& settings.GetColorDepth() == 32)
 		{
-			Logger& logger = Logger::GetInstance();
-			const uint16_t gameVersion = SC4VersionDetection::GetInstance().GetGameVersion();
-
-			if (gameVersion == 641)
+			if (ApplyPatches(kFullScreen32BitColorDepthPatches))
 			{
-				try
-				{
-					// Replace the hard-coded value of 16 with 32.
-					OverwriteMemory(0x887738, 32);
-					logger.WriteLine(LogLevel::Info, "Forced the DirectX full screen color depth to 32-bit.");
-				}
-				catch (const std::exception& e)
-				{
-					logger.WriteLineFormatted(
-						LogLevel::Error,
-						"Failed to force the DirectX full screen color depth to 32-bit: %s",
-						e.what());
-				}
+				Logger::GetInstance().WriteLine(
+					LogCategory::Patches,
+					LogLevel::Info,
+					"Forced the DirectX full screen color depth to 32-bit.");
 			}
 			else
 			{
-				logger.WriteLineFormatted(
+				Logger::GetInstance().WriteLine(
+					LogCategory::Patches,
 					LogLevel::Error,
-					"Unable to force the DirectX full screen color depth to 32-bit. Requires "
-					"game version 641, found game version %d.",
-					gameVersion);
+					"Unable to force the DirectX full screen color depth to 32-bit, this requires game version 641.");
 			}
 		}
 	}
 
-	void SetGraphicsOptions()
+	// Locates and applies a set of patches to the game's code as a single unit,
+	// none of the patches are applied if any of them fail.
+	bool ApplyPatches(std::span<const PatchSiteDefinition> sites)
 	{
-		// These settings will override the values that SC4 already set
-		// when reading its preferences and/or command line arguments.
+		Logger& logger = Logger::GetInstance();
+		const SC4VersionDetection& versionDetection = SC4VersionDetection::GetInstance();
+		const uint16_t gameVersion = versionDetection.GetGameVersion();
 
-		cIGZGraphicSystemPtr pGS;
+		std::filesystem::path cacheFilePath = settingsFilePath.parent_path();
+		cacheFilePath /= PluginPatchSiteCacheFileName;
 
-		if (pGS)
-		{
-			cGZDisplayMetrics metrics{};
-			metrics.width = settings.GetWindowWidth();
-			metrics.height = settings.GetWindowHeight();
-			metrics.bitDepth = settings.GetColorDepth();
-			bool windowedMode = settings.GetWindowMode() != SC4WindowMode::FullScreen;
+		GameExecutableFingerprint executableFingerprint{};
+		const bool hasExecutableFingerprint = versionDetection.GetExecutableFingerprint(executableFingerprint);
 
-			pGS->PreInitSetDesiredGameResolution(metrics);
-			pGS->PreInitSetWindowedMode(windowedMode);
-		}
-
-		cIGZGraphicSystem2Ptr pGS2;
+		PatchSiteResolver resolver(versionDetection.GetGameImage(), gameVersion, executableFingerprint);
 
-		if (pGS2)
+		// The cached patch sites are only used when the executable's code can be identified.
+		if (hasExecutableFingerprint)
 		{
-			const SC4GDriverDescription& requestedDriver = settings.GetGDriverDescription();
-
-			// SC4 will use driver with the requested ID
-			// when it initializes the graphics system.
-			pGS2->SetDefaultDriverClassID(requestedDriver.GetGZCLSID());
+			resolver.LoadCache(cacheFilePath);
 		}
-	}
-
-	void VerifyGraphicsOptions()
-	{
-		Logger& logger = Logger::GetInstance();
 
-		cIGZGraphicSystemPtr pGS;
+		MemoryPatchTransaction transaction;
 
-		if (pGS)
+		for (const PatchSiteDefinition& site : sites)
 		{
-			cGZDisplayMetrics gameMetrics{};
-			pGS->GetGameMetrics(gameMetrics);
-			bool isFullScreen = pGS->IsFullScreenMode();
-
-			uint32_t requestedWidth = settings.GetWindowWidth();
-			uint32_t requestedHeight = settings.GetWindowHeight();
-			uint32_t requestedBitDepth = settings.GetColorDepth();
-			SC4WindowMode windowMode = settings.GetWindowMode();
+			const PatchSiteLocation location = resolver.Resolve(site);
 
-			if (gameMetrics.width != requestedWidth
-				|| gameMetrics.height != requestedHeight
-				|| gameMetrics.bitDepth != requestedBitDepth
-				|| !WindowModesMatch(isFullScreen, windowMode))
+			if (location.source == PatchSiteSource::NotFound)
 			{
 				logger.WriteLineFormatted(
+					LogCategory::Patches,
 					LogLevel::Error,
-					"SC4's graphics options (%u\u0078%u\u0078%u, %s) doesn't match the requested options (%u\u0078%u\u0078%u, %s).",
-					gameMetrics.width,
-					gameMetrics.height,
-					gameMetrics.bitDepth,
-					isFullScreen ? "full screen" : "windowed",
-					requestedWidth,
-					requestedHeight,
-					requestedBitDepth,
-				    windowMode == SC4WindowMode::FullScreen ? "full screen" : "windowed");
+					"Unable to find the {} patch location in game version {}.",
+					site.name,
+					gameVersion);
+				return false;
 			}
-		}
 
-		cIGZGraphicSystem2Ptr pGS2;
+			LOG_DEBUG(
+				LogCategory::Patches,
+				"Found the {} patch location at 0x{:X} using {}.",
+				site.name,
+				location.address,
+				GetPatchSiteSourceName(location.source));
 
-		if (pGS2)
-		{
-			cIGZGDriver* pDriver = pGS2->GetGDriver();
+			transaction.Add(site.name, location.address, site.originalBytes, site.patchedBytes);
+		}
 
-			if (pDriver)
-			{
-				const SC4GDriverDescription& requestedDriver = settings.GetGDriverDescription();
+		if (hasExecutableFingerprint && !resolver.SaveCache(cacheFilePath))
+		{
+			LOG_DEBUG(LogCategory::Patches, "Failed to write the patch site cache file.");
+		}
 
-				const uint32_t currentDriverID = pDriver->GetGZCLSID();
-				const uint32_t requestedDriverID = requestedDriver.GetGZCLSID();
+		ProcessMemoryPatchTarget target;
+		const MemoryPatchResult result = transaction.Commit(target);
 
-				if (currentDriverID != requestedDriverID)
-				{
-					logger.WriteLineFormatted(
-						LogLevel::Error,
-						"Failed to set the game's driver to %s.",
-						requestedDriver.GetName().c_str());
-				}
-			}
+		if (result.status != MemoryPatchStatus::Succeeded)
+		{
+			logger.WriteLineFormatted(
+				LogCategory::Patches,
+				LogLevel::Error,
+				"Failed to apply the {} patch: {}.",
+				result.failedPatchName.empty() ? "game" : result.failedPatchName,
+				GetMemoryPatchStatusDescription(result.status));
+			return false;
 		}
+
+		LOG_DEBUG(
+			LogCategory::Patches,
+			"Applied {} patch(es) to {} page range(s) in {} us, {} patch(es) were already applied.",
+			result.appliedCount,
+			result.pageRangeCount,
+			(result.elapsedTicks * 1000000) / Platform::GetPerformanceFrequency(),
+			result.alreadyAppliedCount);
+
+		return true;
 	}
 
+	std::filesystem::path settingsFilePath;
 	Settings settings;
+	SystemFramePacerClock framePacerClock;
+	std::unique_ptr<FramePacer> framePacer;
+	std::unique_ptr<GZCOMGameServices> renderGameServices;
+	RenderOptionsController renderOptions;
+	SettingsFileWatcher settingsWatcher;
+	std::mutex pendingSettingsMutex;
+	std::unique_ptr<Settings> pendingSettings;
+	std::atomic<bool> hasPendingSettings;
+	PlatformProcessSchedulingControls processSchedulingControls;
+	ProcessSchedulingPolicy processScheduling;
 };
 
 cRZCOMDllDirector* RZGetCOMDllDirector() {
@@ -0,0 +1,321 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "GraphicsOptionsStartup.h"
+#include "version.h"
+#include "FlightRecorder.h"
+#include "Logger.h"
+#include "ProcessSchedulingPolicy.h"
+#include "RenderOptionsController.h"
+#include "SC4VideoPreferencesMatching.h"
+#include "StartupTimeline.h"
+#include <string_view>
+
+namespace
+{
+	constexpr std::string_view PluginLogFileName = "SC4GraphicsOptions.log";
+	constexpr std::string_view PluginBinaryLogFileName = "SC4GraphicsOptions.blog";
+	constexpr std::string_view PluginFlightRecorderFileName = "SC4GraphicsOptions.FlightRecorder.log";
+	constexpr std::string_view PluginStartupTraceFileName = "SC4GraphicsOptions.trace.json";
+	constexpr std::string_view PluginAutoTuneCacheFileName = "SC4GraphicsOptions.AutoTune.ini";
+
+	// The log is limited to 1 MB, the logs from the 2 previous sessions are kept
+	// as SC4GraphicsOptions.1.log and SC4GraphicsOptions.2.log.
+	constexpr size_t kMaxLogFileSize = 1024 * 1024;
+	constexpr uint32_t kLogFileHistoryCount = 2;
+}
+
+void GraphicsOptionsStartup::OnStart(
+	const std::filesystem::path& pluginFolderPath,
+	const std::filesystem::path& settingsFilePath,
+	Settings& settings)
+{
+	std::filesystem::path logFilePath = pluginFolderPath;
+	logFilePath /= PluginLogFileName;
+
+	Logger& logger = Logger::GetInstance();
+	logger.Init(
+		logFilePath,
+		LogLevel::Error,
+		true,
+		LogWriteMode::Asynchronous,
+		kMaxLogFileSize,
+		kLogFileHistoryCount);
+	logger.WriteLogFileHeader("SC4GraphicsOptions v" PLUGIN_VERSION_STR);
+
+	std::filesystem::path flightRecorderFilePath = pluginFolderPath;
+	flightRecorderFilePath /= PluginFlightRecorderFileName;
+
+	FlightRecorder::GetInstance().Init(flightRecorderFilePath);
+
+	try
+	{
+		StartupTimelinePhase loadPhase("Settings::Load");
+
+		settings.Load(settingsFilePath);
+	}
+	catch (const std::exception& e)
+	{
+		logger.WriteLine(LogCategory::Settings, LogLevel::Error, e.what());
+	}
+
+	for (size_t i = 0; i < kLogCategoryCount; i++)
+	{
+		const LogCategory category = static_cast<LogCategory>(i);
+
+		logger.SetLogLevel(category, settings.GetLogLevel(category));
+	}
+
+	if (settings.GetLogFileFormat() == LogFileFormat::Binary)
+	{
+		std::filesystem::path binaryLogFilePath = pluginFolderPath;
+		binaryLogFilePath /= PluginBinaryLogFileName;
+
+		logger.EnableBinaryLog(binaryLogFilePath);
+	}
+}
+
+bool GraphicsOptionsStartup::PreFrameWorkInit(
+	const Settings& settings,
+	ISC4GameServices& game,
+	ProcessSchedulingPolicy& processScheduling,
+	SC4VideoOptions& videoOptions)
+{
+	ApplyProcessSchedulingOptions(settings, processScheduling);
+
+	const bool hasVideoPreferences = game.GetVideoPreferences(videoOptions);
+
+	if (hasVideoPreferences)
+	{
+		ApplyVideoPreferences(settings, game, videoOptions);
+
+		StartupTimelinePhase graphicsOptionsPhase("SetGraphicsOptions");
+
+		ApplyGraphicsOptions(settings, game);
+	}
+
+	if (!settings.EnableIntroVideo())
+	{
+		DisableIntroVideo(game);
+	}
+
+	return hasVideoPreferences;
+}
+
+std::unique_ptr<FramePacer> GraphicsOptionsStartup::PreAppInit(
+	const Settings& settings,
+	ISC4GameServices& game,
+	FramePacerClock& framePacerClock)
+{
+	// This checks to ensure that the game is using the options that
+	// we requested in PreFrameWorkInit.
+	VerifyGraphicsOptions(settings, game);
+
+	std::unique_ptr<FramePacer> framePacer;
+
+	const uint32_t maxFrameRate = settings.GetMaxFrameRate();
+
+	if (maxFrameRate != 0)
+	{
+		framePacer = std::make_unique<FramePacer>(framePacerClock, maxFrameRate);
+
+		Logger::GetInstance().WriteLineFormatted(
+			LogCategory::Render,
+			LogLevel::Info,
+			"Limited the frame rate to {} FPS.",
+			maxFrameRate);
+	}
+
+	return framePacer;
+}
+
+void GraphicsOptionsStartup::PostAppInit(
+	const Settings& settings,
+	ISC4GameServices& game,
+	RenderOptionsController& renderOptions,
+	const std::filesystem::path& pluginFolderPath)
+{
+	{
+		StartupTimelinePhase phase("PostAppInit");
+
+		std::filesystem::path autoTuneCacheFilePath = pluginFolderPath;
+		autoTuneCacheFilePath /= PluginAutoTuneCacheFileName;
+
+		renderOptions.Start(settings, game.GetRenderProperties(), autoTuneCacheFilePath);
+	}
+
+	StartupTimeline& startupTimeline = StartupTimeline::GetInstance();
+	startupTimeline.StopSampling();
+
+	if (settings.WriteStartupTrace())
+	{
+		std::filesystem::path traceFilePath = pluginFolderPath;
+		traceFilePath /= PluginStartupTraceFileName;
+
+		if (!startupTimeline.WriteTraceFile(traceFilePath, PLUGIN_VERSION_STR))
+		{
+			Logger::GetInstance().WriteLine(LogCategory::General, LogLevel::Error, "Failed to write the startup trace file.");
+		}
+	}
+}
+
+void GraphicsOptionsStartup::PostAppShutdown(ProcessSchedulingPolicy& processScheduling)
+{
+	processScheduling.Restore();
+
+	FlightRecorder::GetInstance().Shutdown();
+
+	// The logger's background writer thread must be stopped before the
+	// DLL is unloaded.
+	Logger::GetInstance().Shutdown();
+}
+
+void GraphicsOptionsStartup::ApplyProcessSchedulingOptions(const Settings& settings, ProcessSchedulingPolicy& processScheduling)
+{
+	const ProcessSchedulingOptions options
+	{
+		settings.GetTimerResolution(),
+		settings.DisablePowerThrottling(),
+		settings.GetPriorityClass()
+	};
+
+	const ProcessSchedulingState& state = processScheduling.Apply(options);
+	const std::string description = FormatProcessSchedulingState(state);
+
+	if (!description.empty())
+	{
+		const bool failed = state.timerResolutionFailed || state.powerThrottlingFailed || state.priorityClassFailed;
+
+		Logger::GetInstance().WriteLineFormatted(
+			LogCategory::General,
+			failed ? LogLevel::Error : LogLevel::Info,
+			"Process scheduling: {}.",
+			description);
+	}
+}
+
+void GraphicsOptionsStartup::ApplyVideoPreferences(const Settings& settings, ISC4GameServices& game, SC4VideoOptions& options)
+{
+	const uint32_t windowWidth = settings.GetWindowWidth();
+	const uint32_t windowHeight = settings.GetWindowHeight();
+	const uint32_t colorDepth = settings.GetColorDepth();
+	const SC4WindowMode windowMode = settings.GetWindowMode();
+	const SC4GDriverDescription& driver = settings.GetGDriverDescription();
+
+	if (options.width != windowWidth
+		|| options.height != windowHeight
+		|| options.bitDepth != colorDepth
+		|| !WindowModesMatch(options.fullScreen, windowMode)
+		|| !DriverTypesMatch(options.driverType, driver))
+	{
+		options.width = windowWidth;
+		options.height = windowHeight;
+		options.bitDepth = colorDepth;
+		options.fullScreen = windowMode == SC4WindowMode::FullScreen;
+
+		// The game preferences UI treats the driver type as a Boolean, where a value
+		// of 1 indicates hardware rendering and a value of 0 indicates software rendering.
+		// Unlike the base game, we consider OpenGL to be hardware rendering.
+		options.driverType = driver.IsHardwareDriver() ? 1 : 0;
+
+		game.SaveVideoPreferences(options);
+	}
+
+	game.EnableFullGamePauseOnAppFocusLoss(settings.PauseGameOnFocusLoss());
+}
+
+void GraphicsOptionsStartup::ApplyGraphicsOptions(const Settings& settings, ISC4GameServices& game)
+{
+	game.SetDesiredGameResolution(
+		settings.GetWindowWidth(),
+		settings.GetWindowHeight(),
+		settings.GetColorDepth(),
+		settings.GetWindowMode() != SC4WindowMode::FullScreen);
+
+	// SC4 will use driver with the requested ID
+	// when it initializes the graphics system.
+	game.SetDefaultDriverClassID(settings.GetGDriverDescription().GetGZCLSID());
+}
+
+void GraphicsOptionsStartup::DisableIntroVideo(ISC4GameServices& game)
+{
+	// Add the command line argument to disable the intro videos
+	// that the game plays on startup.
+	if (!game.IsCommandLineSwitchPresent("Intro"))
+	{
+		game.AppendCommandLineArgument("-Intro:off");
+	}
+}
+
+bool GraphicsOptionsStartup::VerifyGraphicsOptions(const Settings& settings, ISC4GameServices& game)
+{
+	Logger& logger = Logger::GetInstance();
+	bool result = true;
+
+	SC4GameMetrics gameMetrics{};
+
+	if (game.GetGameMetrics(gameMetrics))
+	{
+		uint32_t requestedWidth = settings.GetWindowWidth();
+		uint32_t requestedHeight = settings.GetWindowHeight();
+		uint32_t requestedBitDepth = settings.GetColorDepth();
+		SC4WindowMode windowMode = settings.GetWindowMode();
+
+		if (gameMetrics.width != requestedWidth
+			|| gameMetrics.height != requestedHeight
+			|| gameMetrics.bitDepth != requestedBitDepth
+			|| !WindowModesMatch(gameMetrics.fullScreen, windowMode))
+		{
+			logger.WriteLineFormatted(
+				LogCategory::Render,
+				LogLevel::Error,
+				"SC4's graphics options ({}\u0078{}\u0078{}, {}) doesn't match the requested options ({}\u0078{}\u0078{}, {}).",
+				gameMetrics.width,
+				gameMetrics.height,
+				gameMetrics.bitDepth,
+				gameMetrics.fullScreen ? "full screen" : "windowed",
+				requestedWidth,
+				requestedHeight,
+				requestedBitDepth,
+				windowMode == SC4WindowMode::FullScreen ? "full screen" : "windowed");
+			result = false;
+		}
+	}
+
+	uint32_t currentDriverID = 0;
+
+	if (game.GetDriverClassID(currentDriverID))
+	{
+		const SC4GDriverDescription& requestedDriver = settings.GetGDriverDescription();
+
+		if (currentDriverID != requestedDriver.GetGZCLSID())
+		{
+			logger.WriteLineFormatted(
+				LogCategory::Render,
+				LogLevel::Error,
+				"Failed to set the game's driver to {}.",
+				requestedDriver.GetName());
+			result = false;
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,78 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include "FramePacer.h"
+#include "SC4GameServices.h"
+#include "Settings.h"
+#include <filesystem>
+#include <memory>
+
+class ProcessSchedulingPolicy;
+class RenderOptionsController;
+
+// The plugin's work in each stage of the game's framework lifecycle that does not
+// depend on the game's GZCOM interfaces, the director calls these with the game's
+// services and adds the hooks and patches that only work in the game's process.
+namespace GraphicsOptionsStartup
+{
+	// Starts the log and the flight recorder in the plugin's folder, then loads the settings
+	// and applies their logging options. An error in the settings file is written to the log
+	// and the default values are used.
+	void OnStart(const std::filesystem::path& pluginFolderPath, const std::filesystem::path& settingsFilePath, Settings& settings);
+
+	// Applies the process scheduling options, the video preferences, the graphics options and the intro video switch.
+	// Returns false if the game's video preferences are not available, the graphics options are not set in that case.
+	bool PreFrameWorkInit(
+		const Settings& settings,
+		ISC4GameServices& game,
+		ProcessSchedulingPolicy& processScheduling,
+		SC4VideoOptions& videoOptions);
+
+	// Verifies the graphics options, and creates the frame pacer if the settings limit the frame rate.
+	std::unique_ptr<FramePacer> PreAppInit(const Settings& settings, ISC4GameServices& game, FramePacerClock& framePacerClock);
+
+	// Sets the render options, then stops the startup timeline and writes the startup trace.
+	void PostAppInit(
+		const Settings& settings,
+		ISC4GameServices& game,
+		RenderOptionsController& renderOptions,
+		const std::filesystem::path& pluginFolderPath);
+
+	// Restores the process scheduling options and stops the flight recorder and the log.
+	void PostAppShutdown(ProcessSchedulingPolicy& processScheduling);
+
+	void ApplyProcessSchedulingOptions(const Settings& settings, ProcessSchedulingPolicy& processScheduling);
+
+	// Changes the game's video preferences to match the settings, the preferences are only saved when they change.
+	// The options are updated to the values that the game will use.
+	void ApplyVideoPreferences(const Settings& settings, ISC4GameServices& game, SC4VideoOptions& options);
+
+	// Sets the resolution, window mode and driver that the game's graphics system will be initialized with.
+	// These override the values that the game set when reading its preferences and command line arguments.
+	void ApplyGraphicsOptions(const Settings& settings, ISC4GameServices& game);
+
+	void DisableIntroVideo(ISC4GameServices& game);
+
+	// Checks that the game is using the options that were requested before it initialized.
+	// The mismatches are written to the log, returns false if any were found.
+	bool VerifyGraphicsOptions(const Settings& settings, ISC4GameServices& game);
+}
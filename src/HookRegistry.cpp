@@ -0,0 +1,116 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "HookRegistry.h"
+#include "Logger.h"
+#include <Windows.h>
+#include "detours/detours.h"
+
+HookRegistry::HookEntry::HookEntry(const char* group, const char* name, void** ppRealFunction, void* hookFunction)
+	: group(group),
+	  ppRealFunction(ppRealFunction),
+	  hookFunction(hookFunction),
+	  installed(false),
+	  statistics(name)
+{
+}
+
+HookRegistry& HookRegistry::GetInstance()
+{
+	static HookRegistry instance;
+
+	return instance;
+}
+
+HookRegistry::HookRegistry() : hooks()
+{
+}
+
+HookStatistics& HookRegistry::Register(const char* group, const char* name, void** ppRealFunction, void* hookFunction)
+{
+	return hooks.emplace_back(group, name, ppRealFunction, hookFunction).statistics;
+}
+
+bool HookRegistry::Install(std::string_view group)
+{
+	return CommitTransaction(group, true);
+}
+
+bool HookRegistry::Remove(std::string_view group)
+{
+	return CommitTransaction(group, false);
+}
+
+void HookRegistry::ReportStatistics()
+{
+	for (HookEntry& entry : hooks)
+	{
+		LOG_DEBUG(LogCategory::Hooks, "{}", entry.statistics.FormatReport());
+	}
+}
+
+bool HookRegistry::CommitTransaction(std::string_view group, bool install)
+{
+	uint32_t hookCount = 0;
+
+	DetourTransactionBegin();
+	DetourUpdateThread(GetCurrentThread());
+
+	for (HookEntry& entry : hooks)
+	{
+		if (group == entry.group && entry.installed != install)
+		{
+			if (install)
+			{
+				DetourAttach(entry.ppRealFunction, entry.hookFunction);
+			}
+			else
+			{
+				DetourDetach(entry.ppRealFunction, entry.hookFunction);
+			}
+
+			hookCount++;
+		}
+	}
+
+	const LONG error = DetourTransactionCommit();
+
+	if (error == NO_ERROR)
+	{
+		for (HookEntry& entry : hooks)
+		{
+			if (group == entry.group)
+			{
+				entry.installed = install;
+			}
+		}
+	}
+
+	LOG_DEBUG(
+		LogCategory::Hooks,
+		"{} {} {} hook(s), error code {}.",
+		install ? "Installed" : "Removed",
+		hookCount,
+		group,
+		error);
+
+	return error == NO_ERROR;
+}
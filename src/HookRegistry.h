@@ -0,0 +1,73 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include "HookStatistics.h"
+#include <deque>
+#include <string_view>
+
+// Tracks the plugin's Detours hooks.
+//
+// Hooks are registered in named groups, the hooks in a group are installed and
+// removed in a single Detours transaction. The call statistics of every hook
+// that was registered are kept until the process exits, so they can be reported
+// after the hooks have been removed.
+//
+// The registration, installation and removal functions must be called from the
+// game's main thread.
+class HookRegistry
+{
+public:
+
+	static HookRegistry& GetInstance();
+
+	// Adds a hook to a group, the hook is attached by the next call to Install for that group.
+	// The returned statistics remain valid until the process exits.
+	HookStatistics& Register(const char* group, const char* name, void** ppRealFunction, void* hookFunction);
+
+	// Attaches the group's hooks that are not installed.
+	bool Install(std::string_view group);
+
+	// Detaches the group's installed hooks.
+	bool Remove(std::string_view group);
+
+	// Writes the call statistics of every hook to the debug log, and records them in the flight recorder.
+	void ReportStatistics();
+
+private:
+
+	struct HookEntry
+	{
+		HookEntry(const char* group, const char* name, void** ppRealFunction, void* hookFunction);
+
+		const char* group;
+		void** ppRealFunction;
+		void* hookFunction;
+		bool installed;
+		HookStatistics statistics;
+	};
+
+	HookRegistry();
+
+	bool CommitTransaction(std::string_view group, bool install);
+
+	std::deque<HookEntry> hooks;
+};
@@ -0,0 +1,107 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "HookStatistics.h"
+#include <format>
+
+HookStatistics::HookStatistics(const char* name)
+	: name(name),
+	  callCount(0),
+	  filteredCallCount(0),
+	  filterActive(true),
+	  ticksPerSecond(Platform::GetPerformanceFrequency()),
+	  durations()
+{
+}
+
+const char* HookStatistics::GetName() const
+{
+	return name;
+}
+
+void HookStatistics::RecordCall(int64_t elapsedTicks)
+{
+	callCount.fetch_add(1, std::memory_order_relaxed);
+
+	if (filterActive.load(std::memory_order_relaxed))
+	{
+		filteredCallCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	const int64_t microseconds = elapsedTicks > 0 ? (elapsedTicks * 1000000) / ticksPerSecond : 0;
+
+	durations.Record(static_cast<uint64_t>(microseconds));
+}
+
+uint64_t HookStatistics::GetCallCount() const
+{
+	return callCount.load(std::memory_order_relaxed);
+}
+
+bool HookStatistics::IsFilterActive() const
+{
+	return filterActive.load(std::memory_order_relaxed);
+}
+
+void HookStatistics::RetireFilter()
+{
+	filterActive.store(false, std::memory_order_relaxed);
+}
+
+uint64_t HookStatistics::GetFilteredCallCount() const
+{
+	return filteredCallCount.load(std::memory_order_relaxed);
+}
+
+void HookStatistics::TakeDurationSnapshot(FrameTimeHistogram::Snapshot& snapshot)
+{
+	durations.TakeSnapshot(snapshot);
+}
+
+std::string HookStatistics::FormatReport()
+{
+	FrameTimeHistogram::Snapshot snapshot;
+	TakeDurationSnapshot(snapshot);
+
+	const uint64_t calls = GetCallCount();
+	const uint64_t filteredCalls = GetFilteredCallCount();
+
+	return std::format(
+		"{}: {} calls, the filter {} {} calls, duration p50 {}us, p99 {}us, max {}us.",
+		name,
+		calls,
+		IsFilterActive() ? "checked" : "was retired after",
+		filteredCalls,
+		snapshot.GetValueAtPercentile(50.0),
+		snapshot.GetValueAtPercentile(99.0),
+		snapshot.GetMaxValue());
+}
+
+HookCallScope::HookCallScope(HookStatistics& statistics)
+	: statistics(statistics),
+	  startTime(Platform::GetPerformanceCounter())
+{
+}
+
+HookCallScope::~HookCallScope()
+{
+	statistics.RecordCall(Platform::GetPerformanceCounter() - startTime);
+}
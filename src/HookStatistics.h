@@ -0,0 +1,89 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include "FrameTimeHistogram.h"
+#include "Platform.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// The call count and call durations of a hook function.
+//
+// The values are updated with relaxed atomic operations, so recording a call
+// never blocks the hooked thread.
+class HookStatistics
+{
+public:
+
+	explicit HookStatistics(const char* name);
+
+	HookStatistics(const HookStatistics&) = delete;
+	HookStatistics& operator=(const HookStatistics&) = delete;
+
+	const char* GetName() const;
+
+	void RecordCall(int64_t elapsedTicks);
+
+	uint64_t GetCallCount() const;
+
+	// A hook's filter selects the calls that the hook modifies, e.g. the calls that create the game's
+	// main window. A hook retires its filter when it has found everything it is looking for, after
+	// that the hook passes every call through to the original function.
+	bool IsFilterActive() const;
+
+	void RetireFilter();
+
+	// Returns the number of calls that the filter was active for.
+	uint64_t GetFilteredCallCount() const;
+
+	// Moves the recorded call durations, in microseconds, into the snapshot.
+	void TakeDurationSnapshot(FrameTimeHistogram::Snapshot& snapshot);
+
+	std::string FormatReport();
+
+private:
+
+	const char* name;
+	std::atomic<uint64_t> callCount;
+	std::atomic<uint64_t> filteredCallCount;
+	std::atomic<bool> filterActive;
+	int64_t ticksPerSecond;
+	FrameTimeHistogram durations;
+};
+
+// Records the duration of a hook call when it goes out of scope.
+class HookCallScope
+{
+public:
+
+	explicit HookCallScope(HookStatistics& statistics);
+
+	~HookCallScope();
+
+	HookCallScope(const HookCallScope&) = delete;
+	HookCallScope& operator=(const HookCallScope&) = delete;
+
+private:
+
+	HookStatistics& statistics;
+	int64_t startTime;
+};
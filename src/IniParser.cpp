@@ -0,0 +1,190 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "IniParser.h"
+#include <format>
+#include <string>
+
+namespace
+{
+	constexpr std::string_view kUtf8ByteOrderMark = "\xEF\xBB\xBF";
+	constexpr std::string_view kWhitespace = " \t";
+
+	std::string_view Trim(std::string_view value)
+	{
+		const size_t start = value.find_first_not_of(kWhitespace);
+
+		if (start == std::string_view::npos)
+		{
+			return {};
+		}
+
+		const size_t end = value.find_last_not_of(kWhitespace);
+
+		return value.substr(start, end - start + 1);
+	}
+
+	uint32_t GetColumn(std::string_view lineText, std::string_view part)
+	{
+		return static_cast<uint32_t>(part.data() - lineText.data()) + 1;
+	}
+
+	char ToLowerAscii(char value)
+	{
+		return (value >= 'A' && value <= 'Z') ? static_cast<char>(value + ('a' - 'A')) : value;
+	}
+
+	std::string FormatErrorMessage(const char* message, uint32_t line, uint32_t column)
+	{
+		return std::format("Line {}, column {}: {}", line, column, message);
+	}
+}
+
+IniParseError::IniParseError(const char* message, uint32_t line, uint32_t column)
+	: std::runtime_error(FormatErrorMessage(message, line, column)),
+	  line(line),
+	  column(column)
+{
+}
+
+uint32_t IniParseError::GetLine() const
+{
+	return line;
+}
+
+uint32_t IniParseError::GetColumn() const
+{
+	return column;
+}
+
+IniParser::IniParser(std::string_view text)
+	: text(text),
+	  position(text.starts_with(kUtf8ByteOrderMark) ? kUtf8ByteOrderMark.size() : 0),
+	  line(0),
+	  section()
+{
+}
+
+bool IniParser::Next(IniEntry& entry)
+{
+	while (position < text.size())
+	{
+		size_t lineEnd = text.find('\n', position);
+
+		if (lineEnd == std::string_view::npos)
+		{
+			lineEnd = text.size();
+		}
+
+		std::string_view lineText = text.substr(position, lineEnd - position);
+
+		if (lineText.ends_with('\r'))
+		{
+			lineText.remove_suffix(1);
+		}
+
+		position = lineEnd + 1;
+		line++;
+
+		const std::string_view content = Trim(lineText);
+
+		if (content.empty() || content.front() == ';' || content.front() == '#')
+		{
+			continue;
+		}
+
+		if (content.front() == '[')
+		{
+			const size_t sectionEnd = content.find(']');
+
+			if (sectionEnd == std::string_view::npos)
+			{
+				throw IniParseError("The section name is missing the closing ']'.", line, GetColumn(lineText, content));
+			}
+
+			const std::string_view trailing = Trim(content.substr(sectionEnd + 1));
+
+			if (!trailing.empty() && trailing.front() != ';' && trailing.front() != '#')
+			{
+				throw IniParseError("Unexpected text after the section name.", line, GetColumn(lineText, trailing));
+			}
+
+			section = Trim(content.substr(1, sectionEnd - 1));
+
+			if (section.empty())
+			{
+				throw IniParseError("The section name is empty.", line, GetColumn(lineText, content));
+			}
+
+			continue;
+		}
+
+		const size_t separator = content.find('=');
+
+		if (separator == std::string_view::npos)
+		{
+			throw IniParseError("Expected a Key=Value line.", line, GetColumn(lineText, content));
+		}
+
+		const std::string_view key = Trim(content.substr(0, separator));
+
+		if (key.empty())
+		{
+			throw IniParseError("The key name is empty.", line, GetColumn(lineText, content));
+		}
+
+		const std::string_view rawValue = content.substr(separator + 1);
+		const std::string_view value = Trim(rawValue);
+
+		entry.section = section;
+		entry.key = key;
+		entry.value = value;
+		entry.line = line;
+		entry.column = GetColumn(lineText, value.empty() ? rawValue : value);
+
+		return true;
+	}
+
+	return false;
+}
+
+bool IniEqualsIgnoreCase(std::string_view lhs, std::string_view rhs)
+{
+	return lhs.size() == rhs.size() && IniStartsWithIgnoreCase(lhs, rhs);
+}
+
+bool IniStartsWithIgnoreCase(std::string_view value, std::string_view prefix)
+{
+	if (value.size() < prefix.size())
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < prefix.size(); i++)
+	{
+		if (ToLowerAscii(value[i]) != ToLowerAscii(prefix[i]))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,79 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+// A key and value from an INI file, the strings are views into the parsed text.
+struct IniEntry
+{
+	std::string_view section;
+	std::string_view key;
+	std::string_view value;
+	// The 1-based line and column of the value, used for error messages.
+	uint32_t line;
+	uint32_t column;
+};
+
+class IniParseError : public std::runtime_error
+{
+public:
+
+	IniParseError(const char* message, uint32_t line, uint32_t column);
+
+	uint32_t GetLine() const;
+
+	uint32_t GetColumn() const;
+
+private:
+
+	uint32_t line;
+	uint32_t column;
+};
+
+// A single-pass INI parser that does not allocate memory.
+//
+// The supported syntax is [Section] headers and Key=Value lines, comments start with
+// a ';' or '#' character. Leading and trailing whitespace is removed from the section
+// names, keys and values. A UTF-8 byte order mark at the start of the text is skipped.
+class IniParser
+{
+public:
+
+	explicit IniParser(std::string_view text);
+
+	// Reads the next key and value, returns false at the end of the text.
+	// Throws an IniParseError if a line is not valid.
+	bool Next(IniEntry& entry);
+
+private:
+
+	std::string_view text;
+	size_t position;
+	uint32_t line;
+	std::string_view section;
+};
+
+bool IniEqualsIgnoreCase(std::string_view lhs, std::string_view rhs);
+
+bool IniStartsWithIgnoreCase(std::string_view value, std::string_view prefix);
@@ -0,0 +1,54 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+enum class LogCategory : uint8_t
+{
+	General = 0,
+	Settings,
+	Hooks,
+	Patches,
+	Render,
+	Telemetry
+};
+
+constexpr size_t kLogCategoryCount = static_cast<size_t>(LogCategory::Telemetry) + 1;
+
+// The category names are also used as the key names in the [Logging] section of the INI file.
+constexpr const char* kLogCategoryNames[kLogCategoryCount] =
+{
+	"General",
+	"Settings",
+	"Hooks",
+	"Patches",
+	"Render",
+	"Telemetry"
+};
+
+constexpr const char* GetLogCategoryName(LogCategory category)
+{
+	const size_t index = static_cast<size_t>(category);
+
+	return index < kLogCategoryCount ? kLogCategoryNames[index] : "Unknown";
+}
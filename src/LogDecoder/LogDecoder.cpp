@@ -0,0 +1,308 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// Converts a binary log (SC4GraphicsOptions.blog) to text or JSON.
+// This tool only depends on the C++ standard library, so it can be built on any
+// platform with a C++20 compiler, e.g.:
+// g++ -std=c++20 -O2 -I.. LogDecoder.cpp ../BinaryLogFormat.cpp -o SC4GraphicsOptionsLogDecoder
+
+#include "BinaryLogFormat.h"
+#include "LogCategory.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+	enum class OutputFormat
+	{
+		Text,
+		Json
+	};
+
+	// Formats the system time as an ISO 8601 UTC date and time.
+	std::string FormatSystemTime(uint64_t systemTime)
+	{
+		// The number of 100-nanosecond intervals between January 1, 1601 and January 1, 1970.
+		constexpr uint64_t kUnixEpochOffset = 116444736000000000;
+
+		if (systemTime < kUnixEpochOffset)
+		{
+			return "unknown";
+		}
+
+		const uint64_t unixTime = systemTime - kUnixEpochOffset;
+		const uint64_t milliseconds = (unixTime / 10000) % 1000;
+		const uint64_t totalSeconds = unixTime / 10000000;
+		const int64_t days = static_cast<int64_t>(totalSeconds / 86400);
+		const uint64_t secondsOfDay = totalSeconds % 86400;
+
+		// Converts the days since 1970-01-01 to a civil date, this is Howard Hinnant's civil_from_days algorithm.
+		const int64_t z = days + 719468;
+		const int64_t era = z / 146097;
+		const int64_t dayOfEra = z - (era * 146097);
+		const int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+		const int64_t dayOfYear = dayOfEra - ((365 * yearOfEra) + (yearOfEra / 4) - (yearOfEra / 100));
+		const int64_t monthPrime = ((5 * dayOfYear) + 2) / 153;
+		const int64_t day = dayOfYear - (((153 * monthPrime) + 2) / 5) + 1;
+		const int64_t month = monthPrime < 10 ? monthPrime + 3 : monthPrime - 9;
+		const int64_t year = yearOfEra + (era * 400) + (month <= 2 ? 1 : 0);
+
+		char buffer[64]{};
+
+		std::snprintf(
+			buffer,
+			sizeof(buffer),
+			"%04lld-%02lld-%02lldT%02llu:%02llu:%02llu.%03lluZ",
+			static_cast<long long>(year),
+			static_cast<long long>(month),
+			static_cast<long long>(day),
+			static_cast<unsigned long long>(secondsOfDay / 3600),
+			static_cast<unsigned long long>((secondsOfDay / 60) % 60),
+			static_cast<unsigned long long>(secondsOfDay % 60),
+			static_cast<unsigned long long>(milliseconds));
+
+		return buffer;
+	}
+
+	std::string FormatMicroseconds(uint64_t microseconds)
+	{
+		char buffer[64]{};
+
+		std::snprintf(
+			buffer,
+			sizeof(buffer),
+			"+%llu.%06llus",
+			static_cast<unsigned long long>(microseconds / 1000000),
+			static_cast<unsigned long long>(microseconds % 1000000));
+
+		return buffer;
+	}
+
+	std::string EscapeJsonString(std::string_view value)
+	{
+		std::string output;
+		output.reserve(value.size() + 2);
+
+		for (const char c : value)
+		{
+			switch (c)
+			{
+			case '"':
+				output.append("\\\"");
+				break;
+			case '\\':
+				output.append("\\\\");
+				break;
+			case '\n':
+				output.append("\\n");
+				break;
+			case '\r':
+				output.append("\\r");
+				break;
+			case '\t':
+				output.append("\\t");
+				break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20)
+				{
+					char buffer[8]{};
+					std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned int>(c));
+					output.append(buffer);
+				}
+				else
+				{
+					output.push_back(c);
+				}
+				break;
+			}
+		}
+
+		return output;
+	}
+
+	void WriteTextEvent(std::ostream& output, const BinaryLogFormat::Event& event, const std::string& message)
+	{
+		output << FormatSystemTime(event.systemTime) << ' '
+			   << FormatMicroseconds(event.microsecondsSinceLoad) << " ["
+			   << BinaryLogFormat::GetLogLevelName(event.level) << "] ["
+			   << GetLogCategoryName(static_cast<LogCategory>(event.category)) << "] "
+			   << message << '\n';
+	}
+
+	void WriteJsonEvent(
+		std::ostream& output,
+		const BinaryLogFormat::Event& event,
+		const std::string& format,
+		const std::string& message,
+		bool firstEvent)
+	{
+		output << (firstEvent ? "\n" : ",\n")
+			   << "  {\"time\": \"" << FormatSystemTime(event.systemTime) << '"'
+			   << ", \"microsecondsSinceLoad\": " << event.microsecondsSinceLoad
+			   << ", \"level\": \"" << BinaryLogFormat::GetLogLevelName(event.level) << '"'
+			   << ", \"category\": \"" << GetLogCategoryName(static_cast<LogCategory>(event.category)) << '"'
+			   << ", \"format\": \"" << EscapeJsonString(format) << '"'
+			   << ", \"message\": \"" << EscapeJsonString(message) << "\"}";
+	}
+
+	bool DecodeLog(const std::vector<uint8_t>& data, std::ostream& output, OutputFormat outputFormat)
+	{
+		BinaryLogFormat::Reader reader(data.data(), data.size());
+		uint32_t version = 0;
+
+		if (!reader.ReadFileHeader(version))
+		{
+			std::cerr << "The input file is not a binary log.\n";
+			return false;
+		}
+
+		if (version != BinaryLogFormat::kFileVersion)
+		{
+			std::cerr << "Unsupported binary log version " << version << ".\n";
+			return false;
+		}
+
+		BinaryLogFormat::Event event{};
+		BinaryLogFormat::ReadResult readResult = BinaryLogFormat::ReadResult::EndOfFile;
+		bool firstEvent = true;
+
+		if (outputFormat == OutputFormat::Json)
+		{
+			output << '[';
+		}
+
+		while ((readResult = reader.ReadEvent(event)) == BinaryLogFormat::ReadResult::Event)
+		{
+			if (!event.argumentsValid)
+			{
+				std::cerr << "Invalid argument data in the event at offset " << event.offset << ".\n";
+			}
+
+			if (!event.format)
+			{
+				std::cerr << "Unknown format string id " << event.formatStringID << ".\n";
+				continue;
+			}
+
+			const std::string message = BinaryLogFormat::FormatEventMessage(*event.format, event.arguments);
+
+			if (outputFormat == OutputFormat::Json)
+			{
+				WriteJsonEvent(output, event, *event.format, message, firstEvent);
+			}
+			else
+			{
+				WriteTextEvent(output, event, message);
+			}
+
+			firstEvent = false;
+		}
+
+		if (readResult == BinaryLogFormat::ReadResult::TruncatedRecord)
+		{
+			// A truncated record at the end of the file is expected if the game crashed.
+			std::cerr << "The binary log ends with a truncated record.\n";
+		}
+		else if (readResult == BinaryLogFormat::ReadResult::UnknownRecordType)
+		{
+			std::cerr << "Unknown record type " << static_cast<int>(data[reader.GetOffset()])
+					  << " at offset " << reader.GetOffset() << ".\n";
+		}
+
+		if (outputFormat == OutputFormat::Json)
+		{
+			output << "\n]\n";
+		}
+
+		return readResult != BinaryLogFormat::ReadResult::UnknownRecordType;
+	}
+
+	void PrintUsage()
+	{
+		std::cerr << "Usage: SC4GraphicsOptionsLogDecoder [--json] <input.blog> [output file]\n"
+				  << "The decoded log is written to standard output if no output file is specified.\n";
+	}
+}
+
+int main(int argc, char** argv)
+{
+	OutputFormat outputFormat = OutputFormat::Text;
+	std::vector<std::string> paths;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string_view argument = argv[i];
+
+		if (argument == "--json")
+		{
+			outputFormat = OutputFormat::Json;
+		}
+		else if (argument == "--text")
+		{
+			outputFormat = OutputFormat::Text;
+		}
+		else
+		{
+			paths.emplace_back(argument);
+		}
+	}
+
+	if (paths.empty() || paths.size() > 2)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	std::ifstream input(paths[0], std::ifstream::in | std::ifstream::binary);
+
+	if (!input)
+	{
+		std::cerr << "Failed to open " << paths[0] << ".\n";
+		return 1;
+	}
+
+	const std::vector<uint8_t> data{ std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>() };
+
+	bool result = false;
+
+	if (paths.size() == 2)
+	{
+		std::ofstream output(paths[1], std::ofstream::out | std::ofstream::trunc);
+
+		if (!output)
+		{
+			std::cerr << "Failed to create " << paths[1] << ".\n";
+			return 1;
+		}
+
+		result = DecodeLog(data, output, outputFormat);
+	}
+	else
+	{
+		result = DecodeLog(data, std::cout, outputFormat);
+	}
+
+	return result ? 0 : 1;
+}
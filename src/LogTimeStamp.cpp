@@ -0,0 +1,136 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "LogTimeStamp.h"
+#include "Platform.h"
+#include <charconv>
+#include <cstring>
+
+namespace
+{
+	constexpr uint64_t kSystemTimeTicksPerSecond = 10000000;
+
+	// These are initialized when the DLL is loaded.
+	const int64_t s_PerformanceCounterAtLoad = Platform::GetPerformanceCounter();
+	const int64_t s_PerformanceFrequency = Platform::GetPerformanceFrequency();
+}
+
+LogTimeStamp LogTimeStamp::Now()
+{
+	return LogTimeStamp(Platform::GetSystemTime(), Platform::GetPerformanceCounter());
+}
+
+LogTimeStamp::LogTimeStamp() : systemTime(0), performanceCounter(0)
+{
+}
+
+LogTimeStamp::LogTimeStamp(uint64_t systemTime, int64_t performanceCounter)
+	: systemTime(systemTime),
+	  performanceCounter(performanceCounter)
+{
+}
+
+uint64_t LogTimeStamp::GetMicrosecondsSinceLoad() const
+{
+	const int64_t elapsed = performanceCounter - s_PerformanceCounterAtLoad;
+
+	if (elapsed <= 0 || s_PerformanceFrequency <= 0)
+	{
+		return 0;
+	}
+
+	// Split the conversion to avoid overflowing the multiplication.
+	const uint64_t ticks = static_cast<uint64_t>(elapsed);
+	const uint64_t frequency = static_cast<uint64_t>(s_PerformanceFrequency);
+
+	const uint64_t seconds = ticks / frequency;
+	const uint64_t remainder = ticks % frequency;
+
+	return (seconds * 1000000) + ((remainder * 1000000) / frequency);
+}
+
+uint64_t LogTimeStamp::GetSystemTime() const
+{
+	return systemTime;
+}
+
+LogTimeStampFormatter::LogTimeStampFormatter()
+	: cachedSecond(UINT64_MAX),
+	  wallClockPrefixLength(0),
+	  buffer()
+{
+}
+
+const char* LogTimeStampFormatter::Format(const LogTimeStamp& timeStamp)
+{
+	const uint64_t systemTime = timeStamp.GetSystemTime();
+	const uint64_t second = systemTime / kSystemTimeTicksPerSecond;
+
+	if (second != cachedSecond)
+	{
+		RenderWallClockPrefix(systemTime);
+		cachedSecond = second;
+	}
+
+	const uint64_t microseconds = timeStamp.GetMicrosecondsSinceLoad();
+
+	// The suffix is at most 30 characters, the prefix length is limited to leave room for it.
+	char* const first = buffer + wallClockPrefixLength;
+	char* const last = buffer + sizeof(buffer) - 1;
+	char* position = first;
+
+	*position++ = '+';
+	position = std::to_chars(position, last, microseconds / 1000000).ptr;
+	*position++ = '.';
+
+	// Zero-pad the fractional part to 6 digits.
+	char fraction[8]{};
+	const char* const fractionEnd = std::to_chars(fraction, fraction + sizeof(fraction), microseconds % 1000000).ptr;
+	const size_t fractionLength = static_cast<size_t>(fractionEnd - fraction);
+
+	for (size_t i = fractionLength; i < 6; i++)
+	{
+		*position++ = '0';
+	}
+
+	std::memcpy(position, fraction, fractionLength);
+	position += fractionLength;
+
+	*position++ = 's';
+	*position++ = ' ';
+	*position = '\0';
+
+	return buffer;
+}
+
+void LogTimeStampFormatter::RenderWallClockPrefix(uint64_t systemTime)
+{
+	constexpr size_t kMaxPrefixLength = sizeof(buffer) - 32;
+
+	wallClockPrefixLength = Platform::FormatLocalTime(systemTime, buffer, kMaxPrefixLength);
+
+	// Add a space to the end of the time string if it does not have one.
+	if (wallClockPrefixLength > 0 && buffer[wallClockPrefixLength - 1] != ' ')
+	{
+		buffer[wallClockPrefixLength] = ' ';
+		wallClockPrefixLength++;
+	}
+}
@@ -0,0 +1,73 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// The time that a log line was written.
+// Capturing the time is cheap, the formatting is deferred to LogTimeStampFormatter
+// so that it can be performed on the logger's background writer thread.
+class LogTimeStamp
+{
+public:
+
+	LogTimeStamp();
+
+	static LogTimeStamp Now();
+
+	// Gets the number of microseconds between the DLL being loaded and this time stamp.
+	uint64_t GetMicrosecondsSinceLoad() const;
+
+	// Gets the system time in 100-nanosecond intervals since January 1, 1601 (UTC).
+	uint64_t GetSystemTime() const;
+
+private:
+
+	LogTimeStamp(uint64_t systemTime, int64_t performanceCounter);
+
+	uint64_t systemTime;
+	int64_t performanceCounter;
+};
+
+// Formats a LogTimeStamp as the local wall-clock time followed by the
+// offset since the DLL was loaded, e.g. "10:42:07 PM +1.204518s ".
+// The wall-clock prefix is cached and only re-rendered when the second changes.
+//
+// This class is not thread safe, each thread that formats time stamps
+// must use its own instance.
+class LogTimeStampFormatter
+{
+public:
+
+	LogTimeStampFormatter();
+
+	// Returns the formatted time stamp, the string is valid until the next call.
+	const char* Format(const LogTimeStamp& timeStamp);
+
+private:
+
+	void RenderWallClockPrefix(uint64_t systemTime);
+
+	uint64_t cachedSecond;
+	size_t wallClockPrefixLength;
+	char buffer[128];
+};
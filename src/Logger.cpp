@@ -20,46 +20,259 @@
  */
 
 #include "Logger.h"
-#include <Windows.h>
+#include "BoundedMPSCQueue.h"
+#include "LogTimeStamp.h"
+#include "Platform.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iterator>
+#include <thread>
 
 namespace
 {
-	std::string GetTimeStamp()
+#ifdef _DEBUG
+	void PrintLineToDebugOutput(const char* timeStamp, const char* line)
+	{
+		if (timeStamp)
+		{
+			Platform::WriteDebugOutput(timeStamp);
+		}
+
+		Platform::WriteDebugOutput(line);
+		Platform::WriteDebugOutput("\n");
+	}
+#endif // _DEBUG
+
+	// A fixed size buffer that counts the characters that did not fit.
+	struct FixedFormatBuffer
+	{
+		char* data;
+		size_t capacity;
+		size_t length;
+	};
+
+	// An output iterator that writes to a FixedFormatBuffer.
+	// The copies of the iterator share the buffer's length, formatting
+	// libraries write through copies, e.g. *out++ = value.
+	class FixedBufferOutputIterator
 	{
-		char buffer[1024]{};
+	public:
 
-		GetTimeFormatA(
-			LOCALE_USER_DEFAULT,
-			0,
-			nullptr,
-			nullptr,
-			buffer,
-			_countof(buffer));
+		using iterator_category = std::output_iterator_tag;
+		using value_type = void;
+		using difference_type = ptrdiff_t;
+		using pointer = void;
+		using reference = void;
 
-		std::string time(buffer);
+		explicit FixedBufferOutputIterator(FixedFormatBuffer& buffer) : buffer(&buffer)
+		{
+		}
 
-		// Add a space to the end of the time string if it doe not have one.
-		if (time.size() > 0 && time[time.size() - 1] != ' ')
+		FixedBufferOutputIterator& operator=(char value)
 		{
-			time.append(1, ' ');
+			if (buffer->length < buffer->capacity)
+			{
+				buffer->data[buffer->length] = value;
+			}
+
+			buffer->length++;
+			return *this;
 		}
 
-		return time;
+		FixedBufferOutputIterator& operator*()
+		{
+			return *this;
+		}
+
+		FixedBufferOutputIterator& operator++()
+		{
+			return *this;
+		}
+
+		FixedBufferOutputIterator operator++(int)
+		{
+			return *this;
+		}
+
+	private:
+
+		FixedFormatBuffer* buffer;
+	};
+}
+
+class Logger::AsyncWriter
+{
+public:
+
+	AsyncWriter(MappedLogFile& logFile, bool writeTimeStamp)
+		: logFile(logFile),
+		  writeTimeStamp(writeTimeStamp),
+		  timeStampFormatter(),
+		  queue(),
+		  droppedLineCount(0),
+		  reportedDroppedLineCount(0),
+		  wakeupCount(0),
+		  writerWaiting(false),
+		  stopRequested(false),
+		  writerThread()
+	{
+		writerThread = std::thread(&AsyncWriter::WriterThreadProc, this);
 	}
 
-#ifdef _DEBUG
-	void PrintLineToDebugOutput(const char* timeStamp, const char* line)
+	~AsyncWriter()
 	{
-		if (timeStamp)
+		Stop();
+	}
+
+	// Queues the line for the writer thread, this never blocks the caller.
+	// If the queue is full the line is dropped and counted, the writer thread
+	// reports the number of dropped lines the next time that it writes to the log.
+	void Enqueue(const char* const message, bool includeTimeStamp)
+	{
+		const bool queued = queue.TryPush([&](QueuedLine& line)
+		{
+			line.hasTimeStamp = includeTimeStamp && writeTimeStamp;
+
+			if (line.hasTimeStamp)
+			{
+				line.time = LogTimeStamp::Now();
+			}
+
+			// Lines that are longer than the queue entry are truncated.
+			const size_t length = std::min(std::strlen(message), kMaxLineLength);
+
+			std::memcpy(line.text, message, length);
+			line.text[length] = '\0';
+		});
+
+		if (queued)
+		{
+			WakeWriter();
+		}
+		else
+		{
+			droppedLineCount.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	// Writes any queued lines and waits for the writer thread to exit.
+	void Stop()
+	{
+		if (writerThread.joinable())
+		{
+			stopRequested.store(true, std::memory_order_release);
+			wakeupCount.fetch_add(1, std::memory_order_release);
+			wakeupCount.notify_one();
+
+			writerThread.join();
+		}
+	}
+
+private:
+
+	static constexpr size_t kQueueCapacity = 256;
+	static constexpr size_t kMaxLineLength = 511;
+
+	struct QueuedLine
+	{
+		LogTimeStamp time;
+		bool hasTimeStamp;
+		char text[kMaxLineLength + 1];
+	};
+
+	void WakeWriter()
+	{
+		// The fence pairs with the one in WriterThreadProc, it ensures that either the
+		// writer sees the line we just queued or we see that the writer is waiting.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		if (writerWaiting.load(std::memory_order_relaxed))
+		{
+			wakeupCount.fetch_add(1, std::memory_order_release);
+			wakeupCount.notify_one();
+		}
+	}
+
+	void WriterThreadProc()
+	{
+		while (true)
+		{
+			const uint32_t observedWakeupCount = wakeupCount.load(std::memory_order_acquire);
+
+			WriteQueuedLines();
+
+			if (stopRequested.load(std::memory_order_acquire))
+			{
+				// Lines may have been queued after the last batch was written.
+				WriteQueuedLines();
+				break;
+			}
+
+			writerWaiting.store(true, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			if (queue.IsEmpty())
+			{
+				wakeupCount.wait(observedWakeupCount, std::memory_order_acquire);
+			}
+
+			writerWaiting.store(false, std::memory_order_relaxed);
+		}
+	}
+
+	void WriteQueuedLines()
+	{
+		while (queue.TryPop([this](const QueuedLine& line) { WriteLine(line); }))
 		{
-			OutputDebugStringA(timeStamp);
 		}
 
-		OutputDebugStringA(line);
-		OutputDebugStringA("\n");
+		const uint32_t droppedLines = droppedLineCount.load(std::memory_order_relaxed);
+
+		if (droppedLines != reportedDroppedLineCount)
+		{
+			const std::string message = std::format(
+				"Dropped {} log line(s), the log queue was full.",
+				droppedLines - reportedDroppedLineCount);
+
+			logFile.WriteLine({}, message);
+			reportedDroppedLineCount = droppedLines;
+		}
 	}
+
+	void WriteLine(const QueuedLine& line)
+	{
+		if (line.hasTimeStamp)
+		{
+			const char* const timeStamp = timeStampFormatter.Format(line.time);
+
+#ifdef _DEBUG
+			PrintLineToDebugOutput(timeStamp, line.text);
 #endif // _DEBUG
-}
+
+			logFile.WriteLine(timeStamp, line.text);
+		}
+		else
+		{
+#ifdef _DEBUG
+			PrintLineToDebugOutput(nullptr, line.text);
+#endif // _DEBUG
+
+			logFile.WriteLine({}, line.text);
+		}
+	}
+
+	MappedLogFile& logFile;
+	const bool writeTimeStamp;
+	LogTimeStampFormatter timeStampFormatter;
+	BoundedMPSCQueue<QueuedLine, kQueueCapacity> queue;
+	std::atomic<uint32_t> droppedLineCount;
+	uint32_t reportedDroppedLineCount;
+	std::atomic<uint32_t> wakeupCount;
+	std::atomic<bool> writerWaiting;
+	std::atomic<bool> stopRequested;
+	std::thread writerThread;
+};
 
 Logger& Logger::GetInstance()
 {
@@ -71,95 +284,177 @@ Logger& Logger::GetInstance()
 Logger::Logger()
 	: initialized(false),
 	  writeTimeStamp(true),
+	  categoryLogLevels(),
 	  logFile(),
-	  logLevel(LogLevel::Error)
+	  timeStampFormatter(),
+	  asyncWriter(),
+	  binaryLog()
 {
 }
 
 Logger::~Logger()
 {
-	initialized = false;
+	Shutdown();
 }
 
-void Logger::Init(std::filesystem::path logFilePath, LogLevel level, bool includeTimeStamp)
+void Logger::Init(
+	std::filesystem::path logFilePath,
+	LogLevel level,
+	bool includeTimeStamp,
+	LogWriteMode writeMode,
+	size_t maxLogFileSize,
+	uint32_t logFileHistoryCount)
 {
-	if (!initialized)
+	if (!initialized.load(std::memory_order_acquire))
 	{
-		initialized = true;
+		logFile.Open(logFilePath, maxLogFileSize, logFileHistoryCount);
+		for (std::atomic<LogLevel>& categoryLogLevel : categoryLogLevels)
+		{
+			categoryLogLevel.store(level, std::memory_order_relaxed);
+		}
 
-		logFile.open(logFilePath, std::ofstream::out | std::ofstream::trunc);
-		logLevel = level;
 		writeTimeStamp = includeTimeStamp;
+
+		// The writers from a previous Init call were stopped by Shutdown.
+		asyncWriter.reset();
+		binaryLog.reset();
+
+		if (logFile.IsOpen() && writeMode == LogWriteMode::Asynchronous)
+		{
+			asyncWriter = std::make_unique<AsyncWriter>(logFile, includeTimeStamp);
+		}
+
+		// The log file and writer must be set up before other threads can see that the logger is initialized.
+		initialized.store(true, std::memory_order_release);
 	}
 }
 
-bool Logger::IsEnabled(LogLevel level) const
+void Logger::EnableBinaryLog(const std::filesystem::path& binaryLogFilePath)
 {
-	return logLevel >= level;
+	if (initialized.load(std::memory_order_acquire) && !binaryLog)
+	{
+		auto writer = std::make_unique<BinaryLogWriter>(binaryLogFilePath);
+
+		if (writer->IsOpen())
+		{
+			WriteLineFormatted(
+				LogCategory::General,
+				LogLevel::Info,
+				"Writing the log messages to {}.",
+				binaryLogFilePath.filename().string());
+			binaryLog = std::move(writer);
+		}
+		else
+		{
+			WriteLineFormatted(
+				LogCategory::General,
+				LogLevel::Error,
+				"Failed to create the binary log file {}.",
+				binaryLogFilePath.filename().string());
+		}
+	}
 }
 
-void Logger::WriteLogFileHeader(const char* const text)
+void Logger::Shutdown()
 {
-	if (initialized && logFile)
+	if (initialized.exchange(false, std::memory_order_acq_rel))
 	{
-		logFile << text << std::endl;
+		if (asyncWriter)
+		{
+			asyncWriter->Stop();
+		}
+
+		if (binaryLog)
+		{
+			binaryLog->Flush();
+		}
+
+		logFile.Close();
 	}
 }
 
-void Logger::WriteLine(LogLevel level, const char* const message)
+void Logger::SetLogLevel(LogCategory category, LogLevel level)
+{
+	categoryLogLevels[static_cast<size_t>(category)].store(level, std::memory_order_relaxed);
+}
+
+void Logger::WriteLogFileHeader(const char* const text)
 {
-	if (!IsEnabled(level))
+	if (initialized.load(std::memory_order_acquire) && logFile.IsOpen())
 	{
-		return;
+		if (asyncWriter)
+		{
+			asyncWriter->Enqueue(text, false);
+		}
+		else
+		{
+			logFile.WriteLine({}, text);
+		}
 	}
-
-	WriteLineCore(message);
 }
 
-void Logger::WriteLineFormatted(LogLevel level, const char* const format, ...)
+void Logger::WriteLine(LogCategory category, LogLevel level, const char* const message)
 {
-	if (!IsEnabled(level))
+	if (!IsEnabled(category, level))
 	{
 		return;
 	}
 
-	va_list args;
-	va_start(args, format);
+	if (binaryLog)
+	{
+		binaryLog->Write(category, level, "{}", message);
+	}
+	else
+	{
+		WriteLineCore(message);
+	}
 
-	va_list argsCopy;
-	va_copy(argsCopy, args);
+	if (level == LogLevel::Error)
+	{
+		FlightRecorder::GetInstance().RequestErrorDump();
+	}
+}
 
-	int formattedStringLength = std::vsnprintf(nullptr, 0, format, argsCopy);
+void Logger::WriteLineFormattedCore(std::string_view format, std::format_args args)
+{
+	// Most lines fit in the stack buffer, longer lines fall back to
+	// formatting into a heap-allocated string.
+	char buffer[1024];
+	FixedFormatBuffer formatBuffer{ buffer, sizeof(buffer) - 1, 0 };
 
-	va_end(argsCopy);
+	std::vformat_to(FixedBufferOutputIterator(formatBuffer), format, args);
 
-	if (formattedStringLength > 0)
+	if (formatBuffer.length < sizeof(buffer))
 	{
-		size_t formattedStringLengthWithNull = static_cast<size_t>(formattedStringLength) + 1;
-
-		std::unique_ptr<char[]> buffer = std::make_unique_for_overwrite<char[]>(formattedStringLengthWithNull);
-
-		std::vsnprintf(buffer.get(), formattedStringLengthWithNull, format, args);
+		buffer[formatBuffer.length] = '\0';
 
-		WriteLineCore(buffer.get());
+		WriteLineCore(buffer);
 	}
+	else
+	{
+		const std::string line = std::vformat(format, args);
 
-	va_end(args);
+		WriteLineCore(line.c_str());
+	}
 }
 
 void Logger::WriteLineCore(const char* const message)
 {
-	if (initialized && logFile)
+	if (initialized.load(std::memory_order_acquire) && logFile.IsOpen())
 	{
-		if (writeTimeStamp)
+		if (asyncWriter)
+		{
+			asyncWriter->Enqueue(message, true);
+		}
+		else if (writeTimeStamp)
 		{
-			std::string timeStamp = GetTimeStamp();
+			const char* const timeStamp = timeStampFormatter.Format(LogTimeStamp::Now());
 
 #ifdef _DEBUG
-			PrintLineToDebugOutput(timeStamp.c_str(), message);
+			PrintLineToDebugOutput(timeStamp, message);
 #endif // _DEBUG
 
-			logFile << timeStamp << message << std::endl;
+			logFile.WriteLine(timeStamp, message);
 		}
 		else
 		{
@@ -167,7 +462,7 @@ void Logger::WriteLineCore(const char* const message)
 			PrintLineToDebugOutput(nullptr, message);
 #endif // _DEBUG
 
-			logFile << message << std::endl;
+			logFile.WriteLine({}, message);
 
 		}
 	}
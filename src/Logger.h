@@ -20,43 +20,147 @@
  */
 
 #pragma once
+#include "BinaryLogWriter.h"
+#include "FlightRecorder.h"
+#include "LogCategory.h"
+#include "LogLevel.h"
+#include "LogTimeStamp.h"
+#include "MappedLogFile.h"
 #include <filesystem>
-#include <fstream>
+#include <format>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string_view>
 
-enum class LogLevel : int32_t
+enum class LogWriteMode : int32_t
 {
-	Info = 0,
-	Error = 1,
-	Debug = 2,
-	Trace = 3
+	// The log lines are written to the file on the calling thread.
+	Synchronous = 0,
+	// The log lines are queued and written to the file by a background thread.
+	// Lines that do not fit in the queue are dropped and counted.
+	Asynchronous = 1
 };
 
+// The most verbose log level that is compiled into the plugin.
+// The LOG_DEBUG and LOG_TRACE calls for levels above this compile to nothing,
+// and their arguments are not evaluated.
+// Release builds include the Debug level so that those events are available
+// to the flight recorder.
+#ifdef _DEBUG
+constexpr LogLevel kMaxCompiledLogLevel = LogLevel::Trace;
+#else
+constexpr LogLevel kMaxCompiledLogLevel = LogLevel::Debug;
+#endif // _DEBUG
+
+#define LOG_DEBUG(category, ...) LOG_AT_LEVEL(category, LogLevel::Debug, __VA_ARGS__)
+#define LOG_TRACE(category, ...) LOG_AT_LEVEL(category, LogLevel::Trace, __VA_ARGS__)
+
+#define LOG_AT_LEVEL(category, level, ...)										\
+	do																			\
+	{																			\
+		if constexpr (kMaxCompiledLogLevel >= (level))							\
+		{																		\
+			Logger::GetInstance().RecordLineFormatted((category), (level), __VA_ARGS__); \
+		}																		\
+	} while (false)
+
 class Logger
 {
 public:
 
 	static Logger& GetInstance();
 
-	void Init(std::filesystem::path logFilePath, LogLevel logLevel, bool includeTimeStamp = true);
+	void Init(
+		std::filesystem::path logFilePath,
+		LogLevel logLevel,
+		bool includeTimeStamp = true,
+		LogWriteMode writeMode = LogWriteMode::Synchronous,
+		size_t maxLogFileSize = 1024 * 1024,
+		uint32_t logFileHistoryCount = 2);
+
+	// Writes the subsequent log lines to a binary log file instead of the text log.
+	// The binary log stores the format string and the raw argument values, it can be
+	// converted back to text with the log decoder tool.
+	void EnableBinaryLog(const std::filesystem::path& binaryLogFilePath);
+
+	// Writes any queued lines to the log file and stops the background writer thread.
+	// This must be called before the DLL is unloaded when using LogWriteMode::Asynchronous,
+	// the writer thread cannot be joined from the DLL's static destructors.
+	void Shutdown();
+
+	// Sets the log level of the specified category, Init sets all categories to its log level.
+	// The log level can be changed while other threads are logging.
+	void SetLogLevel(LogCategory category, LogLevel level);
 
-	bool IsEnabled(LogLevel option) const;
+	bool IsEnabled(LogCategory category, LogLevel level) const
+	{
+		return level <= kMaxCompiledLogLevel
+			&& categoryLogLevels[static_cast<size_t>(category)].load(std::memory_order_relaxed) >= level;
+	}
 
 	void WriteLogFileHeader(const char* const message);
 
-	void WriteLine(LogLevel level, const char* const message);
+	void WriteLine(LogCategory category, LogLevel level, const char* const message);
 
-	void WriteLineFormatted(LogLevel level, const char* const format, ...);
+	// Writes a line using a std::format format string, which is checked at compile time.
+	template <typename... Args>
+	void WriteLineFormatted(
+		LogCategory category,
+		LogLevel level,
+		std::format_string<Args...> format,
+		Args&&... args)
+	{
+		if (IsEnabled(category, level))
+		{
+			if (binaryLog)
+			{
+				binaryLog->Write(category, level, format.get(), args...);
+			}
+			else
+			{
+				WriteLineFormattedCore(format.get(), std::make_format_args(args...));
+			}
+
+			if (level == LogLevel::Error)
+			{
+				FlightRecorder::GetInstance().RequestErrorDump();
+			}
+		}
+	}
+
+	// Records the line in the flight recorder, and writes it to the log if the level is enabled.
+	// This is used by the LOG_DEBUG and LOG_TRACE macros.
+	template <typename... Args>
+	void RecordLineFormatted(
+		LogCategory category,
+		LogLevel level,
+		std::format_string<Args...> format,
+		Args&&... args)
+	{
+		FlightRecorder::GetInstance().Record(category, level, format.get(), args...);
+
+		WriteLineFormatted(category, level, format, std::forward<Args>(args)...);
+	}
 
 private:
 
 	Logger();
 	~Logger();
 
+	class AsyncWriter;
+
+	void WriteLineFormattedCore(std::string_view format, std::format_args args);
+
 	void WriteLineCore(const char* const message);
 
-	bool initialized;
+	// Read by the threads that write to the log while Init and Shutdown change it.
+	std::atomic<bool> initialized;
 	bool writeTimeStamp;
-	LogLevel logLevel;
-	std::ofstream logFile;
+	std::array<std::atomic<LogLevel>, kLogCategoryCount> categoryLogLevels;
+	MappedLogFile logFile;
+	LogTimeStampFormatter timeStampFormatter;
+	std::unique_ptr<AsyncWriter> asyncWriter;
+	std::unique_ptr<BinaryLogWriter> binaryLog;
 };
 
@@ -0,0 +1,248 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "MappedLogFile.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace
+{
+	constexpr std::string_view kNewLine = "\r\n";
+	constexpr size_t kMinimumFileSize = 64 * 1024;
+
+	std::filesystem::path GetHistoryFilePath(const std::filesystem::path& path, uint32_t index)
+	{
+		std::filesystem::path historyPath = path.parent_path();
+
+		std::wstring fileName = path.stem().wstring();
+		fileName.append(L".");
+		fileName.append(std::to_wstring(index));
+		fileName.append(path.extension().wstring());
+
+		historyPath /= fileName;
+
+		return historyPath;
+	}
+
+	// A log segment that was not closed properly (e.g. because the game crashed) is
+	// still at its preallocated size, with the unused space filled with zeros.
+	// This trims the zeros and notes that the log is incomplete.
+	void RecoverUnclosedLogFile(const std::filesystem::path& path)
+	{
+		std::error_code ec;
+
+		const uintmax_t fileSize = std::filesystem::file_size(path, ec);
+
+		if (ec || fileSize == 0)
+		{
+			return;
+		}
+
+		uintmax_t dataEnd = fileSize;
+
+		{
+			std::ifstream stream(path, std::ifstream::in | std::ifstream::binary);
+
+			if (!stream)
+			{
+				return;
+			}
+
+			std::vector<char> buffer(64 * 1024);
+			bool foundData = false;
+
+			// Scan backwards for the last non-zero byte.
+			while (dataEnd > 0 && !foundData)
+			{
+				const uintmax_t chunkSize = std::min<uintmax_t>(dataEnd, buffer.size());
+				const uintmax_t chunkStart = dataEnd - chunkSize;
+
+				stream.seekg(static_cast<std::streamoff>(chunkStart));
+
+				if (!stream.read(buffer.data(), static_cast<std::streamsize>(chunkSize)))
+				{
+					break;
+				}
+
+				for (size_t i = static_cast<size_t>(chunkSize); i > 0; i--)
+				{
+					if (buffer[i - 1] != '\0')
+					{
+						dataEnd = chunkStart + i;
+						foundData = true;
+						break;
+					}
+				}
+
+				if (!foundData)
+				{
+					dataEnd = chunkStart;
+				}
+			}
+		}
+
+		if (dataEnd < fileSize)
+		{
+			std::filesystem::resize_file(path, dataEnd, ec);
+
+			if (!ec)
+			{
+				std::ofstream stream(path, std::ofstream::out | std::ofstream::binary | std::ofstream::app);
+
+				stream << "\r\n[The log was not closed, the game may have crashed.]\r\n";
+			}
+		}
+	}
+
+	void RotateLogFiles(const std::filesystem::path& path, uint32_t historyCount)
+	{
+		std::error_code ec;
+
+		if (!std::filesystem::exists(path, ec))
+		{
+			return;
+		}
+
+		RecoverUnclosedLogFile(path);
+
+		if (historyCount == 0)
+		{
+			std::filesystem::remove(path, ec);
+			return;
+		}
+
+		std::filesystem::remove(GetHistoryFilePath(path, historyCount), ec);
+
+		for (uint32_t i = historyCount - 1; i >= 1; i--)
+		{
+			const std::filesystem::path source = GetHistoryFilePath(path, i);
+
+			if (std::filesystem::exists(source, ec))
+			{
+				std::filesystem::rename(source, GetHistoryFilePath(path, i + 1), ec);
+			}
+		}
+
+		std::filesystem::rename(path, GetHistoryFilePath(path, 1), ec);
+	}
+}
+
+MappedLogFile::MappedLogFile()
+	: path(),
+	  maxFileSize(0),
+	  historyCount(0),
+	  file(),
+	  view(nullptr),
+	  writeOffset(0)
+{
+}
+
+MappedLogFile::~MappedLogFile()
+{
+	Close();
+}
+
+bool MappedLogFile::Open(const std::filesystem::path& logFilePath, size_t maxLogFileSize, uint32_t logFileHistoryCount)
+{
+	Close();
+
+	path = logFilePath;
+	maxFileSize = std::max(maxLogFileSize, kMinimumFileSize);
+	historyCount = logFileHistoryCount;
+
+	return OpenSegment();
+}
+
+bool MappedLogFile::IsOpen() const
+{
+	return view != nullptr;
+}
+
+void MappedLogFile::WriteLine(std::string_view prefix, std::string_view text)
+{
+	if (!view)
+	{
+		return;
+	}
+
+	const size_t lineLength = prefix.size() + text.size() + kNewLine.size();
+
+	if ((writeOffset + lineLength) > maxFileSize && writeOffset > 0)
+	{
+		// Start a new segment, the current segment becomes <name>.1<ext>.
+		CloseSegment();
+
+		if (!OpenSegment())
+		{
+			return;
+		}
+	}
+
+	const size_t available = maxFileSize - writeOffset - kNewLine.size();
+
+	const size_t prefixLength = std::min(prefix.size(), available);
+	const size_t textLength = std::min(text.size(), available - prefixLength);
+
+	std::memcpy(view + writeOffset, prefix.data(), prefixLength);
+	writeOffset += prefixLength;
+
+	std::memcpy(view + writeOffset, text.data(), textLength);
+	writeOffset += textLength;
+
+	std::memcpy(view + writeOffset, kNewLine.data(), kNewLine.size());
+	writeOffset += kNewLine.size();
+}
+
+void MappedLogFile::Close()
+{
+	CloseSegment();
+}
+
+bool MappedLogFile::OpenSegment()
+{
+	RotateLogFiles(path, historyCount);
+
+	if (!file.Create(path, maxFileSize))
+	{
+		return false;
+	}
+
+	view = file.GetData();
+	writeOffset = 0;
+
+	return true;
+}
+
+void MappedLogFile::CloseSegment()
+{
+	if (view)
+	{
+		// Trim the unused part of the preallocated segment.
+		file.Close(writeOffset);
+		view = nullptr;
+	}
+
+	writeOffset = 0;
+}
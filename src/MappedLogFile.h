@@ -0,0 +1,72 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include "Platform.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+// A text log file that is written through a memory-mapped view of a
+// preallocated file segment.
+//
+// Writing a line is a memcpy into the mapping, the data is visible to the OS
+// immediately, so it is not lost if the game crashes.
+// When a segment is full the file is closed and rotated, and a new segment is started.
+// The previous log files are kept as <name>.1<ext> through <name>.N<ext>, where 1 is the newest.
+//
+// This class is not thread safe.
+class MappedLogFile
+{
+public:
+
+	MappedLogFile();
+	~MappedLogFile();
+
+	MappedLogFile(const MappedLogFile&) = delete;
+	MappedLogFile& operator=(const MappedLogFile&) = delete;
+
+	// Rotates the existing log files and creates a new log file segment.
+	bool Open(const std::filesystem::path& path, size_t maxFileSize, uint32_t historyCount);
+
+	bool IsOpen() const;
+
+	// Writes the prefix and text followed by a new line.
+	// A line is never split across two segments, lines that are larger than
+	// a segment are truncated.
+	void WriteLine(std::string_view prefix, std::string_view text);
+
+	// Closes the log file and trims it to the length of the data that was written.
+	void Close();
+
+private:
+
+	bool OpenSegment();
+	void CloseSegment();
+
+	std::filesystem::path path;
+	size_t maxFileSize;
+	uint32_t historyCount;
+	Platform::MappedFile file;
+	char* view;
+	size_t writeOffset;
+};
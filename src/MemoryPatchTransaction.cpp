@@ -0,0 +1,362 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "MemoryPatchTransaction.h"
+#include "Platform.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+	struct ProtectedPageRange
+	{
+		MemoryPageRange range;
+		uint32_t oldProtection;
+	};
+
+	struct WrittenPatch
+	{
+		const MemoryPatch* patch;
+		std::vector<uint8_t> originalBytes;
+	};
+
+	bool ContainsReplacementBytes(const MemoryPatch& patch)
+	{
+		return std::memcmp(
+			reinterpret_cast<const void*>(patch.address),
+			patch.replacementBytes.data(),
+			patch.replacementBytes.size()) == 0;
+	}
+
+	void Rollback(
+		IMemoryPatchTarget& target,
+		const std::vector<WrittenPatch>& writtenPatches,
+		const std::vector<ProtectedPageRange>& protectedRanges)
+	{
+		for (auto it = writtenPatches.rbegin(); it != writtenPatches.rend(); ++it)
+		{
+			std::memcpy(
+				reinterpret_cast<void*>(it->patch->address),
+				it->originalBytes.data(),
+				it->originalBytes.size());
+		}
+
+		for (const ProtectedPageRange& item : protectedRanges)
+		{
+			target.RestoreProtection(item.range, item.oldProtection);
+
+			if (!writtenPatches.empty())
+			{
+				target.FlushInstructionCache(item.range);
+			}
+		}
+	}
+
+	// The patches must be sorted by address.
+	bool PlanSortedPageRanges(
+		const std::vector<const MemoryPatch*>& sortedPatches,
+		const IMemoryPatchTarget& target,
+		std::vector<MemoryPageRange>& pageRanges)
+	{
+		const size_t pageSize = target.GetPageSize();
+
+		if (pageSize == 0 || (pageSize & (pageSize - 1)) != 0)
+		{
+			throw std::invalid_argument("The page size must be a power of 2.");
+		}
+
+		pageRanges.clear();
+
+		const uintptr_t pageMask = ~(static_cast<uintptr_t>(pageSize) - 1);
+
+		for (const MemoryPatch* patch : sortedPatches)
+		{
+			uintptr_t start = patch->address & pageMask;
+			const uintptr_t end = ((patch->address + patch->replacementBytes.size() - 1) & pageMask) + pageSize;
+
+			while (start < end)
+			{
+				if (!pageRanges.empty())
+				{
+					const MemoryPageRange& last = pageRanges.back();
+					const uintptr_t lastEnd = last.address + last.size;
+
+					// The pages are already in the previous range.
+					if (start < lastEnd)
+					{
+						start = lastEnd;
+						continue;
+					}
+				}
+
+				uint32_t protection = 0;
+				uintptr_t regionEnd = 0;
+
+				if (!target.QueryProtection(start, protection, regionEnd))
+				{
+					return false;
+				}
+
+				// The pages up to the end of the region, or the end of the patch, have the same protection.
+				const uintptr_t alignedRegionEnd = (regionEnd + pageSize - 1) & pageMask;
+				const uintptr_t segmentEnd = std::min(end, std::max(alignedRegionEnd, start + pageSize));
+
+				if (!pageRanges.empty())
+				{
+					MemoryPageRange& last = pageRanges.back();
+
+					if (last.address + last.size == start && last.protection == protection)
+					{
+						last.size = static_cast<size_t>(segmentEnd - last.address);
+						start = segmentEnd;
+						continue;
+					}
+				}
+
+				pageRanges.push_back(MemoryPageRange{ start, static_cast<size_t>(segmentEnd - start), protection });
+				start = segmentEnd;
+			}
+		}
+
+		return true;
+	}
+
+	MemoryPatchResult MakeResult(MemoryPatchStatus status, const MemoryPatch* failedPatch, int64_t startTime)
+	{
+		return MemoryPatchResult
+		{
+			status,
+			failedPatch ? failedPatch->name : std::string(),
+			0,
+			0,
+			0,
+			Platform::GetPerformanceCounter() - startTime
+		};
+	}
+}
+
+size_t ProcessMemoryPatchTarget::GetPageSize() const
+{
+	return Platform::GetMemoryPageSize();
+}
+
+bool ProcessMemoryPatchTarget::QueryProtection(uintptr_t address, uint32_t& protection, uintptr_t& regionEnd) const
+{
+	return Platform::QueryMemoryProtection(address, protection, regionEnd);
+}
+
+bool ProcessMemoryPatchTarget::MakeWritable(const MemoryPageRange& range, uint32_t& oldProtection)
+{
+	return Platform::MakeMemoryWritable(range.address, range.size, oldProtection);
+}
+
+bool ProcessMemoryPatchTarget::RestoreProtection(const MemoryPageRange& range, uint32_t oldProtection)
+{
+	return Platform::RestoreMemoryProtection(range.address, range.size, oldProtection);
+}
+
+void ProcessMemoryPatchTarget::FlushInstructionCache(const MemoryPageRange& range)
+{
+	Platform::FlushInstructionCache(range.address, range.size);
+}
+
+const char* GetMemoryPatchStatusDescription(MemoryPatchStatus status)
+{
+	switch (status)
+	{
+	case MemoryPatchStatus::Succeeded:
+		return "succeeded";
+	case MemoryPatchStatus::OverlappingPatches:
+		return "the patch overlaps another patch";
+	case MemoryPatchStatus::VerificationFailed:
+		return "the memory does not contain the expected bytes";
+	case MemoryPatchStatus::ProtectionFailed:
+		return "the memory protection could not be changed";
+	default:
+		return "unknown error";
+	}
+}
+
+MemoryPatchTransaction::MemoryPatchTransaction() : patches()
+{
+}
+
+void MemoryPatchTransaction::Add(
+	std::string_view name,
+	uintptr_t address,
+	std::string_view expectedBytes,
+	std::string_view replacementBytes)
+{
+	BytePattern expected(expectedBytes);
+	const BytePattern replacement(replacementBytes);
+
+	if (replacement.HasWildcards())
+	{
+		throw std::invalid_argument("The replacement bytes cannot contain wildcards.");
+	}
+
+	if (replacement.GetLength() != expected.GetLength())
+	{
+		throw std::invalid_argument("The replacement bytes must be the same length as the expected bytes.");
+	}
+
+	std::vector<uint8_t> bytes(replacement.GetLength());
+
+	for (size_t i = 0; i < bytes.size(); i++)
+	{
+		bytes[i] = replacement.GetByte(i);
+	}
+
+	patches.push_back(MemoryPatch{ std::string(name), address, std::move(expected), std::move(bytes) });
+}
+
+bool MemoryPatchTransaction::IsEmpty() const
+{
+	return patches.empty();
+}
+
+size_t MemoryPatchTransaction::GetPatchCount() const
+{
+	return patches.size();
+}
+
+bool MemoryPatchTransaction::PlanPageRanges(const IMemoryPatchTarget& target, std::vector<MemoryPageRange>& pageRanges) const
+{
+	std::vector<const MemoryPatch*> sortedPatches;
+	sortedPatches.reserve(patches.size());
+
+	for (const MemoryPatch& patch : patches)
+	{
+		sortedPatches.push_back(&patch);
+	}
+
+	std::sort(
+		sortedPatches.begin(),
+		sortedPatches.end(),
+		[](const MemoryPatch* lhs, const MemoryPatch* rhs) { return lhs->address < rhs->address; });
+
+	return PlanSortedPageRanges(sortedPatches, target, pageRanges);
+}
+
+MemoryPatchResult MemoryPatchTransaction::Commit(IMemoryPatchTarget& target)
+{
+	const int64_t startTime = Platform::GetPerformanceCounter();
+
+	std::vector<MemoryPatch> pendingPatches;
+	pendingPatches.swap(patches);
+
+	std::sort(
+		pendingPatches.begin(),
+		pendingPatches.end(),
+		[](const MemoryPatch& lhs, const MemoryPatch& rhs) { return lhs.address < rhs.address; });
+
+	// Verify all of the patches before any memory is modified.
+
+	std::vector<const MemoryPatch*> patchesToWrite;
+	size_t alreadyAppliedCount = 0;
+
+	for (size_t i = 0; i < pendingPatches.size(); i++)
+	{
+		const MemoryPatch& patch = pendingPatches[i];
+
+		if (i > 0)
+		{
+			const MemoryPatch& previous = pendingPatches[i - 1];
+
+			if (patch.address < previous.address + previous.replacementBytes.size())
+			{
+				return MakeResult(MemoryPatchStatus::OverlappingPatches, &patch, startTime);
+			}
+		}
+
+		if (ContainsReplacementBytes(patch))
+		{
+			alreadyAppliedCount++;
+		}
+		else if (patch.expectedBytes.Matches(reinterpret_cast<const uint8_t*>(patch.address)))
+		{
+			patchesToWrite.push_back(&patch);
+		}
+		else
+		{
+			return MakeResult(MemoryPatchStatus::VerificationFailed, &patch, startTime);
+		}
+	}
+
+	std::vector<MemoryPageRange> pageRanges;
+
+	if (!PlanSortedPageRanges(patchesToWrite, target, pageRanges))
+	{
+		return MakeResult(MemoryPatchStatus::ProtectionFailed, nullptr, startTime);
+	}
+
+	std::vector<ProtectedPageRange> protectedRanges;
+	protectedRanges.reserve(pageRanges.size());
+
+	for (const MemoryPageRange& range : pageRanges)
+	{
+		uint32_t oldProtection = 0;
+
+		if (!target.MakeWritable(range, oldProtection))
+		{
+			Rollback(target, {}, protectedRanges);
+			return MakeResult(MemoryPatchStatus::ProtectionFailed, nullptr, startTime);
+		}
+
+		protectedRanges.push_back(ProtectedPageRange{ range, oldProtection });
+	}
+
+	std::vector<WrittenPatch> writtenPatches;
+	writtenPatches.reserve(patchesToWrite.size());
+
+	for (const MemoryPatch* patch : patchesToWrite)
+	{
+		void* const destination = reinterpret_cast<void*>(patch->address);
+		const size_t size = patch->replacementBytes.size();
+
+		WrittenPatch& writtenPatch = writtenPatches.emplace_back(WrittenPatch{ patch, std::vector<uint8_t>(size) });
+		std::memcpy(writtenPatch.originalBytes.data(), destination, size);
+		std::memcpy(destination, patch->replacementBytes.data(), size);
+
+		if (!ContainsReplacementBytes(*patch))
+		{
+			Rollback(target, writtenPatches, protectedRanges);
+			return MakeResult(MemoryPatchStatus::VerificationFailed, patch, startTime);
+		}
+	}
+
+	for (const ProtectedPageRange& item : protectedRanges)
+	{
+		target.RestoreProtection(item.range, item.oldProtection);
+		target.FlushInstructionCache(item.range);
+	}
+
+	return MemoryPatchResult
+	{
+		MemoryPatchStatus::Succeeded,
+		std::string(),
+		patchesToWrite.size(),
+		alreadyAppliedCount,
+		pageRanges.size(),
+		Platform::GetPerformanceCounter() - startTime
+	};
+}
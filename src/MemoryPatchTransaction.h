@@ -0,0 +1,147 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include "SignatureScanner.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct MemoryPatch
+{
+	std::string name;
+	uintptr_t address;
+	// The bytes that must be present before the patch is applied, may contain wildcards.
+	BytePattern expectedBytes;
+	std::vector<uint8_t> replacementBytes;
+};
+
+// A range of whole memory pages, the unit that the memory protection is changed for.
+// All of the pages in the range have the same protection.
+struct MemoryPageRange
+{
+	uintptr_t address;
+	size_t size;
+	uint32_t protection;
+};
+
+// The memory protection operations that a patch transaction uses.
+// The patched memory is read and written directly, so a transaction can be
+// committed to a plain buffer.
+class IMemoryPatchTarget
+{
+public:
+
+	virtual ~IMemoryPatchTarget() = default;
+
+	virtual size_t GetPageSize() const = 0;
+
+	// Gets the protection of the page that contains the address, and the end of the region
+	// of pages after it that have the same protection.
+	virtual bool QueryProtection(uintptr_t address, uint32_t& protection, uintptr_t& regionEnd) const = 0;
+
+	virtual bool MakeWritable(const MemoryPageRange& range, uint32_t& oldProtection) = 0;
+
+	virtual bool RestoreProtection(const MemoryPageRange& range, uint32_t oldProtection) = 0;
+
+	virtual void FlushInstructionCache(const MemoryPageRange& range) = 0;
+};
+
+// Patches the memory of the current process using the Platform functions.
+class ProcessMemoryPatchTarget final : public IMemoryPatchTarget
+{
+public:
+
+	size_t GetPageSize() const override;
+
+	bool QueryProtection(uintptr_t address, uint32_t& protection, uintptr_t& regionEnd) const override;
+
+	bool MakeWritable(const MemoryPageRange& range, uint32_t& oldProtection) override;
+
+	bool RestoreProtection(const MemoryPageRange& range, uint32_t oldProtection) override;
+
+	void FlushInstructionCache(const MemoryPageRange& range) override;
+};
+
+enum class MemoryPatchStatus : int32_t
+{
+	Succeeded = 0,
+	// Two patches modify the same bytes.
+	OverlappingPatches,
+	// The memory did not contain the expected bytes, or did not contain the
+	// replacement bytes after it was written.
+	VerificationFailed,
+	// The memory protection could not be changed.
+	ProtectionFailed
+};
+
+struct MemoryPatchResult
+{
+	MemoryPatchStatus status;
+	// The patch that caused the transaction to fail, empty on success.
+	std::string failedPatchName;
+	// The number of patches that were written, and the number that were skipped
+	// because the memory already contained the replacement bytes.
+	size_t appliedCount;
+	size_t alreadyAppliedCount;
+	size_t pageRangeCount;
+	// The time that Commit took, in performance counter ticks.
+	int64_t elapsedTicks;
+};
+
+const char* GetMemoryPatchStatusDescription(MemoryPatchStatus status);
+
+// Applies a set of memory patches as a single unit.
+//
+// All of the patches are verified before any memory is modified, and the patches are
+// grouped by page so that the protection of each page is only changed once. Adjacent
+// pages are only grouped when they have the same protection, so that restoring the
+// protection of a group does not change the protection of any of its pages. If any
+// patch fails, the patches that were already written are reverted and the original
+// memory protection is restored.
+class MemoryPatchTransaction
+{
+public:
+
+	MemoryPatchTransaction();
+
+	// The byte strings use the BytePattern format, the replacement bytes cannot contain wildcards
+	// and must be the same length as the expected bytes.
+	// Throws std::invalid_argument if the byte strings are not valid.
+	void Add(std::string_view name, uintptr_t address, std::string_view expectedBytes, std::string_view replacementBytes);
+
+	bool IsEmpty() const;
+
+	size_t GetPatchCount() const;
+
+	// Gets the page ranges that contain the patches, sorted by address.
+	// Pages that are adjacent to each other and have the same protection are merged into one range.
+	// Returns false if the protection of a page cannot be queried.
+	bool PlanPageRanges(const IMemoryPatchTarget& target, std::vector<MemoryPageRange>& pageRanges) const;
+
+	// Applies the patches and removes them from the transaction.
+	MemoryPatchResult Commit(IMemoryPatchTarget& target);
+
+private:
+
+	std::vector<MemoryPatch> patches;
+};
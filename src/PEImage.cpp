@@ -0,0 +1,352 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "PEImage.h"
+#include <cstring>
+
+namespace
+{
+	constexpr uint16_t kDosSignature = 0x5A4D; // MZ
+	constexpr uint32_t kNtSignature = 0x00004550; // PE\0\0
+	constexpr uint16_t kOptionalHeaderMagicPE32 = 0x10B;
+	constexpr uint16_t kOptionalHeaderMagicPE32Plus = 0x20B;
+	constexpr uint16_t kFileLargeAddressAware = 0x0020;
+	constexpr uint32_t kResourceDataDirectoryIndex = 2;
+	constexpr uint32_t kFixedFileInfoSignature = 0xFEEF04BD;
+	constexpr uint16_t kResourceTypeVersion = 16;
+	constexpr uint16_t kVersionResourceId = 1;
+
+	constexpr size_t kDosHeaderNewHeaderOffset = 0x3C;
+	constexpr size_t kFileHeaderSize = 20;
+	constexpr size_t kSectionHeaderSize = 40;
+	constexpr size_t kResourceDirectorySize = 16;
+	constexpr size_t kResourceDirectoryEntrySize = 8;
+	constexpr size_t kResourceDataEntrySize = 16;
+	constexpr size_t kFixedFileInfoSize = 52;
+	constexpr uint32_t kResourceHighBit = 0x80000000;
+
+	// The image is read with memcpy because its fields are not always aligned.
+	template <typename T>
+	T Read(const uint8_t* data)
+	{
+		T value;
+		std::memcpy(&value, data, sizeof(T));
+		return value;
+	}
+
+	bool RangeIsValid(size_t offset, size_t length, size_t size)
+	{
+		return offset <= size && length <= size - offset;
+	}
+}
+
+PEImage::PEImage()
+	: base(nullptr),
+	  size(0),
+	  imageBase(0),
+	  sizeOfImage(0),
+	  timeDateStamp(0),
+	  resourceDirectoryRva(0),
+	  resourceDirectorySize(0),
+	  fileCharacteristics(0),
+	  is64Bit(false),
+	  sections()
+{
+}
+
+bool PEImage::Load(const void* imageData, size_t imageSize)
+{
+	base = static_cast<const uint8_t*>(imageData);
+	size = imageSize;
+	sections.clear();
+
+	if (!base
+		|| !RangeIsValid(0, kDosHeaderNewHeaderOffset + sizeof(uint32_t), size)
+		|| Read<uint16_t>(base) != kDosSignature)
+	{
+		return false;
+	}
+
+	const size_t ntHeadersOffset = Read<uint32_t>(base + kDosHeaderNewHeaderOffset);
+
+	if (!RangeIsValid(ntHeadersOffset, sizeof(uint32_t) + kFileHeaderSize + sizeof(uint16_t), size)
+		|| Read<uint32_t>(base + ntHeadersOffset) != kNtSignature)
+	{
+		return false;
+	}
+
+	const uint8_t* const fileHeader = base + ntHeadersOffset + sizeof(uint32_t);
+	const uint16_t numberOfSections = Read<uint16_t>(fileHeader + 2);
+	const uint16_t sizeOfOptionalHeader = Read<uint16_t>(fileHeader + 16);
+	timeDateStamp = Read<uint32_t>(fileHeader + 4);
+	fileCharacteristics = Read<uint16_t>(fileHeader + 18);
+
+	const size_t optionalHeaderOffset = ntHeadersOffset + sizeof(uint32_t) + kFileHeaderSize;
+
+	if (!RangeIsValid(optionalHeaderOffset, sizeOfOptionalHeader, size))
+	{
+		return false;
+	}
+
+	const uint8_t* const optionalHeader = base + optionalHeaderOffset;
+	const uint16_t magic = Read<uint16_t>(optionalHeader);
+
+	size_t numberOfRvaAndSizesOffset = 0;
+
+	if (magic == kOptionalHeaderMagicPE32 && sizeOfOptionalHeader >= 96)
+	{
+		is64Bit = false;
+		imageBase = Read<uint32_t>(optionalHeader + 28);
+		numberOfRvaAndSizesOffset = 92;
+	}
+	else if (magic == kOptionalHeaderMagicPE32Plus && sizeOfOptionalHeader >= 112)
+	{
+		is64Bit = true;
+		imageBase = Read<uint64_t>(optionalHeader + 24);
+		numberOfRvaAndSizesOffset = 108;
+	}
+	else
+	{
+		return false;
+	}
+
+	sizeOfImage = Read<uint32_t>(optionalHeader + 56);
+
+	const uint32_t numberOfRvaAndSizes = Read<uint32_t>(optionalHeader + numberOfRvaAndSizesOffset);
+	const size_t dataDirectoryOffset = numberOfRvaAndSizesOffset + sizeof(uint32_t);
+	const size_t resourceDataDirectoryOffset = dataDirectoryOffset + (kResourceDataDirectoryIndex * 8);
+
+	resourceDirectoryRva = 0;
+	resourceDirectorySize = 0;
+
+	if (numberOfRvaAndSizes > kResourceDataDirectoryIndex
+		&& RangeIsValid(resourceDataDirectoryOffset, 8, sizeOfOptionalHeader))
+	{
+		resourceDirectoryRva = Read<uint32_t>(optionalHeader + resourceDataDirectoryOffset);
+		resourceDirectorySize = Read<uint32_t>(optionalHeader + resourceDataDirectoryOffset + 4);
+	}
+
+	const size_t sectionTableOffset = optionalHeaderOffset + sizeOfOptionalHeader;
+
+	if (!RangeIsValid(sectionTableOffset, static_cast<size_t>(numberOfSections) * kSectionHeaderSize, size))
+	{
+		return false;
+	}
+
+	sections.reserve(numberOfSections);
+
+	for (size_t i = 0; i < numberOfSections; i++)
+	{
+		const uint8_t* const sectionHeader = base + sectionTableOffset + (i * kSectionHeaderSize);
+
+		// The section name is padded with null characters, it is not terminated when it is 8 characters long.
+		const char* const name = reinterpret_cast<const char*>(sectionHeader);
+		const size_t nameLength = strnlen(name, 8);
+
+		sections.push_back(PESection
+		{
+			std::string(name, nameLength),
+			Read<uint32_t>(sectionHeader + 12),
+			Read<uint32_t>(sectionHeader + 8),
+			Read<uint32_t>(sectionHeader + 20),
+			Read<uint32_t>(sectionHeader + 16),
+			Read<uint32_t>(sectionHeader + 36),
+		});
+	}
+
+	return true;
+}
+
+bool PEImage::Is64Bit() const
+{
+	return is64Bit;
+}
+
+bool PEImage::IsLargeAddressAware() const
+{
+	return (fileCharacteristics & kFileLargeAddressAware) != 0;
+}
+
+uint64_t PEImage::GetImageBase() const
+{
+	return imageBase;
+}
+
+uint32_t PEImage::GetSizeOfImage() const
+{
+	return sizeOfImage;
+}
+
+uint32_t PEImage::GetTimeDateStamp() const
+{
+	return timeDateStamp;
+}
+
+const std::vector<PESection>& PEImage::GetSections() const
+{
+	return sections;
+}
+
+const PESection* PEImage::FindSection(std::string_view name) const
+{
+	for (const PESection& section : sections)
+	{
+		if (section.name == name)
+		{
+			return &section;
+		}
+	}
+
+	return nullptr;
+}
+
+const uint8_t* PEImage::GetDataAtRva(uint32_t rva, size_t length) const
+{
+	return base && RangeIsValid(rva, length, size) ? base + rva : nullptr;
+}
+
+bool PEImage::FindResourceDirectoryEntry(uint32_t directoryOffset, uint16_t id, bool useFirstEntry, uint32_t& entryValue) const
+{
+	const uint8_t* const directory = GetDataAtRva(resourceDirectoryRva + directoryOffset, kResourceDirectorySize);
+
+	if (!directory || !RangeIsValid(directoryOffset, kResourceDirectorySize, resourceDirectorySize))
+	{
+		return false;
+	}
+
+	const uint16_t namedEntryCount = Read<uint16_t>(directory + 12);
+	const uint16_t idEntryCount = Read<uint16_t>(directory + 14);
+	const size_t entryCount = static_cast<size_t>(namedEntryCount) + idEntryCount;
+	const size_t entriesOffset = static_cast<size_t>(directoryOffset) + kResourceDirectorySize;
+
+	if (!RangeIsValid(entriesOffset, entryCount * kResourceDirectoryEntrySize, resourceDirectorySize))
+	{
+		return false;
+	}
+
+	const uint8_t* const entries = directory + kResourceDirectorySize;
+
+	if (useFirstEntry)
+	{
+		if (entryCount == 0)
+		{
+			return false;
+		}
+
+		entryValue = Read<uint32_t>(entries + 4);
+		return true;
+	}
+
+	// The named entries are sorted before the integer ID entries.
+	for (size_t i = namedEntryCount; i < entryCount; i++)
+	{
+		const uint8_t* const entry = entries + (i * kResourceDirectoryEntrySize);
+		const uint32_t name = Read<uint32_t>(entry);
+
+		if ((name & kResourceHighBit) == 0 && name == id)
+		{
+			entryValue = Read<uint32_t>(entry + 4);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool PEImage::FindResource(uint16_t type, uint16_t name, const uint8_t*& data, uint32_t& length) const
+{
+	if (resourceDirectoryRva == 0 || resourceDirectorySize == 0)
+	{
+		return false;
+	}
+
+	// The resource tree has 3 levels: type, name and language.
+	// The first two levels must point to subdirectories and the last to a data entry.
+	uint32_t typeEntry = 0;
+	uint32_t nameEntry = 0;
+	uint32_t languageEntry = 0;
+
+	if (!FindResourceDirectoryEntry(0, type, false, typeEntry)
+		|| (typeEntry & kResourceHighBit) == 0
+		|| !FindResourceDirectoryEntry(typeEntry & ~kResourceHighBit, name, false, nameEntry)
+		|| (nameEntry & kResourceHighBit) == 0
+		|| !FindResourceDirectoryEntry(nameEntry & ~kResourceHighBit, 0, true, languageEntry)
+		|| (languageEntry & kResourceHighBit) != 0
+		|| !RangeIsValid(languageEntry, kResourceDataEntrySize, resourceDirectorySize))
+	{
+		return false;
+	}
+
+	const uint8_t* const dataEntry = GetDataAtRva(resourceDirectoryRva + languageEntry, kResourceDataEntrySize);
+
+	if (!dataEntry)
+	{
+		return false;
+	}
+
+	// Unlike the directory offsets, the data entry contains an RVA.
+	const uint32_t dataRva = Read<uint32_t>(dataEntry);
+	const uint32_t dataSize = Read<uint32_t>(dataEntry + 4);
+
+	data = GetDataAtRva(dataRva, dataSize);
+	length = dataSize;
+
+	return data != nullptr;
+}
+
+bool PEImage::GetFileVersion(uint64_t& version) const
+{
+	const uint8_t* data = nullptr;
+	uint32_t length = 0;
+
+	if (!FindResource(kResourceTypeVersion, kVersionResourceId, data, length))
+	{
+		return false;
+	}
+
+	// The VS_VERSIONINFO structure starts with 3 WORD values and the null-terminated UTF-16
+	// string "VS_VERSION_INFO", followed by padding to a 32-bit boundary and the VS_FIXEDFILEINFO.
+	static constexpr char16_t kVersionInfoKey[] = u"VS_VERSION_INFO";
+	constexpr size_t kKeyOffset = 6;
+	constexpr size_t kKeySize = sizeof(kVersionInfoKey);
+	constexpr size_t kFixedFileInfoOffset = (kKeyOffset + kKeySize + 3) & ~size_t(3);
+
+	if (length < kFixedFileInfoOffset + kFixedFileInfoSize
+		|| Read<uint16_t>(data + 2) < kFixedFileInfoSize
+		|| std::memcmp(data + kKeyOffset, kVersionInfoKey, kKeySize) != 0)
+	{
+		return false;
+	}
+
+	const uint8_t* const fixedFileInfo = data + kFixedFileInfoOffset;
+
+	if (Read<uint32_t>(fixedFileInfo) != kFixedFileInfoSignature)
+	{
+		return false;
+	}
+
+	const uint32_t fileVersionMS = Read<uint32_t>(fixedFileInfo + 8);
+	const uint32_t fileVersionLS = Read<uint32_t>(fixedFileInfo + 12);
+
+	version = (static_cast<uint64_t>(fileVersionMS) << 32) | fileVersionLS;
+
+	return true;
+}
@@ -0,0 +1,98 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct PESection
+{
+	std::string name;
+	uint32_t virtualAddress;
+	uint32_t virtualSize;
+	// The location of the section's data in the executable file.
+	uint32_t pointerToRawData;
+	uint32_t sizeOfRawData;
+	uint32_t characteristics;
+};
+
+// A read-only view of a PE/COFF image that the loader has mapped into memory,
+// e.g. the game's executable. The sections are read at their relative virtual
+// addresses, so no file I/O is required.
+//
+// Every offset that is read from the image is checked against the image size,
+// a malformed image makes Load or the lookup functions fail instead of reading
+// outside of the image.
+class PEImage
+{
+public:
+
+	PEImage();
+
+	// Parses the headers and the section table of a mapped image.
+	// The size is the number of bytes that can be read from the base address.
+	bool Load(const void* base, size_t size);
+
+	bool Is64Bit() const;
+
+	// Returns true if the IMAGE_FILE_LARGE_ADDRESS_AWARE flag is set.
+	bool IsLargeAddressAware() const;
+
+	uint64_t GetImageBase() const;
+
+	uint32_t GetSizeOfImage() const;
+
+	// The link time stamp from the file header.
+	uint32_t GetTimeDateStamp() const;
+
+	const std::vector<PESection>& GetSections() const;
+
+	const PESection* FindSection(std::string_view name) const;
+
+	// Returns a pointer to the data at the specified relative virtual address,
+	// or nullptr if the range is outside of the image.
+	const uint8_t* GetDataAtRva(uint32_t rva, size_t length) const;
+
+	// Finds a resource with an integer type and name, using the first language that is present.
+	bool FindResource(uint16_t type, uint16_t name, const uint8_t*& data, uint32_t& length) const;
+
+	// Reads the file version from the VS_FIXEDFILEINFO structure in the version resource.
+	// The most significant 16 bits are the major version, followed by the minor, build and revision numbers.
+	bool GetFileVersion(uint64_t& version) const;
+
+private:
+
+	bool FindResourceDirectoryEntry(uint32_t directoryOffset, uint16_t id, bool useFirstEntry, uint32_t& entryValue) const;
+
+	const uint8_t* base;
+	size_t size;
+	uint64_t imageBase;
+	uint32_t sizeOfImage;
+	uint32_t timeDateStamp;
+	uint32_t resourceDirectoryRva;
+	uint32_t resourceDirectorySize;
+	uint16_t fileCharacteristics;
+	bool is64Bit;
+	std::vector<PESection> sections;
+};
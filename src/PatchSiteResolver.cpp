@@ -0,0 +1,288 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "PatchSiteResolver.h"
+#include "IniParser.h"
+#include "SignatureScanner.h"
+#include <charconv>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+	constexpr uint32_t kCacheFileVersion = 2;
+
+	bool ParseUInt32(std::string_view text, uint32_t& value)
+	{
+		int base = 10;
+
+		if (IniStartsWithIgnoreCase(text, "0x"))
+		{
+			text.remove_prefix(2);
+			base = 16;
+		}
+
+		const char* const first = text.data();
+		const char* const last = first + text.size();
+		const std::from_chars_result result = std::from_chars(first, last, value, base);
+
+		return result.ec == std::errc() && result.ptr == last && first != last;
+	}
+
+	void AppendHex(std::string& text, uint32_t value)
+	{
+		char buffer[8]{};
+		const std::to_chars_result result = std::to_chars(std::begin(buffer), std::end(buffer), value, 16);
+
+		text.append(8 - static_cast<size_t>(result.ptr - buffer), '0');
+		text.append(buffer, result.ptr);
+	}
+
+	std::string CreateFingerprint(const PEImage& image, const GameExecutableFingerprint& executableFingerprint)
+	{
+		// The link time stamp changes every time the executable is built, the image size
+		// and code checksum distinguish the executables that have been modified after linking.
+		std::string fingerprint;
+		fingerprint.reserve(26);
+
+		AppendHex(fingerprint, image.GetTimeDateStamp());
+		fingerprint.push_back('-');
+		AppendHex(fingerprint, image.GetSizeOfImage());
+		fingerprint.push_back('-');
+		AppendHex(fingerprint, executableFingerprint.codeCrc32c);
+
+		return fingerprint;
+	}
+
+	bool BytesMatch(const PEImage& image, uint32_t rva, const char* pattern)
+	{
+		if (!pattern)
+		{
+			return false;
+		}
+
+		const BytePattern bytes(pattern);
+		const uint8_t* data = image.GetDataAtRva(rva, bytes.GetLength());
+
+		return data && bytes.Matches(data);
+	}
+}
+
+PatchSiteResolver::PatchSiteResolver(
+	const PEImage& image,
+	uint16_t gameVersion,
+	const GameExecutableFingerprint& executableFingerprint)
+	: image(image),
+	  gameVersion(gameVersion),
+	  fingerprint(CreateFingerprint(image, executableFingerprint)),
+	  cachedRvas(),
+	  cacheModified(false)
+{
+}
+
+bool PatchSiteResolver::LoadCache(const std::filesystem::path& path)
+{
+	std::ifstream stream(path, std::ifstream::in | std::ifstream::binary);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	std::stringstream buffer;
+	buffer << stream.rdbuf();
+	const std::string text = buffer.str();
+
+	uint32_t version = 0;
+	bool fingerprintMatches = false;
+	std::map<std::string, uint32_t, std::less<>> rvas;
+
+	try
+	{
+		IniParser parser(text);
+		IniEntry entry{};
+
+		while (parser.Next(entry))
+		{
+			if (IniEqualsIgnoreCase(entry.key, "Version"))
+			{
+				if (!ParseUInt32(entry.value, version))
+				{
+					return false;
+				}
+			}
+			else if (IniEqualsIgnoreCase(entry.key, "Fingerprint"))
+			{
+				fingerprintMatches = IniEqualsIgnoreCase(entry.value, fingerprint);
+			}
+			else if (IniEqualsIgnoreCase(entry.section, "PatchSites"))
+			{
+				uint32_t rva = 0;
+
+				if (!ParseUInt32(entry.value, rva))
+				{
+					return false;
+				}
+
+				rvas.emplace(entry.key, rva);
+			}
+		}
+	}
+	catch (const IniParseError&)
+	{
+		return false;
+	}
+
+	if (version != kCacheFileVersion || !fingerprintMatches)
+	{
+		return false;
+	}
+
+	cachedRvas = std::move(rvas);
+	return true;
+}
+
+bool PatchSiteResolver::SaveCache(const std::filesystem::path& path)
+{
+	if (!cacheModified)
+	{
+		return true;
+	}
+
+	std::ofstream stream(path, std::ofstream::out | std::ofstream::trunc);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	stream << "; The patch site offsets that SC4GraphicsOptions found in the game's executable.\n"
+		<< "; Delete this file to search for the patch sites again.\n"
+		<< "[Executable]\n"
+		<< "Version=" << kCacheFileVersion << '\n'
+		<< "Fingerprint=" << fingerprint << '\n'
+		<< "[PatchSites]\n";
+
+	for (const auto& [name, rva] : cachedRvas)
+	{
+		std::string value("0x");
+		AppendHex(value, rva);
+
+		stream << name << '=' << value << '\n';
+	}
+
+	if (!stream.flush())
+	{
+		return false;
+	}
+
+	cacheModified = false;
+	return true;
+}
+
+PatchSiteLocation PatchSiteResolver::Resolve(const PatchSiteDefinition& site)
+{
+	const auto cachedItem = cachedRvas.find(std::string_view(site.name));
+
+	if (cachedItem != cachedRvas.end())
+	{
+		if (IsValidPatchSite(site, cachedItem->second))
+		{
+			return MakeLocation(cachedItem->second, PatchSiteSource::Cache);
+		}
+
+		cachedRvas.erase(cachedItem);
+		cacheModified = true;
+	}
+
+	if (site.signature)
+	{
+		const uint32_t rva = FindSignature(site);
+
+		if (rva != 0 && IsValidPatchSite(site, rva))
+		{
+			cachedRvas.emplace(site.name, rva);
+			cacheModified = true;
+
+			return MakeLocation(rva, PatchSiteSource::Signature);
+		}
+	}
+
+	if (site.knownGameVersion != 0
+		&& site.knownGameVersion == gameVersion
+		&& site.knownAddress > image.GetImageBase())
+	{
+		const uint64_t rva = site.knownAddress - image.GetImageBase();
+
+		if (rva <= UINT32_MAX && IsValidPatchSite(site, static_cast<uint32_t>(rva)))
+		{
+			return MakeLocation(static_cast<uint32_t>(rva), PatchSiteSource::KnownAddress);
+		}
+	}
+
+	return PatchSiteLocation{ 0, PatchSiteSource::NotFound };
+}
+
+const std::string& PatchSiteResolver::GetFingerprint() const
+{
+	return fingerprint;
+}
+
+bool PatchSiteResolver::IsValidPatchSite(const PatchSiteDefinition& site, uint32_t rva) const
+{
+	return BytesMatch(image, rva, site.originalBytes) || BytesMatch(image, rva, site.patchedBytes);
+}
+
+uint32_t PatchSiteResolver::FindSignature(const PatchSiteDefinition& site) const
+{
+	const PESection* section = image.FindSection(site.sectionName);
+
+	if (!section)
+	{
+		return 0;
+	}
+
+	const uint8_t* data = image.GetDataAtRva(section->virtualAddress, section->virtualSize);
+
+	if (!data)
+	{
+		return 0;
+	}
+
+	const size_t offset = SignatureScanner::FindUnique(data, section->virtualSize, BytePattern(site.signature));
+
+	if (offset == SignatureScanner::kNotFound)
+	{
+		return 0;
+	}
+
+	const int64_t rva = static_cast<int64_t>(section->virtualAddress) + static_cast<int64_t>(offset) + site.signatureOffset;
+
+	return rva > 0 && rva <= UINT32_MAX ? static_cast<uint32_t>(rva) : 0;
+}
+
+PatchSiteLocation PatchSiteResolver::MakeLocation(uint32_t rva, PatchSiteSource source) const
+{
+	const uint8_t* data = image.GetDataAtRva(rva, 1);
+
+	return PatchSiteLocation{ reinterpret_cast<uintptr_t>(data), source };
+}
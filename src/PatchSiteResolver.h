@@ -0,0 +1,100 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include "GameExecutableFingerprint.h"
+#include "PEImage.h"
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+
+// Describes a location in the game's executable that a patch modifies.
+struct PatchSiteDefinition
+{
+	const char* name;
+	// The section that the signature is searched for in.
+	const char* sectionName;
+	// The byte pattern that identifies the patch site, nullptr if no signature is known.
+	const char* signature;
+	// The offset of the patch site from the start of the signature.
+	int32_t signatureOffset;
+	// The game version that the known address was verified on, 0 if there is no known address.
+	uint16_t knownGameVersion;
+	uint32_t knownAddress;
+	// The bytes that are present at the patch site before and after it is patched.
+	// A location is only used when it contains one of these byte patterns.
+	const char* originalBytes;
+	const char* patchedBytes;
+};
+
+enum class PatchSiteSource : int32_t
+{
+	NotFound = 0,
+	Cache,
+	Signature,
+	KnownAddress
+};
+
+struct PatchSiteLocation
+{
+	uintptr_t address;
+	PatchSiteSource source;
+};
+
+// Finds patch sites in the game's executable.
+//
+// A site is located using the following methods, in order:
+// 1. The offset that a previous signature scan found for the same executable.
+// 2. A signature scan of the site's section, the signature must match exactly one location.
+// 3. The known address for the detected game version.
+//
+// The scan results are stored in a cache file that is keyed on the executable's code
+// fingerprint and headers, the cached offsets are discarded when the executable changes.
+class PatchSiteResolver
+{
+public:
+
+	PatchSiteResolver(const PEImage& image, uint16_t gameVersion, const GameExecutableFingerprint& executableFingerprint);
+
+	bool LoadCache(const std::filesystem::path& path);
+
+	// Writes the cache file if a signature scan found a new patch site.
+	bool SaveCache(const std::filesystem::path& path);
+
+	PatchSiteLocation Resolve(const PatchSiteDefinition& site);
+
+	const std::string& GetFingerprint() const;
+
+private:
+
+	bool IsValidPatchSite(const PatchSiteDefinition& site, uint32_t rva) const;
+
+	uint32_t FindSignature(const PatchSiteDefinition& site) const;
+
+	PatchSiteLocation MakeLocation(uint32_t rva, PatchSiteSource source) const;
+
+	const PEImage& image;
+	uint16_t gameVersion;
+	std::string fingerprint;
+	std::map<std::string, uint32_t, std::less<>> cachedRvas;
+	bool cacheModified;
+};
@@ -0,0 +1,187 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include "ProcessPriorityClass.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// The operating system services that are used by the plugin's core code (settings,
+// logging and patching).
+//
+// PlatformWin32.cpp implements these for the game. PlatformPosix.cpp allows
+// the core code to be built and run on other operating systems.
+namespace Platform
+{
+	// Returns the current value of the high-resolution monotonic counter.
+	int64_t GetPerformanceCounter();
+
+	// Returns the number of high-resolution counter ticks per second.
+	int64_t GetPerformanceFrequency();
+
+	// Returns the current UTC time, in 100-nanosecond intervals since January 1, 1601.
+	uint64_t GetSystemTime();
+
+	// Sleeps for at least the specified number of performance counter ticks.
+	// This uses the most precise timer that the OS provides.
+	void SleepFor(int64_t ticks);
+
+	// Formats the time of day part of a system time in the user's time zone and locale.
+	// Returns the length of the string, not including the null terminator, or 0 on failure.
+	size_t FormatLocalTime(uint64_t systemTime, char* buffer, size_t bufferSize);
+
+	// Writes the text to the debugger's output window, or to stderr when no debugger is available.
+	void WriteDebugOutput(const char* text);
+
+	struct DisplaySize
+	{
+		uint32_t width;
+		uint32_t height;
+	};
+
+	DisplaySize GetPrimaryMonitorSize();
+
+	struct DisplayMode
+	{
+		uint32_t width;
+		uint32_t height;
+		uint32_t bitsPerPixel;
+		uint32_t refreshRate;
+	};
+
+	struct DisplayModeList
+	{
+		// The display adapter output and the monitor that is attached to it.
+		std::string adapterName;
+		std::string monitorName;
+		// The mode that the desktop is currently using.
+		DisplayMode currentMode;
+		// The modes that the monitor supports.
+		std::vector<DisplayMode> modes;
+	};
+
+	// Enumerates the display modes of the primary monitor, this can take several milliseconds.
+	// Returns false if the display modes cannot be enumerated.
+	bool EnumeratePrimaryDisplayModes(DisplayModeList& list);
+
+	// Sets a callback that is called when the process is about to be terminated
+	// because of an unhandled exception.
+	void SetCrashCallback(void (*callback)());
+
+	size_t GetMemoryPageSize();
+
+	// Gets the protection of the page that contains the address, and the end of the region
+	// of pages after it that have the same protection.
+	bool QueryMemoryProtection(uintptr_t address, uint32_t& protection, uintptr_t& regionEnd);
+
+	// Allows the pages that contain the memory range to be written to, e.g. the game's code.
+	// The previous protection is stored in oldProtection, it must be restored with RestoreMemoryProtection.
+	bool MakeMemoryWritable(uintptr_t address, size_t size, uint32_t& oldProtection);
+
+	bool RestoreMemoryProtection(uintptr_t address, size_t size, uint32_t protection);
+
+	// Must be called after modifying code that may have already been executed.
+	void FlushInstructionCache(uintptr_t address, size_t size);
+
+	// The system timer resolutions in 100-nanosecond units, a smaller value is a finer resolution.
+	struct TimerResolutionRange
+	{
+		uint32_t coarsest;
+		uint32_t finest;
+		uint32_t current;
+	};
+
+	bool QueryTimerResolution(TimerResolutionRange& range);
+
+	// Requests a timer resolution for the process, in 100-nanosecond units.
+	// The resolution that the system uses after the request is stored in actualResolution.
+	bool SetTimerResolution(uint32_t resolution, uint32_t& actualResolution);
+
+	// Removes a request that was made with SetTimerResolution.
+	bool ResetTimerResolution(uint32_t resolution);
+
+	// Opts the process out of the execution speed throttling (EcoQoS) that the OS applies
+	// to background processes, and optionally out of the timer resolution throttling.
+	bool DisablePowerThrottling(bool includeTimerResolution);
+
+	// Returns the process to the OS's default power throttling policy.
+	bool RestorePowerThrottling();
+
+	// The previous priority class is stored in previousPriorityClass, it must be
+	// restored with RestoreProcessPriorityClass.
+	bool SetProcessPriorityClass(ProcessPriorityClass priorityClass, uint32_t& previousPriorityClass);
+
+	bool RestoreProcessPriorityClass(uint32_t previousPriorityClass);
+
+	// A writable memory-mapped file.
+	class MappedFile
+	{
+	public:
+
+		MappedFile();
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		// Creates or truncates the file, extends it to the specified size and maps it.
+		bool Create(const std::filesystem::path& path, size_t size);
+
+		char* GetData() const;
+
+		// Unmaps the file and truncates it to the specified length.
+		void Close(size_t length);
+
+	private:
+
+		intptr_t fileHandle;
+		void* mappingHandle;
+		char* data;
+		size_t size;
+	};
+
+	// A file that is written without any buffering or memory allocation.
+	// This is used to write the flight recorder dumps from the crash handler.
+	class OutputFile
+	{
+	public:
+
+		OutputFile();
+		~OutputFile();
+
+		OutputFile(const OutputFile&) = delete;
+		OutputFile& operator=(const OutputFile&) = delete;
+
+		// Creates or truncates the file.
+		bool Create(const std::filesystem::path& path);
+
+		bool Write(const void* buffer, size_t length);
+
+		void Close();
+
+	private:
+
+		intptr_t fileHandle;
+	};
+}
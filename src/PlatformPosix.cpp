@@ -0,0 +1,427 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "Platform.h"
+#include <csignal>
+#include <cstdio>
+#include <ctime>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace
+{
+	// The number of 100-nanosecond intervals between January 1, 1601 and January 1, 1970.
+	constexpr uint64_t kUnixEpochSystemTime = 116444736000000000;
+	constexpr uint64_t kSystemTimeTicksPerSecond = 10000000;
+
+	void (*s_CrashCallback)() = nullptr;
+
+	void CrashSignalHandler(int signal)
+	{
+		if (s_CrashCallback)
+		{
+			s_CrashCallback();
+		}
+
+		std::signal(signal, SIG_DFL);
+		std::raise(signal);
+	}
+}
+
+int64_t Platform::GetPerformanceCounter()
+{
+	timespec time{};
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return (static_cast<int64_t>(time.tv_sec) * 1000000000) + time.tv_nsec;
+}
+
+int64_t Platform::GetPerformanceFrequency()
+{
+	return 1000000000;
+}
+
+uint64_t Platform::GetSystemTime()
+{
+	timespec time{};
+	clock_gettime(CLOCK_REALTIME, &time);
+
+	return kUnixEpochSystemTime
+		+ (static_cast<uint64_t>(time.tv_sec) * kSystemTimeTicksPerSecond)
+		+ (static_cast<uint64_t>(time.tv_nsec) / 100);
+}
+
+void Platform::SleepFor(int64_t ticks)
+{
+	if (ticks <= 0)
+	{
+		return;
+	}
+
+	// The performance counter ticks are nanoseconds.
+	timespec duration{};
+	duration.tv_sec = static_cast<time_t>(ticks / 1000000000);
+	duration.tv_nsec = static_cast<long>(ticks % 1000000000);
+
+	while (clock_nanosleep(CLOCK_MONOTONIC, 0, &duration, &duration) == EINTR)
+	{
+	}
+}
+
+size_t Platform::FormatLocalTime(uint64_t systemTime, char* buffer, size_t bufferSize)
+{
+	if (systemTime < kUnixEpochSystemTime)
+	{
+		return 0;
+	}
+
+	const time_t unixTime = static_cast<time_t>((systemTime - kUnixEpochSystemTime) / kSystemTimeTicksPerSecond);
+
+	tm localTime{};
+
+	if (!localtime_r(&unixTime, &localTime))
+	{
+		return 0;
+	}
+
+	return std::strftime(buffer, bufferSize, "%X", &localTime);
+}
+
+void Platform::WriteDebugOutput(const char* text)
+{
+	std::fputs(text, stderr);
+}
+
+Platform::DisplaySize Platform::GetPrimaryMonitorSize()
+{
+	// The host build does not have a display, this is a common monitor size.
+	return DisplaySize{ 1920, 1080 };
+}
+
+bool Platform::EnumeratePrimaryDisplayModes(DisplayModeList& list)
+{
+	// The host build does not have a display, the callers use the monitor size instead.
+	static_cast<void>(list);
+	return false;
+}
+
+void Platform::SetCrashCallback(void (*callback)())
+{
+	if (!s_CrashCallback)
+	{
+		for (int signal : { SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT })
+		{
+			std::signal(signal, CrashSignalHandler);
+		}
+	}
+
+	s_CrashCallback = callback;
+}
+
+size_t Platform::GetMemoryPageSize()
+{
+	return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+bool Platform::QueryMemoryProtection(uintptr_t address, uint32_t& protection, uintptr_t& regionEnd)
+{
+	// Linux lists the process's memory mappings and their protection in /proc/self/maps,
+	// other systems are assumed to be patching code.
+	FILE* maps = std::fopen("/proc/self/maps", "r");
+
+	if (!maps)
+	{
+		const uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+
+		protection = PROT_READ | PROT_EXEC;
+		regionEnd = (address & ~(pageSize - 1)) + pageSize;
+		return true;
+	}
+
+	bool found = false;
+	unsigned long long start = 0;
+	unsigned long long end = 0;
+	char permissions[5]{};
+	char line[512]{};
+
+	while (std::fgets(line, sizeof(line), maps))
+	{
+		if (std::sscanf(line, "%llx-%llx %4s", &start, &end, permissions) == 3
+			&& address >= start
+			&& address < end)
+		{
+			protection = (permissions[0] == 'r' ? PROT_READ : 0)
+				| (permissions[1] == 'w' ? PROT_WRITE : 0)
+				| (permissions[2] == 'x' ? PROT_EXEC : 0);
+			regionEnd = static_cast<uintptr_t>(end);
+			found = true;
+			break;
+		}
+	}
+
+	std::fclose(maps);
+	return found;
+}
+
+bool Platform::MakeMemoryWritable(uintptr_t address, size_t size, uint32_t& oldProtection)
+{
+	const uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+	const uintptr_t pageStart = address & ~(pageSize - 1);
+	const size_t protectSize = static_cast<size_t>((address + size) - pageStart);
+
+	// Like VirtualProtect, this reports the protection of the first page.
+	uint32_t protection = 0;
+	uintptr_t regionEnd = 0;
+
+	if (!QueryMemoryProtection(pageStart, protection, regionEnd)
+		|| mprotect(reinterpret_cast<void*>(pageStart), protectSize, PROT_READ | PROT_WRITE | PROT_EXEC) != 0)
+	{
+		return false;
+	}
+
+	oldProtection = protection;
+	return true;
+}
+
+bool Platform::RestoreMemoryProtection(uintptr_t address, size_t size, uint32_t protection)
+{
+	const uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+	const uintptr_t pageStart = address & ~(pageSize - 1);
+	const size_t protectSize = static_cast<size_t>((address + size) - pageStart);
+
+	return mprotect(reinterpret_cast<void*>(pageStart), protectSize, static_cast<int>(protection)) == 0;
+}
+
+void Platform::FlushInstructionCache(uintptr_t address, size_t size)
+{
+	char* start = reinterpret_cast<char*>(address);
+
+	__builtin___clear_cache(start, start + size);
+}
+
+bool Platform::QueryTimerResolution(TimerResolutionRange& range)
+{
+	// The POSIX timers do not have a process-wide resolution.
+	static_cast<void>(range);
+	return false;
+}
+
+bool Platform::SetTimerResolution(uint32_t resolution, uint32_t& actualResolution)
+{
+	static_cast<void>(resolution);
+	static_cast<void>(actualResolution);
+	return false;
+}
+
+bool Platform::ResetTimerResolution(uint32_t resolution)
+{
+	static_cast<void>(resolution);
+	return false;
+}
+
+bool Platform::DisablePowerThrottling(bool includeTimerResolution)
+{
+	static_cast<void>(includeTimerResolution);
+	return false;
+}
+
+bool Platform::RestorePowerThrottling()
+{
+	return false;
+}
+
+bool Platform::SetProcessPriorityClass(ProcessPriorityClass priorityClass, uint32_t& previousPriorityClass)
+{
+	int niceValue = 0;
+
+	switch (priorityClass)
+	{
+	case ProcessPriorityClass::Normal:
+		niceValue = 0;
+		break;
+	case ProcessPriorityClass::AboveNormal:
+		niceValue = -5;
+		break;
+	case ProcessPriorityClass::High:
+		niceValue = -10;
+		break;
+	case ProcessPriorityClass::Default:
+	default:
+		return false;
+	}
+
+	// getpriority can return -1 as a valid value, errno distinguishes it from an error.
+	errno = 0;
+	const int previous = getpriority(PRIO_PROCESS, 0);
+
+	if ((previous == -1 && errno != 0) || setpriority(PRIO_PROCESS, 0, niceValue) != 0)
+	{
+		return false;
+	}
+
+	previousPriorityClass = static_cast<uint32_t>(previous);
+	return true;
+}
+
+bool Platform::RestoreProcessPriorityClass(uint32_t previousPriorityClass)
+{
+	return setpriority(PRIO_PROCESS, 0, static_cast<int>(previousPriorityClass)) == 0;
+}
+
+Platform::MappedFile::MappedFile()
+	: fileHandle(-1),
+	  mappingHandle(nullptr),
+	  data(nullptr),
+	  size(0)
+{
+}
+
+Platform::MappedFile::~MappedFile()
+{
+	Close(size);
+}
+
+bool Platform::MappedFile::Create(const std::filesystem::path& path, size_t mappingSize)
+{
+	Close(size);
+
+	const int file = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+	if (file == -1)
+	{
+		return false;
+	}
+
+	if (ftruncate(file, static_cast<off_t>(mappingSize)) != 0)
+	{
+		close(file);
+		return false;
+	}
+
+	void* mappedView = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+
+	if (mappedView == MAP_FAILED)
+	{
+		close(file);
+		return false;
+	}
+
+	fileHandle = file;
+	data = static_cast<char*>(mappedView);
+	size = mappingSize;
+
+	return true;
+}
+
+char* Platform::MappedFile::GetData() const
+{
+	return data;
+}
+
+void Platform::MappedFile::Close(size_t length)
+{
+	if (data)
+	{
+		munmap(data, size);
+		data = nullptr;
+	}
+
+	if (fileHandle != -1)
+	{
+		const int file = static_cast<int>(fileHandle);
+
+		// Trim the unused part of the preallocated file.
+		const int result = ftruncate(file, static_cast<off_t>(length));
+		static_cast<void>(result);
+
+		close(file);
+		fileHandle = -1;
+	}
+
+	size = 0;
+}
+
+Platform::OutputFile::OutputFile()
+	: fileHandle(-1)
+{
+}
+
+Platform::OutputFile::~OutputFile()
+{
+	Close();
+}
+
+bool Platform::OutputFile::Create(const std::filesystem::path& path)
+{
+	Close();
+
+	const int file = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+	if (file == -1)
+	{
+		return false;
+	}
+
+	fileHandle = file;
+	return true;
+}
+
+bool Platform::OutputFile::Write(const void* buffer, size_t length)
+{
+	if (fileHandle == -1)
+	{
+		return false;
+	}
+
+	const char* data = static_cast<const char*>(buffer);
+
+	while (length > 0)
+	{
+		const ssize_t bytesWritten = write(static_cast<int>(fileHandle), data, length);
+
+		if (bytesWritten < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			return false;
+		}
+
+		data += bytesWritten;
+		length -= static_cast<size_t>(bytesWritten);
+	}
+
+	return true;
+}
+
+void Platform::OutputFile::Close()
+{
+	if (fileHandle != -1)
+	{
+		close(static_cast<int>(fileHandle));
+		fileHandle = -1;
+	}
+}
@@ -0,0 +1,599 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "Platform.h"
+#include <algorithm>
+#include <Windows.h>
+#include "wil/resource.h"
+#include "wil/result.h"
+
+// Older Windows SDKs do not define this flag, it was added in Windows 11.
+#ifndef PROCESS_POWER_THROTTLING_IGNORE_TIMER_RESOLUTION
+#define PROCESS_POWER_THROTTLING_IGNORE_TIMER_RESOLUTION 0x4
+#endif
+
+namespace
+{
+	void (*s_CrashCallback)() = nullptr;
+	LPTOP_LEVEL_EXCEPTION_FILTER s_PreviousExceptionFilter = nullptr;
+
+	LONG WINAPI CrashCallbackExceptionFilter(EXCEPTION_POINTERS* pExceptionInfo)
+	{
+		if (s_CrashCallback)
+		{
+			s_CrashCallback();
+		}
+
+		if (s_PreviousExceptionFilter)
+		{
+			return s_PreviousExceptionFilter(pExceptionInfo);
+		}
+
+		return EXCEPTION_CONTINUE_SEARCH;
+	}
+
+	HANDLE ToHandle(intptr_t value)
+	{
+		return reinterpret_cast<HANDLE>(value);
+	}
+
+	const intptr_t kInvalidFileHandle = reinterpret_cast<intptr_t>(INVALID_HANDLE_VALUE);
+
+	// The native timer resolution functions allow a finer resolution than timeBeginPeriod.
+	// They are undocumented and must be loaded from ntdll at runtime.
+	typedef LONG(NTAPI* PFN_NT_QUERY_TIMER_RESOLUTION)(PULONG MaximumTime, PULONG MinimumTime, PULONG CurrentTime);
+	typedef LONG(NTAPI* PFN_NT_SET_TIMER_RESOLUTION)(ULONG DesiredTime, BOOLEAN SetResolution, PULONG ActualTime);
+
+	template<typename T>
+	T GetNtdllFunction(const char* name)
+	{
+		const HMODULE ntdll = GetModuleHandleW(L"ntdll.dll");
+
+		return ntdll ? reinterpret_cast<T>(GetProcAddress(ntdll, name)) : nullptr;
+	}
+
+	std::string ToUtf8(const WCHAR* value)
+	{
+		std::string result;
+
+		const int length = WideCharToMultiByte(CP_UTF8, 0, value, -1, nullptr, 0, nullptr, nullptr);
+
+		if (length > 1)
+		{
+			result.resize(static_cast<size_t>(length));
+			WideCharToMultiByte(CP_UTF8, 0, value, -1, result.data(), length, nullptr, nullptr);
+			result.resize(static_cast<size_t>(length - 1));
+		}
+
+		return result;
+	}
+
+	Platform::DisplayMode DisplayModeFromDevMode(const DEVMODEW& devMode)
+	{
+		return Platform::DisplayMode
+		{
+			devMode.dmPelsWidth,
+			devMode.dmPelsHeight,
+			devMode.dmBitsPerPel,
+			devMode.dmDisplayFrequency
+		};
+	}
+
+	HANDLE CreateSleepTimer()
+	{
+		// High-resolution timers are supported starting with Windows 10 version 1803,
+		// older versions use a standard timer.
+		HANDLE timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+
+		if (!timer)
+		{
+			timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+		}
+
+		return timer;
+	}
+}
+
+int64_t Platform::GetPerformanceCounter()
+{
+	LARGE_INTEGER counter{};
+	QueryPerformanceCounter(&counter);
+
+	return counter.QuadPart;
+}
+
+int64_t Platform::GetPerformanceFrequency()
+{
+	LARGE_INTEGER frequency{};
+	QueryPerformanceFrequency(&frequency);
+
+	return frequency.QuadPart;
+}
+
+uint64_t Platform::GetSystemTime()
+{
+	FILETIME systemTime{};
+	GetSystemTimeAsFileTime(&systemTime);
+
+	ULARGE_INTEGER value{};
+	value.LowPart = systemTime.dwLowDateTime;
+	value.HighPart = systemTime.dwHighDateTime;
+
+	return value.QuadPart;
+}
+
+void Platform::SleepFor(int64_t ticks)
+{
+	if (ticks <= 0)
+	{
+		return;
+	}
+
+	// Each thread that sleeps has its own timer, the timer is closed when the thread exits.
+	thread_local wil::unique_handle timer(CreateSleepTimer());
+
+	static const int64_t frequency = GetPerformanceFrequency();
+
+	// A negative due time is relative to the current time, in 100-nanosecond intervals.
+	LARGE_INTEGER dueTime{};
+	dueTime.QuadPart = -std::max<int64_t>((ticks * 10000000) / frequency, 1);
+
+	if (timer && SetWaitableTimer(timer.get(), &dueTime, 0, nullptr, nullptr, FALSE))
+	{
+		WaitForSingleObject(timer.get(), INFINITE);
+	}
+	else
+	{
+		Sleep(static_cast<DWORD>((ticks * 1000) / frequency));
+	}
+}
+
+size_t Platform::FormatLocalTime(uint64_t systemTime, char* buffer, size_t bufferSize)
+{
+	ULARGE_INTEGER value{};
+	value.QuadPart = systemTime;
+
+	FILETIME utcFileTime{};
+	utcFileTime.dwLowDateTime = value.LowPart;
+	utcFileTime.dwHighDateTime = value.HighPart;
+
+	SYSTEMTIME utcTime{};
+	SYSTEMTIME localTime{};
+
+	if (FileTimeToSystemTime(&utcFileTime, &utcTime)
+		&& SystemTimeToTzSpecificLocalTime(nullptr, &utcTime, &localTime))
+	{
+		const int length = GetTimeFormatA(
+			LOCALE_USER_DEFAULT,
+			0,
+			&localTime,
+			nullptr,
+			buffer,
+			static_cast<int>(bufferSize));
+
+		if (length > 1)
+		{
+			// The returned length includes the null terminator.
+			return static_cast<size_t>(length) - 1;
+		}
+	}
+
+	return 0;
+}
+
+void Platform::WriteDebugOutput(const char* text)
+{
+	OutputDebugStringA(text);
+}
+
+Platform::DisplaySize Platform::GetPrimaryMonitorSize()
+{
+	return DisplaySize
+	{
+		static_cast<uint32_t>(GetSystemMetrics(SM_CXSCREEN)),
+		static_cast<uint32_t>(GetSystemMetrics(SM_CYSCREEN))
+	};
+}
+
+bool Platform::EnumeratePrimaryDisplayModes(DisplayModeList& list)
+{
+	DISPLAY_DEVICEW adapter{};
+	adapter.cb = sizeof(adapter);
+
+	bool foundPrimaryAdapter = false;
+
+	for (DWORD i = 0; EnumDisplayDevicesW(nullptr, i, &adapter, 0); i++)
+	{
+		if ((adapter.StateFlags & DISPLAY_DEVICE_PRIMARY_DEVICE) != 0)
+		{
+			foundPrimaryAdapter = true;
+			break;
+		}
+	}
+
+	if (!foundPrimaryAdapter)
+	{
+		return false;
+	}
+
+	list.adapterName = ToUtf8(adapter.DeviceName);
+
+	DISPLAY_DEVICEW monitor{};
+	monitor.cb = sizeof(monitor);
+
+	if (EnumDisplayDevicesW(adapter.DeviceName, 0, &monitor, 0))
+	{
+		list.monitorName = ToUtf8(monitor.DeviceID);
+	}
+
+	DEVMODEW devMode{};
+	devMode.dmSize = sizeof(devMode);
+
+	if (!EnumDisplaySettingsExW(adapter.DeviceName, ENUM_CURRENT_SETTINGS, &devMode, 0))
+	{
+		return false;
+	}
+
+	list.currentMode = DisplayModeFromDevMode(devMode);
+	list.modes.clear();
+
+	// Without EDS_RAWMODE, only the modes that the monitor supports are returned.
+	for (DWORD modeIndex = 0; EnumDisplaySettingsExW(adapter.DeviceName, modeIndex, &devMode, 0); modeIndex++)
+	{
+		list.modes.push_back(DisplayModeFromDevMode(devMode));
+	}
+
+	return true;
+}
+
+void Platform::SetCrashCallback(void (*callback)())
+{
+	if (!s_CrashCallback)
+	{
+		s_PreviousExceptionFilter = SetUnhandledExceptionFilter(CrashCallbackExceptionFilter);
+	}
+
+	s_CrashCallback = callback;
+}
+
+size_t Platform::GetMemoryPageSize()
+{
+	SYSTEM_INFO systemInfo{};
+	GetSystemInfo(&systemInfo);
+
+	return systemInfo.dwPageSize;
+}
+
+bool Platform::QueryMemoryProtection(uintptr_t address, uint32_t& protection, uintptr_t& regionEnd)
+{
+	MEMORY_BASIC_INFORMATION info{};
+
+	if (VirtualQuery(reinterpret_cast<LPCVOID>(address), &info, sizeof(info)) != sizeof(info)
+		|| info.State != MEM_COMMIT)
+	{
+		return false;
+	}
+
+	protection = info.Protect;
+	regionEnd = reinterpret_cast<uintptr_t>(info.BaseAddress) + info.RegionSize;
+	return true;
+}
+
+bool Platform::MakeMemoryWritable(uintptr_t address, size_t size, uint32_t& oldProtection)
+{
+	DWORD oldProtect = 0;
+
+	// Allow the executable memory to be written to.
+	if (!VirtualProtect(reinterpret_cast<LPVOID>(address), size, PAGE_EXECUTE_READWRITE, &oldProtect))
+	{
+		return false;
+	}
+
+	oldProtection = oldProtect;
+	return true;
+}
+
+bool Platform::RestoreMemoryProtection(uintptr_t address, size_t size, uint32_t protection)
+{
+	DWORD oldProtect = 0;
+
+	return VirtualProtect(reinterpret_cast<LPVOID>(address), size, protection, &oldProtect) != FALSE;
+}
+
+void Platform::FlushInstructionCache(uintptr_t address, size_t size)
+{
+	::FlushInstructionCache(GetCurrentProcess(), reinterpret_cast<LPCVOID>(address), size);
+}
+
+bool Platform::QueryTimerResolution(TimerResolutionRange& range)
+{
+	const PFN_NT_QUERY_TIMER_RESOLUTION queryTimerResolution = GetNtdllFunction<PFN_NT_QUERY_TIMER_RESOLUTION>("NtQueryTimerResolution");
+
+	ULONG coarsest = 0;
+	ULONG finest = 0;
+	ULONG current = 0;
+
+	if (!queryTimerResolution || queryTimerResolution(&coarsest, &finest, &current) < 0)
+	{
+		return false;
+	}
+
+	range.coarsest = coarsest;
+	range.finest = finest;
+	range.current = current;
+	return true;
+}
+
+bool Platform::SetTimerResolution(uint32_t resolution, uint32_t& actualResolution)
+{
+	const PFN_NT_SET_TIMER_RESOLUTION setTimerResolution = GetNtdllFunction<PFN_NT_SET_TIMER_RESOLUTION>("NtSetTimerResolution");
+
+	ULONG current = 0;
+
+	if (!setTimerResolution || setTimerResolution(resolution, TRUE, &current) < 0)
+	{
+		return false;
+	}
+
+	actualResolution = current;
+	return true;
+}
+
+bool Platform::ResetTimerResolution(uint32_t resolution)
+{
+	const PFN_NT_SET_TIMER_RESOLUTION setTimerResolution = GetNtdllFunction<PFN_NT_SET_TIMER_RESOLUTION>("NtSetTimerResolution");
+
+	ULONG current = 0;
+
+	return setTimerResolution && setTimerResolution(resolution, FALSE, &current) >= 0;
+}
+
+bool Platform::DisablePowerThrottling(bool includeTimerResolution)
+{
+	PROCESS_POWER_THROTTLING_STATE state{};
+	state.Version = PROCESS_POWER_THROTTLING_CURRENT_VERSION;
+	state.ControlMask = PROCESS_POWER_THROTTLING_EXECUTION_SPEED;
+	state.StateMask = 0;
+
+	if (includeTimerResolution)
+	{
+		state.ControlMask |= PROCESS_POWER_THROTTLING_IGNORE_TIMER_RESOLUTION;
+	}
+
+	return SetProcessInformation(GetCurrentProcess(), ProcessPowerThrottling, &state, sizeof(state)) != FALSE;
+}
+
+bool Platform::RestorePowerThrottling()
+{
+	// A control mask of 0 lets the OS decide when to throttle the process.
+	PROCESS_POWER_THROTTLING_STATE state{};
+	state.Version = PROCESS_POWER_THROTTLING_CURRENT_VERSION;
+	state.ControlMask = 0;
+	state.StateMask = 0;
+
+	return SetProcessInformation(GetCurrentProcess(), ProcessPowerThrottling, &state, sizeof(state)) != FALSE;
+}
+
+bool Platform::SetProcessPriorityClass(ProcessPriorityClass priorityClass, uint32_t& previousPriorityClass)
+{
+	DWORD value = 0;
+
+	switch (priorityClass)
+	{
+	case ProcessPriorityClass::Normal:
+		value = NORMAL_PRIORITY_CLASS;
+		break;
+	case ProcessPriorityClass::AboveNormal:
+		value = ABOVE_NORMAL_PRIORITY_CLASS;
+		break;
+	case ProcessPriorityClass::High:
+		value = HIGH_PRIORITY_CLASS;
+		break;
+	case ProcessPriorityClass::Default:
+	default:
+		return false;
+	}
+
+	const DWORD previous = GetPriorityClass(GetCurrentProcess());
+
+	if (previous == 0 || !SetPriorityClass(GetCurrentProcess(), value))
+	{
+		return false;
+	}
+
+	previousPriorityClass = previous;
+	return true;
+}
+
+bool Platform::RestoreProcessPriorityClass(uint32_t previousPriorityClass)
+{
+	return SetPriorityClass(GetCurrentProcess(), previousPriorityClass) != FALSE;
+}
+
+Platform::MappedFile::MappedFile()
+	: fileHandle(kInvalidFileHandle),
+	  mappingHandle(nullptr),
+	  data(nullptr),
+	  size(0)
+{
+}
+
+Platform::MappedFile::~MappedFile()
+{
+	Close(size);
+}
+
+bool Platform::MappedFile::Create(const std::filesystem::path& path, size_t mappingSize)
+{
+	Close(size);
+
+	HANDLE file = CreateFileW(
+		path.c_str(),
+		GENERIC_READ | GENERIC_WRITE,
+		FILE_SHARE_READ,
+		nullptr,
+		CREATE_ALWAYS,
+		FILE_ATTRIBUTE_NORMAL,
+		nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	const uint64_t mappingSize64 = static_cast<uint64_t>(mappingSize);
+
+	// Creating the mapping extends the file to the mapping size.
+	HANDLE mapping = CreateFileMappingW(
+		file,
+		nullptr,
+		PAGE_READWRITE,
+		static_cast<DWORD>(mappingSize64 >> 32),
+		static_cast<DWORD>(mappingSize64 & 0xFFFFFFFF),
+		nullptr);
+
+	if (!mapping)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	void* mappedView = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, mappingSize);
+
+	if (!mappedView)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	fileHandle = reinterpret_cast<intptr_t>(file);
+	mappingHandle = mapping;
+	data = static_cast<char*>(mappedView);
+	size = mappingSize;
+
+	return true;
+}
+
+char* Platform::MappedFile::GetData() const
+{
+	return data;
+}
+
+void Platform::MappedFile::Close(size_t length)
+{
+	if (data)
+	{
+		UnmapViewOfFile(data);
+		data = nullptr;
+	}
+
+	if (mappingHandle)
+	{
+		CloseHandle(mappingHandle);
+		mappingHandle = nullptr;
+	}
+
+	if (fileHandle != kInvalidFileHandle)
+	{
+		HANDLE file = ToHandle(fileHandle);
+
+		LARGE_INTEGER position{};
+		position.QuadPart = static_cast<LONGLONG>(length);
+
+		if (SetFilePointerEx(file, position, nullptr, FILE_BEGIN))
+		{
+			SetEndOfFile(file);
+		}
+
+		CloseHandle(file);
+		fileHandle = kInvalidFileHandle;
+	}
+
+	size = 0;
+}
+
+Platform::OutputFile::OutputFile()
+	: fileHandle(kInvalidFileHandle)
+{
+}
+
+Platform::OutputFile::~OutputFile()
+{
+	Close();
+}
+
+bool Platform::OutputFile::Create(const std::filesystem::path& path)
+{
+	Close();
+
+	HANDLE file = CreateFileW(
+		path.c_str(),
+		GENERIC_WRITE,
+		FILE_SHARE_READ,
+		nullptr,
+		CREATE_ALWAYS,
+		FILE_ATTRIBUTE_NORMAL,
+		nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	fileHandle = reinterpret_cast<intptr_t>(file);
+	return true;
+}
+
+bool Platform::OutputFile::Write(const void* buffer, size_t length)
+{
+	if (fileHandle == kInvalidFileHandle)
+	{
+		return false;
+	}
+
+	const uint8_t* data = static_cast<const uint8_t*>(buffer);
+
+	while (length > 0)
+	{
+		DWORD bytesWritten = 0;
+		const DWORD bytesToWrite = static_cast<DWORD>(std::min<size_t>(length, 0x10000000));
+
+		if (!WriteFile(ToHandle(fileHandle), data, bytesToWrite, &bytesWritten, nullptr) || bytesWritten == 0)
+		{
+			return false;
+		}
+
+		data += bytesWritten;
+		length -= bytesWritten;
+	}
+
+	return true;
+}
+
+void Platform::OutputFile::Close()
+{
+	if (fileHandle != kInvalidFileHandle)
+	{
+		CloseHandle(ToHandle(fileHandle));
+		fileHandle = kInvalidFileHandle;
+	}
+}
@@ -0,0 +1,258 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "ProcessSchedulingPolicy.h"
+#include "Platform.h"
+#include <algorithm>
+
+namespace
+{
+	constexpr uint32_t kTimerUnitsPerMicrosecond = 10;
+
+	void AppendSeparator(std::string& text)
+	{
+		if (!text.empty())
+		{
+			text.append(", ");
+		}
+	}
+
+	std::string FormatTimerResolution(uint32_t resolution)
+	{
+		// Format the 100-nanosecond units as milliseconds with 4 decimal places.
+		const uint32_t milliseconds = resolution / 10000;
+		const uint32_t fraction = resolution % 10000;
+
+		std::string text = std::to_string(milliseconds);
+		text.push_back('.');
+
+		const std::string fractionText = std::to_string(fraction);
+		text.append(4 - fractionText.size(), '0');
+		text.append(fractionText);
+		text.append(" ms");
+
+		return text;
+	}
+}
+
+bool PlatformProcessSchedulingControls::QueryTimerResolution(uint32_t& coarsest, uint32_t& finest)
+{
+	Platform::TimerResolutionRange range{};
+
+	if (!Platform::QueryTimerResolution(range) || range.finest == 0 || range.finest > range.coarsest)
+	{
+		return false;
+	}
+
+	coarsest = range.coarsest;
+	finest = range.finest;
+	return true;
+}
+
+bool PlatformProcessSchedulingControls::SetTimerResolution(uint32_t resolution, uint32_t& actualResolution)
+{
+	return Platform::SetTimerResolution(resolution, actualResolution);
+}
+
+bool PlatformProcessSchedulingControls::ResetTimerResolution(uint32_t resolution)
+{
+	return Platform::ResetTimerResolution(resolution);
+}
+
+bool PlatformProcessSchedulingControls::DisablePowerThrottling(bool includeTimerResolution)
+{
+	return Platform::DisablePowerThrottling(includeTimerResolution);
+}
+
+bool PlatformProcessSchedulingControls::RestorePowerThrottling()
+{
+	return Platform::RestorePowerThrottling();
+}
+
+bool PlatformProcessSchedulingControls::SetPriorityClass(ProcessPriorityClass priorityClass, uint32_t& previousPriorityClass)
+{
+	return Platform::SetProcessPriorityClass(priorityClass, previousPriorityClass);
+}
+
+bool PlatformProcessSchedulingControls::RestorePriorityClass(uint32_t previousPriorityClass)
+{
+	return Platform::RestoreProcessPriorityClass(previousPriorityClass);
+}
+
+ProcessSchedulingPolicy::ProcessSchedulingPolicy(IProcessSchedulingControls& controls)
+	: controls(controls),
+	  state{}
+{
+}
+
+const ProcessSchedulingState& ProcessSchedulingPolicy::Apply(const ProcessSchedulingOptions& options)
+{
+	Restore();
+
+	if (options.timerResolutionMicroseconds != 0)
+	{
+		uint32_t resolution = options.timerResolutionMicroseconds * kTimerUnitsPerMicrosecond;
+
+		uint32_t coarsest = 0;
+		uint32_t finest = 0;
+
+		if (controls.QueryTimerResolution(coarsest, finest))
+		{
+			resolution = std::clamp(resolution, finest, coarsest);
+		}
+
+		uint32_t actualResolution = 0;
+
+		if (controls.SetTimerResolution(resolution, actualResolution))
+		{
+			state.timerResolution = resolution;
+			state.actualTimerResolution = actualResolution;
+		}
+		else
+		{
+			state.timerResolutionFailed = true;
+		}
+	}
+
+	if (options.disablePowerThrottling)
+	{
+		if (controls.DisablePowerThrottling(true))
+		{
+			state.powerThrottlingDisabled = true;
+			state.timerResolutionThrottlingDisabled = true;
+		}
+		else if (controls.DisablePowerThrottling(false))
+		{
+			state.powerThrottlingDisabled = true;
+		}
+		else
+		{
+			state.powerThrottlingFailed = true;
+		}
+	}
+
+	if (options.priorityClass != ProcessPriorityClass::Default)
+	{
+		uint32_t previousPriorityClass = 0;
+
+		if (controls.SetPriorityClass(options.priorityClass, previousPriorityClass))
+		{
+			state.priorityClass = options.priorityClass;
+			state.previousPriorityClass = previousPriorityClass;
+		}
+		else
+		{
+			state.priorityClassFailed = true;
+		}
+	}
+
+	return state;
+}
+
+void ProcessSchedulingPolicy::Restore()
+{
+	if (state.priorityClass != ProcessPriorityClass::Default)
+	{
+		controls.RestorePriorityClass(state.previousPriorityClass);
+	}
+
+	if (state.powerThrottlingDisabled)
+	{
+		controls.RestorePowerThrottling();
+	}
+
+	if (state.timerResolution != 0)
+	{
+		controls.ResetTimerResolution(state.timerResolution);
+	}
+
+	state = {};
+}
+
+const ProcessSchedulingState& ProcessSchedulingPolicy::GetState() const
+{
+	return state;
+}
+
+std::string FormatProcessSchedulingState(const ProcessSchedulingState& state)
+{
+	std::string text;
+
+	if (state.timerResolution != 0)
+	{
+		text.append("timer resolution ");
+		text.append(FormatTimerResolution(state.timerResolution));
+
+		if (state.actualTimerResolution != state.timerResolution)
+		{
+			text.append(" (system ");
+			text.append(FormatTimerResolution(state.actualTimerResolution));
+			text.push_back(')');
+		}
+	}
+	else if (state.timerResolutionFailed)
+	{
+		text.append("timer resolution change failed");
+	}
+
+	if (state.powerThrottlingDisabled)
+	{
+		AppendSeparator(text);
+		text.append(state.timerResolutionThrottlingDisabled
+			? "power throttling disabled"
+			: "power throttling disabled (execution speed only)");
+	}
+	else if (state.powerThrottlingFailed)
+	{
+		AppendSeparator(text);
+		text.append("power throttling opt-out failed");
+	}
+
+	if (state.priorityClass != ProcessPriorityClass::Default)
+	{
+		AppendSeparator(text);
+		text.append("priority class ");
+		text.append(GetProcessPriorityClassName(state.priorityClass));
+	}
+	else if (state.priorityClassFailed)
+	{
+		AppendSeparator(text);
+		text.append("priority class change failed");
+	}
+
+	return text;
+}
+
+const char* GetProcessPriorityClassName(ProcessPriorityClass priorityClass)
+{
+	switch (priorityClass)
+	{
+	case ProcessPriorityClass::Normal:
+		return "Normal";
+	case ProcessPriorityClass::AboveNormal:
+		return "AboveNormal";
+	case ProcessPriorityClass::High:
+		return "High";
+	case ProcessPriorityClass::Default:
+	default:
+		return "Default";
+	}
+}
@@ -0,0 +1,118 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include "ProcessPriorityClass.h"
+#include <cstdint>
+#include <string>
+
+// The OS functions that the process scheduling policy uses.
+//
+// Timer resolutions are in 100-nanosecond units, a smaller value is a finer resolution.
+class IProcessSchedulingControls
+{
+public:
+
+	virtual ~IProcessSchedulingControls() = default;
+
+	// Returns false if the supported range is not available, the finest value is at or below the coarsest.
+	virtual bool QueryTimerResolution(uint32_t& coarsest, uint32_t& finest) = 0;
+
+	virtual bool SetTimerResolution(uint32_t resolution, uint32_t& actualResolution) = 0;
+
+	virtual bool ResetTimerResolution(uint32_t resolution) = 0;
+
+	virtual bool DisablePowerThrottling(bool includeTimerResolution) = 0;
+
+	virtual bool RestorePowerThrottling() = 0;
+
+	virtual bool SetPriorityClass(ProcessPriorityClass priorityClass, uint32_t& previousPriorityClass) = 0;
+
+	virtual bool RestorePriorityClass(uint32_t previousPriorityClass) = 0;
+};
+
+// Implements the controls with the Platform functions.
+class PlatformProcessSchedulingControls final : public IProcessSchedulingControls
+{
+public:
+
+	bool QueryTimerResolution(uint32_t& coarsest, uint32_t& finest) override;
+	bool SetTimerResolution(uint32_t resolution, uint32_t& actualResolution) override;
+	bool ResetTimerResolution(uint32_t resolution) override;
+	bool DisablePowerThrottling(bool includeTimerResolution) override;
+	bool RestorePowerThrottling() override;
+	bool SetPriorityClass(ProcessPriorityClass priorityClass, uint32_t& previousPriorityClass) override;
+	bool RestorePriorityClass(uint32_t previousPriorityClass) override;
+};
+
+struct ProcessSchedulingOptions
+{
+	// The requested timer resolution in microseconds, 0 leaves it unchanged.
+	uint32_t timerResolutionMicroseconds;
+	bool disablePowerThrottling;
+	ProcessPriorityClass priorityClass;
+};
+
+// The changes that were made to the process, and the ones that the OS refused.
+struct ProcessSchedulingState
+{
+	// The resolution that was requested in 100-nanosecond units, 0 if it was not changed.
+	uint32_t timerResolution;
+	// The resolution that the OS reported after the request.
+	uint32_t actualTimerResolution;
+	bool timerResolutionFailed;
+
+	bool powerThrottlingDisabled;
+	// Older versions of Windows only allow the execution speed throttling to be disabled.
+	bool timerResolutionThrottlingDisabled;
+	bool powerThrottlingFailed;
+
+	ProcessPriorityClass priorityClass;
+	uint32_t previousPriorityClass;
+	bool priorityClassFailed;
+};
+
+// Applies the process scheduling options when the game starts, and undoes the changes when it exits.
+class ProcessSchedulingPolicy
+{
+public:
+
+	explicit ProcessSchedulingPolicy(IProcessSchedulingControls& controls);
+
+	// The requested timer resolution is clamped to the range that the system supports.
+	// The options that the OS rejects are recorded in the state and skipped.
+	const ProcessSchedulingState& Apply(const ProcessSchedulingOptions& options);
+
+	// Only the options that Apply changed are restored, in the reverse order.
+	void Restore();
+
+	const ProcessSchedulingState& GetState() const;
+
+private:
+
+	IProcessSchedulingControls& controls;
+	ProcessSchedulingState state;
+};
+
+// Describes the applied options for the log, returns an empty string if nothing was requested.
+std::string FormatProcessSchedulingState(const ProcessSchedulingState& state);
+
+const char* GetProcessPriorityClassName(ProcessPriorityClass priorityClass);
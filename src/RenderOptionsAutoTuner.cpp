@@ -0,0 +1,312 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "RenderOptionsAutoTuner.h"
+#include "IniParser.h"
+#include <charconv>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+	constexpr RenderOptionsCandidate kCandidates[] =
+	{
+		{ false, 0 },
+		{ false, 2 },
+		{ false, 4 },
+		{ false, 8 },
+		{ true, 0 },
+		{ true, 2 },
+		{ true, 4 },
+		{ true, 8 },
+	};
+
+	constexpr uint32_t kCacheFileVersion = 1;
+
+	// The percentage that a candidate's score must improve on the best candidate's score,
+	// this prevents measurement noise from selecting a different candidate.
+	constexpr uint64_t kMinImprovementPercent = 2;
+
+	bool ParseUInt32(std::string_view text, uint32_t& value)
+	{
+		const char* const first = text.data();
+		const char* const last = first + text.size();
+		const std::from_chars_result result = std::from_chars(first, last, value);
+
+		return result.ec == std::errc() && result.ptr == last && first != last;
+	}
+}
+
+RenderOptionsAutoTuner::RenderOptionsAutoTuner(
+	const RenderOptionsCandidate& currentOptions,
+	uint32_t warmupFrames,
+	uint32_t measuredFramesPerRound,
+	uint32_t roundCount)
+	: candidates(),
+	  measurements(),
+	  results(),
+	  warmupFrames(warmupFrames),
+	  measuredFramesPerRound(measuredFramesPerRound),
+	  roundCount(roundCount),
+	  currentCandidate(0),
+	  bestCandidate(0),
+	  currentRound(0),
+	  framesSinceChange(0),
+	  measuredFrames(0),
+	  finished(false)
+{
+	// The options that the game is using are measured first, so they win a tie.
+	candidates.push_back(currentOptions);
+
+	for (const RenderOptionsCandidate& candidate : kCandidates)
+	{
+		if (candidate != currentOptions)
+		{
+			candidates.push_back(candidate);
+		}
+	}
+
+	measurements.resize(candidates.size());
+}
+
+const RenderOptionsCandidate& RenderOptionsAutoTuner::GetCurrentCandidate() const
+{
+	return candidates[currentCandidate];
+}
+
+AutoTuneStep RenderOptionsAutoTuner::RecordFrame(uint64_t frameTimeMicroseconds)
+{
+	if (finished)
+	{
+		return AutoTuneStep::Finished;
+	}
+
+	framesSinceChange++;
+
+	if (framesSinceChange <= warmupFrames || frameTimeMicroseconds > kMaxMeasuredFrameTime)
+	{
+		return AutoTuneStep::Measuring;
+	}
+
+	measurements[currentCandidate].Add(frameTimeMicroseconds, 1);
+	measuredFrames++;
+
+	if (measuredFrames < measuredFramesPerRound)
+	{
+		return AutoTuneStep::Measuring;
+	}
+
+	measuredFrames = 0;
+	framesSinceChange = 0;
+	currentCandidate++;
+
+	if (currentCandidate == candidates.size())
+	{
+		currentCandidate = 0;
+		currentRound++;
+
+		if (currentRound == roundCount)
+		{
+			Finish();
+			return AutoTuneStep::Finished;
+		}
+	}
+
+	return AutoTuneStep::ApplyCandidate;
+}
+
+bool RenderOptionsAutoTuner::IsFinished() const
+{
+	return finished;
+}
+
+const RenderOptionsCandidate& RenderOptionsAutoTuner::GetBestCandidate() const
+{
+	return candidates[bestCandidate];
+}
+
+const std::vector<RenderOptionsResult>& RenderOptionsAutoTuner::GetResults() const
+{
+	return results;
+}
+
+void RenderOptionsAutoTuner::Finish()
+{
+	finished = true;
+	results.clear();
+
+	for (size_t i = 0; i < candidates.size(); i++)
+	{
+		const FrameTimeHistogram::Snapshot& snapshot = measurements[i];
+
+		results.push_back(RenderOptionsResult
+		{
+			candidates[i],
+			snapshot.GetTotalCount(),
+			snapshot.GetValueAtPercentile(50.0),
+			snapshot.GetValueAtPercentile(95.0),
+		});
+	}
+
+	bestCandidate = 0;
+
+	for (size_t i = 1; i < results.size(); i++)
+	{
+		const RenderOptionsResult& candidate = results[i];
+		const RenderOptionsResult& best = results[bestCandidate];
+
+		const uint64_t candidateScore = candidate.p95FrameTime * 100;
+		const uint64_t requiredScore = best.p95FrameTime * (100 - kMinImprovementPercent);
+
+		if (candidateScore < requiredScore
+			|| (candidate.p95FrameTime == best.p95FrameTime && candidate.medianFrameTime < best.medianFrameTime))
+		{
+			bestCandidate = i;
+		}
+	}
+
+	currentCandidate = bestCandidate;
+	measurements.clear();
+	measurements.shrink_to_fit();
+}
+
+bool LoadAutoTuneCache(const std::filesystem::path& path, const AutoTuneCacheKey& key, RenderOptionsCandidate& candidate)
+{
+	std::ifstream stream(path, std::ifstream::in | std::ifstream::binary);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	std::stringstream buffer;
+	buffer << stream.rdbuf();
+	const std::string text = buffer.str();
+
+	uint32_t version = 0;
+	uint32_t width = 0;
+	uint32_t height = 0;
+	uint32_t colorDepth = 0;
+	uint32_t windowMode = 0;
+	uint32_t noPartialBackingStoreCopies = 0;
+	uint32_t dirtyRectMergeFrames = 0;
+	bool driverMatches = false;
+	uint32_t valueCount = 0;
+
+	try
+	{
+		IniParser parser(text);
+		IniEntry entry{};
+
+		while (parser.Next(entry))
+		{
+			bool parsed = true;
+
+			if (IniEqualsIgnoreCase(entry.key, "Version"))
+			{
+				parsed = ParseUInt32(entry.value, version);
+			}
+			else if (IniEqualsIgnoreCase(entry.key, "Driver"))
+			{
+				driverMatches = IniEqualsIgnoreCase(entry.value, key.driver);
+			}
+			else if (IniEqualsIgnoreCase(entry.key, "Width"))
+			{
+				parsed = ParseUInt32(entry.value, width);
+			}
+			else if (IniEqualsIgnoreCase(entry.key, "Height"))
+			{
+				parsed = ParseUInt32(entry.value, height);
+			}
+			else if (IniEqualsIgnoreCase(entry.key, "ColorDepth"))
+			{
+				parsed = ParseUInt32(entry.value, colorDepth);
+			}
+			else if (IniEqualsIgnoreCase(entry.key, "WindowMode"))
+			{
+				parsed = ParseUInt32(entry.value, windowMode);
+			}
+			else if (IniEqualsIgnoreCase(entry.key, "NoPartialBackingStoreCopies"))
+			{
+				parsed = ParseUInt32(entry.value, noPartialBackingStoreCopies);
+			}
+			else if (IniEqualsIgnoreCase(entry.key, "DirtyRectMergeFrames"))
+			{
+				parsed = ParseUInt32(entry.value, dirtyRectMergeFrames);
+			}
+			else
+			{
+				continue;
+			}
+
+			if (!parsed)
+			{
+				return false;
+			}
+
+			valueCount++;
+		}
+	}
+	catch (const IniParseError&)
+	{
+		return false;
+	}
+
+	if (valueCount != 8
+		|| version != kCacheFileVersion
+		|| !driverMatches
+		|| width != key.width
+		|| height != key.height
+		|| colorDepth != key.colorDepth
+		|| windowMode != key.windowMode)
+	{
+		return false;
+	}
+
+	candidate.noPartialBackingStoreCopies = noPartialBackingStoreCopies != 0;
+	candidate.dirtyRectMergeFrames = static_cast<int32_t>(dirtyRectMergeFrames);
+
+	return true;
+}
+
+bool SaveAutoTuneCache(const std::filesystem::path& path, const AutoTuneCacheKey& key, const RenderOptionsCandidate& candidate)
+{
+	std::ofstream stream(path, std::ofstream::out | std::ofstream::trunc);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	stream << "; The render options that SC4GraphicsOptions selected for this system.\n"
+		<< "; Delete this file to measure the render options again.\n"
+		<< "[AutoTune]\n"
+		<< "Version=" << kCacheFileVersion << '\n'
+		<< "Driver=" << key.driver << '\n'
+		<< "Width=" << key.width << '\n'
+		<< "Height=" << key.height << '\n'
+		<< "ColorDepth=" << key.colorDepth << '\n'
+		<< "WindowMode=" << key.windowMode << '\n'
+		<< "NoPartialBackingStoreCopies=" << (candidate.noPartialBackingStoreCopies ? 1 : 0) << '\n'
+		<< "DirtyRectMergeFrames=" << candidate.dirtyRectMergeFrames << '\n';
+
+	return static_cast<bool>(stream.flush());
+}
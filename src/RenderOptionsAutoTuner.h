@@ -0,0 +1,124 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include "FrameTimeHistogram.h"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+struct RenderOptionsCandidate
+{
+	bool noPartialBackingStoreCopies;
+	int32_t dirtyRectMergeFrames;
+
+	bool operator==(const RenderOptionsCandidate&) const = default;
+};
+
+struct RenderOptionsResult
+{
+	RenderOptionsCandidate candidate;
+	uint64_t frameCount;
+	// The frame time percentiles, in microseconds.
+	uint64_t medianFrameTime;
+	uint64_t p95FrameTime;
+};
+
+enum class AutoTuneStep : int32_t
+{
+	// The current candidate is still being measured.
+	Measuring = 0,
+	// The caller must apply the new current candidate.
+	ApplyCandidate,
+	// The search is complete, the caller must apply the best candidate.
+	Finished
+};
+
+// Searches for the DirtyRectMergeFrames and NoPartialBackingStoreCopies render options
+// that give the lowest frame times on the user's system.
+//
+// The candidates are measured in several interleaved rounds, so that a change in the
+// scene that the game is drawing affects all of the candidates equally. A candidate is
+// scored by its 95th percentile frame time, and it must be at least 2% faster than the
+// best candidate so far to replace it. The options that the game is using are the first candidate.
+class RenderOptionsAutoTuner
+{
+public:
+
+	// The warm-up frames after each change of the render options are not measured,
+	// because the game may redraw the whole screen.
+	RenderOptionsAutoTuner(
+		const RenderOptionsCandidate& currentOptions,
+		uint32_t warmupFrames,
+		uint32_t measuredFramesPerRound,
+		uint32_t roundCount);
+
+	// Frames that take longer than this, e.g. while the game is loading or saving a city,
+	// are not measured.
+	static constexpr uint64_t kMaxMeasuredFrameTime = 250000;
+
+	const RenderOptionsCandidate& GetCurrentCandidate() const;
+
+	// Records the time of a frame that was drawn with the current candidate.
+	AutoTuneStep RecordFrame(uint64_t frameTimeMicroseconds);
+
+	bool IsFinished() const;
+
+	// Gets the best candidate, this is only valid after the search has finished.
+	const RenderOptionsCandidate& GetBestCandidate() const;
+
+	// Gets the measurements for each candidate, this is only valid after the search has finished.
+	const std::vector<RenderOptionsResult>& GetResults() const;
+
+private:
+
+	void Finish();
+
+	std::vector<RenderOptionsCandidate> candidates;
+	std::vector<FrameTimeHistogram::Snapshot> measurements;
+	std::vector<RenderOptionsResult> results;
+	uint32_t warmupFrames;
+	uint32_t measuredFramesPerRound;
+	uint32_t roundCount;
+	size_t currentCandidate;
+	size_t bestCandidate;
+	uint32_t currentRound;
+	uint32_t framesSinceChange;
+	uint32_t measuredFrames;
+	bool finished;
+};
+
+// Identifies the graphics options that a tuning result is valid for.
+struct AutoTuneCacheKey
+{
+	std::string driver;
+	uint32_t width;
+	uint32_t height;
+	uint32_t colorDepth;
+	uint32_t windowMode;
+};
+
+// Reads the result of a previous search, returns false if the file does not exist
+// or was written for different graphics options.
+bool LoadAutoTuneCache(const std::filesystem::path& path, const AutoTuneCacheKey& key, RenderOptionsCandidate& candidate);
+
+bool SaveAutoTuneCache(const std::filesystem::path& path, const AutoTuneCacheKey& key, const RenderOptionsCandidate& candidate);
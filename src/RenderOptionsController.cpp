@@ -0,0 +1,392 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "RenderOptionsController.h"
+#include "IniParser.h"
+#include "Logger.h"
+#include "SC4GameServices.h"
+#include "Settings.h"
+
+namespace
+{
+	// Returns the name of the first [RenderProperties] value that sets an auto-tuned option,
+	// or an empty string if there is none.
+	std::string_view FindAutoTunedOverride(const Settings& settings)
+	{
+		for (const RenderPropertyOverride& renderPropertyOverride : settings.GetRenderPropertyOverrides())
+		{
+			if (IniEqualsIgnoreCase(renderPropertyOverride.name, "NoPartialBackingStoreCopies")
+				|| IniEqualsIgnoreCase(renderPropertyOverride.name, "DirtyRectMergeFrames"))
+			{
+				return renderPropertyOverride.name;
+			}
+		}
+
+		return std::string_view();
+	}
+}
+
+RenderOptionsController::RenderOptionsController()
+	: pRenderProperties(nullptr),
+	  autoTuneCacheFilePath(),
+	  autoTuneCacheKey{},
+	  forceDrawOnScrollBatch(),
+	  renderPropertyOverrideBatch(),
+	  autoTuneBatch(),
+	  autoTuner(),
+	  lastPresentCounter(0)
+{
+}
+
+void RenderOptionsController::Start(
+	const Settings& settings,
+	ISC4RenderProperties* pRenderProperties,
+	const std::filesystem::path& autoTuneCacheFilePath)
+{
+	this->pRenderProperties = pRenderProperties;
+	this->autoTuneCacheFilePath = autoTuneCacheFilePath;
+
+	autoTuneCacheKey = AutoTuneCacheKey
+	{
+		settings.GetGDriverDescription().GetName(),
+		settings.GetWindowWidth(),
+		settings.GetWindowHeight(),
+		settings.GetColorDepth(),
+		static_cast<uint32_t>(settings.GetWindowMode())
+	};
+
+	if (settings.ForceDrawOnScroll())
+	{
+		ApplyForceDrawOnScrollOptions(settings);
+	}
+
+	ApplyRenderPropertyOverrides(settings);
+
+	if (settings.AutoTuneRenderOptions())
+	{
+		StartAutoTune(settings);
+	}
+}
+
+bool RenderOptionsController::IsAutoTuning() const
+{
+	return autoTuner != nullptr;
+}
+
+void RenderOptionsController::OnPresent(int64_t presentCounter, int64_t counterFrequency)
+{
+	if (!autoTuner)
+	{
+		return;
+	}
+
+	if (lastPresentCounter != 0)
+	{
+		const int64_t elapsedTicks = presentCounter - lastPresentCounter;
+		const uint64_t frameTime = static_cast<uint64_t>((elapsedTicks * 1000000) / counterFrequency);
+
+		switch (autoTuner->RecordFrame(frameTime))
+		{
+		case AutoTuneStep::ApplyCandidate:
+			ApplyAutoTuneCandidate(autoTuner->GetCurrentCandidate());
+			break;
+		case AutoTuneStep::Finished:
+			FinishAutoTune();
+			return;
+		case AutoTuneStep::Measuring:
+		default:
+			break;
+		}
+	}
+
+	lastPresentCounter = presentCounter;
+}
+
+void RenderOptionsController::OnForceDrawOnScrollChanged(const Settings& settings)
+{
+	// The ForceDrawOnScroll options change the frame times that were measured so far.
+	if (autoTuner)
+	{
+		StopAutoTune("the ForceDrawOnScroll setting changed");
+	}
+
+	if (pRenderProperties)
+	{
+		autoTuneBatch.Restore(pRenderProperties);
+	}
+
+	ApplyForceDrawOnScrollOptions(settings);
+
+	if (pRenderProperties && !autoTuneBatch.IsEmpty())
+	{
+		autoTuneBatch.Apply(pRenderProperties);
+	}
+}
+
+void RenderOptionsController::OnMaxFrameRateChanged(const Settings& settings)
+{
+	if (autoTuner && settings.GetMaxFrameRate() != 0)
+	{
+		StopAutoTune("the MaxFrameRate limit hides the frame time differences");
+	}
+}
+
+void RenderOptionsController::OnRenderPropertyOverridesChanged(const Settings& settings)
+{
+	const std::string_view autoTunedOverride = FindAutoTunedOverride(settings);
+
+	if (autoTuner && !autoTunedOverride.empty())
+	{
+		StopAutoTune("the [RenderProperties] section sets a tuned option");
+	}
+
+	if (!pRenderProperties)
+	{
+		return;
+	}
+
+	autoTuneBatch.Restore(pRenderProperties);
+
+	ApplyRenderPropertyOverrides(settings);
+
+	if (!autoTuneBatch.IsEmpty())
+	{
+		if (autoTunedOverride.empty())
+		{
+			autoTuneBatch.Apply(pRenderProperties);
+		}
+		else
+		{
+			autoTuneBatch = RenderPropertyBatch();
+
+			Logger::GetInstance().WriteLineFormatted(
+				LogCategory::Render,
+				LogLevel::Info,
+				"The tuned render options are no longer used because the [RenderProperties] section sets {}.",
+				autoTunedOverride);
+		}
+	}
+}
+
+// Sets the ForceDrawOnScroll render options, or restores the values that they replaced.
+void RenderOptionsController::ApplyForceDrawOnScrollOptions(const Settings& settings)
+{
+	Logger& logger = Logger::GetInstance();
+
+	if (settings.ForceDrawOnScroll())
+	{
+		bool result = false;
+
+		if (pRenderProperties)
+		{
+			// The ForceDrawOnScroll setting overrides a few render options for graphics cards with
+			// "slow partial depth buffer copies" that are commented out in the standard version of Graphics Rules.sgr.
+			// The comments in that file indicate that Maxis only observed this issue with a subset of older ATI Radeon
+			// cards, but complaints from users indicate it affects other graphics cards as well.
+
+			constexpr int32_t kCursorType_BlackAndWhite = 0;
+
+			forceDrawOnScrollBatch = RenderPropertyBatch();
+			// All of thse values are copied from Graphics Rules.sgr.
+			// Setting the NoPartialBackingStoreCopies option to true activates a special low-impact scrolling mode.
+			forceDrawOnScrollBatch.Add("NoPartialBackingStoreCopies", 1);
+			// This should reduce the number of dirty rects the game uses.
+			forceDrawOnScrollBatch.Add("DirtyRectMergeFrames", 8);
+			// Use a black & white cursor due to color cursors not working well on the affected cards.
+			forceDrawOnScrollBatch.Add("CursorType", kCursorType_BlackAndWhite);
+
+			// The values in the [RenderProperties] section take precedence.
+			for (const RenderPropertyOverride& renderPropertyOverride : settings.GetRenderPropertyOverrides())
+			{
+				forceDrawOnScrollBatch.Remove(renderPropertyOverride.name);
+			}
+
+			result = forceDrawOnScrollBatch.Apply(pRenderProperties);
+		}
+
+		if (result)
+		{
+			logger.WriteLine(LogCategory::Render, LogLevel::Info, "Set the ForceDrawOnScroll rendering options.");
+		}
+		else
+		{
+			logger.WriteLine(LogCategory::Render, LogLevel::Error, "Failed to set the ForceDrawOnScroll rendering options.");
+		}
+	}
+	else if (pRenderProperties)
+	{
+		forceDrawOnScrollBatch.Restore(pRenderProperties);
+
+		logger.WriteLine(LogCategory::Render, LogLevel::Info, "Restored the rendering options that ForceDrawOnScroll overrides.");
+	}
+}
+
+// Applies the [RenderProperties] section, replacing the values from a previous load of the settings.
+void RenderOptionsController::ApplyRenderPropertyOverrides(const Settings& settings)
+{
+	if (pRenderProperties)
+	{
+		renderPropertyOverrideBatch.Restore(pRenderProperties);
+		renderPropertyOverrideBatch = RenderPropertyBatch();
+
+		for (const RenderPropertyOverride& renderPropertyOverride : settings.GetRenderPropertyOverrides())
+		{
+			renderPropertyOverrideBatch.Add(renderPropertyOverride.name, renderPropertyOverride.value);
+		}
+
+		if (!renderPropertyOverrideBatch.IsEmpty())
+		{
+			renderPropertyOverrideBatch.Apply(pRenderProperties);
+		}
+	}
+}
+
+void RenderOptionsController::StartAutoTune(const Settings& settings)
+{
+	Logger& logger = Logger::GetInstance();
+
+	const std::string_view autoTunedOverride = FindAutoTunedOverride(settings);
+
+	if (!autoTunedOverride.empty())
+	{
+		logger.WriteLineFormatted(
+			LogCategory::Render,
+			LogLevel::Error,
+			"The render options are not tuned because the [RenderProperties] section sets {}.",
+			autoTunedOverride);
+		return;
+	}
+
+	if (settings.GetMaxFrameRate() != 0)
+	{
+		logger.WriteLine(
+			LogCategory::Render,
+			LogLevel::Error,
+			"The render options are not tuned because the MaxFrameRate limit hides the frame time differences.");
+		return;
+	}
+
+	RenderOptionsCandidate options{};
+
+	if (LoadAutoTuneCache(autoTuneCacheFilePath, autoTuneCacheKey, options))
+	{
+		ApplyAutoTuneCandidate(options);
+
+		logger.WriteLineFormatted(
+			LogCategory::Render,
+			LogLevel::Info,
+			"Using the tuned render options: NoPartialBackingStoreCopies={}, DirtyRectMergeFrames={}.",
+			options.noPartialBackingStoreCopies,
+			options.dirtyRectMergeFrames);
+		return;
+	}
+
+	if (pRenderProperties)
+	{
+		const int32_t noPartialBackingStoreKey = pRenderProperties->BoolPropertyIDFromName("NoPartialBackingStoreCopies");
+		const int32_t dirtyRectMergeFramesKey = pRenderProperties->IntPropertyIDFromName("DirtyRectMergeFrames");
+
+		if (noPartialBackingStoreKey != -1 && dirtyRectMergeFramesKey != -1)
+		{
+			options.noPartialBackingStoreCopies = pRenderProperties->GetBoolValue(noPartialBackingStoreKey);
+			options.dirtyRectMergeFrames = pRenderProperties->GetIntValue(dirtyRectMergeFramesKey);
+
+			autoTuner = std::make_unique<RenderOptionsAutoTuner>(
+				options,
+				kAutoTuneWarmupFrames,
+				kAutoTuneFramesPerRound,
+				kAutoTuneRoundCount);
+			lastPresentCounter = 0;
+
+			logger.WriteLine(
+				LogCategory::Render,
+				LogLevel::Info,
+				"Measuring the frame times of the render options, this takes a few minutes of play.");
+		}
+	}
+}
+
+void RenderOptionsController::ApplyAutoTuneCandidate(const RenderOptionsCandidate& candidate)
+{
+	if (pRenderProperties)
+	{
+		autoTuneBatch.Restore(pRenderProperties);
+		autoTuneBatch = RenderPropertyBatch();
+		autoTuneBatch.Add("NoPartialBackingStoreCopies", candidate.noPartialBackingStoreCopies ? 1 : 0);
+		autoTuneBatch.Add("DirtyRectMergeFrames", candidate.dirtyRectMergeFrames);
+		autoTuneBatch.Apply(pRenderProperties);
+	}
+}
+
+void RenderOptionsController::FinishAutoTune()
+{
+	Logger& logger = Logger::GetInstance();
+
+	for (const RenderOptionsResult& result : autoTuner->GetResults())
+	{
+		logger.WriteLineFormatted(
+			LogCategory::Render,
+			LogLevel::Info,
+			"NoPartialBackingStoreCopies={}, DirtyRectMergeFrames={}: {} frames, median {:.2f} ms, 95th percentile {:.2f} ms.",
+			result.candidate.noPartialBackingStoreCopies,
+			result.candidate.dirtyRectMergeFrames,
+			result.frameCount,
+			static_cast<double>(result.medianFrameTime) / 1000.0,
+			static_cast<double>(result.p95FrameTime) / 1000.0);
+	}
+
+	const RenderOptionsCandidate best = autoTuner->GetBestCandidate();
+	autoTuner.reset();
+
+	ApplyAutoTuneCandidate(best);
+
+	logger.WriteLineFormatted(
+		LogCategory::Render,
+		LogLevel::Info,
+		"Selected the render options NoPartialBackingStoreCopies={}, DirtyRectMergeFrames={}.",
+		best.noPartialBackingStoreCopies,
+		best.dirtyRectMergeFrames);
+
+	if (!SaveAutoTuneCache(autoTuneCacheFilePath, autoTuneCacheKey, best))
+	{
+		logger.WriteLine(LogCategory::Render, LogLevel::Error, "Failed to write the render options auto-tune file.");
+	}
+}
+
+// Discards the measurements and restores the values that the game used before the auto-tune started.
+// Nothing is written to the auto-tune file, so the render options are measured again the next time the game starts.
+void RenderOptionsController::StopAutoTune(std::string_view reason)
+{
+	autoTuner.reset();
+
+	if (pRenderProperties)
+	{
+		autoTuneBatch.Restore(pRenderProperties);
+	}
+
+	autoTuneBatch = RenderPropertyBatch();
+
+	Logger::GetInstance().WriteLineFormatted(
+		LogCategory::Render,
+		LogLevel::Info,
+		"Stopped measuring the render options because {}, they will be measured again the next time the game starts.",
+		reason);
+}
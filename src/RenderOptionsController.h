@@ -0,0 +1,86 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include "RenderOptionsAutoTuner.h"
+#include "RenderPropertyBatch.h"
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+class ISC4RenderProperties;
+class Settings;
+
+// Sets the render properties that the plugin changes, in three layers that are applied in order:
+// the ForceDrawOnScroll options, the [RenderProperties] section and the auto-tuned options.
+//
+// The auto-tuned NoPartialBackingStoreCopies and DirtyRectMergeFrames values replace the
+// ForceDrawOnScroll values, so the auto-tuned layer is removed while a lower layer changes
+// and is then applied again. A settings reload that invalidates the measurements stops the
+// auto-tune and restores the values that the game used before it started.
+class RenderOptionsController
+{
+public:
+
+	// Each render option combination is measured in 2 rounds of 200 frames, after 30 warm-up frames.
+	static constexpr uint32_t kAutoTuneWarmupFrames = 30;
+	static constexpr uint32_t kAutoTuneFramesPerRound = 200;
+	static constexpr uint32_t kAutoTuneRoundCount = 2;
+
+	RenderOptionsController();
+
+	// Sets the ForceDrawOnScroll options and the [RenderProperties] section, then applies the
+	// cached auto-tune result or starts measuring the render options.
+	// The render properties may be null, otherwise they must remain valid while the controller is used.
+	void Start(
+		const Settings& settings,
+		ISC4RenderProperties* pRenderProperties,
+		const std::filesystem::path& autoTuneCacheFilePath);
+
+	bool IsAutoTuning() const;
+
+	// Called on the game thread before a frame is presented, the counter is in ticks of the given frequency.
+	void OnPresent(int64_t presentCounter, int64_t counterFrequency);
+
+	// Called on the game thread after a settings reload changed the setting.
+	void OnForceDrawOnScrollChanged(const Settings& settings);
+	void OnMaxFrameRateChanged(const Settings& settings);
+	void OnRenderPropertyOverridesChanged(const Settings& settings);
+
+private:
+
+	void ApplyForceDrawOnScrollOptions(const Settings& settings);
+	void ApplyRenderPropertyOverrides(const Settings& settings);
+	void StartAutoTune(const Settings& settings);
+	void ApplyAutoTuneCandidate(const RenderOptionsCandidate& candidate);
+	void FinishAutoTune();
+	void StopAutoTune(std::string_view reason);
+
+	ISC4RenderProperties* pRenderProperties;
+	std::filesystem::path autoTuneCacheFilePath;
+	AutoTuneCacheKey autoTuneCacheKey;
+	RenderPropertyBatch forceDrawOnScrollBatch;
+	RenderPropertyBatch renderPropertyOverrideBatch;
+	RenderPropertyBatch autoTuneBatch;
+	std::unique_ptr<RenderOptionsAutoTuner> autoTuner;
+	int64_t lastPresentCounter;
+};
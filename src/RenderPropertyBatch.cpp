@@ -0,0 +1,161 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "RenderPropertyBatch.h"
+#include "IniParser.h"
+#include "Logger.h"
+#include "SC4GameServices.h"
+#include <algorithm>
+
+RenderPropertyBatch::RenderPropertyBatch()
+	: properties(),
+	  applied(false)
+{
+}
+
+void RenderPropertyBatch::Add(std::string_view name, int32_t value)
+{
+	for (Property& property : properties)
+	{
+		if (IniEqualsIgnoreCase(property.name, name))
+		{
+			property.value = value;
+			return;
+		}
+	}
+
+	properties.push_back(Property{ std::string(name), value, -1, 0, PropertyType::Unknown });
+}
+
+void RenderPropertyBatch::Remove(std::string_view name)
+{
+	properties.erase(
+		std::remove_if(
+			properties.begin(),
+			properties.end(),
+			[name](const Property& property) { return IniEqualsIgnoreCase(property.name, name); }),
+		properties.end());
+}
+
+bool RenderPropertyBatch::IsEmpty() const
+{
+	return properties.empty();
+}
+
+bool RenderPropertyBatch::Apply(ISC4RenderProperties* pRenderProperties)
+{
+	Logger& logger = Logger::GetInstance();
+
+	bool allNamesResolved = true;
+
+	// All of the names are resolved and the previous values are read before any property is set.
+	for (Property& property : properties)
+	{
+		property.id = pRenderProperties->BoolPropertyIDFromName(property.name.c_str());
+
+		if (property.id != -1)
+		{
+			property.type = PropertyType::Bool;
+			property.previousValue = pRenderProperties->GetBoolValue(property.id) ? 1 : 0;
+		}
+		else
+		{
+			property.id = pRenderProperties->IntPropertyIDFromName(property.name.c_str());
+
+			if (property.id != -1)
+			{
+				property.type = PropertyType::Int;
+				property.previousValue = pRenderProperties->GetIntValue(property.id);
+			}
+			else
+			{
+				property.type = PropertyType::Unknown;
+				allNamesResolved = false;
+
+				logger.WriteLineFormatted(
+					LogCategory::Render,
+					LogLevel::Error,
+					"Unknown render property '{}', it must be a bool or int property from Graphics Rules.sgr.",
+					property.name);
+			}
+		}
+	}
+
+	for (const Property& property : properties)
+	{
+		switch (property.type)
+		{
+		case PropertyType::Bool:
+			pRenderProperties->SetBoolValue(property.id, property.value != 0);
+
+			logger.WriteLineFormatted(
+				LogCategory::Render,
+				LogLevel::Info,
+				"Set the {} render property from {} to {}.",
+				property.name,
+				property.previousValue != 0,
+				property.value != 0);
+			break;
+		case PropertyType::Int:
+			pRenderProperties->SetIntValue(property.id, property.value);
+
+			logger.WriteLineFormatted(
+				LogCategory::Render,
+				LogLevel::Info,
+				"Set the {} render property from {} to {}.",
+				property.name,
+				property.previousValue,
+				property.value);
+			break;
+		case PropertyType::Unknown:
+		default:
+			break;
+		}
+	}
+
+	applied = true;
+
+	return allNamesResolved;
+}
+
+void RenderPropertyBatch::Restore(ISC4RenderProperties* pRenderProperties)
+{
+	if (applied)
+	{
+		applied = false;
+
+		for (const Property& property : properties)
+		{
+			switch (property.type)
+			{
+			case PropertyType::Bool:
+				pRenderProperties->SetBoolValue(property.id, property.previousValue != 0);
+				break;
+			case PropertyType::Int:
+				pRenderProperties->SetIntValue(property.id, property.previousValue);
+				break;
+			case PropertyType::Unknown:
+			default:
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,77 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class ISC4RenderProperties;
+
+// A set of render property values that are applied together.
+//
+// The property names are resolved with the game's BoolPropertyIDFromName and IntPropertyIDFromName
+// functions before any value is changed, the values that are replaced are kept so that they can be
+// restored.
+class RenderPropertyBatch
+{
+public:
+
+	RenderPropertyBatch();
+
+	// Adds a property value, a later value for the same name replaces the earlier one.
+	// Bool properties treat any non-zero value as true.
+	void Add(std::string_view name, int32_t value);
+
+	// Removes a property from the batch, e.g. when the user has set it to a different value.
+	void Remove(std::string_view name);
+
+	bool IsEmpty() const;
+
+	// Resolves the property names, sets the values and logs the previous and new values.
+	// Returns false if any property name is unknown, the properties with known names are still set.
+	bool Apply(ISC4RenderProperties* pRenderProperties);
+
+	// Restores the values that Apply replaced.
+	void Restore(ISC4RenderProperties* pRenderProperties);
+
+private:
+
+	enum class PropertyType : int32_t
+	{
+		Unknown = 0,
+		Bool,
+		Int
+	};
+
+	struct Property
+	{
+		std::string name;
+		int32_t value;
+		int32_t id;
+		int32_t previousValue;
+		PropertyType type;
+	};
+
+	std::vector<Property> properties;
+	bool applied;
+};
@@ -0,0 +1,104 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include <cstdint>
+
+// The video options from the game's preferences.
+struct SC4VideoOptions
+{
+	uint32_t width;
+	uint32_t height;
+	uint32_t bitDepth;
+	bool fullScreen;
+	// The game treats the driver type as a Boolean, 1 is hardware rendering and 0 is software rendering.
+	uint8_t driverType;
+};
+
+// The display options that the game's graphics system is using.
+struct SC4GameMetrics
+{
+	uint32_t width;
+	uint32_t height;
+	uint32_t bitDepth;
+	bool fullScreen;
+};
+
+// The game's render properties, the options from Graphics Rules.sgr.
+//
+// The property names are resolved to IDs that are only valid for that type,
+// the ID functions return -1 if the name is not a property of that type.
+class ISC4RenderProperties
+{
+public:
+
+	virtual ~ISC4RenderProperties() = default;
+
+	virtual int32_t BoolPropertyIDFromName(const char* name) = 0;
+
+	virtual int32_t IntPropertyIDFromName(const char* name) = 0;
+
+	virtual bool GetBoolValue(int32_t id) = 0;
+
+	virtual int32_t GetIntValue(int32_t id) = 0;
+
+	virtual void SetBoolValue(int32_t id, bool value) = 0;
+
+	virtual void SetIntValue(int32_t id, int32_t value) = 0;
+};
+
+// The game functions that the plugin's startup code uses.
+//
+// The director implements these with the game's GZCOM interfaces, keeping the
+// startup logic independent of the game allows it to run against another implementation.
+class ISC4GameServices
+{
+public:
+
+	virtual ~ISC4GameServices() = default;
+
+	// Returns false if the game's application object is not available.
+	virtual bool GetVideoPreferences(SC4VideoOptions& options) = 0;
+
+	// Updates the game's video preferences and saves them to the game's preferences file.
+	virtual void SaveVideoPreferences(const SC4VideoOptions& options) = 0;
+
+	virtual void EnableFullGamePauseOnAppFocusLoss(bool enable) = 0;
+
+	// Sets the options that the graphics system will use when it is initialized.
+	virtual void SetDesiredGameResolution(uint32_t width, uint32_t height, uint32_t bitDepth, bool windowed) = 0;
+
+	virtual void SetDefaultDriverClassID(uint32_t driverClassID) = 0;
+
+	// Returns false if the graphics system is not available.
+	virtual bool GetGameMetrics(SC4GameMetrics& metrics) = 0;
+
+	// Returns false if the graphics driver has not been created.
+	virtual bool GetDriverClassID(uint32_t& driverClassID) = 0;
+
+	virtual bool IsCommandLineSwitchPresent(const char* name) = 0;
+
+	virtual void AppendCommandLineArgument(const char* argument) = 0;
+
+	// Returns nullptr if the game has not loaded its render properties, the object
+	// remains valid for the lifetime of the game services.
+	virtual ISC4RenderProperties* GetRenderProperties() = 0;
+};
@@ -0,0 +1,397 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SC4PresentHooks.h"
+#include "FramePacer.h"
+#include "FrameTimeTelemetry.h"
+#include "HookRegistry.h"
+#include "Logger.h"
+#include "SC4GDriverCLSIDDefs.h"
+#include <Windows.h>
+#include <ddraw.h>
+#include <d3d.h>
+
+namespace
+{
+	constexpr const char* kHookGroupName = "present";
+
+	// The vtable indexes of the DirectDraw 7 and Direct3D 7 methods, from the interface declarations
+	// in ddraw.h and d3d.h.
+	constexpr size_t kIDirectDraw7CreateSurfaceIndex = 6;
+	constexpr size_t kIDirectDrawSurface7BltIndex = 5;
+	constexpr size_t kIDirectDrawSurface7FlipIndex = 11;
+	constexpr size_t kIDirect3D7CreateDeviceIndex = 4;
+	constexpr size_t kIDirect3DDevice7EndSceneIndex = 6;
+
+	template <typename T>
+	T GetVTableFunction(void* pInterface, size_t index)
+	{
+		void** vtable = *reinterpret_cast<void***>(pInterface);
+
+		return reinterpret_cast<T>(vtable[index]);
+	}
+}
+
+typedef HRESULT(WINAPI* PFN_DIRECT_DRAW_CREATE_EX)(
+	_In_opt_ GUID* lpGuid,
+	_Out_ LPVOID* lplpDD,
+	_In_ REFIID iid,
+	_In_opt_ IUnknown* pUnkOuter);
+
+typedef HRESULT(STDMETHODCALLTYPE* PFN_DIRECT_DRAW7_CREATE_SURFACE)(
+	IDirectDraw7* pThis,
+	LPDDSURFACEDESC2 lpDDSurfaceDesc2,
+	LPDIRECTDRAWSURFACE7* lplpDDSurface,
+	IUnknown* pUnkOuter);
+
+typedef HRESULT(STDMETHODCALLTYPE* PFN_DIRECT_DRAW_SURFACE7_BLT)(
+	IDirectDrawSurface7* pThis,
+	LPRECT lpDestRect,
+	LPDIRECTDRAWSURFACE7 lpDDSrcSurface,
+	LPRECT lpSrcRect,
+	DWORD dwFlags,
+	LPDDBLTFX lpDDBltFx);
+
+typedef HRESULT(STDMETHODCALLTYPE* PFN_DIRECT_DRAW_SURFACE7_FLIP)(
+	IDirectDrawSurface7* pThis,
+	LPDIRECTDRAWSURFACE7 lpDDSurfaceTargetOverride,
+	DWORD dwFlags);
+
+typedef HRESULT(STDMETHODCALLTYPE* PFN_DIRECT3D7_CREATE_DEVICE)(
+	IDirect3D7* pThis,
+	REFCLSID rclsid,
+	LPDIRECTDRAWSURFACE7 lpDDS,
+	LPDIRECT3DDEVICE7* lplpD3DDevice);
+
+typedef HRESULT(STDMETHODCALLTYPE* PFN_DIRECT3D_DEVICE7_END_SCENE)(IDirect3DDevice7* pThis);
+
+typedef BOOL(WINAPI* PFN_WGL_SWAP_BUFFERS)(_In_ HDC hdc);
+
+static PFN_DIRECT_DRAW_CREATE_EX RealDirectDrawCreateEx = nullptr;
+static PFN_DIRECT_DRAW7_CREATE_SURFACE RealCreateSurface = nullptr;
+static PFN_DIRECT_DRAW_SURFACE7_BLT RealBlt = nullptr;
+static PFN_DIRECT_DRAW_SURFACE7_FLIP RealFlip = nullptr;
+static PFN_DIRECT3D7_CREATE_DEVICE RealCreateDevice = nullptr;
+static PFN_DIRECT3D_DEVICE7_END_SCENE RealEndScene = nullptr;
+static PFN_WGL_SWAP_BUFFERS RealWglSwapBuffers = nullptr;
+
+static HookStatistics* s_DirectDrawCreateExStatistics = nullptr;
+static HookStatistics* s_CreateSurfaceStatistics = nullptr;
+static HookStatistics* s_BltStatistics = nullptr;
+static HookStatistics* s_FlipStatistics = nullptr;
+static HookStatistics* s_CreateDeviceStatistics = nullptr;
+static HookStatistics* s_EndSceneStatistics = nullptr;
+static HookStatistics* s_WglSwapBuffersStatistics = nullptr;
+
+static IDirectDrawSurface7* s_PrimarySurface = nullptr;
+// Set when the game finishes rendering a scene, and cleared by the next present.
+// In windowed mode the game copies each of the frame's dirty rectangles to the primary
+// surface with a separate Blt call, only the first one after the scene is a present.
+static bool s_FrameRendered = false;
+static FramePacer* s_FramePacer = nullptr;
+static SC4PresentHooks::PresentCallback s_PresentCallback = nullptr;
+static void* s_PresentCallbackContext = nullptr;
+
+static void BeforePresent()
+{
+	// The callback runs first, it may replace the frame pacer.
+	if (s_PresentCallback)
+	{
+		s_PresentCallback(s_PresentCallbackContext);
+	}
+
+	if (s_FramePacer)
+	{
+		s_FramePacer->WaitForNextFrame();
+	}
+}
+
+static void AfterPresent()
+{
+	FrameTimeTelemetry::GetInstance().OnFramePresented();
+}
+
+// Adds a hook to the present hook group and attaches it, the hooks are only registered once.
+static void InstallHook(HookStatistics*& pStatistics, PVOID* ppRealFunction, PVOID hookFunction, const char* name)
+{
+	if (!pStatistics)
+	{
+		HookRegistry& registry = HookRegistry::GetInstance();
+
+		pStatistics = &registry.Register(kHookGroupName, name, ppRealFunction, hookFunction);
+		registry.Install(kHookGroupName);
+	}
+}
+
+static HRESULT STDMETHODCALLTYPE HookedBlt(
+	IDirectDrawSurface7* pThis,
+	LPRECT lpDestRect,
+	LPDIRECTDRAWSURFACE7 lpDDSrcSurface,
+	LPRECT lpSrcRect,
+	DWORD dwFlags,
+	LPDDBLTFX lpDDBltFx)
+{
+	HookCallScope scope(*s_BltStatistics);
+
+	// In windowed mode the game presents a frame by copying its back buffer to the primary surface.
+	// When the EndScene hook is not installed every copy is counted as a present.
+	const bool isPresent = pThis == s_PrimarySurface
+		&& lpDDSrcSurface
+		&& (s_FrameRendered || !s_EndSceneStatistics);
+
+	if (isPresent)
+	{
+		s_FrameRendered = false;
+		BeforePresent();
+	}
+
+	const HRESULT hr = RealBlt(pThis, lpDestRect, lpDDSrcSurface, lpSrcRect, dwFlags, lpDDBltFx);
+
+	if (isPresent && SUCCEEDED(hr))
+	{
+		AfterPresent();
+	}
+
+	return hr;
+}
+
+static HRESULT STDMETHODCALLTYPE HookedFlip(
+	IDirectDrawSurface7* pThis,
+	LPDIRECTDRAWSURFACE7 lpDDSurfaceTargetOverride,
+	DWORD dwFlags)
+{
+	HookCallScope scope(*s_FlipStatistics);
+
+	const bool isPresent = pThis == s_PrimarySurface;
+
+	if (isPresent)
+	{
+		s_FrameRendered = false;
+		BeforePresent();
+	}
+
+	const HRESULT hr = RealFlip(pThis, lpDDSurfaceTargetOverride, dwFlags);
+
+	if (isPresent && SUCCEEDED(hr))
+	{
+		AfterPresent();
+	}
+
+	return hr;
+}
+
+static HRESULT STDMETHODCALLTYPE HookedEndScene(IDirect3DDevice7* pThis)
+{
+	HookCallScope scope(*s_EndSceneStatistics);
+
+	const HRESULT hr = RealEndScene(pThis);
+
+	if (SUCCEEDED(hr))
+	{
+		s_FrameRendered = true;
+	}
+
+	return hr;
+}
+
+static HRESULT STDMETHODCALLTYPE HookedCreateDevice(
+	IDirect3D7* pThis,
+	REFCLSID rclsid,
+	LPDIRECTDRAWSURFACE7 lpDDS,
+	LPDIRECT3DDEVICE7* lplpD3DDevice)
+{
+	HookCallScope scope(*s_CreateDeviceStatistics);
+
+	const HRESULT hr = RealCreateDevice(pThis, rclsid, lpDDS, lplpD3DDevice);
+
+	if (SUCCEEDED(hr) && !RealEndScene)
+	{
+		RealEndScene = GetVTableFunction<PFN_DIRECT3D_DEVICE7_END_SCENE>(*lplpD3DDevice, kIDirect3DDevice7EndSceneIndex);
+
+		InstallHook(s_EndSceneStatistics, &(PVOID&)RealEndScene, HookedEndScene, "IDirect3DDevice7::EndScene");
+	}
+
+	return hr;
+}
+
+static HRESULT STDMETHODCALLTYPE HookedCreateSurface(
+	IDirectDraw7* pThis,
+	LPDDSURFACEDESC2 lpDDSurfaceDesc2,
+	LPDIRECTDRAWSURFACE7* lplpDDSurface,
+	IUnknown* pUnkOuter)
+{
+	HookCallScope scope(*s_CreateSurfaceStatistics);
+
+	const HRESULT hr = RealCreateSurface(pThis, lpDDSurfaceDesc2, lplpDDSurface, pUnkOuter);
+
+	if (SUCCEEDED(hr)
+		&& lpDDSurfaceDesc2
+		&& (lpDDSurfaceDesc2->dwFlags & DDSD_CAPS) != 0
+		&& (lpDDSurfaceDesc2->ddsCaps.dwCaps & DDSCAPS_PRIMARYSURFACE) != 0)
+	{
+		IDirectDrawSurface7* pSurface = *lplpDDSurface;
+
+		// The game recreates the primary surface when the display mode changes,
+		// the surface methods only need to be hooked once.
+		s_PrimarySurface = pSurface;
+		s_FrameRendered = false;
+
+		if (!RealFlip)
+		{
+			RealBlt = GetVTableFunction<PFN_DIRECT_DRAW_SURFACE7_BLT>(pSurface, kIDirectDrawSurface7BltIndex);
+			RealFlip = GetVTableFunction<PFN_DIRECT_DRAW_SURFACE7_FLIP>(pSurface, kIDirectDrawSurface7FlipIndex);
+
+			InstallHook(s_BltStatistics, &(PVOID&)RealBlt, HookedBlt, "IDirectDrawSurface7::Blt");
+			InstallHook(s_FlipStatistics, &(PVOID&)RealFlip, HookedFlip, "IDirectDrawSurface7::Flip");
+		}
+	}
+
+	return hr;
+}
+
+static HRESULT WINAPI HookedDirectDrawCreateEx(
+	_In_opt_ GUID* lpGuid,
+	_Out_ LPVOID* lplpDD,
+	_In_ REFIID iid,
+	_In_opt_ IUnknown* pUnkOuter)
+{
+	HookCallScope scope(*s_DirectDrawCreateExStatistics);
+
+	const HRESULT hr = RealDirectDrawCreateEx(lpGuid, lplpDD, iid, pUnkOuter);
+
+	if (SUCCEEDED(hr) && !RealCreateSurface && IsEqualIID(iid, IID_IDirectDraw7))
+	{
+		IDirectDraw7* pDirectDraw = static_cast<IDirectDraw7*>(*lplpDD);
+
+		RealCreateSurface = GetVTableFunction<PFN_DIRECT_DRAW7_CREATE_SURFACE>(pDirectDraw, kIDirectDraw7CreateSurfaceIndex);
+
+		InstallHook(s_CreateSurfaceStatistics, &(PVOID&)RealCreateSurface, HookedCreateSurface, "IDirectDraw7::CreateSurface");
+
+		// The game renders with a Direct3D 7 device, its EndScene calls mark the end of each frame.
+		IDirect3D7* pDirect3D = nullptr;
+
+		if (SUCCEEDED(pDirectDraw->QueryInterface(IID_IDirect3D7, reinterpret_cast<void**>(&pDirect3D))))
+		{
+			RealCreateDevice = GetVTableFunction<PFN_DIRECT3D7_CREATE_DEVICE>(pDirect3D, kIDirect3D7CreateDeviceIndex);
+			pDirect3D->Release();
+
+			InstallHook(s_CreateDeviceStatistics, &(PVOID&)RealCreateDevice, HookedCreateDevice, "IDirect3D7::CreateDevice");
+		}
+		else
+		{
+			LOG_DEBUG(LogCategory::Hooks, "Failed to get the IDirect3D7 interface, every Blt to the primary surface is a present.");
+		}
+	}
+
+	return hr;
+}
+
+static BOOL WINAPI HookedWglSwapBuffers(_In_ HDC hdc)
+{
+	HookCallScope scope(*s_WglSwapBuffersStatistics);
+
+	BeforePresent();
+
+	const BOOL result = RealWglSwapBuffers(hdc);
+
+	if (result)
+	{
+		AfterPresent();
+	}
+
+	return result;
+}
+
+void SC4PresentHooks::Install(const SC4GDriverDescription& driver)
+{
+	Logger& logger = Logger::GetInstance();
+
+	// The game loads the driver's system DLL when it initializes the graphics system, the DLL is loaded
+	// early so that its functions can be hooked. A DirectX wrapper's ddraw.dll in the game folder is
+	// found using the same search order that the game uses.
+	switch (driver.GetGZCLSID())
+	{
+	case kSCGDriverDirectX:
+	{
+		HMODULE ddraw = LoadLibraryW(L"ddraw.dll");
+
+		if (ddraw)
+		{
+			RealDirectDrawCreateEx = reinterpret_cast<PFN_DIRECT_DRAW_CREATE_EX>(GetProcAddress(ddraw, "DirectDrawCreateEx"));
+		}
+
+		if (RealDirectDrawCreateEx)
+		{
+			InstallHook(s_DirectDrawCreateExStatistics, &(PVOID&)RealDirectDrawCreateEx, HookedDirectDrawCreateEx, "DirectDrawCreateEx");
+		}
+		else
+		{
+			logger.WriteLine(LogCategory::Hooks, LogLevel::Error, "Failed to find DirectDrawCreateEx, the present hooks were not installed.");
+		}
+		break;
+	}
+	case kSCGDriverOpenGL:
+	{
+		HMODULE opengl32 = LoadLibraryW(L"opengl32.dll");
+
+		if (opengl32)
+		{
+			RealWglSwapBuffers = reinterpret_cast<PFN_WGL_SWAP_BUFFERS>(GetProcAddress(opengl32, "wglSwapBuffers"));
+		}
+
+		if (RealWglSwapBuffers)
+		{
+			InstallHook(s_WglSwapBuffersStatistics, &(PVOID&)RealWglSwapBuffers, HookedWglSwapBuffers, "wglSwapBuffers");
+		}
+		else
+		{
+			logger.WriteLine(LogCategory::Hooks, LogLevel::Error, "Failed to find wglSwapBuffers, the present hooks were not installed.");
+		}
+		break;
+	}
+	default:
+		logger.WriteLineFormatted(
+			LogCategory::Hooks,
+			LogLevel::Info,
+			"The frame time telemetry and frame rate limit are not supported for the {} driver.",
+			driver.GetName());
+		break;
+	}
+}
+
+void SC4PresentHooks::Remove()
+{
+	HookRegistry::GetInstance().Remove(kHookGroupName);
+
+	s_PrimarySurface = nullptr;
+	s_FrameRendered = false;
+}
+
+void SC4PresentHooks::SetFramePacer(FramePacer* pacer)
+{
+	s_FramePacer = pacer;
+}
+
+void SC4PresentHooks::SetPresentCallback(PresentCallback callback, void* context)
+{
+	s_PresentCallbackContext = context;
+	s_PresentCallback = callback;
+}
@@ -0,0 +1,53 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include "SC4GDriverDescription.h"
+
+class FramePacer;
+
+// Hooks the functions that the game's graphics driver uses to present a frame,
+// and reports each presented frame to the frame time telemetry.
+// When a frame pacer is set, it is called before each present to limit the frame rate.
+// The present callback is called on the game's render thread before each present, it is
+// used to apply work that other threads hand off to the game thread.
+//
+// The DirectX driver presents with IDirectDrawSurface7::Flip in full screen mode
+// and with a IDirectDrawSurface7::Blt to the primary surface in windowed mode.
+// A windowed frame can copy several dirty rectangles, only the first Blt after
+// IDirect3DDevice7::EndScene is counted as a present.
+// The OpenGL driver presents with wglSwapBuffers.
+//
+// The hooks are registered with the HookRegistry, which reports their call statistics.
+namespace SC4PresentHooks
+{
+	void Install(const SC4GDriverDescription& driver);
+
+	void Remove();
+
+	// Sets the frame pacer that is called before the game presents a frame, or nullptr to remove it.
+	void SetFramePacer(FramePacer* pacer);
+
+	typedef void(*PresentCallback)(void* context);
+
+	// Sets the callback that is called before the game presents a frame, or nullptr to remove it.
+	void SetPresentCallback(PresentCallback callback, void* context);
+}
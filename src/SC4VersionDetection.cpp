@@ -41,51 +41,117 @@
 */
 
 #include "SC4VersionDetection.h"
+#include "StartupTimeline.h"
+#include <filesystem>
+#include <string_view>
+#include <system_error>
 #include <Windows.h>
+#include <Psapi.h>
 #include "wil/resource.h"
 #include "wil/win32_helpers.h"
 
+static constexpr std::string_view FingerprintCacheFileName = "SC4GraphicsOptions.GameExecutable.ini";
+
 namespace
 {
-	uint64_t GetAssemblyVersion(HMODULE hModule)
+	bool LoadGameImage(PEImage& image)
+	{
+		// The executable is already mapped into memory, reading its headers and resources
+		// from the mapped image avoids reading the 7 MB file from disk.
+		const HMODULE hModule = GetModuleHandleW(nullptr);
+		MODULEINFO moduleInfo{};
+
+		return hModule
+			&& GetModuleInformation(GetCurrentProcess(), hModule, &moduleInfo, sizeof(moduleInfo))
+			&& image.Load(moduleInfo.lpBaseOfDll, moduleInfo.SizeOfImage);
+	}
+
+	std::filesystem::path GetGameExecutablePath()
 	{
-		wil::unique_cotaskmem_string szVersionFile = wil::GetModuleFileNameW(hModule);
+		wil::unique_cotaskmem_string modulePath = wil::GetModuleFileNameW(nullptr);
 
-		// http://stackoverflow.com/a/940743
-		DWORD verHandle = 0;
-		UINT  size = 0;
-		DWORD verSize = GetFileVersionInfoSizeW(szVersionFile.get(), &verHandle);
+		return std::filesystem::path(modulePath.get());
+	}
+
+	bool GetGameExecutableFileInfo(const std::filesystem::path& path, GameExecutableFileInfo& fileInfo)
+	{
+		std::error_code error;
+		const uintmax_t size = std::filesystem::file_size(path, error);
 
-		if (verSize > 0)
+		if (error)
 		{
-			auto verData = wil::make_unique_cotaskmem<BYTE[]>(verSize);
-			LPBYTE lpBuffer = nullptr;
+			return false;
+		}
 
-			if (GetFileVersionInfoW(szVersionFile.get(), 0, verSize, verData.get())
-				&& VerQueryValueW(verData.get(), L"\\", reinterpret_cast<LPVOID*>(&lpBuffer), &size)
-				&& size > 0)
+		const std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(path, error);
+
+		if (error)
+		{
+			return false;
+		}
+
+		fileInfo.size = size;
+		fileInfo.lastWriteTime = lastWriteTime.time_since_epoch().count();
+		return true;
+	}
+
+	std::filesystem::path GetFingerprintCacheFilePath()
+	{
+		wil::unique_cotaskmem_string modulePath = wil::GetModuleFileNameW(wil::GetModuleInstanceHandle());
+
+		std::filesystem::path path(modulePath.get());
+		path.replace_filename(FingerprintCacheFileName);
+
+		return path;
+	}
+
+	// Hashing the executable's code takes a few milliseconds, so the fingerprint is
+	// cached until the executable file changes.
+	bool GetFingerprint(GameExecutableFingerprint& fingerprint)
+	{
+		try
+		{
+			const std::filesystem::path executablePath = GetGameExecutablePath();
+			GameExecutableFileInfo fileInfo{};
+
+			if (!GetGameExecutableFileInfo(executablePath, fileInfo))
 			{
-				VS_FIXEDFILEINFO* verInfo = (VS_FIXEDFILEINFO*)lpBuffer;
-				if (verInfo->dwSignature == 0xfeef04bd)
-				{
-					uint64_t qwValue = (uint64_t)verInfo->dwFileVersionMS << 32;
-					qwValue |= verInfo->dwFileVersionLS;
-
-					return qwValue;
-				}
+				return ComputeGameExecutableFingerprint(executablePath, fingerprint);
 			}
-		}
 
-		return 0;
+			const std::filesystem::path cacheFilePath = GetFingerprintCacheFilePath();
+
+			if (LoadGameExecutableFingerprintCache(cacheFilePath, fileInfo, fingerprint))
+			{
+				return true;
+			}
+
+			if (!ComputeGameExecutableFingerprint(executablePath, fingerprint))
+			{
+				return false;
+			}
+
+			SaveGameExecutableFingerprintCache(cacheFilePath, fileInfo, fingerprint);
+			return true;
+		}
+		catch (const std::exception&)
+		{
+			return false;
+		}
 	}
 
-	uint16_t DetermineGameVersion()
+	uint16_t DetermineGameVersion(const PEImage& image)
 	{
-		uint64_t qwFileVersion = GetAssemblyVersion(nullptr);
+		uint64_t qwFileVersion = 0;
+
+		if (!image.GetFileVersion(qwFileVersion))
+		{
+			qwFileVersion = 0;
+		}
+
 		uint16_t wMajorVer = (qwFileVersion >> 48) & 0xFFFF;
 		uint16_t wMinorVer = (qwFileVersion >> 32) & 0xFFFF;
 		uint16_t wRevision = (qwFileVersion >> 16) & 0xFFFF;
-		uint16_t wBuildNum = qwFileVersion & 0xFFFF;
 
 		uint16_t nGameVersion = 0;
 
@@ -102,7 +168,16 @@ namespace
 		// Fall back to a less accurate detection mechanism
 		if (nGameVersion == 0)
 		{
-			uint8_t uSentinel = *(uint8_t*)0x6E5000;
+			constexpr uint64_t kSentinelAddress = 0x6E5000;
+
+			const uint8_t* pSentinel = nullptr;
+
+			if (image.GetImageBase() != 0 && image.GetImageBase() <= kSentinelAddress)
+			{
+				pSentinel = image.GetDataAtRva(static_cast<uint32_t>(kSentinelAddress - image.GetImageBase()), 1);
+			}
+
+			const uint8_t uSentinel = pSentinel ? *pSentinel : 0;
 
 			switch (uSentinel)
 			{
@@ -140,6 +215,40 @@ uint16_t SC4VersionDetection::GetGameVersion() const noexcept
 	return gameVersion;
 }
 
-SC4VersionDetection::SC4VersionDetection() : gameVersion(DetermineGameVersion())
+bool SC4VersionDetection::IsLargeAddressAware() const noexcept
+{
+	return largeAddressAware;
+}
+
+const PEImage& SC4VersionDetection::GetGameImage() const noexcept
+{
+	return gameImage;
+}
+
+bool SC4VersionDetection::GetExecutableFingerprint(GameExecutableFingerprint& value) const noexcept
+{
+	if (!hasFingerprint)
+	{
+		return false;
+	}
+
+	value = fingerprint;
+	return true;
+}
+
+SC4VersionDetection::SC4VersionDetection()
+	: gameVersion(0),
+	  largeAddressAware(false),
+	  gameImage(),
+	  fingerprint(),
+	  hasFingerprint(false)
 {
+	StartupTimelinePhase phase("SC4VersionDetection");
+
+	if (LoadGameImage(gameImage))
+	{
+		hasFingerprint = GetFingerprint(fingerprint);
+		gameVersion = DetermineGameVersion(gameImage);
+		largeAddressAware = gameImage.IsLargeAddressAware();
+	}
 }
@@ -20,6 +20,8 @@
  */
 
 #pragma once
+#include "GameExecutableFingerprint.h"
+#include "PEImage.h"
 #include <cstdint>
 
 class SC4VersionDetection
@@ -30,10 +32,23 @@ public:
 
 	uint16_t GetGameVersion() const noexcept;
 
+	// Returns true if the game executable has been patched to use up to 4 GB of memory.
+	bool IsLargeAddressAware() const noexcept;
+
+	// The game's executable image, this is empty if the image could not be read.
+	const PEImage& GetGameImage() const noexcept;
+
+	// Returns false if the fingerprint could not be computed.
+	bool GetExecutableFingerprint(GameExecutableFingerprint& fingerprint) const noexcept;
+
 private:
 
 	SC4VersionDetection();
 
 	uint16_t gameVersion;
+	bool largeAddressAware;
+	PEImage gameImage;
+	GameExecutableFingerprint fingerprint;
+	bool hasFingerprint;
 };
 
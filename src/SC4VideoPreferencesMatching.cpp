@@ -0,0 +1,43 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SC4VideoPreferencesMatching.h"
+
+bool DriverTypesMatch(uint8_t existingDriverType, const SC4GDriverDescription& newDriverType)
+{
+	bool existingDriverIsHardware = existingDriverType != 0;
+
+	return existingDriverIsHardware == newDriverType.IsHardwareDriver();
+}
+
+bool WindowModesMatch(bool isFullScreen, SC4WindowMode windowMode)
+{
+	switch (windowMode)
+	{
+	case SC4WindowMode::Windowed:
+	case SC4WindowMode::BorderlessFullScreen:
+		return !isFullScreen;
+	case SC4WindowMode::FullScreen:
+		return isFullScreen;
+	default:
+		return false;
+	}
+}
@@ -0,0 +1,33 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include "SC4GDriverDescription.h"
+#include "SC4WindowMode.h"
+#include <cstdint>
+
+// Checks if the driver type from the game's video preferences matches the driver.
+// The game's preferences treat the driver type as a Boolean, where a value
+// of 1 indicates hardware rendering and a value of 0 indicates software rendering.
+bool DriverTypesMatch(uint8_t existingDriverType, const SC4GDriverDescription& newDriverType);
+
+// Checks if the game's full screen state matches the window mode.
+bool WindowModesMatch(bool isFullScreen, SC4WindowMode windowMode);
@@ -20,40 +20,27 @@
  */
 
 #include "SC4WindowCreationHooks.h"
+#include "HookRegistry.h"
+#include "Logger.h"
+#include "SC4WindowNameMatching.h"
+#include "StartupTimeline.h"
 #include <Windows.h>
-#include <string>
-#include "boost/algorithm/string.hpp"
 #include "detours/detours.h"
 
 namespace
 {
-	bool StringViewEquals(const std::string_view& lhs, const std::string_view& rhs)
-	{
-		return lhs.size() == rhs.size()
-			&& boost::equals(lhs, rhs);
-	}
-
-	bool IsSC4AppWindowClassName(const std::string_view& className)
-	{
-		return StringViewEquals(className, "GDriverClass--DirectX")
-			|| StringViewEquals(className, "GDriverClass--OpenGL")
-			|| StringViewEquals(className, "GDriverClass--Software");
-	}
-
-	bool IsSC4AppWindowName(const std::string_view& windowName)
-	{
-		return StringViewEquals(windowName, "GDriverWindow--DirectX")
-			|| StringViewEquals(windowName, "GDriverWindow--OpenGL")
-			|| StringViewEquals(windowName, "GDriverWindow--Software");
-	}
+	constexpr const char* kHookGroupName = "window creation";
 
 	bool IsSC4AppWindow(
 		_In_opt_ LPCSTR lpClassName,
 		_In_opt_ LPCSTR lpWindowName)
 	{
+		StartupTimelineSample sample("IsSC4AppWindow");
+
 		bool result = false;
 
-		if (lpClassName && lpWindowName)
+		// The class name can also be an atom, which is a value below 0x10000 instead of a pointer.
+		if (!IS_INTRESOURCE(lpClassName) && lpWindowName)
 		{
 			// We check the window name first, as some windows may
 			// not use a valid string for the class name.
@@ -96,6 +83,9 @@ static PFN_SHOW_WINDOW RealShowWindow = &ShowWindow;
 
 static SC4WindowMode s_WindowMode = SC4WindowMode::Windowed;
 static HWND s_SC4MainWindowHWND = nullptr;
+static HookStatistics* s_CreateWindowExAStatistics = nullptr;
+static HookStatistics* s_SetWindowPosStatistics = nullptr;
+static HookStatistics* s_ShowWindowStatistics = nullptr;
 
 static HWND WINAPI HookedCreateWindowExA(
 	_In_ DWORD dwExStyle,
@@ -111,7 +101,11 @@ static HWND WINAPI HookedCreateWindowExA(
 	_In_opt_ HINSTANCE hInstance,
 	_In_opt_ LPVOID lpParam)
 {
-	if (IsSC4AppWindow(lpClassName, lpWindowName))
+	HookCallScope scope(*s_CreateWindowExAStatistics);
+
+	// The game only creates one main window, after it has been captured
+	// the window names are no longer checked.
+	if (s_CreateWindowExAStatistics->IsFilterActive() && IsSC4AppWindow(lpClassName, lpWindowName))
 	{
 		if (s_WindowMode == SC4WindowMode::BorderlessFullScreen)
 		{
@@ -145,6 +139,13 @@ static HWND WINAPI HookedCreateWindowExA(
 			hInstance,
 			lpParam);
 
+		if (s_SC4MainWindowHWND)
+		{
+			s_CreateWindowExAStatistics->RetireFilter();
+		}
+
+		LOG_TRACE(LogCategory::Hooks, "Captured the SC4 main window, {}\u0078{}.", nWidth, nHeight);
+
 		return s_SC4MainWindowHWND;
 	}
 	else
@@ -174,6 +175,8 @@ static BOOL WINAPI HookedSetWindowPos(
 	_In_ int cy,
 	_In_ UINT uFlags)
 {
+	HookCallScope scope(*s_SetWindowPosStatistics);
+
 	if (hWnd == s_SC4MainWindowHWND)
 	{
 		if (s_WindowMode == SC4WindowMode::BorderlessFullScreen)
@@ -189,6 +192,8 @@ static BOOL WINAPI HookedSetWindowPos(
 
 static BOOL WINAPI HookedShowWindow(_In_ HWND hWnd, _In_ int nCmdShow)
 {
+	HookCallScope scope(*s_ShowWindowStatistics);
+
 	if (hWnd == s_SC4MainWindowHWND)
 	{
 		if (s_WindowMode == SC4WindowMode::BorderlessFullScreen)
@@ -207,20 +212,31 @@ void SC4WindowCreationHooks::Install(SC4WindowMode windowMode)
 
 	DetourRestoreAfterWith();
 
-	DetourTransactionBegin();
-	DetourUpdateThread(GetCurrentThread());
-	DetourAttach(&(PVOID&)RealCreateWindowExA, HookedCreateWindowExA);
-	DetourAttach(&(PVOID&)RealSetWindowPos, HookedSetWindowPos);
-	DetourAttach(&(PVOID&)RealShowWindow, HookedShowWindow);
-	DetourTransactionCommit();
+	if (!s_CreateWindowExAStatistics)
+	{
+		HookRegistry& registry = HookRegistry::GetInstance();
+
+		s_CreateWindowExAStatistics = &registry.Register(
+			kHookGroupName,
+			"CreateWindowExA",
+			&(PVOID&)RealCreateWindowExA,
+			HookedCreateWindowExA);
+		s_SetWindowPosStatistics = &registry.Register(
+			kHookGroupName,
+			"SetWindowPos",
+			&(PVOID&)RealSetWindowPos,
+			HookedSetWindowPos);
+		s_ShowWindowStatistics = &registry.Register(
+			kHookGroupName,
+			"ShowWindow",
+			&(PVOID&)RealShowWindow,
+			HookedShowWindow);
+	}
+
+	HookRegistry::GetInstance().Install(kHookGroupName);
 }
 
 void SC4WindowCreationHooks::Remove()
 {
-	DetourTransactionBegin();
-	DetourUpdateThread(GetCurrentThread());
-	DetourDetach(&(PVOID&)RealCreateWindowExA, HookedCreateWindowExA);
-	DetourDetach(&(PVOID&)RealSetWindowPos, HookedSetWindowPos);
-	DetourDetach(&(PVOID&)RealShowWindow, HookedShowWindow);
-	DetourTransactionCommit();
+	HookRegistry::GetInstance().Remove(kHookGroupName);
 }
@@ -0,0 +1,70 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SC4WindowNameMatching.h"
+#include <cstddef>
+#include <cstring>
+
+namespace
+{
+	// Compares a string of a known length with a string literal, the compiler
+	// replaces the fixed length comparison with a few integer comparisons.
+	template <size_t N>
+	bool EqualsLiteral(const char* value, const char (&literal)[N])
+	{
+		return std::memcmp(value, literal, N - 1) == 0;
+	}
+
+	// Each of the game's window and class names has a different length for
+	// a given driver, so at most one comparison is needed.
+	// The names are at most 23 characters, a longer name cannot match.
+	constexpr size_t kMaxNameLength = 23;
+}
+
+bool IsSC4AppWindowClassName(const char* className)
+{
+	switch (strnlen(className, kMaxNameLength + 1))
+	{
+	case 20:
+		return EqualsLiteral(className, "GDriverClass--OpenGL");
+	case 21:
+		return EqualsLiteral(className, "GDriverClass--DirectX");
+	case 22:
+		return EqualsLiteral(className, "GDriverClass--Software");
+	default:
+		return false;
+	}
+}
+
+bool IsSC4AppWindowName(const char* windowName)
+{
+	switch (strnlen(windowName, kMaxNameLength + 1))
+	{
+	case 21:
+		return EqualsLiteral(windowName, "GDriverWindow--OpenGL");
+	case 22:
+		return EqualsLiteral(windowName, "GDriverWindow--DirectX");
+	case 23:
+		return EqualsLiteral(windowName, "GDriverWindow--Software");
+	default:
+		return false;
+	}
+}
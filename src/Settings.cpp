@@ -20,143 +20,167 @@
  */
 
 #include "Settings.h"
+#include "DisplayModeCache.h"
+#include "IniParser.h"
 #include "Logger.h"
-#include "boost/algorithm/string.hpp"
-#include "boost/property_tree/ptree.hpp"
-#include "boost/property_tree/ini_parser.hpp"
+#include "Platform.h"
+#include <charconv>
+#include <fstream>
 #include <string>
-#include <Windows.h>
 
 namespace
 {
-	bool EqualsIgnoreCase(const std::string_view& lhs, const std::string_view& rhs)
+	constexpr size_t kEnableIntroVideoIndex = GetSettingIndex("GraphicsOptions", "EnableIntroVideo");
+	constexpr size_t kPauseGameOnFocusLossIndex = GetSettingIndex("GraphicsOptions", "PauseGameOnFocusLoss");
+	constexpr size_t kForceDrawOnScrollIndex = GetSettingIndex("GraphicsOptions", "ForceDrawOnScroll");
+	constexpr size_t kAutoTuneRenderOptionsIndex = GetSettingIndex("GraphicsOptions", "AutoTuneRenderOptions");
+	constexpr size_t kDriverIndex = GetSettingIndex("GraphicsOptions", "Driver");
+	constexpr size_t kWindowWidthIndex = GetSettingIndex("GraphicsOptions", "WindowWidth");
+	constexpr size_t kWindowHeightIndex = GetSettingIndex("GraphicsOptions", "WindowHeight");
+	constexpr size_t kColorDepthIndex = GetSettingIndex("GraphicsOptions", "ColorDepth");
+	constexpr size_t kWindowModeIndex = GetSettingIndex("GraphicsOptions", "WindowMode");
+	constexpr size_t kMaxFrameRateIndex = GetSettingIndex("GraphicsOptions", "MaxFrameRate");
+	constexpr size_t kLogFormatIndex = GetSettingIndex("Logging", "LogFormat");
+	constexpr size_t kFirstLogLevelIndex = GetSettingIndex("Logging", kLogCategoryNames[0]);
+	constexpr size_t kStartupTraceIndex = GetSettingIndex("Logging", "StartupTrace");
+	constexpr size_t kFrameTimesIndex = GetSettingIndex("Telemetry", "FrameTimes");
+	constexpr size_t kReportIntervalSecondsIndex = GetSettingIndex("Telemetry", "ReportIntervalSeconds");
+	constexpr size_t kHotReloadIndex = GetSettingIndex("Settings", "HotReload");
+	constexpr size_t kTimerResolutionIndex = GetSettingIndex("Performance", "TimerResolutionMicroseconds");
+	constexpr size_t kDisablePowerThrottlingIndex = GetSettingIndex("Performance", "DisablePowerThrottling");
+	constexpr size_t kPriorityClassIndex = GetSettingIndex("Performance", "PriorityClass");
+
+	static_assert(
+		GetSettingIndex("Logging", kLogCategoryNames[kLogCategoryCount - 1]) == kFirstLogLevelIndex + kLogCategoryCount - 1,
+		"The log level settings must be in the same order as the LogCategory enumeration.");
+
+	std::string ReadFile(const std::filesystem::path& path)
 	{
-		return lhs.size() == rhs.size()
-			&& boost::iequals(lhs, rhs);
-	}
+		std::ifstream stream(path, std::ifstream::in | std::ifstream::binary);
 
-	bool StartsWithIgnoreCase(const std::string_view& lhs, const std::string_view& rhs)
-	{
-		return lhs.size() >= rhs.size()
-			&& boost::istarts_with(lhs, rhs);
-	}
-
-	SC4GDriverDescription DriverDescriptionFromProperty(
-		const boost::property_tree::ptree& tree,
-		const char* const propertyPath)
-	{
-		const std::string value = tree.get<std::string>(propertyPath);
-
-		if (EqualsIgnoreCase(value, "DirectX"))
-		{
-			return SC4GDriverDescription::DirectX();
-		}
-		else if (EqualsIgnoreCase(value, "OpenGL") || EqualsIgnoreCase(value, "SCGL"))
+		if (!stream)
 		{
-			return SC4GDriverDescription::OpenGL();
+			throw std::runtime_error("Failed to open the settings file.");
 		}
-		else if (StartsWithIgnoreCase(value, "Soft")) // SC4 only checks the first 4 letters of Software.
+
+		std::error_code ec;
+		const uintmax_t fileSize = std::filesystem::file_size(path, ec);
+
+		if (ec || fileSize > 1024 * 1024)
 		{
-			return SC4GDriverDescription::Software();
+			throw std::runtime_error("Failed to read the settings file.");
 		}
-		else
-		{
-			Logger& logger = Logger::GetInstance();
 
-			logger.WriteLineFormatted(
-				LogLevel::Error,
-				"Unknown Driver value '%s', falling back to DirectX.",
-				value.c_str());
+		std::string text(static_cast<size_t>(fileSize), '\0');
 
-			return SC4GDriverDescription::DirectX();
+		if (!stream.read(text.data(), static_cast<std::streamsize>(text.size())))
+		{
+			throw std::runtime_error("Failed to read the settings file.");
 		}
+
+		return text;
 	}
 
-	SC4WindowMode WindowModeFromProperty(
-		const boost::property_tree::ptree& tree,
-		const char* const propertyPath)
+	void LogInvalidValue(const SettingDefinition& definition, const IniEntry& entry, SettingParseResult result, uint32_t value)
 	{
-		const std::string value = tree.get<std::string>(propertyPath);
+		Logger& logger = Logger::GetInstance();
 
-		if (EqualsIgnoreCase(value, "Windowed"))
-		{
-			return SC4WindowMode::Windowed;
-		}
-		else if (EqualsIgnoreCase(value, "FullScreen"))
+		if (result == SettingParseResult::OutOfRange)
 		{
-			return SC4WindowMode::FullScreen;
-		}
-		else if (StartsWithIgnoreCase(value, "Borderless"))
-		{
-			return SC4WindowMode::BorderlessFullScreen;
+			logger.WriteLineFormatted(
+				LogCategory::Settings,
+				LogLevel::Error,
+				"Line {}, column {}: The {} value {} must be {}between {} and {}, using {}.",
+				entry.line,
+				entry.column,
+				entry.key,
+				entry.value,
+				(definition.flags & kSettingFlagsZeroDisables) != 0 ? "0 or " : "",
+				definition.minValue,
+				definition.maxValue,
+				value);
 		}
 		else
 		{
-			Logger& logger = Logger::GetInstance();
+			const std::string_view valueName = GetSettingValueName(definition, value);
 
 			logger.WriteLineFormatted(
+				LogCategory::Settings,
 				LogLevel::Error,
-				"Unknown WindowMode value '%s', falling back to Windowed.",
-				value.c_str());
-
-			return SC4WindowMode::Windowed;
+				"Line {}, column {}: Unknown {} value '{}', falling back to {}.",
+				entry.line,
+				entry.column,
+				entry.key,
+				entry.value,
+				valueName.empty() ? std::to_string(value) : std::string(valueName));
 		}
 	}
 }
 
-Settings::Settings()
-	: enableIntroVideo(true),
-	  pauseGameOnFocusLoss(false),
-	  forceDrawOnScroll(false),
-	  driverDescription(SC4GDriverDescription::DirectX()),
-	  windowWidth(1024),
-	  windowHeight(768),
-	  colorDepth(32),
-	  windowMode(SC4WindowMode::Windowed)
+Settings::Settings() : values(), renderPropertyOverrides()
 {
+	for (size_t i = 0; i < kSettingCount; i++)
+	{
+		values[i] = kSettingDefinitions[i].defaultValue;
+	}
 }
 
 void Settings::Load(const std::filesystem::path& path)
 {
-	Logger& logger = Logger::GetInstance();
+	// The values are read into a copy that replaces the current values when the whole
+	// file has been parsed, so a syntax error part way through the file does not leave
+	// some of its values applied.
+	Settings loaded;
+
+	try
+	{
+		// The file is read into a single buffer, the parser's keys and values are views into it.
+		const std::string text = ReadFile(path);
 
-	std::ifstream stream(path, std::ifstream::in);
+		IniParser parser(text);
+		IniEntry entry{};
 
-	if (!stream)
+		while (parser.Next(entry))
+		{
+			loaded.LoadValue(entry);
+		}
+	}
+	catch (...)
 	{
-		throw std::runtime_error("Failed to open the settings file.");
+		ApplyDisplayLimits();
+		throw;
 	}
 
-	boost::property_tree::ptree tree;
+	values = loaded.values;
+	renderPropertyOverrides = std::move(loaded.renderPropertyOverrides);
 
-	boost::property_tree::ini_parser::read_ini(stream, tree);
+	ApplyDisplayLimits();
 
-	enableIntroVideo = tree.get<bool>("GraphicsOptions.EnableIntroVideo");
-	pauseGameOnFocusLoss = tree.get<bool>("GraphicsOptions.PauseGameOnFocusLoss");
-	forceDrawOnScroll = tree.get<bool>("GraphicsOptions.ForceDrawOnScroll", false);
-	driverDescription = DriverDescriptionFromProperty(tree, "GraphicsOptions.Driver");
-	windowMode = WindowModeFromProperty(tree, "GraphicsOptions.WindowMode");
-	colorDepth = tree.get<uint32_t>("GraphicsOptions.ColorDepth");
+	LOG_DEBUG(
+		LogCategory::Settings,
+		"Loaded the settings: Driver={}, WindowMode={}, {}x{}x{}.",
+		GetGDriverDescription().GetName(),
+		GetSettingValueName(kSettingDefinitions[kWindowModeIndex], values[kWindowModeIndex]),
+		GetWindowWidth(),
+		GetWindowHeight(),
+		GetColorDepth());
+}
 
-	if (colorDepth != 16 && colorDepth != 32)
-	{
-		logger.WriteLineFormatted(
-			LogLevel::Error,
-			"Unsupported color depth value %d, must be one of 16 or 32. Defaulting to 32.",
-			colorDepth);
-		colorDepth = 32;
-	}
+void Settings::ApplyDisplayLimits()
+{
+	Logger& logger = Logger::GetInstance();
 
-	const uint32_t primaryMonitorWidth = static_cast<uint32_t>(GetSystemMetrics(SM_CXSCREEN));
-	const uint32_t primaryMonitorHeight = static_cast<uint32_t>(GetSystemMetrics(SM_CYSCREEN));
+	const Platform::DisplaySize primaryMonitorSize = Platform::GetPrimaryMonitorSize();
+	const uint32_t primaryMonitorWidth = primaryMonitorSize.width;
+	const uint32_t primaryMonitorHeight = primaryMonitorSize.height;
 
-	if (windowMode == SC4WindowMode::BorderlessFullScreen)
+	if (GetWindowMode() == SC4WindowMode::BorderlessFullScreen)
 	{
 		// Borderless full screen mode is a window that has no caption or border
 		// and matches the resolution of the primary monitor.
 		// The OS will detect this case and hide the task bar.
-		windowWidth = primaryMonitorWidth;
-		windowHeight = primaryMonitorHeight;
+		values[kWindowWidthIndex] = primaryMonitorWidth;
+		values[kWindowHeightIndex] = primaryMonitorHeight;
 	}
 	else
 	{
@@ -165,75 +189,298 @@ void Settings::Load(const std::filesystem::path& path)
 		// If the exclusive full screen window size is less then the primary monitor's
 		// resolution, the OS will change the monitor's display resolution to whatever
 		// the application requests.
+		// The schema limits the window size to 800x600 or larger.
 
-		windowWidth = tree.get<uint32_t>("GraphicsOptions.WindowWidth");
-		windowHeight = tree.get<uint32_t>("GraphicsOptions.WindowHeight");
+		const Platform::DisplayModeList* displayModes = GetWindowMode() == SC4WindowMode::FullScreen
+			? DisplayModeCache::GetInstance().GetPrimaryDisplayModes()
+			: nullptr;
 
-		if (windowWidth < 800 || windowHeight < 600)
+		if (displayModes)
 		{
-			logger.WriteLine(
-				LogLevel::Error,
-				"The window dimensions must be at least 800x600, defaulting to 800x600.");
-
-			windowWidth = 800;
-			windowHeight = 600;
+			SelectFullScreenDisplayMode(*displayModes);
 		}
-		else if (windowWidth > primaryMonitorWidth || windowHeight > primaryMonitorHeight)
+		else if (values[kWindowWidthIndex] > primaryMonitorWidth || values[kWindowHeightIndex] > primaryMonitorHeight)
 		{
 			logger.WriteLineFormatted(
+				LogCategory::Settings,
 				LogLevel::Error,
 				"The window dimensions are larger than the monitor size, using the"
-				"the primary display size %u\u0078%u.",
+				" primary display size {}\u0078{}.",
 				primaryMonitorWidth,
 				primaryMonitorHeight);
 
-			windowWidth = primaryMonitorWidth;
-			windowHeight = primaryMonitorHeight;
+			values[kWindowWidthIndex] = primaryMonitorWidth;
+			values[kWindowHeightIndex] = primaryMonitorHeight;
 		}
 	}
 }
 
+void Settings::SelectFullScreenDisplayMode(const Platform::DisplayModeList& displayModes)
+{
+	// Requesting a mode that the monitor does not support makes the exclusive full screen
+	// mode change slow, or causes it to fail.
+	const DisplayModeRequest request
+	{
+		values[kWindowWidthIndex],
+		values[kWindowHeightIndex],
+		values[kColorDepthIndex],
+		kSettingDefinitions[kWindowWidthIndex].minValue,
+		kSettingDefinitions[kWindowHeightIndex].minValue,
+	};
+
+	const DisplayModeSelection selection = SelectDisplayMode(displayModes, request);
+	const Platform::DisplayMode& mode = selection.mode;
+
+	Logger& logger = Logger::GetInstance();
+
+	switch (selection.match)
+	{
+	case DisplayModeMatch::Desktop:
+		logger.WriteLineFormatted(
+			LogCategory::Settings,
+			LogLevel::Info,
+			"Using the desktop display mode {}\u0078{}\u0078{} at {} Hz, the display mode does not need to change.",
+			mode.width,
+			mode.height,
+			mode.bitsPerPixel,
+			mode.refreshRate);
+		break;
+	case DisplayModeMatch::Exact:
+		logger.WriteLineFormatted(
+			LogCategory::Settings,
+			LogLevel::Info,
+			"Using the display mode {}\u0078{}\u0078{}, the monitor supports up to {} Hz at this size.",
+			mode.width,
+			mode.height,
+			mode.bitsPerPixel,
+			mode.refreshRate);
+		break;
+	case DisplayModeMatch::Closest:
+		logger.WriteLineFormatted(
+			LogCategory::Settings,
+			LogLevel::Error,
+			"The monitor does not support {}\u0078{}\u0078{}, using the closest display mode {}\u0078{}\u0078{} at up to {} Hz.",
+			request.width,
+			request.height,
+			request.bitsPerPixel,
+			mode.width,
+			mode.height,
+			mode.bitsPerPixel,
+			mode.refreshRate);
+		break;
+	case DisplayModeMatch::None:
+	default:
+		logger.WriteLineFormatted(
+			LogCategory::Settings,
+			LogLevel::Error,
+			"The monitor has no {}-bit display modes, the game may fail to switch to full screen mode.",
+			request.bitsPerPixel);
+		return;
+	}
+
+	values[kWindowWidthIndex] = mode.width;
+	values[kWindowHeightIndex] = mode.height;
+}
+
+void Settings::LoadValue(const IniEntry& entry)
+{
+	if (IniEqualsIgnoreCase(entry.section, "RenderProperties"))
+	{
+		// The render property names are not known until the game loads Graphics Rules.sgr.
+		LoadRenderPropertyOverride(entry);
+		return;
+	}
+
+	const size_t index = FindSettingIndex(entry.section, entry.key);
+
+	if (index != kInvalidSettingIndex)
+	{
+		const SettingDefinition& definition = kSettingDefinitions[index];
+
+		uint32_t value = 0;
+		const SettingParseResult result = ParseSettingValue(definition, entry.value, value);
+
+		if (result != SettingParseResult::Success)
+		{
+			LogInvalidValue(definition, entry, result, value);
+		}
+
+		values[index] = value;
+	}
+}
+
+void Settings::LoadRenderPropertyOverride(const IniEntry& entry)
+{
+	int32_t value = 0;
+
+	if (IniEqualsIgnoreCase(entry.value, "true"))
+	{
+		value = 1;
+	}
+	else if (IniEqualsIgnoreCase(entry.value, "false"))
+	{
+		value = 0;
+	}
+	else
+	{
+		const char* const first = entry.value.data();
+		const char* const last = first + entry.value.size();
+		const std::from_chars_result result = std::from_chars(first, last, value);
+
+		if (result.ec != std::errc() || result.ptr != last || first == last)
+		{
+			Logger::GetInstance().WriteLineFormatted(
+				LogCategory::Settings,
+				LogLevel::Error,
+				"Line {}, column {}: Invalid {} render property value '{}', must be true, false or a number.",
+				entry.line,
+				entry.column,
+				entry.key,
+				entry.value);
+			return;
+		}
+	}
+
+	for (RenderPropertyOverride& existing : renderPropertyOverrides)
+	{
+		if (IniEqualsIgnoreCase(existing.name, entry.key))
+		{
+			existing.value = value;
+			return;
+		}
+	}
+
+	renderPropertyOverrides.push_back(RenderPropertyOverride{ std::string(entry.key), value });
+}
+
+uint32_t Settings::GetValue(size_t settingIndex) const
+{
+	return settingIndex < kSettingCount ? values[settingIndex] : 0;
+}
+
+void Settings::SetValue(size_t settingIndex, uint32_t value)
+{
+	if (settingIndex < kSettingCount)
+	{
+		values[settingIndex] = value;
+	}
+}
+
 bool Settings::EnableIntroVideo() const
 {
-	return enableIntroVideo;
+	return values[kEnableIntroVideoIndex] != 0;
 }
 
 const SC4GDriverDescription& Settings::GetGDriverDescription() const
 {
-	return driverDescription;
+	switch (values[kDriverIndex])
+	{
+	case kSCGDriverOpenGL:
+		return SC4GDriverDescription::OpenGL();
+	case kSCGDriverSoftware:
+		return SC4GDriverDescription::Software();
+	case kSCGDriverDirectX:
+	default:
+		return SC4GDriverDescription::DirectX();
+	}
 }
 
 uint32_t Settings::GetWindowWidth() const
 {
-	return windowWidth;
+	return values[kWindowWidthIndex];
 }
 
 uint32_t Settings::GetWindowHeight() const
 {
-	return windowHeight;
+	return values[kWindowHeightIndex];
 }
 
 uint32_t Settings::GetColorDepth() const
 {
-	return colorDepth;
+	return values[kColorDepthIndex];
 }
 
 SC4WindowMode Settings::GetWindowMode() const
 {
-	return windowMode;
+	return static_cast<SC4WindowMode>(values[kWindowModeIndex]);
 }
 
 bool Settings::IsUsingGDriver(uint32_t clsid) const
 {
-	return driverDescription.GetGZCLSID() == clsid;
+	return values[kDriverIndex] == clsid;
 }
 
 bool Settings::PauseGameOnFocusLoss() const
 {
-	return pauseGameOnFocusLoss;
+	return values[kPauseGameOnFocusLossIndex] != 0;
 }
 
 bool Settings::ForceDrawOnScroll() const
 {
-	return forceDrawOnScroll;
+	return values[kForceDrawOnScrollIndex] != 0;
+}
+
+bool Settings::AutoTuneRenderOptions() const
+{
+	return values[kAutoTuneRenderOptionsIndex] != 0;
+}
+
+uint32_t Settings::GetMaxFrameRate() const
+{
+	return values[kMaxFrameRateIndex];
+}
+
+LogFileFormat Settings::GetLogFileFormat() const
+{
+	return static_cast<LogFileFormat>(values[kLogFormatIndex]);
+}
+
+LogLevel Settings::GetLogLevel(LogCategory category) const
+{
+	return static_cast<LogLevel>(values[kFirstLogLevelIndex + static_cast<size_t>(category)]);
+}
+
+bool Settings::WriteStartupTrace() const
+{
+	return values[kStartupTraceIndex] != 0;
+}
+
+bool Settings::EnableFrameTimeTelemetry() const
+{
+	return values[kFrameTimesIndex] != 0;
+}
+
+uint32_t Settings::GetTelemetryReportInterval() const
+{
+	return values[kReportIntervalSecondsIndex];
+}
+
+bool Settings::HotReload() const
+{
+	return values[kHotReloadIndex] != 0;
+}
+
+uint32_t Settings::GetTimerResolution() const
+{
+	return values[kTimerResolutionIndex];
+}
+
+bool Settings::DisablePowerThrottling() const
+{
+	return values[kDisablePowerThrottlingIndex] != 0;
+}
+
+ProcessPriorityClass Settings::GetPriorityClass() const
+{
+	return static_cast<ProcessPriorityClass>(values[kPriorityClassIndex]);
+}
+
+const std::vector<RenderPropertyOverride>& Settings::GetRenderPropertyOverrides() const
+{
+	return renderPropertyOverrides;
+}
+
+void Settings::SetRenderPropertyOverrides(const std::vector<RenderPropertyOverride>& overrides)
+{
+	renderPropertyOverrides = overrides;
 }
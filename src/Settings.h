@@ -20,9 +20,29 @@
  */
 
 #pragma once
+#include "LogCategory.h"
+#include "LogFileFormat.h"
+#include "LogLevel.h"
+#include "Platform.h"
 #include "SC4GDriverDescription.h"
 #include "SC4WindowMode.h"
+#include "SettingsSchema.h"
+#include <array>
 #include <filesystem>
+#include <string>
+#include <vector>
+
+struct IniEntry;
+
+// A value from the [RenderProperties] section, the property type is
+// not known until the name is resolved by the game.
+struct RenderPropertyOverride
+{
+	std::string name;
+	int32_t value;
+
+	bool operator==(const RenderPropertyOverride&) const = default;
+};
 
 class Settings
 {
@@ -30,8 +50,16 @@ public:
 
 	Settings();
 
+	// Loads the settings from an INI file.
+	// If the file cannot be read or parsed an exception is thrown and the current values are kept.
 	void Load(const std::filesystem::path& path);
 
+	// Gets the value of a setting, the index is from GetSettingIndex or FindSettingIndex.
+	uint32_t GetValue(size_t settingIndex) const;
+
+	// Sets the value of a setting, this is used to apply the settings that can change while the game is running.
+	void SetValue(size_t settingIndex, uint32_t value);
+
 	bool EnableIntroVideo() const;
 
 	const SC4GDriverDescription& GetGDriverDescription() const;
@@ -50,15 +78,45 @@ public:
 
 	bool ForceDrawOnScroll() const;
 
+	bool AutoTuneRenderOptions() const;
+
+	// Gets the maximum frame rate, 0 if the frame rate is not limited.
+	uint32_t GetMaxFrameRate() const;
+
+	LogFileFormat GetLogFileFormat() const;
+
+	LogLevel GetLogLevel(LogCategory category) const;
+
+	bool WriteStartupTrace() const;
+
+	bool EnableFrameTimeTelemetry() const;
+
+	uint32_t GetTelemetryReportInterval() const;
+
+	bool HotReload() const;
+
+	// Gets the requested timer resolution in microseconds, 0 if the timer resolution is not changed.
+	uint32_t GetTimerResolution() const;
+
+	bool DisablePowerThrottling() const;
+
+	ProcessPriorityClass GetPriorityClass() const;
+
+	const std::vector<RenderPropertyOverride>& GetRenderPropertyOverrides() const;
+
+	void SetRenderPropertyOverrides(const std::vector<RenderPropertyOverride>& overrides);
+
 private:
 
-	bool enableIntroVideo;
-	bool pauseGameOnFocusLoss;
-	bool forceDrawOnScroll;
-	SC4GDriverDescription driverDescription;
-	uint32_t windowWidth;
-	uint32_t windowHeight;
-	uint32_t colorDepth;
-	SC4WindowMode windowMode;
-};
+	void LoadValue(const IniEntry& entry);
+
+	void LoadRenderPropertyOverride(const IniEntry& entry);
 
+	// Fits the window size to the primary monitor and its display modes.
+	void ApplyDisplayLimits();
+
+	void SelectFullScreenDisplayMode(const Platform::DisplayModeList& displayModes);
+
+	std::array<uint32_t, kSettingCount> values;
+	std::vector<RenderPropertyOverride> renderPropertyOverrides;
+};
@@ -0,0 +1,221 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SettingsFileWatcher.h"
+#include "Logger.h"
+#include "Platform.h"
+#include "SettingsReload.h"
+#include <array>
+
+namespace
+{
+	// Editors often write a file in several steps, e.g. truncate then write, or
+	// write a temporary file and rename it over the original.
+	constexpr int64_t kDebounceDelayMilliseconds = 250;
+
+	constexpr DWORD kNotifyFilter = FILE_NOTIFY_CHANGE_FILE_NAME
+		| FILE_NOTIFY_CHANGE_SIZE
+		| FILE_NOTIFY_CHANGE_LAST_WRITE;
+
+	bool ContainsFileName(const uint8_t* buffer, DWORD length, const std::wstring& fileName)
+	{
+		DWORD offset = 0;
+
+		while (offset < length)
+		{
+			const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(buffer + offset);
+
+			const int nameLength = static_cast<int>(info->FileNameLength / sizeof(WCHAR));
+
+			if (info->Action != FILE_ACTION_REMOVED
+				&& info->Action != FILE_ACTION_RENAMED_OLD_NAME
+				&& CompareStringOrdinal(
+					info->FileName,
+					nameLength,
+					fileName.c_str(),
+					static_cast<int>(fileName.size()),
+					TRUE) == CSTR_EQUAL)
+			{
+				return true;
+			}
+
+			if (info->NextEntryOffset == 0)
+			{
+				break;
+			}
+
+			offset += info->NextEntryOffset;
+		}
+
+		return false;
+	}
+}
+
+SettingsFileWatcher::SettingsFileWatcher()
+	: fileName(),
+	  callback(nullptr),
+	  callbackContext(nullptr),
+	  directory(),
+	  stopEvent(),
+	  watcherThread()
+{
+}
+
+SettingsFileWatcher::~SettingsFileWatcher()
+{
+	Stop();
+}
+
+bool SettingsFileWatcher::Start(const std::filesystem::path& filePath, ChangedCallback callback, void* context)
+{
+	if (watcherThread.joinable())
+	{
+		return true;
+	}
+
+	// The folder is watched instead of the file, because an editor may replace the file.
+	directory.reset(CreateFileW(
+		filePath.parent_path().c_str(),
+		FILE_LIST_DIRECTORY,
+		FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		nullptr,
+		OPEN_EXISTING,
+		FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+		nullptr));
+
+	if (!directory)
+	{
+		Logger::GetInstance().WriteLineFormatted(
+			LogCategory::Settings,
+			LogLevel::Error,
+			"Failed to watch the settings file folder, error code {}.",
+			GetLastError());
+		return false;
+	}
+
+	if (!stopEvent.try_create(wil::EventOptions::ManualReset, nullptr))
+	{
+		directory.reset();
+		return false;
+	}
+
+	fileName = filePath.filename().wstring();
+	this->callback = callback;
+	callbackContext = context;
+	watcherThread = std::thread(&SettingsFileWatcher::WatcherThreadProc, this);
+
+	return true;
+}
+
+void SettingsFileWatcher::Stop()
+{
+	if (watcherThread.joinable())
+	{
+		stopEvent.SetEvent();
+		watcherThread.join();
+	}
+
+	directory.reset();
+	stopEvent.reset();
+}
+
+void SettingsFileWatcher::WatcherThreadProc()
+{
+	const int64_t frequency = Platform::GetPerformanceFrequency();
+
+	SettingsChangeDebouncer debouncer((kDebounceDelayMilliseconds * frequency) / 1000);
+
+	wil::unique_event changeEvent;
+
+	if (!changeEvent.try_create(wil::EventOptions::ManualReset, nullptr))
+	{
+		return;
+	}
+
+	alignas(DWORD) std::array<uint8_t, 4096> buffer{};
+	OVERLAPPED overlapped{};
+	overlapped.hEvent = changeEvent.get();
+
+	auto beginRead = [&]()
+	{
+		changeEvent.ResetEvent();
+
+		return ReadDirectoryChangesW(
+			directory.get(),
+			buffer.data(),
+			static_cast<DWORD>(buffer.size()),
+			FALSE,
+			kNotifyFilter,
+			nullptr,
+			&overlapped,
+			nullptr) != FALSE;
+	};
+
+	bool readPending = beginRead();
+
+	while (true)
+	{
+		const int64_t remainingTicks = debouncer.GetRemainingTicks(Platform::GetPerformanceCounter());
+		const DWORD timeout = remainingTicks < 0
+			? INFINITE
+			: static_cast<DWORD>(((remainingTicks * 1000) + frequency - 1) / frequency);
+
+		const HANDLE handles[2] = { stopEvent.get(), changeEvent.get() };
+
+		const DWORD waitResult = WaitForMultipleObjects(readPending ? 2 : 1, handles, FALSE, timeout);
+
+		if (waitResult == WAIT_OBJECT_0 || waitResult == WAIT_FAILED)
+		{
+			break;
+		}
+		else if (waitResult == WAIT_OBJECT_0 + 1)
+		{
+			DWORD bytesTransferred = 0;
+
+			if (GetOverlappedResult(directory.get(), &overlapped, &bytesTransferred, FALSE))
+			{
+				// A zero length result means that the change buffer overflowed, the file may have changed.
+				if (bytesTransferred == 0 || ContainsFileName(buffer.data(), bytesTransferred, fileName))
+				{
+					debouncer.OnChange(Platform::GetPerformanceCounter());
+				}
+			}
+
+			readPending = beginRead();
+		}
+
+		if (debouncer.Poll(Platform::GetPerformanceCounter()))
+		{
+			LOG_DEBUG(LogCategory::Settings, "The settings file changed, reloading.");
+
+			callback(callbackContext);
+		}
+	}
+
+	if (readPending)
+	{
+		// The buffer and OVERLAPPED structure must remain valid until the read completes.
+		DWORD bytesTransferred = 0;
+
+		CancelIoEx(directory.get(), &overlapped);
+		GetOverlappedResult(directory.get(), &overlapped, &bytesTransferred, TRUE);
+	}
+}
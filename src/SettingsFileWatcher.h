@@ -0,0 +1,55 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include <filesystem>
+#include <thread>
+#include <Windows.h>
+#include "wil/resource.h"
+
+// Watches the plugin's settings file for changes using a background thread.
+// The change notifications are debounced, the callback is called on the watcher
+// thread once the file has not changed for a short delay.
+class SettingsFileWatcher
+{
+public:
+
+	typedef void(*ChangedCallback)(void* context);
+
+	SettingsFileWatcher();
+
+	~SettingsFileWatcher();
+
+	bool Start(const std::filesystem::path& filePath, ChangedCallback callback, void* context);
+
+	void Stop();
+
+private:
+
+	void WatcherThreadProc();
+
+	std::wstring fileName;
+	ChangedCallback callback;
+	void* callbackContext;
+	wil::unique_hfile directory;
+	wil::unique_event stopEvent;
+	std::thread watcherThread;
+};
@@ -0,0 +1,92 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SettingsReload.h"
+
+SettingsChangeDebouncer::SettingsChangeDebouncer(int64_t delayTicks)
+	: delayTicks(delayTicks),
+	  lastChangeCounter(0),
+	  pending(false)
+{
+}
+
+void SettingsChangeDebouncer::OnChange(int64_t currentCounter)
+{
+	// Every notification restarts the delay, an editor that writes a file in
+	// several steps only causes one reload.
+	lastChangeCounter = currentCounter;
+	pending = true;
+}
+
+bool SettingsChangeDebouncer::IsPending() const
+{
+	return pending;
+}
+
+int64_t SettingsChangeDebouncer::GetRemainingTicks(int64_t currentCounter) const
+{
+	if (!pending)
+	{
+		return -1;
+	}
+
+	const int64_t elapsedTicks = currentCounter - lastChangeCounter;
+
+	return elapsedTicks >= delayTicks ? 0 : delayTicks - elapsedTicks;
+}
+
+bool SettingsChangeDebouncer::Poll(int64_t currentCounter)
+{
+	if (GetRemainingTicks(currentCounter) == 0)
+	{
+		pending = false;
+		return true;
+	}
+
+	return false;
+}
+
+bool SettingsDiff::IsEmpty() const
+{
+	return runtimeChanges.empty() && deferredChanges.empty();
+}
+
+SettingsDiff DiffSettings(const Settings& current, const Settings& updated)
+{
+	SettingsDiff diff;
+
+	for (size_t i = 0; i < kSettingCount; i++)
+	{
+		if (current.GetValue(i) != updated.GetValue(i))
+		{
+			if ((kSettingDefinitions[i].flags & kSettingFlagsRuntimeChangeable) != 0)
+			{
+				diff.runtimeChanges.push_back(i);
+			}
+			else
+			{
+				diff.deferredChanges.push_back(i);
+			}
+		}
+	}
+
+	return diff;
+}
@@ -0,0 +1,65 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include "Settings.h"
+#include <cstdint>
+#include <vector>
+
+// Coalesces the burst of change notifications that a text editor produces when it saves
+// a file, a reload is ready once the file has not changed for the debounce delay.
+class SettingsChangeDebouncer
+{
+public:
+
+	explicit SettingsChangeDebouncer(int64_t delayTicks);
+
+	// Records a change notification at the specified performance counter value.
+	void OnChange(int64_t currentCounter);
+
+	bool IsPending() const;
+
+	// Returns the number of ticks until the pending reload is ready, or -1 if no change is pending.
+	int64_t GetRemainingTicks(int64_t currentCounter) const;
+
+	// Returns true, once, when the pending change has been quiet for the debounce delay.
+	bool Poll(int64_t currentCounter);
+
+private:
+
+	int64_t delayTicks;
+	int64_t lastChangeCounter;
+	bool pending;
+};
+
+// The settings that differ between the current and the reloaded settings, as indexes
+// into kSettingDefinitions.
+struct SettingsDiff
+{
+	// The settings that are applied while the game is running.
+	std::vector<size_t> runtimeChanges;
+	// The settings that take effect the next time that the game is started.
+	std::vector<size_t> deferredChanges;
+
+	bool IsEmpty() const;
+};
+
+SettingsDiff DiffSettings(const Settings& current, const Settings& updated);
@@ -0,0 +1,110 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SettingsSchema.h"
+#include "IniParser.h"
+#include <algorithm>
+#include <charconv>
+
+SettingParseResult ParseSettingValue(const SettingDefinition& definition, std::string_view text, uint32_t& value)
+{
+	switch (definition.type)
+	{
+	case SettingType::Bool:
+		if (IniEqualsIgnoreCase(text, "true") || text == "1")
+		{
+			value = 1;
+			return SettingParseResult::Success;
+		}
+		else if (IniEqualsIgnoreCase(text, "false") || text == "0")
+		{
+			value = 0;
+			return SettingParseResult::Success;
+		}
+		break;
+	case SettingType::UInt32:
+	{
+		const char* const first = text.data();
+		const char* const last = first + text.size();
+		uint32_t number = 0;
+
+		const std::from_chars_result result = std::from_chars(first, last, number);
+
+		if (result.ec == std::errc() && result.ptr == last && first != last)
+		{
+			if (number == 0 && (definition.flags & kSettingFlagsZeroDisables) != 0)
+			{
+				value = 0;
+				return SettingParseResult::Success;
+			}
+
+			value = std::clamp(number, definition.minValue, definition.maxValue);
+
+			return value == number ? SettingParseResult::Success : SettingParseResult::OutOfRange;
+		}
+		else if (result.ec == std::errc::result_out_of_range)
+		{
+			value = definition.maxValue;
+			return SettingParseResult::OutOfRange;
+		}
+		break;
+	}
+	case SettingType::Enum:
+		for (const SettingEnumValue& enumValue : definition.enumValues)
+		{
+			const bool matches = enumValue.matchPrefix
+				? IniStartsWithIgnoreCase(text, enumValue.name)
+				: IniEqualsIgnoreCase(text, enumValue.name);
+
+			if (matches)
+			{
+				value = enumValue.value;
+				return SettingParseResult::Success;
+			}
+		}
+		break;
+	}
+
+	value = definition.defaultValue;
+	return SettingParseResult::InvalidValue;
+}
+
+std::string_view GetSettingValueName(const SettingDefinition& definition, uint32_t value)
+{
+	switch (definition.type)
+	{
+	case SettingType::Bool:
+		return value != 0 ? "true" : "false";
+	case SettingType::Enum:
+		for (const SettingEnumValue& enumValue : definition.enumValues)
+		{
+			if (enumValue.value == value)
+			{
+				return enumValue.name;
+			}
+		}
+		break;
+	case SettingType::UInt32:
+		break;
+	}
+
+	return {};
+}
@@ -0,0 +1,345 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include "LogFileFormat.h"
+#include "LogLevel.h"
+#include "ProcessPriorityClass.h"
+#include "SC4GDriverCLSIDDefs.h"
+#include "SC4WindowMode.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+// The settings that are read from SC4GraphicsOptions.ini.
+//
+// Each setting is described by one line in the kSettingDefinitions table, which provides its
+// INI section and key, value type, default value, allowed range or names, and whether it can be
+// changed while the game is running. The table drives the parsing, validation and defaults,
+// a setting is added by adding a line to the table.
+//
+// The settings are found by name with a perfect hash that is generated at compile time.
+
+enum class SettingType : uint8_t
+{
+	Bool = 0,
+	UInt32,
+	// A named value, e.g. Driver=DirectX.
+	Enum
+};
+
+enum SettingFlags : uint8_t
+{
+	kSettingFlagsNone = 0,
+	// The setting can be changed while the game is running.
+	kSettingFlagsRuntimeChangeable = 1 << 0,
+	// A value of zero is allowed in addition to the range, it disables the feature.
+	kSettingFlagsZeroDisables = 1 << 1
+};
+
+struct SettingEnumValue
+{
+	std::string_view name;
+	uint32_t value;
+	// Any name that starts with this name matches, e.g. Borderless for BorderlessFullScreen.
+	bool matchPrefix;
+};
+
+struct SettingDefinition
+{
+	std::string_view section;
+	std::string_view key;
+	SettingType type;
+	uint32_t defaultValue;
+	uint32_t minValue;
+	uint32_t maxValue;
+	std::span<const SettingEnumValue> enumValues;
+	uint8_t flags;
+};
+
+constexpr SettingDefinition BoolSetting(
+	std::string_view section,
+	std::string_view key,
+	bool defaultValue,
+	uint8_t flags = kSettingFlagsNone)
+{
+	return SettingDefinition{ section, key, SettingType::Bool, defaultValue ? 1U : 0U, 0, 1, {}, flags };
+}
+
+constexpr SettingDefinition UInt32Setting(
+	std::string_view section,
+	std::string_view key,
+	uint32_t defaultValue,
+	uint32_t minValue,
+	uint32_t maxValue,
+	uint8_t flags = kSettingFlagsNone)
+{
+	return SettingDefinition{ section, key, SettingType::UInt32, defaultValue, minValue, maxValue, {}, flags };
+}
+
+template <typename T>
+constexpr SettingDefinition EnumSetting(
+	std::string_view section,
+	std::string_view key,
+	std::span<const SettingEnumValue> enumValues,
+	T defaultValue,
+	uint8_t flags = kSettingFlagsNone)
+{
+	return SettingDefinition
+	{
+		section,
+		key,
+		SettingType::Enum,
+		static_cast<uint32_t>(defaultValue),
+		0,
+		UINT32_MAX,
+		enumValues,
+		flags
+	};
+}
+
+inline constexpr SettingEnumValue kDriverValues[] =
+{
+	{ "DirectX", kSCGDriverDirectX, false },
+	{ "OpenGL", kSCGDriverOpenGL, false },
+	{ "SCGL", kSCGDriverOpenGL, false },
+	// SC4 only checks the first 4 letters of Software.
+	{ "Soft", kSCGDriverSoftware, true },
+};
+
+inline constexpr SettingEnumValue kColorDepthValues[] =
+{
+	{ "32", 32, false },
+	{ "16", 16, false },
+};
+
+inline constexpr SettingEnumValue kWindowModeValues[] =
+{
+	{ "Windowed", static_cast<uint32_t>(SC4WindowMode::Windowed), false },
+	{ "FullScreen", static_cast<uint32_t>(SC4WindowMode::FullScreen), false },
+	{ "Borderless", static_cast<uint32_t>(SC4WindowMode::BorderlessFullScreen), true },
+};
+
+inline constexpr SettingEnumValue kLogFileFormatValues[] =
+{
+	{ "Text", static_cast<uint32_t>(LogFileFormat::Text), false },
+	{ "Binary", static_cast<uint32_t>(LogFileFormat::Binary), false },
+};
+
+inline constexpr SettingEnumValue kLogLevelValues[] =
+{
+	{ "Error", static_cast<uint32_t>(LogLevel::Error), false },
+	{ "Debug", static_cast<uint32_t>(LogLevel::Debug), false },
+	{ "Trace", static_cast<uint32_t>(LogLevel::Trace), false },
+	{ "Info", static_cast<uint32_t>(LogLevel::Info), false },
+};
+
+inline constexpr SettingEnumValue kPriorityClassValues[] =
+{
+	{ "Default", static_cast<uint32_t>(ProcessPriorityClass::Default), false },
+	{ "Normal", static_cast<uint32_t>(ProcessPriorityClass::Normal), false },
+	{ "AboveNormal", static_cast<uint32_t>(ProcessPriorityClass::AboveNormal), false },
+	{ "High", static_cast<uint32_t>(ProcessPriorityClass::High), false },
+};
+
+inline constexpr SettingDefinition kSettingDefinitions[] =
+{
+	BoolSetting("GraphicsOptions", "EnableIntroVideo", true),
+	BoolSetting("GraphicsOptions", "PauseGameOnFocusLoss", false, kSettingFlagsRuntimeChangeable),
+	BoolSetting("GraphicsOptions", "ForceDrawOnScroll", false, kSettingFlagsRuntimeChangeable),
+	BoolSetting("GraphicsOptions", "AutoTuneRenderOptions", false),
+	EnumSetting("GraphicsOptions", "Driver", kDriverValues, kSCGDriverDirectX),
+	UInt32Setting("GraphicsOptions", "WindowWidth", 1024, 800, 65535),
+	UInt32Setting("GraphicsOptions", "WindowHeight", 768, 600, 65535),
+	EnumSetting("GraphicsOptions", "ColorDepth", kColorDepthValues, 32),
+	EnumSetting("GraphicsOptions", "WindowMode", kWindowModeValues, SC4WindowMode::Windowed),
+	UInt32Setting("GraphicsOptions", "MaxFrameRate", 0, 10, 1000, kSettingFlagsZeroDisables | kSettingFlagsRuntimeChangeable),
+	EnumSetting("Logging", "LogFormat", kLogFileFormatValues, LogFileFormat::Text),
+	// The log level keys must be in the same order as the LogCategory enumeration.
+	EnumSetting("Logging", "General", kLogLevelValues, LogLevel::Error, kSettingFlagsRuntimeChangeable),
+	EnumSetting("Logging", "Settings", kLogLevelValues, LogLevel::Error, kSettingFlagsRuntimeChangeable),
+	EnumSetting("Logging", "Hooks", kLogLevelValues, LogLevel::Error, kSettingFlagsRuntimeChangeable),
+	EnumSetting("Logging", "Patches", kLogLevelValues, LogLevel::Error, kSettingFlagsRuntimeChangeable),
+	EnumSetting("Logging", "Render", kLogLevelValues, LogLevel::Error, kSettingFlagsRuntimeChangeable),
+	EnumSetting("Logging", "Telemetry", kLogLevelValues, LogLevel::Error, kSettingFlagsRuntimeChangeable),
+	BoolSetting("Logging", "StartupTrace", false),
+	BoolSetting("Telemetry", "FrameTimes", false),
+	UInt32Setting("Telemetry", "ReportIntervalSeconds", 60, 0, 86400, kSettingFlagsRuntimeChangeable),
+	BoolSetting("Settings", "HotReload", false),
+	UInt32Setting("Performance", "TimerResolutionMicroseconds", 0, 500, 15625, kSettingFlagsZeroDisables),
+	BoolSetting("Performance", "DisablePowerThrottling", false),
+	EnumSetting("Performance", "PriorityClass", kPriorityClassValues, ProcessPriorityClass::Default),
+};
+
+inline constexpr size_t kSettingCount = std::size(kSettingDefinitions);
+inline constexpr size_t kInvalidSettingIndex = SIZE_MAX;
+
+namespace SettingsSchemaDetail
+{
+	constexpr size_t kHashTableSize = 64;
+
+	static_assert(kSettingCount < kHashTableSize / 2, "The hash table is too small.");
+	static_assert(kSettingCount < UINT8_MAX);
+
+	constexpr char ToLowerAscii(char value)
+	{
+		return (value >= 'A' && value <= 'Z') ? static_cast<char>(value + ('a' - 'A')) : value;
+	}
+
+	constexpr bool EqualsIgnoreCase(std::string_view lhs, std::string_view rhs)
+	{
+		if (lhs.size() != rhs.size())
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < lhs.size(); i++)
+		{
+			if (ToLowerAscii(lhs[i]) != ToLowerAscii(rhs[i]))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// A case-insensitive FNV-1a hash of the section and key names.
+	constexpr uint32_t HashSettingName(std::string_view section, std::string_view key, uint32_t seed)
+	{
+		uint32_t hash = 2166136261U ^ seed;
+
+		for (char c : section)
+		{
+			hash = (hash ^ static_cast<uint8_t>(ToLowerAscii(c))) * 16777619U;
+		}
+
+		hash = (hash ^ static_cast<uint8_t>('.')) * 16777619U;
+
+		for (char c : key)
+		{
+			hash = (hash ^ static_cast<uint8_t>(ToLowerAscii(c))) * 16777619U;
+		}
+
+		// Mix the high bits into the table index bits.
+		return hash ^ (hash >> 16);
+	}
+
+	consteval uint32_t FindPerfectHashSeed()
+	{
+		for (uint32_t seed = 0; seed < 100000; seed++)
+		{
+			std::array<bool, kHashTableSize> usedSlots{};
+			bool collision = false;
+
+			for (const SettingDefinition& definition : kSettingDefinitions)
+			{
+				const size_t slot = HashSettingName(definition.section, definition.key, seed) % kHashTableSize;
+
+				if (usedSlots[slot])
+				{
+					collision = true;
+					break;
+				}
+
+				usedSlots[slot] = true;
+			}
+
+			if (!collision)
+			{
+				return seed;
+			}
+		}
+
+		throw "Failed to find a perfect hash seed for the settings.";
+	}
+
+	inline constexpr uint32_t kPerfectHashSeed = FindPerfectHashSeed();
+
+	// Maps a hash table slot to the setting index plus one, 0 is an empty slot.
+	consteval std::array<uint8_t, kHashTableSize> BuildHashTable()
+	{
+		std::array<uint8_t, kHashTableSize> table{};
+
+		for (size_t i = 0; i < kSettingCount; i++)
+		{
+			const SettingDefinition& definition = kSettingDefinitions[i];
+
+			table[HashSettingName(definition.section, definition.key, kPerfectHashSeed) % kHashTableSize] = static_cast<uint8_t>(i + 1);
+		}
+
+		return table;
+	}
+
+	inline constexpr std::array<uint8_t, kHashTableSize> kHashTable = BuildHashTable();
+}
+
+// Returns the index of a setting in kSettingDefinitions, or kInvalidSettingIndex if the setting does not exist.
+// The section and key names are not case-sensitive.
+constexpr size_t FindSettingIndex(std::string_view section, std::string_view key)
+{
+	using namespace SettingsSchemaDetail;
+
+	const uint8_t entry = kHashTable[HashSettingName(section, key, kPerfectHashSeed) % kHashTableSize];
+
+	if (entry != 0)
+	{
+		const size_t index = static_cast<size_t>(entry) - 1;
+		const SettingDefinition& definition = kSettingDefinitions[index];
+
+		if (EqualsIgnoreCase(definition.section, section) && EqualsIgnoreCase(definition.key, key))
+		{
+			return index;
+		}
+	}
+
+	return kInvalidSettingIndex;
+}
+
+// Returns the index of a setting that must exist, a missing setting is a compile error.
+consteval size_t GetSettingIndex(std::string_view section, std::string_view key)
+{
+	const size_t index = FindSettingIndex(section, key);
+
+	if (index == kInvalidSettingIndex)
+	{
+		throw "The setting is not in the kSettingDefinitions table.";
+	}
+
+	return index;
+}
+
+enum class SettingParseResult
+{
+	Success = 0,
+	// The value is not valid for the setting's type, the default value is used.
+	InvalidValue,
+	// The value is outside of the setting's range, the closest allowed value is used.
+	OutOfRange
+};
+
+// Parses a value using the setting's definition.
+SettingParseResult ParseSettingValue(const SettingDefinition& definition, std::string_view text, uint32_t& value);
+
+// Returns the INI file name of a value, e.g. true or DirectX. Numeric values return an empty string.
+std::string_view GetSettingValueName(const SettingDefinition& definition, uint32_t value);
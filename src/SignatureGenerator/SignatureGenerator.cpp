@@ -0,0 +1,213 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// Generates the signature of a patch site from a game executable that the patch site's
+// known address was verified on, e.g. the version 641 SimCity 4.exe.
+// The output is the pattern and offset for the site's PatchSiteDefinition.
+//
+// This tool is built by the CMake build of the core library:
+// SignatureGenerator "SimCity 4.exe" 0x887738 [--length=1] [--min-length=16] [--max-length=64]
+
+#include "PEImage.h"
+#include "SignatureScanner.h"
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+	constexpr size_t kDefaultMinLength = 16;
+	constexpr size_t kDefaultMaxLength = 64;
+
+	void PrintUsage()
+	{
+		std::cerr << "Usage: SignatureGenerator <executable> <address> [--length=<bytes>] [--min-length=<bytes>] [--max-length=<bytes>]\n"
+			<< "The address is the virtual address of the patch site, e.g. 0x887738.\n"
+			<< "The length is the number of bytes that the patch modifies, the default is 1.\n";
+	}
+
+	bool ParseNumber(std::string_view text, uint64_t& value)
+	{
+		int base = 10;
+
+		if (text.starts_with("0x") || text.starts_with("0X"))
+		{
+			text.remove_prefix(2);
+			base = 16;
+		}
+
+		const char* const first = text.data();
+		const char* const last = first + text.size();
+		const std::from_chars_result result = std::from_chars(first, last, value, base);
+
+		return result.ec == std::errc() && result.ptr == last && first != last;
+	}
+
+	void PrintHexBytes(const uint8_t* data, size_t length)
+	{
+		constexpr char kHexDigits[] = "0123456789ABCDEF";
+
+		for (size_t i = 0; i < length; i++)
+		{
+			if (i > 0)
+			{
+				std::cout << ' ';
+			}
+
+			std::cout << kHexDigits[data[i] >> 4] << kHexDigits[data[i] & 0xF];
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<std::string_view> positionalArguments;
+	uint64_t siteLength = 1;
+	uint64_t minLength = kDefaultMinLength;
+	uint64_t maxLength = kDefaultMaxLength;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string_view argument = argv[i];
+
+		if (argument.starts_with("--length="))
+		{
+			if (!ParseNumber(argument.substr(9), siteLength) || siteLength == 0)
+			{
+				PrintUsage();
+				return 1;
+			}
+		}
+		else if (argument.starts_with("--min-length="))
+		{
+			if (!ParseNumber(argument.substr(13), minLength))
+			{
+				PrintUsage();
+				return 1;
+			}
+		}
+		else if (argument.starts_with("--max-length="))
+		{
+			if (!ParseNumber(argument.substr(13), maxLength))
+			{
+				PrintUsage();
+				return 1;
+			}
+		}
+		else
+		{
+			positionalArguments.push_back(argument);
+		}
+	}
+
+	uint64_t address = 0;
+
+	if (positionalArguments.size() != 2 || !ParseNumber(positionalArguments[1], address))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	const std::string path(positionalArguments[0]);
+	std::ifstream input(path, std::ifstream::in | std::ifstream::binary);
+
+	if (!input)
+	{
+		std::cerr << "Failed to open " << path << ".\n";
+		return 1;
+	}
+
+	const std::vector<uint8_t> file{ std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>() };
+
+	// The headers are at the same offsets in the file and in the mapped image.
+	PEImage image;
+
+	if (!image.Load(file.data(), file.size()) || image.Is64Bit())
+	{
+		std::cerr << path << " is not a 32-bit PE executable.\n";
+		return 1;
+	}
+
+	if (address < image.GetImageBase() || address - image.GetImageBase() >= image.GetSizeOfImage())
+	{
+		std::cerr << "The address is outside of the executable's image.\n";
+		return 1;
+	}
+
+	const uint64_t rva = address - image.GetImageBase();
+
+	for (const PESection& section : image.GetSections())
+	{
+		if (rva < section.virtualAddress || rva - section.virtualAddress >= section.sizeOfRawData)
+		{
+			continue;
+		}
+
+		if (section.pointerToRawData > file.size() || section.sizeOfRawData > file.size() - section.pointerToRawData)
+		{
+			std::cerr << "The " << section.name << " section extends past the end of the file.\n";
+			return 1;
+		}
+
+		const uint8_t* const sectionData = file.data() + section.pointerToRawData;
+		const size_t siteOffset = static_cast<size_t>(rva - section.virtualAddress);
+
+		if (siteLength > section.sizeOfRawData - siteOffset)
+		{
+			std::cerr << "The patch site extends past the end of the " << section.name << " section.\n";
+			return 1;
+		}
+
+		const uint64_t imageEnd = image.GetImageBase() + image.GetSizeOfImage();
+		GeneratedSignature signature{};
+
+		if (!SignatureScanner::CreateUniquePattern(
+			sectionData,
+			section.sizeOfRawData,
+			siteOffset,
+			static_cast<size_t>(siteLength),
+			static_cast<uint32_t>(image.GetImageBase()),
+			imageEnd > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(imageEnd),
+			static_cast<size_t>(minLength),
+			static_cast<size_t>(maxLength),
+			signature))
+		{
+			std::cerr << "No unique signature up to " << maxLength << " bytes was found.\n";
+			return 1;
+		}
+
+		std::cout << "Section: " << section.name << '\n'
+			<< "Signature: " << signature.pattern << '\n'
+			<< "SignatureOffset: " << signature.siteOffset << '\n'
+			<< "OriginalBytes: ";
+		PrintHexBytes(sectionData + siteOffset, static_cast<size_t>(siteLength));
+		std::cout << '\n';
+
+		return 0;
+	}
+
+	std::cerr << "The address is not in a section that has file data.\n";
+	return 1;
+}
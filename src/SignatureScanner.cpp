@@ -0,0 +1,513 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SignatureScanner.h"
+#include "StartupTimeline.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define SIGNATURE_SCANNER_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SIGNATURE_SCANNER_TARGET(name)
+#else
+#define SIGNATURE_SCANNER_TARGET(name) __attribute__((target(name)))
+#endif // _MSC_VER
+#endif
+
+namespace
+{
+	int HexDigitValue(char c)
+	{
+		if (c >= '0' && c <= '9')
+		{
+			return c - '0';
+		}
+		else if (c >= 'a' && c <= 'f')
+		{
+			return c - 'a' + 10;
+		}
+		else if (c >= 'A' && c <= 'F')
+		{
+			return c - 'A' + 10;
+		}
+
+		return -1;
+	}
+
+	void AppendPatternByte(std::string& pattern, uint8_t value, bool wildcard)
+	{
+		constexpr char kHexDigits[] = "0123456789ABCDEF";
+
+		if (!pattern.empty())
+		{
+			pattern.push_back(' ');
+		}
+
+		if (wildcard)
+		{
+			pattern.append("??");
+		}
+		else
+		{
+			pattern.push_back(kHexDigits[value >> 4]);
+			pattern.push_back(kHexDigits[value & 0xF]);
+		}
+	}
+
+	size_t FindScalar(const uint8_t* data, size_t size, const BytePattern& pattern, size_t start)
+	{
+		const size_t length = pattern.GetLength();
+
+		if (size < length)
+		{
+			return SignatureScanner::kNotFound;
+		}
+
+		const size_t end = size - length + 1;
+		const size_t firstAnchor = pattern.GetFirstAnchorIndex();
+		const uint8_t firstByte = pattern.GetByte(firstAnchor);
+
+		size_t i = start;
+
+		while (i < end)
+		{
+			const void* found = std::memchr(data + i + firstAnchor, firstByte, end - i);
+
+			if (!found)
+			{
+				break;
+			}
+
+			i = static_cast<size_t>(static_cast<const uint8_t*>(found) - data) - firstAnchor;
+
+			if (pattern.Matches(data + i))
+			{
+				return i;
+			}
+
+			i++;
+		}
+
+		return SignatureScanner::kNotFound;
+	}
+
+#ifdef SIGNATURE_SCANNER_X86
+	uint32_t CountTrailingZeros(uint32_t value)
+	{
+#ifdef _MSC_VER
+		unsigned long index = 0;
+		_BitScanForward(&index, value);
+		return index;
+#else
+		return static_cast<uint32_t>(__builtin_ctz(value));
+#endif // _MSC_VER
+	}
+
+	// Compares the pattern's first and last anchor bytes at 16 positions at once,
+	// based on the "SIMD-friendly algorithms for substring searching" approach by Wojciech Muła.
+	SIGNATURE_SCANNER_TARGET("sse2")
+	size_t FindSSE2(const uint8_t* data, size_t size, const BytePattern& pattern, size_t start)
+	{
+		const size_t length = pattern.GetLength();
+
+		if (size < length)
+		{
+			return SignatureScanner::kNotFound;
+		}
+
+		const size_t end = size - length + 1;
+		const size_t firstAnchor = pattern.GetFirstAnchorIndex();
+		const size_t lastAnchor = pattern.GetLastAnchorIndex();
+		const __m128i firstByte = _mm_set1_epi8(static_cast<char>(pattern.GetByte(firstAnchor)));
+		const __m128i lastByte = _mm_set1_epi8(static_cast<char>(pattern.GetByte(lastAnchor)));
+
+		size_t i = start;
+
+		for (; i + 16 <= end; i += 16)
+		{
+			const __m128i firstBlock = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + firstAnchor));
+			const __m128i lastBlock = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + lastAnchor));
+
+			uint32_t candidates = static_cast<uint32_t>(_mm_movemask_epi8(
+				_mm_and_si128(_mm_cmpeq_epi8(firstBlock, firstByte), _mm_cmpeq_epi8(lastBlock, lastByte))));
+
+			while (candidates != 0)
+			{
+				const size_t position = i + CountTrailingZeros(candidates);
+
+				if (pattern.Matches(data + position))
+				{
+					return position;
+				}
+
+				candidates &= candidates - 1;
+			}
+		}
+
+		return FindScalar(data, size, pattern, i);
+	}
+
+	SIGNATURE_SCANNER_TARGET("avx2")
+	size_t FindAVX2(const uint8_t* data, size_t size, const BytePattern& pattern, size_t start)
+	{
+		const size_t length = pattern.GetLength();
+
+		if (size < length)
+		{
+			return SignatureScanner::kNotFound;
+		}
+
+		const size_t end = size - length + 1;
+		const size_t firstAnchor = pattern.GetFirstAnchorIndex();
+		const size_t lastAnchor = pattern.GetLastAnchorIndex();
+		const __m256i firstByte = _mm256_set1_epi8(static_cast<char>(pattern.GetByte(firstAnchor)));
+		const __m256i lastByte = _mm256_set1_epi8(static_cast<char>(pattern.GetByte(lastAnchor)));
+
+		size_t i = start;
+
+		for (; i + 32 <= end; i += 32)
+		{
+			const __m256i firstBlock = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + firstAnchor));
+			const __m256i lastBlock = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + lastAnchor));
+
+			uint32_t candidates = static_cast<uint32_t>(_mm256_movemask_epi8(
+				_mm256_and_si256(_mm256_cmpeq_epi8(firstBlock, firstByte), _mm256_cmpeq_epi8(lastBlock, lastByte))));
+
+			while (candidates != 0)
+			{
+				const size_t position = i + CountTrailingZeros(candidates);
+
+				if (pattern.Matches(data + position))
+				{
+					return position;
+				}
+
+				candidates &= candidates - 1;
+			}
+		}
+
+		return FindSSE2(data, size, pattern, i);
+	}
+
+	bool CpuSupportsAVX2()
+	{
+#ifdef _MSC_VER
+		int cpuInfo[4] = {};
+
+		__cpuid(cpuInfo, 0);
+
+		if (cpuInfo[0] < 7)
+		{
+			return false;
+		}
+
+		__cpuid(cpuInfo, 1);
+
+		// The OS must save the AVX registers on a context switch.
+		constexpr int kOSXSaveBit = 1 << 27;
+		constexpr int kAVXBit = 1 << 28;
+
+		if ((cpuInfo[2] & (kOSXSaveBit | kAVXBit)) != (kOSXSaveBit | kAVXBit)
+			|| (_xgetbv(0) & 0x6) != 0x6)
+		{
+			return false;
+		}
+
+		__cpuidex(cpuInfo, 7, 0);
+
+		constexpr int kAVX2Bit = 1 << 5;
+
+		return (cpuInfo[1] & kAVX2Bit) != 0;
+#else
+		return __builtin_cpu_supports("avx2");
+#endif // _MSC_VER
+	}
+
+	bool CpuSupportsSSE2()
+	{
+#ifdef _MSC_VER
+		int cpuInfo[4] = {};
+
+		__cpuid(cpuInfo, 1);
+
+		constexpr int kSSE2Bit = 1 << 26;
+
+		return (cpuInfo[3] & kSSE2Bit) != 0;
+#else
+		return __builtin_cpu_supports("sse2");
+#endif // _MSC_VER
+	}
+#endif // SIGNATURE_SCANNER_X86
+}
+
+BytePattern::BytePattern(std::string_view text)
+	: bytes(),
+	  mask(),
+	  firstAnchor(0),
+	  lastAnchor(0),
+	  hasWildcards(false)
+{
+	size_t i = 0;
+
+	while (i < text.size())
+	{
+		if (text[i] == ' ')
+		{
+			i++;
+			continue;
+		}
+
+		if (i + 1 >= text.size() || (i + 2 < text.size() && text[i + 2] != ' '))
+		{
+			throw std::invalid_argument("Each pattern byte must be 2 characters.");
+		}
+
+		if (text[i] == '?' && text[i + 1] == '?')
+		{
+			bytes.push_back(0);
+			mask.push_back(0);
+			hasWildcards = true;
+		}
+		else
+		{
+			const int high = HexDigitValue(text[i]);
+			const int low = HexDigitValue(text[i + 1]);
+
+			if (high < 0 || low < 0)
+			{
+				throw std::invalid_argument("The pattern contains an invalid hexadecimal byte.");
+			}
+
+			bytes.push_back(static_cast<uint8_t>((high << 4) | low));
+			mask.push_back(0xFF);
+		}
+
+		i += 2;
+	}
+
+	bool foundAnchor = false;
+
+	for (size_t index = 0; index < mask.size(); index++)
+	{
+		if (mask[index] != 0)
+		{
+			if (!foundAnchor)
+			{
+				firstAnchor = index;
+				foundAnchor = true;
+			}
+
+			lastAnchor = index;
+		}
+	}
+
+	if (!foundAnchor)
+	{
+		throw std::invalid_argument("The pattern must contain at least one byte that is not a wildcard.");
+	}
+}
+
+size_t BytePattern::GetLength() const
+{
+	return bytes.size();
+}
+
+bool BytePattern::Matches(const uint8_t* data) const
+{
+	if (!hasWildcards)
+	{
+		return std::memcmp(data, bytes.data(), bytes.size()) == 0;
+	}
+
+	for (size_t i = 0; i < bytes.size(); i++)
+	{
+		if ((data[i] & mask[i]) != bytes[i])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool BytePattern::HasWildcards() const
+{
+	return hasWildcards;
+}
+
+size_t BytePattern::GetFirstAnchorIndex() const
+{
+	return firstAnchor;
+}
+
+size_t BytePattern::GetLastAnchorIndex() const
+{
+	return lastAnchor;
+}
+
+uint8_t BytePattern::GetByte(size_t index) const
+{
+	return bytes[index];
+}
+
+SignatureScannerMode SignatureScanner::GetBestMode()
+{
+#ifdef SIGNATURE_SCANNER_X86
+	static const SignatureScannerMode bestMode = CpuSupportsAVX2()
+		? SignatureScannerMode::AVX2
+		: CpuSupportsSSE2() ? SignatureScannerMode::SSE2 : SignatureScannerMode::Scalar;
+
+	return bestMode;
+#else
+	return SignatureScannerMode::Scalar;
+#endif // SIGNATURE_SCANNER_X86
+}
+
+size_t SignatureScanner::Find(const uint8_t* data, size_t size, const BytePattern& pattern, size_t start)
+{
+	return Find(data, size, pattern, start, GetBestMode());
+}
+
+size_t SignatureScanner::Find(
+	const uint8_t* data,
+	size_t size,
+	const BytePattern& pattern,
+	size_t start,
+	SignatureScannerMode mode)
+{
+	StartupTimelineSample sample("SignatureScanner::Find");
+
+	switch (mode)
+	{
+#ifdef SIGNATURE_SCANNER_X86
+	case SignatureScannerMode::AVX2:
+		return FindAVX2(data, size, pattern, start);
+	case SignatureScannerMode::SSE2:
+		return FindSSE2(data, size, pattern, start);
+#endif // SIGNATURE_SCANNER_X86
+	case SignatureScannerMode::Scalar:
+	default:
+		return FindScalar(data, size, pattern, start);
+	}
+}
+
+size_t SignatureScanner::FindUnique(const uint8_t* data, size_t size, const BytePattern& pattern)
+{
+	const size_t first = Find(data, size, pattern, 0);
+
+	if (first == kNotFound || Find(data, size, pattern, first + 1) != kNotFound)
+	{
+		return kNotFound;
+	}
+
+	return first;
+}
+
+bool SignatureScanner::CreateUniquePattern(
+	const uint8_t* data,
+	size_t size,
+	size_t siteOffset,
+	size_t siteLength,
+	uint32_t addressRangeStart,
+	uint32_t addressRangeEnd,
+	size_t minLength,
+	size_t maxLength,
+	GeneratedSignature& signature)
+{
+	if (siteLength == 0 || siteOffset >= size || siteLength > size - siteOffset)
+	{
+		return false;
+	}
+
+	// Mark the bytes that the pattern must not depend on.
+	const size_t windowStart = siteOffset > maxLength ? siteOffset - maxLength : 0;
+	const size_t windowEnd = std::min(size, siteOffset + siteLength + maxLength);
+	std::vector<bool> wildcards(windowEnd - windowStart);
+
+	for (size_t i = windowStart; i + sizeof(uint32_t) <= windowEnd; i++)
+	{
+		uint32_t value = 0;
+		std::memcpy(&value, data + i, sizeof(value));
+
+		if (value >= addressRangeStart && value < addressRangeEnd)
+		{
+			std::fill_n(wildcards.begin() + static_cast<ptrdiff_t>(i - windowStart), sizeof(uint32_t), true);
+		}
+	}
+
+	std::fill_n(wildcards.begin() + static_cast<ptrdiff_t>(siteOffset - windowStart), siteLength, true);
+
+	std::string text;
+
+	const auto tryPattern = [&](size_t length, size_t lead)
+	{
+		if (lead > siteOffset - windowStart || siteOffset - lead + length > windowEnd)
+		{
+			return false;
+		}
+
+		const size_t start = siteOffset - lead;
+		bool hasFixedByte = false;
+
+		text.clear();
+
+		for (size_t i = start; i < start + length; i++)
+		{
+			const bool wildcard = wildcards[i - windowStart];
+
+			AppendPatternByte(text, data[i], wildcard);
+			hasFixedByte |= !wildcard;
+		}
+
+		if (!hasFixedByte || FindUnique(data, size, BytePattern(text)) != start)
+		{
+			return false;
+		}
+
+		signature.pattern = text;
+		signature.siteOffset = lead;
+		return true;
+	};
+
+	for (size_t length = std::max(minLength, siteLength + 1); length <= maxLength; length++)
+	{
+		const size_t span = length - siteLength;
+		const size_t half = span / 2;
+
+		// Try the patterns that have the patch site near their center first, the
+		// instructions on both sides of the site are the most likely to be kept by other builds.
+		for (size_t distance = 0; distance <= span; distance++)
+		{
+			if ((distance <= half && tryPattern(length, half - distance))
+				|| (distance > 0 && half + distance <= span && tryPattern(length, half + distance)))
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
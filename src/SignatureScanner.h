@@ -0,0 +1,111 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A byte pattern with wildcards, written as hexadecimal bytes separated by spaces,
+// e.g. "8B 44 24 ?? 6A 10". A ?? matches any byte.
+class BytePattern
+{
+public:
+
+	// Throws std::invalid_argument if the text is not a valid pattern.
+	explicit BytePattern(std::string_view text);
+
+	size_t GetLength() const;
+
+	// Returns true if the pattern matches the data, which must be at least GetLength() bytes.
+	bool Matches(const uint8_t* data) const;
+
+	bool HasWildcards() const;
+
+	// The scanner searches for the first and last non-wildcard bytes, a candidate
+	// position is only compared with the whole pattern when both of them match.
+	size_t GetFirstAnchorIndex() const;
+
+	size_t GetLastAnchorIndex() const;
+
+	uint8_t GetByte(size_t index) const;
+
+private:
+
+	std::vector<uint8_t> bytes;
+	std::vector<uint8_t> mask;
+	size_t firstAnchor;
+	size_t lastAnchor;
+	bool hasWildcards;
+};
+
+// A signature that CreateUniquePattern generated for a patch site.
+struct GeneratedSignature
+{
+	std::string pattern;
+	// The offset of the patch site from the start of the pattern.
+	size_t siteOffset;
+};
+
+enum class SignatureScannerMode : int32_t
+{
+	Scalar = 0,
+	SSE2,
+	AVX2
+};
+
+namespace SignatureScanner
+{
+	constexpr size_t kNotFound = SIZE_MAX;
+
+	// Returns the fastest mode that the CPU and OS support.
+	SignatureScannerMode GetBestMode();
+
+	// Returns the offset of the first match at or after the start offset, or kNotFound.
+	size_t Find(const uint8_t* data, size_t size, const BytePattern& pattern, size_t start = 0);
+
+	size_t Find(const uint8_t* data, size_t size, const BytePattern& pattern, size_t start, SignatureScannerMode mode);
+
+	// Returns the offset of the only match, or kNotFound if there are no matches or more than one.
+	// A patch must not be applied to a pattern that matches more than one location.
+	size_t FindUnique(const uint8_t* data, size_t size, const BytePattern& pattern);
+
+	// Creates the shortest pattern, between the minimum and maximum length, that only matches
+	// the data around the patch site at the specified offset. A minimum length that is longer
+	// than the shortest unique pattern makes the pattern less likely to match other code in a
+	// different build of the executable.
+	// The patch site bytes are wildcards so that the pattern also matches an executable that
+	// has already been patched. The 4-byte values that are within the address range, e.g. the
+	// image's virtual addresses, are wildcards because they change between builds.
+	// Returns false if no pattern up to the maximum length is unique.
+	bool CreateUniquePattern(
+		const uint8_t* data,
+		size_t size,
+		size_t siteOffset,
+		size_t siteLength,
+		uint32_t addressRangeStart,
+		uint32_t addressRangeEnd,
+		size_t minLength,
+		size_t maxLength,
+		GeneratedSignature& signature);
+}
@@ -0,0 +1,254 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "StartupTimeline.h"
+#include "LogTimeStamp.h"
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t kPluginTrackID = 1;
+	constexpr uint32_t kGameTrackID = 2;
+
+	thread_local uint32_t t_PhaseDepth = 0;
+
+	uint64_t GetMicrosecondsSinceLoad()
+	{
+		return LogTimeStamp::Now().GetMicrosecondsSinceLoad();
+	}
+
+	void WriteCompleteEvent(
+		std::ofstream& stream,
+		bool& firstEvent,
+		std::string_view name,
+		std::string_view category,
+		uint32_t trackID,
+		uint64_t startTime,
+		uint64_t endTime)
+	{
+		stream << (firstEvent ? "\n" : ",\n");
+		stream << std::format(
+			"    {{\"name\": \"{}\", \"cat\": \"{}\", \"ph\": \"X\", \"pid\": 1, \"tid\": {}, \"ts\": {}, \"dur\": {}}}",
+			name,
+			category,
+			trackID,
+			startTime,
+			endTime > startTime ? endTime - startTime : 0);
+
+		firstEvent = false;
+	}
+
+	void WriteTrackNameEvent(std::ofstream& stream, bool& firstEvent, uint32_t trackID, std::string_view name)
+	{
+		stream << (firstEvent ? "\n" : ",\n");
+		stream << std::format(
+			"    {{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": {}, \"args\": {{\"name\": \"{}\"}}}}",
+			trackID,
+			name);
+
+		firstEvent = false;
+	}
+}
+
+StartupTimeline& StartupTimeline::GetInstance()
+{
+	static StartupTimeline instance;
+
+	return instance;
+}
+
+StartupTimeline::StartupTimeline()
+	: phases(),
+	  phaseCount(0),
+	  samples(),
+	  sampling(true)
+{
+	for (SampleStatistics& statistics : samples)
+	{
+		statistics.minTicks.store(UINT64_MAX, std::memory_order_relaxed);
+	}
+}
+
+void StartupTimeline::AddPhase(const char* name, uint64_t startTime, uint64_t endTime, uint32_t depth)
+{
+	const uint32_t index = phaseCount.fetch_add(1, std::memory_order_relaxed);
+
+	if (index < kMaxPhaseCount)
+	{
+		phases[index] = Phase{ name, startTime, endTime, depth };
+	}
+}
+
+void StartupTimeline::AddSample(const char* name, int64_t elapsedTicks)
+{
+	const uint64_t ticks = elapsedTicks > 0 ? static_cast<uint64_t>(elapsedTicks) : 0;
+
+	for (SampleStatistics& statistics : samples)
+	{
+		const char* existingName = statistics.name.load(std::memory_order_acquire);
+
+		if (!existingName)
+		{
+			// Claim the empty slot, another thread may have claimed it first.
+			if (!statistics.name.compare_exchange_strong(existingName, name, std::memory_order_acq_rel))
+			{
+				if (existingName != name)
+				{
+					continue;
+				}
+			}
+		}
+		else if (existingName != name)
+		{
+			continue;
+		}
+
+		statistics.count.fetch_add(1, std::memory_order_relaxed);
+		statistics.totalTicks.fetch_add(ticks, std::memory_order_relaxed);
+
+		uint64_t minTicks = statistics.minTicks.load(std::memory_order_relaxed);
+
+		while (ticks < minTicks && !statistics.minTicks.compare_exchange_weak(minTicks, ticks, std::memory_order_relaxed))
+		{
+		}
+
+		uint64_t maxTicks = statistics.maxTicks.load(std::memory_order_relaxed);
+
+		while (ticks > maxTicks && !statistics.maxTicks.compare_exchange_weak(maxTicks, ticks, std::memory_order_relaxed))
+		{
+		}
+
+		return;
+	}
+}
+
+void StartupTimeline::StopSampling()
+{
+	sampling.store(false, std::memory_order_relaxed);
+}
+
+bool StartupTimeline::WriteTraceFile(const std::filesystem::path& path, std::string_view pluginVersion) const
+{
+	std::ofstream stream(path, std::ofstream::out | std::ofstream::trunc);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	const uint32_t count = std::min<uint32_t>(phaseCount.load(std::memory_order_acquire), kMaxPhaseCount);
+
+	std::vector<Phase> topLevelPhases;
+	bool firstEvent = true;
+
+	stream << "{\n  \"displayTimeUnit\": \"ms\",\n  \"traceEvents\": [";
+
+	WriteTrackNameEvent(stream, firstEvent, kPluginTrackID, "SC4GraphicsOptions");
+	WriteTrackNameEvent(stream, firstEvent, kGameTrackID, "SimCity 4 (between plugin hooks)");
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const Phase& phase = phases[i];
+
+		WriteCompleteEvent(stream, firstEvent, phase.name, "plugin", kPluginTrackID, phase.startTime, phase.endTime);
+
+		if (phase.depth == 0)
+		{
+			topLevelPhases.push_back(phase);
+		}
+	}
+
+	std::sort(
+		topLevelPhases.begin(),
+		topLevelPhases.end(),
+		[](const Phase& lhs, const Phase& rhs) { return lhs.startTime < rhs.startTime; });
+
+	for (size_t i = 1; i < topLevelPhases.size(); i++)
+	{
+		const Phase& previous = topLevelPhases[i - 1];
+		const Phase& next = topLevelPhases[i];
+
+		if (next.startTime > previous.endTime)
+		{
+			WriteCompleteEvent(
+				stream,
+				firstEvent,
+				std::format("{} -> {}", previous.name, next.name),
+				"game",
+				kGameTrackID,
+				previous.endTime,
+				next.startTime);
+		}
+	}
+
+	stream << "\n  ],\n";
+	stream << std::format("  \"otherData\": {{\"version\": \"{}\"}},\n", pluginVersion);
+	stream << "  \"hotPathSamples\": [";
+
+	const double nanosecondsPerTick = 1000000000.0 / static_cast<double>(Platform::GetPerformanceFrequency());
+	bool firstSample = true;
+
+	for (const SampleStatistics& statistics : samples)
+	{
+		const char* name = statistics.name.load(std::memory_order_acquire);
+		const uint64_t sampleCount = statistics.count.load(std::memory_order_relaxed);
+
+		if (!name || sampleCount == 0)
+		{
+			continue;
+		}
+
+		const double totalNanoseconds = static_cast<double>(statistics.totalTicks.load(std::memory_order_relaxed)) * nanosecondsPerTick;
+
+		stream << (firstSample ? "\n" : ",\n");
+		stream << std::format(
+			"    {{\"name\": \"{}\", \"count\": {}, \"meanNanoseconds\": {:.1f}, \"minNanoseconds\": {:.1f}, \"maxNanoseconds\": {:.1f}, \"totalMicroseconds\": {:.3f}}}",
+			name,
+			sampleCount,
+			totalNanoseconds / static_cast<double>(sampleCount),
+			static_cast<double>(statistics.minTicks.load(std::memory_order_relaxed)) * nanosecondsPerTick,
+			static_cast<double>(statistics.maxTicks.load(std::memory_order_relaxed)) * nanosecondsPerTick,
+			totalNanoseconds / 1000.0);
+
+		firstSample = false;
+	}
+
+	stream << "\n  ]\n}\n";
+
+	return static_cast<bool>(stream);
+}
+
+StartupTimelinePhase::StartupTimelinePhase(const char* name)
+	: name(name),
+	  startTime(GetMicrosecondsSinceLoad()),
+	  depth(t_PhaseDepth++)
+{
+}
+
+StartupTimelinePhase::~StartupTimelinePhase()
+{
+	t_PhaseDepth--;
+
+	StartupTimeline::GetInstance().AddPhase(name, startTime, GetMicrosecondsSinceLoad(), depth);
+}
@@ -0,0 +1,138 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include "Platform.h"
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+// Records how long the plugin's startup phases take, and writes them
+// as a Chrome trace event (JSON) file that can be viewed in Perfetto
+// or chrome://tracing.
+//
+// The gaps between the top-level phases (the framework hooks) are written
+// on a separate track, they show how long the game's own initialization stages take.
+//
+// The timeline also collects call statistics for the plugin's startup hot paths (settings
+// parsing, the patch signature scans and the window hooks) until the game has started. These are written to the
+// trace file's hotPathSamples array, so they can be compared between releases.
+class StartupTimeline
+{
+public:
+
+	static StartupTimeline& GetInstance();
+
+	// Records a phase that started and ended at the specified times,
+	// in microseconds since the DLL was loaded.
+	// The name must be a string literal, the timeline only stores its address.
+	void AddPhase(const char* name, uint64_t startTime, uint64_t endTime, uint32_t depth);
+
+	// Adds the duration of a hot path call, in performance counter ticks.
+	// The name must be a string literal, the timeline only stores its address.
+	void AddSample(const char* name, int64_t elapsedTicks);
+
+	bool IsSampling() const
+	{
+		return sampling.load(std::memory_order_relaxed);
+	}
+
+	// Stops collecting the hot path statistics, this is called when the game has started.
+	void StopSampling();
+
+	bool WriteTraceFile(const std::filesystem::path& path, std::string_view pluginVersion) const;
+
+private:
+
+	StartupTimeline();
+
+	static constexpr size_t kMaxPhaseCount = 64;
+	static constexpr size_t kMaxSampleNameCount = 16;
+
+	struct Phase
+	{
+		const char* name;
+		uint64_t startTime;
+		uint64_t endTime;
+		uint32_t depth;
+	};
+
+	struct SampleStatistics
+	{
+		std::atomic<const char*> name;
+		std::atomic<uint64_t> count;
+		std::atomic<uint64_t> totalTicks;
+		std::atomic<uint64_t> minTicks;
+		std::atomic<uint64_t> maxTicks;
+	};
+
+	Phase phases[kMaxPhaseCount];
+	std::atomic<uint32_t> phaseCount;
+	SampleStatistics samples[kMaxSampleNameCount];
+	std::atomic<bool> sampling;
+};
+
+// Records the lifetime of the object as a startup phase.
+class StartupTimelinePhase
+{
+public:
+
+	explicit StartupTimelinePhase(const char* name);
+	~StartupTimelinePhase();
+
+	StartupTimelinePhase(const StartupTimelinePhase&) = delete;
+	StartupTimelinePhase& operator=(const StartupTimelinePhase&) = delete;
+
+private:
+
+	const char* name;
+	uint64_t startTime;
+	uint32_t depth;
+};
+
+// Adds the lifetime of the object to a hot path's call statistics.
+class StartupTimelineSample
+{
+public:
+
+	explicit StartupTimelineSample(const char* name)
+		: name(name),
+		  startCounter(StartupTimeline::GetInstance().IsSampling() ? Platform::GetPerformanceCounter() : 0)
+	{
+	}
+
+	~StartupTimelineSample()
+	{
+		if (startCounter != 0)
+		{
+			StartupTimeline::GetInstance().AddSample(name, Platform::GetPerformanceCounter() - startCounter);
+		}
+	}
+
+	StartupTimelineSample(const StartupTimelineSample&) = delete;
+	StartupTimelineSample& operator=(const StartupTimelineSample&) = delete;
+
+private:
+
+	const char* name;
+	int64_t startCounter;
+};
@@ -0,0 +1,212 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "BinaryLogFormat.h"
+#include "BinaryLogWriter.h"
+#include "TestDirectory.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <format>
+#include <limits>
+
+namespace
+{
+	// Encodes the arguments as the binary log writer does, and formats them with the decoder.
+	template <typename... Args>
+	std::string DecodeMessage(std::string_view format, const Args&... args)
+	{
+		BinaryLogEventArguments buffer;
+		(buffer.Add(args), ...);
+
+		std::vector<BinaryLogFormat::Argument> arguments;
+
+		if (!BinaryLogFormat::DecodeArguments(buffer.GetData(), buffer.GetLength(), arguments))
+		{
+			return "<invalid>";
+		}
+
+		return BinaryLogFormat::FormatEventMessage(format, arguments);
+	}
+
+	// Checks that the decoder formats the arguments the same way as std::format.
+	template <typename... Args>
+	void ExpectSameAsStdFormat(std::string_view format, const Args&... args)
+	{
+		EXPECT_EQ(DecodeMessage(format, args...), std::vformat(format, std::make_format_args(args...))) << format;
+	}
+
+	std::vector<uint8_t> ReadBinaryFile(const TestDirectory& directory, const std::filesystem::path& path)
+	{
+		const std::string text = directory.ReadFile(path);
+
+		return std::vector<uint8_t>(text.begin(), text.end());
+	}
+}
+
+TEST(BinaryLogFormatTests, FormatsReplacementFields)
+{
+	EXPECT_EQ(DecodeMessage("{} and {}", 1, "two"), "1 and two");
+	EXPECT_EQ(DecodeMessage("{1} before {0}", 1, 2), "2 before 1");
+	EXPECT_EQ(DecodeMessage("{{{}}}", true), "{true}");
+	EXPECT_EQ(DecodeMessage("{} {}", 'c'), "c <missing>");
+}
+
+TEST(BinaryLogFormatTests, FormatsIntegerSpecifications)
+{
+	const uint32_t crc = 0x0000BEEF;
+	const uint64_t address = 0x887738;
+	const int32_t negative = -42;
+	const int64_t minimum = std::numeric_limits<int64_t>::min();
+
+	EXPECT_EQ(DecodeMessage("0x{:08X}", crc), "0x0000BEEF");
+	EXPECT_EQ(DecodeMessage("0x{:X}", address), "0x887738");
+
+	ExpectSameAsStdFormat("{:x} {:X} {:#x} {:#X}", crc, crc, crc, crc);
+	ExpectSameAsStdFormat("{:b} {:#B} {:o} {:#o} {:#o}", crc, crc, crc, crc, 0U);
+	ExpectSameAsStdFormat("[{:5}] [{:<5}] [{:^5}] [{:*>6}]", negative, negative, negative, negative);
+	ExpectSameAsStdFormat("[{:05}] [{:+05}] [{:+}] [{: }] [{:#010x}]", negative, 42, 42, 42, crc);
+	ExpectSameAsStdFormat("{} {:x} {:d}", minimum, minimum, std::numeric_limits<uint64_t>::max());
+	ExpectSameAsStdFormat("{:c}", 65);
+}
+
+TEST(BinaryLogFormatTests, FormatsFloatingPointSpecifications)
+{
+	const double value = 3.14159265;
+	const double large = 12345678.9;
+	const double negative = -0.5;
+
+	EXPECT_EQ(DecodeMessage("{:.2f} ms", value), "3.14 ms");
+
+	ExpectSameAsStdFormat("{} {} {}", value, large, negative);
+	ExpectSameAsStdFormat("{:.2f} {:.0f} {:f} {:F}", value, large, negative, value);
+	ExpectSameAsStdFormat("{:e} {:.3E} {:g} {:.3G}", large, value, large, large);
+	ExpectSameAsStdFormat("[{:8.2f}] [{:<8.2f}] [{:^9.1f}] [{:08.2f}] [{:+.1f}]", value, value, value, negative, value);
+	ExpectSameAsStdFormat("{:.3}", value);
+}
+
+TEST(BinaryLogFormatTests, FormatsStringBoolAndCharSpecifications)
+{
+	const std::string text = "DirectX";
+
+	ExpectSameAsStdFormat("[{:10}] [{:>10}] [{:-^11}] [{:.3}]", text, text, text, text);
+	ExpectSameAsStdFormat("[{}] [{:6}] [{:>6}] [{:d}]", true, false, true, true);
+	ExpectSameAsStdFormat("[{}] [{:3}] [{:>3}] [{:d}] [{:x}]", 'A', 'A', 'A', 'A', 'A');
+}
+
+TEST(BinaryLogFormatTests, UnsupportedSpecificationsAreIgnored)
+{
+	EXPECT_EQ(DecodeMessage("{:{}}", 5, 2), "5");
+	EXPECT_EQ(DecodeMessage("{:%Y}", 5), "5");
+}
+
+TEST(BinaryLogFormatTests, WriterOutputRoundTripsThroughTheReader)
+{
+	TestDirectory directory;
+	const std::filesystem::path path = directory.GetPath() / "SC4GraphicsOptions.blog";
+
+	static constexpr std::string_view kCrcFormat = "Game executable code CRC-32C: 0x{:08X}, size: {} bytes.";
+	static constexpr std::string_view kTimeFormat = "{} took {:.2f} ms, {}.";
+
+	const uint32_t crc = 0x1A2B3C;
+	const size_t codeSize = 5222400;
+	const std::string name = "PreFrameWorkInit";
+	const double milliseconds = 1.23456;
+
+	{
+		BinaryLogWriter writer(path);
+		ASSERT_TRUE(writer.IsOpen());
+
+		writer.Write(LogCategory::General, LogLevel::Debug, kCrcFormat, crc, codeSize);
+		writer.Write(LogCategory::Telemetry, LogLevel::Info, kTimeFormat, name, milliseconds, true);
+		// The second event with the same format string reuses its id.
+		writer.Write(LogCategory::General, LogLevel::Error, kCrcFormat, 0U, 0U);
+		writer.Flush();
+	}
+
+	const std::vector<uint8_t> data = ReadBinaryFile(directory, path);
+
+	BinaryLogFormat::Reader reader(data.data(), data.size());
+	uint32_t version = 0;
+
+	ASSERT_TRUE(reader.ReadFileHeader(version));
+	EXPECT_EQ(version, BinaryLogFormat::kFileVersion);
+
+	BinaryLogFormat::Event event{};
+
+	ASSERT_EQ(reader.ReadEvent(event), BinaryLogFormat::ReadResult::Event);
+	ASSERT_NE(event.format, nullptr);
+	EXPECT_TRUE(event.argumentsValid);
+	EXPECT_EQ(event.level, static_cast<uint8_t>(LogLevel::Debug));
+	EXPECT_EQ(event.category, static_cast<uint8_t>(LogCategory::General));
+	EXPECT_EQ(*event.format, kCrcFormat);
+	EXPECT_EQ(
+		BinaryLogFormat::FormatEventMessage(*event.format, event.arguments),
+		std::format("Game executable code CRC-32C: 0x{:08X}, size: {} bytes.", crc, codeSize));
+
+	const uint32_t firstFormatStringID = event.formatStringID;
+
+	ASSERT_EQ(reader.ReadEvent(event), BinaryLogFormat::ReadResult::Event);
+	ASSERT_NE(event.format, nullptr);
+	EXPECT_EQ(event.category, static_cast<uint8_t>(LogCategory::Telemetry));
+	EXPECT_EQ(
+		BinaryLogFormat::FormatEventMessage(*event.format, event.arguments),
+		std::format("{} took {:.2f} ms, {}.", name, milliseconds, true));
+
+	ASSERT_EQ(reader.ReadEvent(event), BinaryLogFormat::ReadResult::Event);
+	EXPECT_EQ(event.formatStringID, firstFormatStringID);
+	EXPECT_EQ(event.level, static_cast<uint8_t>(LogLevel::Error));
+
+	EXPECT_EQ(reader.ReadEvent(event), BinaryLogFormat::ReadResult::EndOfFile);
+
+	// A crash can leave a partial record at the end of the file.
+	const std::vector<uint8_t> truncated(data.begin(), data.end() - 3);
+	BinaryLogFormat::Reader truncatedReader(truncated.data(), truncated.size());
+
+	ASSERT_TRUE(truncatedReader.ReadFileHeader(version));
+	EXPECT_EQ(truncatedReader.ReadEvent(event), BinaryLogFormat::ReadResult::Event);
+	EXPECT_EQ(truncatedReader.ReadEvent(event), BinaryLogFormat::ReadResult::Event);
+	EXPECT_EQ(truncatedReader.ReadEvent(event), BinaryLogFormat::ReadResult::TruncatedRecord);
+}
+
+TEST(BinaryLogFormatTests, ReaderRejectsOtherFiles)
+{
+	const uint8_t text[] = "SC4GraphicsOptions text log";
+	BinaryLogFormat::Reader reader(text, sizeof(text));
+	uint32_t version = 0;
+
+	EXPECT_FALSE(reader.ReadFileHeader(version));
+}
+
+TEST(BinaryLogFormatTests, ReaderStopsAtUnknownRecords)
+{
+	std::vector<uint8_t> data(BinaryLogFormat::kFileHeaderSize);
+	std::memcpy(data.data(), BinaryLogFormat::kFileSignature, sizeof(BinaryLogFormat::kFileSignature));
+	std::memcpy(data.data() + sizeof(BinaryLogFormat::kFileSignature), &BinaryLogFormat::kFileVersion, sizeof(uint32_t));
+	data.push_back(0xFF);
+
+	BinaryLogFormat::Reader reader(data.data(), data.size());
+	BinaryLogFormat::Event event{};
+	uint32_t version = 0;
+
+	ASSERT_TRUE(reader.ReadFileHeader(version));
+	EXPECT_EQ(reader.ReadEvent(event), BinaryLogFormat::ReadResult::UnknownRecordType);
+	EXPECT_EQ(reader.GetOffset(), BinaryLogFormat::kFileHeaderSize);
+}
@@ -0,0 +1,123 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "BoundedMPSCQueue.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	struct Item
+	{
+		uint32_t producer;
+		uint32_t sequence;
+	};
+}
+
+TEST(BoundedMPSCQueueTests, PopsInPushOrder)
+{
+	BoundedMPSCQueue<uint32_t, 4> queue;
+
+	for (uint32_t i = 0; i < 4; i++)
+	{
+		EXPECT_TRUE(queue.TryPush([i](uint32_t& value) { value = i; }));
+	}
+
+	EXPECT_FALSE(queue.TryPush([](uint32_t&) { FAIL() << "The writer must not be called when the queue is full."; }));
+
+	for (uint32_t i = 0; i < 4; i++)
+	{
+		uint32_t value = UINT32_MAX;
+
+		EXPECT_TRUE(queue.TryPop([&value](const uint32_t& item) { value = item; }));
+		EXPECT_EQ(value, i);
+	}
+
+	EXPECT_TRUE(queue.IsEmpty());
+	EXPECT_FALSE(queue.TryPop([](const uint32_t&) {}));
+}
+
+TEST(BoundedMPSCQueueTests, MultipleProducersKeepTheirOrder)
+{
+	constexpr uint32_t kProducerCount = 4;
+	constexpr uint32_t kItemsPerProducer = 200000;
+
+	BoundedMPSCQueue<Item, 64> queue;
+	std::array<std::atomic<uint32_t>, kProducerCount> rejectedCounts{};
+	std::atomic<uint32_t> finishedProducers = 0;
+	std::vector<std::thread> producers;
+
+	for (uint32_t producer = 0; producer < kProducerCount; producer++)
+	{
+		producers.emplace_back([&, producer]
+		{
+			for (uint32_t sequence = 0; sequence < kItemsPerProducer; sequence++)
+			{
+				if (!queue.TryPush([&](Item& item) { item = Item{ producer, sequence }; }))
+				{
+					rejectedCounts[producer].fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+
+			finishedProducers.fetch_add(1, std::memory_order_release);
+		});
+	}
+
+	std::array<uint32_t, kProducerCount> poppedCounts{};
+	std::array<int64_t, kProducerCount> lastSequences;
+	lastSequences.fill(-1);
+	bool ordered = true;
+
+	const auto reader = [&](const Item& item)
+	{
+		if (static_cast<int64_t>(item.sequence) <= lastSequences[item.producer])
+		{
+			ordered = false;
+		}
+
+		lastSequences[item.producer] = item.sequence;
+		poppedCounts[item.producer]++;
+	};
+
+	while (finishedProducers.load(std::memory_order_acquire) != kProducerCount)
+	{
+		queue.TryPop(reader);
+	}
+
+	while (queue.TryPop(reader))
+	{
+	}
+
+	for (std::thread& thread : producers)
+	{
+		thread.join();
+	}
+
+	EXPECT_TRUE(ordered);
+
+	for (uint32_t producer = 0; producer < kProducerCount; producer++)
+	{
+		// Every item was either popped or rejected because the queue was full.
+		EXPECT_EQ(poppedCounts[producer] + rejectedCounts[producer].load(), kItemsPerProducer);
+	}
+}
@@ -0,0 +1,81 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "Crc32c.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <string_view>
+#include <vector>
+
+TEST(Crc32cTests, MatchesTheCheckValue)
+{
+	constexpr std::string_view kCheckInput = "123456789";
+
+	EXPECT_EQ(Crc32c::Compute(kCheckInput.data(), kCheckInput.size(), 0, Crc32cMode::Software), 0xE3069283U);
+
+	if (Crc32c::GetBestMode() == Crc32cMode::SSE42)
+	{
+		EXPECT_EQ(Crc32c::Compute(kCheckInput.data(), kCheckInput.size(), 0, Crc32cMode::SSE42), 0xE3069283U);
+	}
+
+	EXPECT_EQ(Crc32c::Compute(nullptr, 0), 0U);
+}
+
+TEST(Crc32cTests, AllModesMatchForEveryLengthAndAlignment)
+{
+	std::vector<uint8_t> data(1024 + 16);
+	std::mt19937 random(7);
+
+	for (uint8_t& value : data)
+	{
+		value = static_cast<uint8_t>(random());
+	}
+
+	for (size_t alignment = 0; alignment < 8; alignment++)
+	{
+		for (size_t length = 0; length <= 1024; length += (length < 64 ? 1 : 61))
+		{
+			const uint32_t expected = Crc32c::Compute(data.data() + alignment, length, 0, Crc32cMode::Software);
+
+			EXPECT_EQ(Crc32c::Compute(data.data() + alignment, length), expected) << alignment << ", " << length;
+		}
+	}
+}
+
+TEST(Crc32cTests, ComputesAChecksumInParts)
+{
+	std::vector<uint8_t> data(100000);
+	std::mt19937 random(8);
+
+	for (uint8_t& value : data)
+	{
+		value = static_cast<uint8_t>(random());
+	}
+
+	const uint32_t expected = Crc32c::Compute(data.data(), data.size());
+
+	for (size_t split : { size_t(1), size_t(7), size_t(4096), size_t(65536), data.size() - 1 })
+	{
+		const uint32_t first = Crc32c::Compute(data.data(), split);
+
+		EXPECT_EQ(Crc32c::Compute(data.data() + split, data.size() - split, first), expected) << split;
+	}
+}
@@ -0,0 +1,143 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "DisplayModeCache.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+
+namespace
+{
+	constexpr uint32_t kMinWidth = 800;
+	constexpr uint32_t kMinHeight = 600;
+
+	// The modes that a 1920x1080 144 Hz monitor reported, after the duplicates were removed.
+	const Platform::DisplayModeList kDesktop1080pModes
+	{
+		"\\\\.\\DISPLAY1",
+		"MONITOR\\GSM5B7F",
+		{ 1920, 1080, 32, 144 },
+		{
+			{ 640, 480, 32, 60 },
+			{ 800, 600, 16, 60 },
+			{ 800, 600, 32, 60 },
+			{ 1024, 768, 32, 60 },
+			{ 1024, 768, 32, 75 },
+			{ 1280, 720, 32, 60 },
+			{ 1280, 720, 32, 120 },
+			{ 1280, 720, 32, 144 },
+			{ 1280, 1024, 32, 60 },
+			{ 1280, 1024, 32, 75 },
+			{ 1600, 900, 32, 60 },
+			{ 1920, 1080, 16, 60 },
+			{ 1920, 1080, 32, 60 },
+			{ 1920, 1080, 32, 144 },
+		}
+	};
+
+	// A laptop panel that only supports its native size at 32 bits per pixel.
+	const Platform::DisplayModeList kLaptopModes
+	{
+		"\\\\.\\DISPLAY1",
+		"MONITOR\\LGD05FA",
+		{ 1920, 1200, 32, 60 },
+		{
+			{ 640, 480, 32, 60 },
+			{ 1920, 1200, 32, 48 },
+			{ 1920, 1200, 32, 60 },
+		}
+	};
+
+	const Platform::DisplayModeList kEmptyModes{};
+
+	struct SelectDisplayModeCase
+	{
+		const char* name;
+		const Platform::DisplayModeList& list;
+		uint32_t width;
+		uint32_t height;
+		uint32_t bitsPerPixel;
+		Platform::DisplayMode expectedMode;
+		DisplayModeMatch expectedMatch;
+	};
+
+	std::string FormatMode(const Platform::DisplayMode& mode)
+	{
+		return std::to_string(mode.width) + 'x' + std::to_string(mode.height) + 'x'
+			+ std::to_string(mode.bitsPerPixel) + '@' + std::to_string(mode.refreshRate);
+	}
+}
+
+TEST(DisplayModeCacheTests, SelectDisplayMode)
+{
+	const SelectDisplayModeCase cases[] =
+	{
+		{ "desktop mode", kDesktop1080pModes, 1920, 1080, 32, { 1920, 1080, 32, 144 }, DisplayModeMatch::Desktop },
+		{ "exact match", kDesktop1080pModes, 1600, 900, 32, { 1600, 900, 32, 60 }, DisplayModeMatch::Exact },
+		{ "exact match uses the highest refresh rate", kDesktop1080pModes, 1280, 720, 32, { 1280, 720, 32, 144 }, DisplayModeMatch::Exact },
+		{ "exact match at 16 bits per pixel", kDesktop1080pModes, 800, 600, 16, { 800, 600, 16, 60 }, DisplayModeMatch::Exact },
+		{ "closest resolution", kDesktop1080pModes, 1366, 768, 32, { 1280, 720, 32, 144 }, DisplayModeMatch::Closest },
+		{ "closest resolution prefers a mode that fits", kDesktop1080pModes, 1300, 700, 32, { 1280, 720, 32, 144 }, DisplayModeMatch::Closest },
+		{ "closest resolution uses the highest refresh rate", kDesktop1080pModes, 1280, 1000, 32, { 1280, 1024, 32, 75 }, DisplayModeMatch::Closest },
+		{ "closest resolution larger than the monitor", kDesktop1080pModes, 2560, 1440, 32, { 1920, 1080, 32, 144 }, DisplayModeMatch::Desktop },
+		{ "closest resolution is the desktop size", kLaptopModes, 1920, 1080, 32, { 1920, 1200, 32, 60 }, DisplayModeMatch::Desktop },
+		{ "modes below the minimum size are ignored", kLaptopModes, 800, 600, 32, { 1920, 1200, 32, 60 }, DisplayModeMatch::Desktop },
+		{ "no mode with the color depth", kLaptopModes, 1920, 1200, 16, { 1920, 1200, 16, 0 }, DisplayModeMatch::None },
+		{ "empty list", kEmptyModes, 1024, 768, 32, { 1024, 768, 32, 0 }, DisplayModeMatch::None },
+	};
+
+	for (const SelectDisplayModeCase& testCase : cases)
+	{
+		SCOPED_TRACE(testCase.name);
+
+		const DisplayModeRequest request
+		{
+			testCase.width,
+			testCase.height,
+			testCase.bitsPerPixel,
+			kMinWidth,
+			kMinHeight,
+		};
+
+		const DisplayModeSelection selection = SelectDisplayMode(testCase.list, request);
+
+		EXPECT_EQ(FormatMode(selection.mode), FormatMode(testCase.expectedMode));
+		EXPECT_EQ(selection.match, testCase.expectedMatch);
+	}
+}
+
+TEST(DisplayModeCacheTests, RefreshRateTieBreakDoesNotDependOnTheListOrder)
+{
+	Platform::DisplayModeList list = kDesktop1080pModes;
+	std::reverse(list.modes.begin(), list.modes.end());
+
+	const DisplayModeSelection selection = SelectDisplayMode(list, DisplayModeRequest{ 1280, 720, 32, kMinWidth, kMinHeight });
+
+	EXPECT_EQ(FormatMode(selection.mode), "1280x720x32@144");
+	EXPECT_EQ(selection.match, DisplayModeMatch::Exact);
+}
+
+TEST(DisplayModeCacheTests, PrimaryDisplayModesAreUnavailableWithoutADisplay)
+{
+	// The POSIX platform layer cannot enumerate the display modes.
+	EXPECT_EQ(DisplayModeCache::GetInstance().GetPrimaryDisplayModes(), nullptr);
+	EXPECT_EQ(DisplayModeCache::GetInstance().GetPrimaryDisplayModes(), nullptr);
+}
@@ -0,0 +1,140 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include "FakeSC4RenderProperties.h"
+#include "SC4GameServices.h"
+#include <string>
+#include <vector>
+
+// An in-memory game for the startup code.
+//
+// The graphics system reports the options that were set with SetDesiredGameResolution
+// and SetDefaultDriverClassID, like the game does after it has initialized. The tests
+// change the public members to simulate a game that ignores or overrides those options.
+class FakeSC4GameServices final : public ISC4GameServices
+{
+public:
+
+	FakeSC4GameServices()
+		: hasApp(true),
+		  videoPreferences{ 1024, 768, 32, false, 1 },
+		  saveVideoPreferencesCount(0),
+		  pauseOnFocusLoss(false),
+		  hasGraphicsSystem(true),
+		  gameMetrics{},
+		  driverCreated(true),
+		  driverClassID(0),
+		  commandLine(),
+		  renderProperties()
+	{
+	}
+
+	bool GetVideoPreferences(SC4VideoOptions& options) override
+	{
+		if (!hasApp)
+		{
+			return false;
+		}
+
+		options = videoPreferences;
+		return true;
+	}
+
+	void SaveVideoPreferences(const SC4VideoOptions& options) override
+	{
+		videoPreferences = options;
+		saveVideoPreferencesCount++;
+	}
+
+	void EnableFullGamePauseOnAppFocusLoss(bool enable) override
+	{
+		pauseOnFocusLoss = enable;
+	}
+
+	void SetDesiredGameResolution(uint32_t width, uint32_t height, uint32_t bitDepth, bool windowed) override
+	{
+		gameMetrics = SC4GameMetrics{ width, height, bitDepth, !windowed };
+	}
+
+	void SetDefaultDriverClassID(uint32_t value) override
+	{
+		driverClassID = value;
+	}
+
+	bool GetGameMetrics(SC4GameMetrics& metrics) override
+	{
+		if (!hasGraphicsSystem)
+		{
+			return false;
+		}
+
+		metrics = gameMetrics;
+		return true;
+	}
+
+	bool GetDriverClassID(uint32_t& value) override
+	{
+		if (!driverCreated)
+		{
+			return false;
+		}
+
+		value = driverClassID;
+		return true;
+	}
+
+	bool IsCommandLineSwitchPresent(const char* name) override
+	{
+		const std::string switchName = std::string("-") + name;
+
+		for (const std::string& argument : commandLine)
+		{
+			if (argument == switchName || argument.starts_with(switchName + ":"))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void AppendCommandLineArgument(const char* argument) override
+	{
+		commandLine.emplace_back(argument);
+	}
+
+	ISC4RenderProperties* GetRenderProperties() override
+	{
+		return hasApp ? &renderProperties : nullptr;
+	}
+
+	bool hasApp;
+	SC4VideoOptions videoPreferences;
+	uint32_t saveVideoPreferencesCount;
+	bool pauseOnFocusLoss;
+	bool hasGraphicsSystem;
+	SC4GameMetrics gameMetrics;
+	bool driverCreated;
+	uint32_t driverClassID;
+	std::vector<std::string> commandLine;
+	FakeSC4RenderProperties renderProperties;
+};
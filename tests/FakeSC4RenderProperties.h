@@ -0,0 +1,119 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include "SC4GameServices.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// In-memory render properties with the options that the plugin changes.
+//
+// The property IDs are the indexes of the properties, a name only resolves to an ID
+// with the function for the property's type, like the game's render properties.
+class FakeSC4RenderProperties final : public ISC4RenderProperties
+{
+public:
+
+	struct Property
+	{
+		std::string name;
+		bool isBool;
+		int32_t value;
+	};
+
+	FakeSC4RenderProperties()
+		: properties
+		  {
+			  { "NoPartialBackingStoreCopies", true, 0 },
+			  { "DirtyRectMergeFrames", false, 0 },
+			  { "CursorType", false, 1 },
+			  { "ShadowQuality", false, 2 },
+		  },
+		  setValueCount(0)
+	{
+	}
+
+	int32_t BoolPropertyIDFromName(const char* name) override
+	{
+		return FindProperty(name, true);
+	}
+
+	int32_t IntPropertyIDFromName(const char* name) override
+	{
+		return FindProperty(name, false);
+	}
+
+	bool GetBoolValue(int32_t id) override
+	{
+		return properties[id].value != 0;
+	}
+
+	int32_t GetIntValue(int32_t id) override
+	{
+		return properties[id].value;
+	}
+
+	void SetBoolValue(int32_t id, bool value) override
+	{
+		properties[id].value = value ? 1 : 0;
+		setValueCount++;
+	}
+
+	void SetIntValue(int32_t id, int32_t value) override
+	{
+		properties[id].value = value;
+		setValueCount++;
+	}
+
+	// Returns the value of a property, or -1 if there is no property with that name.
+	int32_t GetValue(std::string_view name) const
+	{
+		for (const Property& property : properties)
+		{
+			if (property.name == name)
+			{
+				return property.value;
+			}
+		}
+
+		return -1;
+	}
+
+	std::vector<Property> properties;
+	uint32_t setValueCount;
+
+private:
+
+	int32_t FindProperty(std::string_view name, bool isBool) const
+	{
+		for (size_t i = 0; i < properties.size(); i++)
+		{
+			if (properties[i].isBool == isBool && properties[i].name == name)
+			{
+				return static_cast<int32_t>(i);
+			}
+		}
+
+		return -1;
+	}
+};
@@ -0,0 +1,94 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "FlightRecorder.h"
+#include "TestDirectory.h"
+#include <gtest/gtest.h>
+#include <cstdlib>
+
+namespace
+{
+	constexpr std::string_view kDumpFileName = "SC4GraphicsOptions.FlightRecorder.log";
+}
+
+TEST(FlightRecorderTests, ErrorDumpKeepsTheFirstError)
+{
+	TestDirectory directory;
+	FlightRecorder& recorder = FlightRecorder::GetInstance();
+
+	recorder.Init(directory.GetPath() / kDumpFileName);
+
+	recorder.Record(LogCategory::General, LogLevel::Debug, "Before the first error: {}", 1);
+	recorder.RequestErrorDump();
+	recorder.Record(LogCategory::General, LogLevel::Debug, "Before the second error: {:.1f}", 2.0);
+	recorder.RequestErrorDump();
+	recorder.Record(LogCategory::Telemetry, LogLevel::Trace, "Before shutdown: {}", "done");
+
+	recorder.Shutdown();
+
+	const std::string errorDump = directory.ReadFile("SC4GraphicsOptions.FlightRecorder.Error.log");
+
+	EXPECT_TRUE(errorDump.starts_with("Flight recorder dump, reason: error\n"));
+	EXPECT_NE(errorDump.find("[Debug] [General] Before the first error: 1\n"), std::string::npos);
+	EXPECT_EQ(errorDump.find("Before the second error"), std::string::npos);
+
+	const std::string shutdownDump = directory.ReadFile(std::string(kDumpFileName));
+
+	EXPECT_TRUE(shutdownDump.starts_with("Flight recorder dump, reason: shutdown\n"));
+	EXPECT_NE(shutdownDump.find("Before the first error: 1\n"), std::string::npos);
+	EXPECT_NE(shutdownDump.find("Before the second error: 2.0\n"), std::string::npos);
+	EXPECT_NE(shutdownDump.find("[Trace] [Telemetry] Before shutdown: done\n"), std::string::npos);
+}
+
+TEST(FlightRecorderTests, ErrorDumpIsIgnoredBeforeInit)
+{
+	TestDirectory directory;
+	FlightRecorder& recorder = FlightRecorder::GetInstance();
+
+	recorder.RequestErrorDump();
+	recorder.Init(directory.GetPath() / kDumpFileName);
+	recorder.Shutdown();
+
+	EXPECT_FALSE(std::filesystem::exists(directory.GetPath() / "SC4GraphicsOptions.FlightRecorder.Error.log"));
+	EXPECT_TRUE(std::filesystem::exists(directory.GetPath() / kDumpFileName));
+}
+
+TEST(FlightRecorderDeathTest, CrashHandlerWritesTheCrashDump)
+{
+	TestDirectory directory;
+	FlightRecorder& recorder = FlightRecorder::GetInstance();
+
+	recorder.Init(directory.GetPath() / kDumpFileName);
+
+	EXPECT_DEATH(
+		{
+			recorder.Record(LogCategory::General, LogLevel::Debug, "Before the crash: 0x{:08X}", 0xBEEFU);
+			std::abort();
+		},
+		"");
+
+	recorder.Shutdown();
+
+	const std::string crashDump = directory.ReadFile("SC4GraphicsOptions.FlightRecorder.Crash.log");
+
+	EXPECT_TRUE(crashDump.starts_with("Flight recorder dump, reason: unhandled exception\n"));
+	EXPECT_NE(crashDump.find("Before the crash: 0x0000BEEF\n"), std::string::npos);
+}
@@ -0,0 +1,225 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "FramePacer.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace
+{
+	// One tick is one microsecond.
+	constexpr int64_t kFrequency = 1000000;
+	constexpr int64_t kStartTime = 1000000;
+	constexpr int64_t kFrameInterval60 = kFrequency / 60;
+	constexpr int64_t kFrameInterval30 = kFrequency / 30;
+
+	// A simulated clock, the time only advances when the pacer sleeps or spins,
+	// or when the test simulates the game rendering a frame.
+	class FakeFramePacerClock final : public FramePacerClock
+	{
+	public:
+
+		FakeFramePacerClock()
+			: counter(kStartTime),
+			  oversleep(0),
+			  sleepCount(0)
+		{
+		}
+
+		int64_t GetCounter() override
+		{
+			return counter;
+		}
+
+		int64_t GetFrequency() override
+		{
+			return kFrequency;
+		}
+
+		void Sleep(int64_t ticks) override
+		{
+			counter += ticks + oversleep;
+			sleepCount++;
+		}
+
+		void Pause() override
+		{
+			counter++;
+		}
+
+		void Advance(int64_t ticks)
+		{
+			counter += ticks;
+		}
+
+		int64_t counter;
+		int64_t oversleep;
+		uint32_t sleepCount;
+	};
+
+	// Simulates the game rendering frames that take the specified time,
+	// and returns the time that each frame was presented at.
+	std::vector<int64_t> RenderFrames(FakeFramePacerClock& clock, FramePacer& pacer, int64_t frameCost, size_t count)
+	{
+		std::vector<int64_t> presentTimes;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			clock.Advance(frameCost);
+			pacer.WaitForNextFrame();
+			presentTimes.push_back(clock.GetCounter());
+		}
+
+		return presentTimes;
+	}
+}
+
+TEST(FramePacerTests, TheFirstFrameDoesNotWait)
+{
+	FakeFramePacerClock clock;
+	FramePacer pacer(clock, 60);
+
+	pacer.WaitForNextFrame();
+
+	EXPECT_EQ(clock.GetCounter(), kStartTime);
+	EXPECT_EQ(clock.sleepCount, 0u);
+}
+
+TEST(FramePacerTests, SpacesFramesByTheFrameInterval)
+{
+	FakeFramePacerClock clock;
+	FramePacer pacer(clock, 60);
+	pacer.WaitForNextFrame();
+
+	const std::vector<int64_t> presentTimes = RenderFrames(clock, pacer, 5000, 20);
+
+	for (size_t i = 0; i < presentTimes.size(); i++)
+	{
+		EXPECT_EQ(presentTimes[i], kStartTime + (static_cast<int64_t>(i + 1) * kFrameInterval60)) << "frame " << i;
+	}
+
+	// Each wait sleeps until shortly before the deadline.
+	EXPECT_EQ(clock.sleepCount, presentTimes.size());
+	EXPECT_EQ(pacer.GetAverageFrameCost(), 5000);
+}
+
+TEST(FramePacerTests, SpinsLongerWhenTheTimerOversleeps)
+{
+	FakeFramePacerClock clock;
+	clock.oversleep = 600;
+	FramePacer pacer(clock, 60);
+	pacer.WaitForNextFrame();
+
+	const int64_t initialSpinThreshold = pacer.GetSpinThreshold();
+
+	const std::vector<int64_t> presentTimes = RenderFrames(clock, pacer, 5000, 100);
+
+	// The spin time converges on twice the oversleep plus the minimum spin time of 200 microseconds.
+	EXPECT_GT(pacer.GetSpinThreshold(), initialSpinThreshold);
+	EXPECT_GE(pacer.GetSpinThreshold(), 1380);
+	EXPECT_LE(pacer.GetSpinThreshold(), 1400);
+
+	// The first frames wake up after their deadline, the frames are evenly spaced
+	// once the spin time covers the oversleep.
+	EXPECT_GT(presentTimes[1] - presentTimes[0], kFrameInterval60);
+
+	for (size_t i = 20; i < presentTimes.size(); i++)
+	{
+		EXPECT_EQ(presentTimes[i] - presentTimes[i - 1], kFrameInterval60) << "frame " << i;
+	}
+}
+
+TEST(FramePacerTests, LimitsTheSpinTime)
+{
+	FakeFramePacerClock clock;
+	clock.oversleep = 5000;
+	FramePacer pacer(clock, 60);
+	pacer.WaitForNextFrame();
+
+	RenderFrames(clock, pacer, 5000, 100);
+
+	EXPECT_EQ(pacer.GetSpinThreshold(), 2000);
+}
+
+TEST(FramePacerTests, AFrameThatMissesItsDeadlineRestartsTheSchedule)
+{
+	FakeFramePacerClock clock;
+	FramePacer pacer(clock, 60);
+	pacer.WaitForNextFrame();
+	RenderFrames(clock, pacer, 5000, 5);
+
+	const uint32_t sleepCount = clock.sleepCount;
+	const int64_t lateFrameTime = RenderFrames(clock, pacer, 30000, 1).front();
+
+	// The late frame is presented without waiting.
+	EXPECT_EQ(clock.sleepCount, sleepCount);
+
+	// The following frames are spaced from the late frame instead of catching up.
+	const std::vector<int64_t> presentTimes = RenderFrames(clock, pacer, 5000, 3);
+
+	EXPECT_EQ(presentTimes[0], lateFrameTime + kFrameInterval60);
+	EXPECT_EQ(presentTimes[1], lateFrameTime + (2 * kFrameInterval60));
+	EXPECT_EQ(presentTimes[2], lateFrameTime + (3 * kFrameInterval60));
+}
+
+TEST(FramePacerTests, PacesAGameThatCannotReachTheLimitAtItsFrameCost)
+{
+	FakeFramePacerClock clock;
+	FramePacer pacer(clock, 60);
+	pacer.WaitForNextFrame();
+
+	// The frames alternate between 15 and 25 ms, both average 20 ms.
+	for (size_t i = 0; i < 50; i++)
+	{
+		RenderFrames(clock, pacer, (i % 2) == 0 ? 15000 : 25000, 1);
+	}
+
+	EXPECT_GT(pacer.GetAverageFrameCost(), kFrameInterval60);
+
+	// A fast frame waits for the average frame cost instead of the 16.7 ms interval.
+	const int64_t previousPresentTime = clock.GetCounter();
+	const int64_t fastFrameTime = RenderFrames(clock, pacer, 15000, 1).front();
+
+	EXPECT_EQ(fastFrameTime - previousPresentTime, pacer.GetAverageFrameCost());
+}
+
+TEST(FramePacerTests, ChangingTheFrameRateLimitUsesTheNewInterval)
+{
+	FakeFramePacerClock clock;
+	FramePacer pacer(clock, 60);
+	pacer.WaitForNextFrame();
+
+	const int64_t lastPresentTime = RenderFrames(clock, pacer, 5000, 5).back();
+
+	pacer.SetMaxFrameRate(30);
+
+	std::vector<int64_t> presentTimes = RenderFrames(clock, pacer, 5000, 3);
+
+	EXPECT_EQ(presentTimes[0], lastPresentTime + kFrameInterval30);
+	EXPECT_EQ(presentTimes[1], lastPresentTime + (2 * kFrameInterval30));
+	EXPECT_EQ(presentTimes[2], lastPresentTime + (3 * kFrameInterval30));
+
+	pacer.SetMaxFrameRate(60);
+
+	presentTimes = RenderFrames(clock, pacer, 5000, 2);
+
+	EXPECT_EQ(presentTimes[1] - presentTimes[0], kFrameInterval60);
+}
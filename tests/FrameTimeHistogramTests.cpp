@@ -0,0 +1,213 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "FrameTimeHistogram.h"
+#include <gtest/gtest.h>
+
+namespace
+{
+	constexpr uint64_t kSubBucketThreshold = 128;
+
+	uint64_t GetBucketLowerBound(size_t index)
+	{
+		return index > 0 ? FrameTimeHistogram::GetBucketUpperBound(index - 1) + 1 : 0;
+	}
+
+	FrameTimeHistogram::Snapshot TakeSnapshot(FrameTimeHistogram& histogram)
+	{
+		FrameTimeHistogram::Snapshot snapshot;
+		histogram.TakeSnapshot(snapshot);
+
+		return snapshot;
+	}
+}
+
+TEST(FrameTimeHistogramTests, CountsSmallValuesExactly)
+{
+	for (uint64_t value = 0; value < kSubBucketThreshold; value++)
+	{
+		const size_t index = FrameTimeHistogram::GetBucketIndex(value);
+
+		EXPECT_EQ(index, value);
+		EXPECT_EQ(FrameTimeHistogram::GetBucketUpperBound(index), value);
+	}
+}
+
+TEST(FrameTimeHistogramTests, BucketsCoverEveryValueWithoutGaps)
+{
+	for (size_t index = 1; index < FrameTimeHistogram::kBucketCount; index++)
+	{
+		const uint64_t lowerBound = GetBucketLowerBound(index);
+		const uint64_t upperBound = FrameTimeHistogram::GetBucketUpperBound(index);
+
+		ASSERT_LE(lowerBound, upperBound);
+		ASSERT_EQ(FrameTimeHistogram::GetBucketIndex(lowerBound), index);
+		ASSERT_EQ(FrameTimeHistogram::GetBucketIndex(upperBound), index);
+	}
+
+	EXPECT_EQ(
+		FrameTimeHistogram::GetBucketUpperBound(FrameTimeHistogram::kBucketCount - 1),
+		FrameTimeHistogram::kMaxTrackableValue);
+}
+
+TEST(FrameTimeHistogramTests, BucketsAboveTheExactRangeHaveALowRelativeError)
+{
+	EXPECT_EQ(FrameTimeHistogram::GetBucketIndex(128), FrameTimeHistogram::GetBucketIndex(129));
+	EXPECT_EQ(FrameTimeHistogram::GetBucketIndex(130), FrameTimeHistogram::GetBucketIndex(129) + 1);
+
+	for (size_t index = kSubBucketThreshold; index < FrameTimeHistogram::kBucketCount; index++)
+	{
+		const double lowerBound = static_cast<double>(GetBucketLowerBound(index));
+		const double upperBound = static_cast<double>(FrameTimeHistogram::GetBucketUpperBound(index));
+
+		ASSERT_LT((upperBound - lowerBound) / lowerBound, 0.016);
+	}
+}
+
+TEST(FrameTimeHistogramTests, RecordsValuesIntoTheirBuckets)
+{
+	FrameTimeHistogram histogram;
+	histogram.Record(16667);
+	histogram.Record(16667);
+	histogram.Record(33333);
+
+	const FrameTimeHistogram::Snapshot snapshot = TakeSnapshot(histogram);
+
+	EXPECT_EQ(snapshot.GetTotalCount(), 3u);
+	EXPECT_EQ(snapshot.GetMaxValue(), 33333u);
+	// 16667 is in the [16640, 16895] bucket and 33333 is in the [33280, 33791] bucket.
+	EXPECT_EQ(snapshot.GetValueAtPercentile(50.0), 16895u);
+	EXPECT_EQ(snapshot.GetValueAtPercentile(100.0), 33333u);
+	EXPECT_DOUBLE_EQ(snapshot.GetMeanValue(), ((2 * 16767.5) + 33535.5) / 3.0);
+}
+
+TEST(FrameTimeHistogramTests, CountsValuesAboveTheTrackableRangeAsTheMaximum)
+{
+	FrameTimeHistogram histogram;
+	histogram.Record(FrameTimeHistogram::kMaxTrackableValue * 4);
+
+	const FrameTimeHistogram::Snapshot snapshot = TakeSnapshot(histogram);
+
+	EXPECT_EQ(snapshot.GetTotalCount(), 1u);
+	EXPECT_EQ(snapshot.GetMaxValue(), FrameTimeHistogram::kMaxTrackableValue);
+}
+
+TEST(FrameTimeHistogramTests, PercentilesAtExactBucketEdges)
+{
+	FrameTimeHistogram histogram;
+
+	for (uint64_t value = 1; value <= 100; value++)
+	{
+		histogram.Record(value);
+	}
+
+	const FrameTimeHistogram::Snapshot snapshot = TakeSnapshot(histogram);
+
+	EXPECT_EQ(snapshot.GetValueAtPercentile(0.0), 1u);
+	EXPECT_EQ(snapshot.GetValueAtPercentile(1.0), 1u);
+	EXPECT_EQ(snapshot.GetValueAtPercentile(1.5), 2u);
+	EXPECT_EQ(snapshot.GetValueAtPercentile(50.0), 50u);
+	EXPECT_EQ(snapshot.GetValueAtPercentile(99.0), 99u);
+	EXPECT_EQ(snapshot.GetValueAtPercentile(100.0), 100u);
+	EXPECT_EQ(snapshot.GetValueAtPercentile(150.0), 100u);
+	EXPECT_EQ(snapshot.GetValueAtPercentile(-5.0), 1u);
+}
+
+TEST(FrameTimeHistogramTests, PercentilesAtSubBucketEdges)
+{
+	FrameTimeHistogram histogram;
+	// 128 and 129 share a bucket, 130 is in the next one.
+	histogram.Record(128);
+	histogram.Record(129);
+	histogram.Record(130);
+	histogram.Record(1000);
+
+	const FrameTimeHistogram::Snapshot snapshot = TakeSnapshot(histogram);
+
+	EXPECT_EQ(snapshot.GetValueAtPercentile(25.0), 129u);
+	EXPECT_EQ(snapshot.GetValueAtPercentile(50.0), 129u);
+	EXPECT_EQ(snapshot.GetValueAtPercentile(75.0), 131u);
+	// The last bucket's upper bound is limited to the largest recorded value.
+	EXPECT_EQ(snapshot.GetValueAtPercentile(100.0), 1000u);
+}
+
+TEST(FrameTimeHistogramTests, EmptyHistogram)
+{
+	FrameTimeHistogram histogram;
+
+	const FrameTimeHistogram::Snapshot snapshot = TakeSnapshot(histogram);
+
+	EXPECT_EQ(snapshot.GetTotalCount(), 0u);
+	EXPECT_EQ(snapshot.GetMaxValue(), 0u);
+	EXPECT_EQ(snapshot.GetMeanValue(), 0.0);
+	EXPECT_EQ(snapshot.GetValueAtPercentile(0.0), 0u);
+	EXPECT_EQ(snapshot.GetValueAtPercentile(50.0), 0u);
+	EXPECT_EQ(snapshot.GetValueAtPercentile(100.0), 0u);
+}
+
+TEST(FrameTimeHistogramTests, TakeSnapshotResetsTheHistogram)
+{
+	FrameTimeHistogram histogram;
+	histogram.Record(16667);
+
+	EXPECT_EQ(TakeSnapshot(histogram).GetTotalCount(), 1u);
+
+	const FrameTimeHistogram::Snapshot snapshot = TakeSnapshot(histogram);
+
+	EXPECT_EQ(snapshot.GetTotalCount(), 0u);
+	EXPECT_EQ(snapshot.GetMaxValue(), 0u);
+}
+
+TEST(FrameTimeHistogramTests, MergeAddsTheCounts)
+{
+	FrameTimeHistogram::Snapshot first;
+	first.Add(10, 3);
+
+	FrameTimeHistogram::Snapshot second;
+	second.Add(20, 1);
+	first.Merge(second);
+
+	EXPECT_EQ(first.GetTotalCount(), 4u);
+	EXPECT_EQ(first.GetMaxValue(), 20u);
+	EXPECT_EQ(first.GetValueAtPercentile(75.0), 10u);
+	EXPECT_EQ(first.GetValueAtPercentile(100.0), 20u);
+}
+
+TEST(FrameTimeHistogramTests, FormatsTheReport)
+{
+	FrameTimeHistogram::Snapshot snapshot;
+	snapshot.Add(8333, 90);
+	snapshot.Add(33333, 9);
+	snapshot.Add(100000, 1);
+
+	EXPECT_EQ(
+		FormatFrameTimeReport(snapshot, 10.0),
+		"Frame times over 10.0s: 100 frames (10.0 FPS), mean 11.56ms, p50 8.45ms, p95 33.79ms, p99 33.79ms, max 100.00ms.");
+}
+
+TEST(FrameTimeHistogramTests, FormatsTheReportOfAnEmptyHistogram)
+{
+	const FrameTimeHistogram::Snapshot snapshot;
+
+	EXPECT_EQ(
+		FormatFrameTimeReport(snapshot, 0.0),
+		"Frame times over 0.0s: 0 frames (0.0 FPS), mean 0.00ms, p50 0.00ms, p95 0.00ms, p99 0.00ms, max 0.00ms.");
+}
@@ -0,0 +1,194 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "GameExecutableFingerprint.h"
+#include "Crc32c.h"
+#include "TestDirectory.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+
+namespace
+{
+	constexpr size_t kNtHeadersOffset = 0x80;
+	constexpr size_t kFileHeaderOffset = kNtHeadersOffset + 4;
+	constexpr size_t kOptionalHeaderOffset = kFileHeaderOffset + 20;
+	constexpr size_t kOptionalHeaderSize = 224;
+	constexpr size_t kSectionTableOffset = kOptionalHeaderOffset + kOptionalHeaderSize;
+	constexpr size_t kSectionHeaderSize = 40;
+
+	// The file layout of the synthetic executable's sections.
+	constexpr size_t kTextFileOffset = 0x400;
+	constexpr size_t kTextFileSize = 0x3000;
+	constexpr size_t kDataFileOffset = kTextFileOffset + kTextFileSize;
+	constexpr size_t kDataFileSize = 0x200;
+	constexpr size_t kFileSize = kDataFileOffset + kDataFileSize;
+
+	template <typename T>
+	void Write(std::string& file, size_t offset, T value)
+	{
+		std::memcpy(file.data() + offset, &value, sizeof(value));
+	}
+
+	void WriteSectionHeader(std::string& file, size_t index, const char* name, uint32_t rva, uint32_t fileOffset, uint32_t fileSize)
+	{
+		const size_t offset = kSectionTableOffset + (index * kSectionHeaderSize);
+
+		std::memcpy(file.data() + offset, name, std::strlen(name));
+		Write<uint32_t>(file, offset + 8, fileSize);
+		Write<uint32_t>(file, offset + 12, rva);
+		Write<uint32_t>(file, offset + 16, fileSize);
+		Write<uint32_t>(file, offset + 20, fileOffset);
+	}
+
+	// Builds the contents of a 32-bit executable file with a .text and a .data section.
+	std::string CreateExecutableFile()
+	{
+		std::string file(kFileSize, '\0');
+
+		Write<uint16_t>(file, 0, 0x5A4D);
+		Write<uint32_t>(file, 0x3C, kNtHeadersOffset);
+		Write<uint32_t>(file, kNtHeadersOffset, 0x00004550);
+		Write<uint16_t>(file, kFileHeaderOffset, 0x014C);
+		Write<uint16_t>(file, kFileHeaderOffset + 2, 2);
+		Write<uint16_t>(file, kFileHeaderOffset + 16, kOptionalHeaderSize);
+		Write<uint16_t>(file, kOptionalHeaderOffset, 0x010B);
+		Write<uint32_t>(file, kOptionalHeaderOffset + 28, 0x00400000);
+		Write<uint32_t>(file, kOptionalHeaderOffset + 56, 0x5000);
+
+		WriteSectionHeader(file, 0, ".text", 0x1000, kTextFileOffset, kTextFileSize);
+		WriteSectionHeader(file, 1, ".data", 0x4000, kDataFileOffset, kDataFileSize);
+
+		for (size_t i = 0; i < kTextFileSize; i++)
+		{
+			file[kTextFileOffset + i] = static_cast<char>((i * 31) ^ (i >> 8));
+		}
+
+		return file;
+	}
+
+	GameExecutableFileInfo CreateFileInfo()
+	{
+		return GameExecutableFileInfo{ kFileSize, 133500000000000000 };
+	}
+}
+
+TEST(GameExecutableFingerprintTests, HashesTheCodeSectionOfTheFile)
+{
+	TestDirectory directory;
+	const std::string file = CreateExecutableFile();
+	const std::filesystem::path path = directory.WriteFile("SimCity 4.exe", file);
+
+	GameExecutableFingerprint fingerprint{};
+
+	ASSERT_TRUE(ComputeGameExecutableFingerprint(path, fingerprint));
+	EXPECT_EQ(fingerprint.codeSize, kTextFileSize);
+	EXPECT_EQ(fingerprint.codeCrc32c, Crc32c::Compute(file.data() + kTextFileOffset, kTextFileSize));
+
+	// Changes outside of the code section do not change the fingerprint.
+	std::string modifiedData = file;
+	modifiedData[kDataFileOffset] = 'X';
+
+	GameExecutableFingerprint dataModified{};
+
+	ASSERT_TRUE(ComputeGameExecutableFingerprint(directory.WriteFile("DataModified.exe", modifiedData), dataModified));
+	EXPECT_EQ(dataModified, fingerprint);
+
+	std::string modifiedCode = file;
+	modifiedCode[kTextFileOffset + 100] ^= 0x20;
+
+	GameExecutableFingerprint codeModified{};
+
+	ASSERT_TRUE(ComputeGameExecutableFingerprint(directory.WriteFile("CodeModified.exe", modifiedCode), codeModified));
+	EXPECT_NE(codeModified, fingerprint);
+}
+
+TEST(GameExecutableFingerprintTests, RejectsInvalidFiles)
+{
+	TestDirectory directory;
+	const std::string file = CreateExecutableFile();
+	GameExecutableFingerprint fingerprint{};
+
+	EXPECT_FALSE(ComputeGameExecutableFingerprint(directory.GetPath() / "Missing.exe", fingerprint));
+	EXPECT_FALSE(ComputeGameExecutableFingerprint(directory.WriteFile("Empty.exe", ""), fingerprint));
+	EXPECT_FALSE(ComputeGameExecutableFingerprint(directory.WriteFile("Headers.exe", file.substr(0, 0x100)), fingerprint));
+
+	// The code section extends past the end of the file.
+	EXPECT_FALSE(ComputeGameExecutableFingerprint(
+		directory.WriteFile("Truncated.exe", file.substr(0, kTextFileOffset + kTextFileSize - 1)),
+		fingerprint));
+
+	std::string noCode = file;
+	std::memcpy(noCode.data() + kSectionTableOffset, ".code", 5);
+
+	EXPECT_FALSE(ComputeGameExecutableFingerprint(directory.WriteFile("NoCode.exe", noCode), fingerprint));
+}
+
+TEST(GameExecutableFingerprintTests, CachesTheFingerprintUntilTheFileChanges)
+{
+	TestDirectory directory;
+	const std::filesystem::path cachePath = directory.GetPath() / "SC4GraphicsOptions.GameExecutable.ini";
+	const GameExecutableFileInfo fileInfo = CreateFileInfo();
+	const GameExecutableFingerprint fingerprint{ kTextFileSize, 0x12345678 };
+
+	ASSERT_TRUE(SaveGameExecutableFingerprintCache(cachePath, fileInfo, fingerprint));
+
+	GameExecutableFingerprint cached{};
+
+	ASSERT_TRUE(LoadGameExecutableFingerprintCache(cachePath, fileInfo, cached));
+	EXPECT_EQ(cached, fingerprint);
+
+	GameExecutableFileInfo changedFileInfo = fileInfo;
+	changedFileInfo.lastWriteTime++;
+
+	EXPECT_FALSE(LoadGameExecutableFingerprintCache(cachePath, changedFileInfo, cached));
+
+	changedFileInfo = fileInfo;
+	changedFileInfo.size++;
+
+	EXPECT_FALSE(LoadGameExecutableFingerprintCache(cachePath, changedFileInfo, cached));
+}
+
+TEST(GameExecutableFingerprintTests, IgnoresCacheFilesFromOtherVersions)
+{
+	TestDirectory directory;
+	const GameExecutableFileInfo fileInfo = CreateFileInfo();
+	GameExecutableFingerprint cached{};
+
+	// Version 1 hashed the code in memory, which other plugins may have patched.
+	const std::filesystem::path oldVersionPath = directory.WriteFile(
+		"OldVersion.ini",
+		"[GameExecutable]\nVersion=1\nFileSize=13824\nLastWriteTime=133500000000000000\nCodeSize=12288\nCodeCrc32c=1\n");
+
+	EXPECT_FALSE(LoadGameExecutableFingerprintCache(oldVersionPath, fileInfo, cached));
+
+	const std::filesystem::path missingValuePath = directory.WriteFile(
+		"MissingValue.ini",
+		"[GameExecutable]\nVersion=2\nFileSize=13824\nLastWriteTime=133500000000000000\nCodeSize=12288\n");
+
+	EXPECT_FALSE(LoadGameExecutableFingerprintCache(missingValuePath, fileInfo, cached));
+
+	const std::filesystem::path currentVersionPath = directory.WriteFile(
+		"CurrentVersion.ini",
+		"[GameExecutable]\nVersion=2\nFileSize=13824\nLastWriteTime=133500000000000000\nCodeSize=12288\nCodeCrc32c=1\n");
+
+	EXPECT_TRUE(LoadGameExecutableFingerprintCache(currentVersionPath, fileInfo, cached));
+}
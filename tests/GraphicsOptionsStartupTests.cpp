@@ -0,0 +1,189 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "FakeSC4GameServices.h"
+#include "GraphicsOptionsStartup.h"
+#include "Logger.h"
+#include "ProcessSchedulingPolicy.h"
+#include "RenderOptionsController.h"
+#include "TestDirectory.h"
+#include <gtest/gtest.h>
+
+namespace
+{
+	Settings LoadSettings(std::string_view text)
+	{
+		TestDirectory directory;
+		Settings settings;
+
+		settings.Load(directory.WriteFile("SC4GraphicsOptions.ini", text));
+
+		return settings;
+	}
+
+	constexpr std::string_view kFullScreenSettings =
+		"[GraphicsOptions]\n"
+		"Driver=OpenGL\n"
+		"WindowWidth=1600\n"
+		"WindowHeight=900\n"
+		"WindowMode=FullScreen\n"
+		"EnableIntroVideo=false\n"
+		"PauseGameOnFocusLoss=true\n";
+}
+
+TEST(GraphicsOptionsStartupTests, SavesTheVideoPreferencesWhenTheyChange)
+{
+	const Settings settings = LoadSettings(kFullScreenSettings);
+	FakeSC4GameServices game;
+	game.videoPreferences.driverType = 0;
+
+	SC4VideoOptions options{};
+
+	ASSERT_TRUE(game.GetVideoPreferences(options));
+	GraphicsOptionsStartup::ApplyVideoPreferences(settings, game, options);
+
+	EXPECT_EQ(game.saveVideoPreferencesCount, 1U);
+	EXPECT_EQ(game.videoPreferences.width, 1600U);
+	EXPECT_EQ(game.videoPreferences.height, 900U);
+	EXPECT_EQ(game.videoPreferences.bitDepth, 32U);
+	EXPECT_TRUE(game.videoPreferences.fullScreen);
+	// OpenGL is hardware rendering.
+	EXPECT_EQ(game.videoPreferences.driverType, 1);
+	EXPECT_TRUE(game.pauseOnFocusLoss);
+
+	// The preferences are not saved again when they already match.
+	GraphicsOptionsStartup::ApplyVideoPreferences(settings, game, options);
+
+	EXPECT_EQ(game.saveVideoPreferencesCount, 1U);
+}
+
+TEST(GraphicsOptionsStartupTests, SetsTheGraphicsOptions)
+{
+	const Settings settings = LoadSettings(kFullScreenSettings);
+	FakeSC4GameServices game;
+
+	GraphicsOptionsStartup::ApplyGraphicsOptions(settings, game);
+
+	EXPECT_EQ(game.gameMetrics.width, 1600U);
+	EXPECT_EQ(game.gameMetrics.height, 900U);
+	EXPECT_EQ(game.gameMetrics.bitDepth, 32U);
+	EXPECT_TRUE(game.gameMetrics.fullScreen);
+	EXPECT_EQ(game.driverClassID, settings.GetGDriverDescription().GetGZCLSID());
+	EXPECT_TRUE(GraphicsOptionsStartup::VerifyGraphicsOptions(settings, game));
+}
+
+TEST(GraphicsOptionsStartupTests, DisablesTheIntroVideoOnce)
+{
+	FakeSC4GameServices game;
+
+	GraphicsOptionsStartup::DisableIntroVideo(game);
+	GraphicsOptionsStartup::DisableIntroVideo(game);
+
+	ASSERT_EQ(game.commandLine.size(), 1U);
+	EXPECT_EQ(game.commandLine[0], "-Intro:off");
+
+	// A switch from the user's command line is kept.
+	FakeSC4GameServices gameWithSwitch;
+	gameWithSwitch.commandLine.emplace_back("-Intro:on");
+
+	GraphicsOptionsStartup::DisableIntroVideo(gameWithSwitch);
+
+	EXPECT_EQ(gameWithSwitch.commandLine.size(), 1U);
+}
+
+TEST(GraphicsOptionsStartupTests, VerifyReportsTheOptionsThatTheGameChanged)
+{
+	TestDirectory directory;
+	const std::filesystem::path logFilePath = directory.GetPath() / "SC4GraphicsOptions.log";
+	const Settings settings = LoadSettings(kFullScreenSettings);
+
+	Logger& logger = Logger::GetInstance();
+	logger.Init(logFilePath, LogLevel::Error, false);
+
+	FakeSC4GameServices game;
+	GraphicsOptionsStartup::ApplyGraphicsOptions(settings, game);
+
+	game.gameMetrics.width = 1024;
+	game.driverClassID = 0;
+
+	EXPECT_FALSE(GraphicsOptionsStartup::VerifyGraphicsOptions(settings, game));
+
+	logger.Shutdown();
+
+	const std::string log = directory.ReadFile(logFilePath);
+
+	EXPECT_NE(log.find("(1024x900x32, full screen) doesn't match the requested options (1600x900x32, full screen)"), std::string::npos);
+	EXPECT_NE(log.find("Failed to set the game's driver to"), std::string::npos);
+
+	// Nothing is checked when the graphics system and driver are not available.
+	game.hasGraphicsSystem = false;
+	game.driverCreated = false;
+
+	EXPECT_TRUE(GraphicsOptionsStartup::VerifyGraphicsOptions(settings, game));
+}
+
+TEST(GraphicsOptionsStartupTests, PreFrameWorkInitSkipsTheGraphicsOptionsWithoutTheApp)
+{
+	const Settings settings = LoadSettings(kFullScreenSettings);
+	FakeSC4GameServices game;
+	game.hasApp = false;
+
+	PlatformProcessSchedulingControls processSchedulingControls;
+	ProcessSchedulingPolicy processScheduling(processSchedulingControls);
+	SC4VideoOptions videoOptions{};
+
+	EXPECT_FALSE(GraphicsOptionsStartup::PreFrameWorkInit(settings, game, processScheduling, videoOptions));
+	EXPECT_EQ(game.gameMetrics.width, 0u);
+	EXPECT_EQ(game.driverClassID, 0u);
+	EXPECT_EQ(game.commandLine, std::vector<std::string>{ "-Intro:off" });
+
+	processScheduling.Restore();
+}
+
+TEST(GraphicsOptionsStartupTests, PreAppInitCreatesAFramePacerForAFrameRateLimit)
+{
+	FakeSC4GameServices game;
+	SystemFramePacerClock framePacerClock;
+
+	EXPECT_EQ(GraphicsOptionsStartup::PreAppInit(LoadSettings(""), game, framePacerClock), nullptr);
+	EXPECT_NE(GraphicsOptionsStartup::PreAppInit(LoadSettings("[GraphicsOptions]\nMaxFrameRate=60\n"), game, framePacerClock), nullptr);
+}
+
+TEST(GraphicsOptionsStartupTests, PostAppInitSetsTheRenderOptions)
+{
+	const Settings settings = LoadSettings(
+		"[GraphicsOptions]\n"
+		"ForceDrawOnScroll=true\n"
+		"AutoTuneRenderOptions=true\n"
+		"[RenderProperties]\n"
+		"CursorType=1\n");
+
+	TestDirectory directory;
+	FakeSC4GameServices game;
+	RenderOptionsController renderOptions;
+
+	GraphicsOptionsStartup::PostAppInit(settings, game, renderOptions, directory.GetPath());
+
+	EXPECT_EQ(game.renderProperties.GetValue("NoPartialBackingStoreCopies"), 1);
+	EXPECT_EQ(game.renderProperties.GetValue("DirtyRectMergeFrames"), 8);
+	EXPECT_EQ(game.renderProperties.GetValue("CursorType"), 1);
+	EXPECT_TRUE(renderOptions.IsAutoTuning());
+}
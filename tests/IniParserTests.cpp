@@ -0,0 +1,151 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "IniParser.h"
+#include <gtest/gtest.h>
+#include <string_view>
+
+namespace
+{
+	struct ParseErrorPosition
+	{
+		uint32_t line;
+		uint32_t column;
+		std::string message;
+	};
+
+	// Parses the text until the parser throws, and returns the position that the error reports.
+	ParseErrorPosition GetParseErrorPosition(std::string_view text)
+	{
+		IniParser parser(text);
+		IniEntry entry{};
+
+		try
+		{
+			while (parser.Next(entry))
+			{
+			}
+		}
+		catch (const IniParseError& e)
+		{
+			return ParseErrorPosition{ e.GetLine(), e.GetColumn(), e.what() };
+		}
+
+		ADD_FAILURE() << "The text was parsed without an error.";
+		return ParseErrorPosition{};
+	}
+}
+
+TEST(IniParserTests, ReadsTheEntriesAndTheirPositions)
+{
+	IniParser parser(
+		"\xEF\xBB\xBF; A comment\r\n"
+		"[GraphicsOptions]\r\n"
+		"  WindowWidth = 1280  \r\n"
+		"\r\n"
+		"# Another comment\n"
+		"Driver=\n");
+	IniEntry entry{};
+
+	ASSERT_TRUE(parser.Next(entry));
+	EXPECT_EQ(entry.section, "GraphicsOptions");
+	EXPECT_EQ(entry.key, "WindowWidth");
+	EXPECT_EQ(entry.value, "1280");
+	EXPECT_EQ(entry.line, 3u);
+	EXPECT_EQ(entry.column, 17u);
+
+	ASSERT_TRUE(parser.Next(entry));
+	EXPECT_EQ(entry.key, "Driver");
+	EXPECT_EQ(entry.value, "");
+	EXPECT_EQ(entry.line, 6u);
+	EXPECT_EQ(entry.column, 8u);
+
+	EXPECT_FALSE(parser.Next(entry));
+}
+
+TEST(IniParserTests, ReportsALineWithoutASeparator)
+{
+	const ParseErrorPosition position = GetParseErrorPosition(
+		"[GraphicsOptions]\n"
+		"WindowWidth=1280\n"
+		"   oops\n");
+
+	EXPECT_EQ(position.line, 3u);
+	EXPECT_EQ(position.column, 4u);
+	EXPECT_EQ(position.message, "Line 3, column 4: Expected a Key=Value line.");
+}
+
+TEST(IniParserTests, ReportsAnEmptyKey)
+{
+	const ParseErrorPosition position = GetParseErrorPosition(
+		"[GraphicsOptions]\r\n"
+		"\t= 1280\r\n");
+
+	EXPECT_EQ(position.line, 2u);
+	EXPECT_EQ(position.column, 2u);
+	EXPECT_EQ(position.message, "Line 2, column 2: The key name is empty.");
+}
+
+TEST(IniParserTests, ReportsAnUnterminatedSection)
+{
+	const ParseErrorPosition position = GetParseErrorPosition(
+		"; Settings\n"
+		"\n"
+		"  [GraphicsOptions\n"
+		"WindowWidth=1280\n");
+
+	EXPECT_EQ(position.line, 3u);
+	EXPECT_EQ(position.column, 3u);
+	EXPECT_EQ(position.message, "Line 3, column 3: The section name is missing the closing ']'.");
+}
+
+TEST(IniParserTests, ReportsTextAfterASection)
+{
+	const ParseErrorPosition position = GetParseErrorPosition("[GraphicsOptions] extra\n");
+
+	EXPECT_EQ(position.line, 1u);
+	EXPECT_EQ(position.column, 19u);
+}
+
+TEST(IniParserTests, AllowsACommentAfterASection)
+{
+	IniParser parser("[GraphicsOptions] ; comment\nWindowWidth=1280\n");
+	IniEntry entry{};
+
+	ASSERT_TRUE(parser.Next(entry));
+	EXPECT_EQ(entry.section, "GraphicsOptions");
+}
+
+TEST(IniParserTests, ReportsAnEmptySection)
+{
+	const ParseErrorPosition position = GetParseErrorPosition("WindowWidth=1280\n[ ]\n");
+
+	EXPECT_EQ(position.line, 2u);
+	EXPECT_EQ(position.column, 1u);
+}
+
+TEST(IniParserTests, ByteOrderMarkIsNotCountedInTheColumn)
+{
+	const ParseErrorPosition position = GetParseErrorPosition("\xEF\xBB\xBFoops");
+
+	EXPECT_EQ(position.line, 1u);
+	EXPECT_EQ(position.column, 1u);
+}
@@ -0,0 +1,225 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "Logger.h"
+#include "TestDirectory.h"
+#include <gtest/gtest.h>
+#include <charconv>
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	constexpr size_t kMaxLogFileSize = 64 * 1024 * 1024;
+
+	// The Logger is a singleton, each test initializes it with its own file and shuts it down.
+	class LoggerTests : public testing::Test
+	{
+	protected:
+
+		void Init(LogWriteMode writeMode)
+		{
+			logFilePath = directory.GetPath() / "SC4GraphicsOptions.log";
+
+			Logger::GetInstance().Init(logFilePath, LogLevel::Info, false, writeMode, kMaxLogFileSize, 0);
+		}
+
+		std::vector<std::string> ShutdownAndReadLines()
+		{
+			Logger::GetInstance().Shutdown();
+
+			std::istringstream stream(directory.ReadFile(logFilePath));
+			std::vector<std::string> lines;
+			std::string line;
+
+			while (std::getline(stream, line))
+			{
+				if (!line.empty() && line.back() == '\r')
+				{
+					line.pop_back();
+				}
+
+				lines.push_back(line);
+			}
+
+			return lines;
+		}
+
+		void TearDown() override
+		{
+			Logger::GetInstance().Shutdown();
+		}
+
+		TestDirectory directory;
+		std::filesystem::path logFilePath;
+	};
+
+	bool ParseNumber(std::string_view text, uint32_t& value)
+	{
+		const std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), value);
+
+		return result.ec == std::errc() && result.ptr == text.data() + text.size();
+	}
+}
+
+TEST_F(LoggerTests, SynchronousModeWritesEnabledLevels)
+{
+	Init(LogWriteMode::Synchronous);
+
+	Logger& logger = Logger::GetInstance();
+	logger.WriteLine(LogCategory::General, LogLevel::Info, "info line");
+	logger.WriteLineFormatted(LogCategory::Settings, LogLevel::Info, "formatted {} {}", 1, "two");
+	logger.WriteLine(LogCategory::General, LogLevel::Trace, "trace line");
+
+	const std::vector<std::string> expected{ "info line", "formatted 1 two" };
+
+	EXPECT_EQ(ShutdownAndReadLines(), expected);
+}
+
+TEST_F(LoggerTests, LongFormattedLinesAreNotTruncated)
+{
+	Init(LogWriteMode::Synchronous);
+
+	// The line is longer than the logger's stack buffer.
+	const std::string value(3000, 'x');
+	Logger::GetInstance().WriteLineFormatted(LogCategory::General, LogLevel::Info, "[{}]", value);
+
+	const std::vector<std::string> expected{ "[" + value + "]" };
+
+	EXPECT_EQ(ShutdownAndReadLines(), expected);
+}
+
+TEST_F(LoggerTests, AsynchronousModeFlushesOnShutdown)
+{
+	Init(LogWriteMode::Asynchronous);
+
+	Logger& logger = Logger::GetInstance();
+
+	for (uint32_t i = 0; i < 100; i++)
+	{
+		logger.WriteLineFormatted(LogCategory::General, LogLevel::Info, "line {}", i);
+
+		// Give the writer thread time to drain the queue, so no lines are dropped.
+		if ((i % 16) == 15)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+	}
+
+	const std::vector<std::string> lines = ShutdownAndReadLines();
+
+	ASSERT_EQ(lines.size(), 100U);
+
+	for (uint32_t i = 0; i < 100; i++)
+	{
+		EXPECT_EQ(lines[i], "line " + std::to_string(i));
+	}
+}
+
+TEST_F(LoggerTests, SynchronousModeAfterAsynchronousMode)
+{
+	Init(LogWriteMode::Asynchronous);
+	Logger::GetInstance().WriteLine(LogCategory::General, LogLevel::Info, "asynchronous");
+	ASSERT_EQ(ShutdownAndReadLines(), std::vector<std::string>{ "asynchronous" });
+
+	// The stopped writer thread must not be used after the logger is initialized again.
+	Init(LogWriteMode::Synchronous);
+	Logger::GetInstance().WriteLine(LogCategory::General, LogLevel::Info, "synchronous");
+	EXPECT_EQ(ShutdownAndReadLines(), std::vector<std::string>{ "synchronous" });
+}
+
+TEST_F(LoggerTests, AsynchronousModeWithSeveralProducers)
+{
+	constexpr uint32_t kProducerCount = 4;
+	constexpr uint32_t kLinesPerProducer = 50000;
+
+	Init(LogWriteMode::Asynchronous);
+
+	std::vector<std::thread> producers;
+	const auto start = std::chrono::steady_clock::now();
+
+	for (uint32_t producer = 0; producer < kProducerCount; producer++)
+	{
+		producers.emplace_back([producer]
+		{
+			Logger& logger = Logger::GetInstance();
+
+			for (uint32_t i = 0; i < kLinesPerProducer; i++)
+			{
+				logger.WriteLineFormatted(LogCategory::General, LogLevel::Info, "producer {} line {}", producer, i);
+			}
+		});
+	}
+
+	for (std::thread& thread : producers)
+	{
+		thread.join();
+	}
+
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	const std::vector<std::string> lines = ShutdownAndReadLines();
+
+	std::array<int64_t, kProducerCount> lastLines;
+	lastLines.fill(-1);
+	uint32_t writtenCount = 0;
+	uint32_t droppedCount = 0;
+
+	constexpr std::string_view kDroppedPrefix = "Dropped ";
+	constexpr std::string_view kDroppedSuffix = " log line(s), the log queue was full.";
+
+	for (const std::string& line : lines)
+	{
+		uint32_t producer = 0;
+		uint32_t number = 0;
+
+		if (line.starts_with(kDroppedPrefix) && line.ends_with(kDroppedSuffix))
+		{
+			const std::string_view count = std::string_view(line).substr(
+				kDroppedPrefix.size(),
+				line.size() - kDroppedPrefix.size() - kDroppedSuffix.size());
+
+			ASSERT_TRUE(ParseNumber(count, number)) << line;
+			droppedCount += number;
+			continue;
+		}
+
+		const size_t lineSeparator = line.find(" line ");
+
+		ASSERT_TRUE(line.starts_with("producer ") && lineSeparator != std::string::npos) << line;
+		ASSERT_TRUE(ParseNumber(std::string_view(line).substr(9, lineSeparator - 9), producer)) << line;
+		ASSERT_TRUE(ParseNumber(std::string_view(line).substr(lineSeparator + 6), number)) << line;
+		ASSERT_LT(producer, kProducerCount);
+
+		// The queue keeps the order of each producer's lines.
+		EXPECT_GT(static_cast<int64_t>(number), lastLines[producer]) << line;
+		lastLines[producer] = number;
+		writtenCount++;
+	}
+
+	// Every line is either written or counted as dropped.
+	EXPECT_EQ(writtenCount + droppedCount, kProducerCount * kLinesPerProducer);
+	EXPECT_GT(writtenCount, 0U);
+
+	RecordProperty("LinesPerSecond", std::to_string(static_cast<uint64_t>(kProducerCount * kLinesPerProducer / elapsed.count())));
+	RecordProperty("DroppedLines", std::to_string(droppedCount));
+}
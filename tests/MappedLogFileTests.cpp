@@ -0,0 +1,171 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "MappedLogFile.h"
+#include "TestDirectory.h"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace
+{
+	constexpr size_t kSegmentSize = 64 * 1024;
+
+	size_t CountLines(const std::string& text)
+	{
+		size_t count = 0;
+
+		for (size_t offset = text.find("\r\n"); offset != std::string::npos; offset = text.find("\r\n", offset + 2))
+		{
+			count++;
+		}
+
+		return count;
+	}
+}
+
+TEST(MappedLogFileTests, CloseTrimsTheSegmentToTheWrittenData)
+{
+	TestDirectory directory;
+	const std::filesystem::path path = directory.GetPath() / "SC4GraphicsOptions.log";
+
+	{
+		MappedLogFile file;
+
+		ASSERT_TRUE(file.Open(path, kSegmentSize, 1));
+		file.WriteLine("Info: ", "first");
+		file.WriteLine("", "second");
+	}
+
+	EXPECT_EQ(directory.ReadFile(path), "Info: first\r\nsecond\r\n");
+}
+
+TEST(MappedLogFileTests, RotatesAtTheSizeLimit)
+{
+	TestDirectory directory;
+	const std::filesystem::path path = directory.GetPath() / "SC4GraphicsOptions.log";
+
+	// 100 bytes per line, so a 64 KiB segment holds 655 whole lines.
+	const std::string text(98, 'x');
+	const size_t linesPerSegment = kSegmentSize / 100;
+	const size_t lineCount = (linesPerSegment * 2) + 10;
+
+	{
+		MappedLogFile file;
+
+		ASSERT_TRUE(file.Open(path, kSegmentSize, 2));
+
+		for (size_t i = 0; i < lineCount; i++)
+		{
+			file.WriteLine("", text);
+		}
+	}
+
+	const std::string current = directory.ReadFile(path);
+	const std::string previous = directory.ReadFile(directory.GetPath() / "SC4GraphicsOptions.1.log");
+	const std::string oldest = directory.ReadFile(directory.GetPath() / "SC4GraphicsOptions.2.log");
+
+	// Each full segment is trimmed to its whole lines, a line is never split.
+	EXPECT_EQ(oldest.size(), linesPerSegment * 100);
+	EXPECT_EQ(previous.size(), linesPerSegment * 100);
+	EXPECT_EQ(current.size(), 10 * 100);
+	EXPECT_EQ(CountLines(oldest) + CountLines(previous) + CountLines(current), lineCount);
+	EXPECT_EQ(oldest.find('\0'), std::string::npos);
+	EXPECT_EQ(previous.find('\0'), std::string::npos);
+}
+
+TEST(MappedLogFileTests, RotationKeepsTheConfiguredHistoryCount)
+{
+	TestDirectory directory;
+	const std::filesystem::path path = directory.GetPath() / "SC4GraphicsOptions.log";
+
+	for (int session = 0; session < 4; session++)
+	{
+		MappedLogFile file;
+
+		ASSERT_TRUE(file.Open(path, kSegmentSize, 2));
+		file.WriteLine("Session ", std::to_string(session));
+	}
+
+	EXPECT_EQ(directory.ReadFile(path), "Session 3\r\n");
+	EXPECT_EQ(directory.ReadFile(directory.GetPath() / "SC4GraphicsOptions.1.log"), "Session 2\r\n");
+	EXPECT_EQ(directory.ReadFile(directory.GetPath() / "SC4GraphicsOptions.2.log"), "Session 1\r\n");
+	EXPECT_FALSE(std::filesystem::exists(directory.GetPath() / "SC4GraphicsOptions.3.log"));
+}
+
+TEST(MappedLogFileTests, LinesLargerThanASegmentAreTruncated)
+{
+	TestDirectory directory;
+	const std::filesystem::path path = directory.GetPath() / "SC4GraphicsOptions.log";
+
+	{
+		MappedLogFile file;
+
+		ASSERT_TRUE(file.Open(path, kSegmentSize, 0));
+		file.WriteLine("Prefix: ", std::string(kSegmentSize * 2, 'y'));
+	}
+
+	const std::string contents = directory.ReadFile(path);
+
+	EXPECT_EQ(contents.size(), kSegmentSize);
+	EXPECT_TRUE(contents.starts_with("Prefix: yyy"));
+	EXPECT_TRUE(contents.ends_with("y\r\n"));
+}
+
+TEST(MappedLogFileTests, RecoversASegmentThatWasNotClosed)
+{
+	TestDirectory directory;
+
+	// A crashed session leaves the preallocated segment with its unused space filled with zeros.
+	std::string crashed = "Info: Started\r\nError: Something failed\r\n";
+	crashed.append(kSegmentSize - crashed.size(), '\0');
+
+	const std::filesystem::path path = directory.WriteFile("SC4GraphicsOptions.log", crashed);
+
+	{
+		MappedLogFile file;
+
+		ASSERT_TRUE(file.Open(path, kSegmentSize, 1));
+		file.WriteLine("", "Next session");
+	}
+
+	EXPECT_EQ(
+		directory.ReadFile(directory.GetPath() / "SC4GraphicsOptions.1.log"),
+		"Info: Started\r\nError: Something failed\r\n\r\n[The log was not closed, the game may have crashed.]\r\n");
+	EXPECT_EQ(directory.ReadFile(path), "Next session\r\n");
+}
+
+TEST(MappedLogFileTests, RecoversASegmentThatOnlyContainsZeros)
+{
+	TestDirectory directory;
+
+	const std::filesystem::path path = directory.WriteFile("SC4GraphicsOptions.log", std::string(kSegmentSize * 2, '\0'));
+
+	{
+		MappedLogFile file;
+
+		ASSERT_TRUE(file.Open(path, kSegmentSize, 1));
+	}
+
+	EXPECT_EQ(
+		directory.ReadFile(directory.GetPath() / "SC4GraphicsOptions.1.log"),
+		"\r\n[The log was not closed, the game may have crashed.]\r\n");
+	EXPECT_EQ(directory.ReadFile(path), "");
+}
@@ -0,0 +1,309 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "MemoryPatchTransaction.h"
+#include "Platform.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+	constexpr size_t kFakePageSize = 64;
+	constexpr size_t kFakePageCount = 8;
+	constexpr uint32_t kReadExecute = 0x20;
+	constexpr uint32_t kReadOnly = 0x02;
+	constexpr uint32_t kReadWriteExecute = 0x40;
+
+	// Patches a buffer, and records the protection that each of the buffer's pages would have.
+	class FakeMemoryPatchTarget final : public IMemoryPatchTarget
+	{
+	public:
+
+		FakeMemoryPatchTarget()
+			: memory(),
+			  pageProtections(),
+			  makeWritableCalls(),
+			  restoreCalls(),
+			  failMakeWritableCall(SIZE_MAX)
+		{
+			memory.fill(0x90);
+			pageProtections.fill(kReadExecute);
+		}
+
+		uintptr_t GetAddress(size_t offset) const
+		{
+			return reinterpret_cast<uintptr_t>(memory.data()) + offset;
+		}
+
+		size_t GetPageSize() const override
+		{
+			return kFakePageSize;
+		}
+
+		bool QueryProtection(uintptr_t address, uint32_t& protection, uintptr_t& regionEnd) const override
+		{
+			size_t page = GetPageIndex(address);
+
+			if (page >= kFakePageCount)
+			{
+				return false;
+			}
+
+			protection = pageProtections[page];
+
+			while (page < kFakePageCount && pageProtections[page] == protection)
+			{
+				page++;
+			}
+
+			regionEnd = GetAddress(page * kFakePageSize);
+			return true;
+		}
+
+		bool MakeWritable(const MemoryPageRange& range, uint32_t& oldProtection) override
+		{
+			if (makeWritableCalls.size() == failMakeWritableCall)
+			{
+				return false;
+			}
+
+			makeWritableCalls.push_back(range);
+
+			// Like VirtualProtect, this reports the protection of the first page.
+			oldProtection = pageProtections[GetPageIndex(range.address)];
+			SetProtection(range, kReadWriteExecute);
+			return true;
+		}
+
+		bool RestoreProtection(const MemoryPageRange& range, uint32_t oldProtection) override
+		{
+			restoreCalls.push_back(MemoryPageRange{ range.address, range.size, oldProtection });
+			SetProtection(range, oldProtection);
+			return true;
+		}
+
+		void FlushInstructionCache(const MemoryPageRange& range) override
+		{
+			static_cast<void>(range);
+		}
+
+		alignas(kFakePageSize) std::array<uint8_t, kFakePageSize * kFakePageCount> memory;
+		std::array<uint32_t, kFakePageCount> pageProtections;
+		std::vector<MemoryPageRange> makeWritableCalls;
+		std::vector<MemoryPageRange> restoreCalls;
+		size_t failMakeWritableCall;
+
+	private:
+
+		size_t GetPageIndex(uintptr_t address) const
+		{
+			return static_cast<size_t>(address - GetAddress(0)) / kFakePageSize;
+		}
+
+		void SetProtection(const MemoryPageRange& range, uint32_t protection)
+		{
+			for (size_t i = 0; i < range.size / kFakePageSize; i++)
+			{
+				pageProtections[GetPageIndex(range.address) + i] = protection;
+			}
+		}
+	};
+}
+
+TEST(MemoryPatchTransactionTests, MergesAdjacentPagesWithTheSameProtection)
+{
+	FakeMemoryPatchTarget target;
+	MemoryPatchTransaction transaction;
+
+	transaction.Add("first", target.GetAddress(10), "90", "20");
+	transaction.Add("second", target.GetAddress(kFakePageSize + 10), "90", "20");
+	transaction.Add("third", target.GetAddress((4 * kFakePageSize) + 10), "90", "20");
+
+	std::vector<MemoryPageRange> pageRanges;
+
+	ASSERT_TRUE(transaction.PlanPageRanges(target, pageRanges));
+	ASSERT_EQ(pageRanges.size(), 2U);
+	EXPECT_EQ(pageRanges[0].address, target.GetAddress(0));
+	EXPECT_EQ(pageRanges[0].size, 2 * kFakePageSize);
+	EXPECT_EQ(pageRanges[0].protection, kReadExecute);
+	EXPECT_EQ(pageRanges[1].address, target.GetAddress(4 * kFakePageSize));
+	EXPECT_EQ(pageRanges[1].size, kFakePageSize);
+}
+
+TEST(MemoryPatchTransactionTests, KeepsAdjacentPagesWithDifferentProtectionsSeparate)
+{
+	FakeMemoryPatchTarget target;
+	target.pageProtections[1] = kReadOnly;
+
+	MemoryPatchTransaction transaction;
+	transaction.Add("first", target.GetAddress(10), "90", "20");
+	transaction.Add("second", target.GetAddress(kFakePageSize + 10), "90", "20");
+	transaction.Add("third", target.GetAddress((2 * kFakePageSize) + 10), "90", "20");
+
+	std::vector<MemoryPageRange> pageRanges;
+
+	ASSERT_TRUE(transaction.PlanPageRanges(target, pageRanges));
+	ASSERT_EQ(pageRanges.size(), 3U);
+	EXPECT_EQ(pageRanges[0].protection, kReadExecute);
+	EXPECT_EQ(pageRanges[1].protection, kReadOnly);
+	EXPECT_EQ(pageRanges[2].protection, kReadExecute);
+
+	const MemoryPatchResult result = transaction.Commit(target);
+
+	ASSERT_EQ(result.status, MemoryPatchStatus::Succeeded);
+	EXPECT_EQ(result.appliedCount, 3U);
+	EXPECT_EQ(result.pageRangeCount, 3U);
+
+	// Every page has its original protection after the commit.
+	EXPECT_EQ(target.pageProtections[0], kReadExecute);
+	EXPECT_EQ(target.pageProtections[1], kReadOnly);
+	EXPECT_EQ(target.pageProtections[2], kReadExecute);
+	EXPECT_EQ(target.memory[kFakePageSize + 10], 0x20);
+}
+
+TEST(MemoryPatchTransactionTests, SplitsAPatchThatSpansPagesWithDifferentProtections)
+{
+	FakeMemoryPatchTarget target;
+	target.pageProtections[3] = kReadOnly;
+
+	MemoryPatchTransaction transaction;
+	transaction.Add("spanning", target.GetAddress((3 * kFakePageSize) - 2), "90 90 90 90", "01 02 03 04");
+
+	const MemoryPatchResult result = transaction.Commit(target);
+
+	ASSERT_EQ(result.status, MemoryPatchStatus::Succeeded);
+	ASSERT_EQ(target.makeWritableCalls.size(), 2U);
+	EXPECT_EQ(target.makeWritableCalls[0].address, target.GetAddress(2 * kFakePageSize));
+	EXPECT_EQ(target.makeWritableCalls[1].address, target.GetAddress(3 * kFakePageSize));
+
+	ASSERT_EQ(target.restoreCalls.size(), 2U);
+	EXPECT_EQ(target.restoreCalls[0].protection, kReadExecute);
+	EXPECT_EQ(target.restoreCalls[1].protection, kReadOnly);
+	EXPECT_EQ(target.pageProtections[2], kReadExecute);
+	EXPECT_EQ(target.pageProtections[3], kReadOnly);
+}
+
+TEST(MemoryPatchTransactionTests, RestoresTheProtectionWhenMakeWritableFails)
+{
+	FakeMemoryPatchTarget target;
+	target.pageProtections[2] = kReadOnly;
+	target.failMakeWritableCall = 1;
+
+	MemoryPatchTransaction transaction;
+	transaction.Add("first", target.GetAddress(10), "90", "20");
+	transaction.Add("second", target.GetAddress((2 * kFakePageSize) + 10), "90", "20");
+
+	const MemoryPatchResult result = transaction.Commit(target);
+
+	EXPECT_EQ(result.status, MemoryPatchStatus::ProtectionFailed);
+	ASSERT_EQ(target.restoreCalls.size(), 1U);
+	EXPECT_EQ(target.restoreCalls[0].protection, kReadExecute);
+	EXPECT_EQ(target.pageProtections[0], kReadExecute);
+	EXPECT_EQ(target.memory[10], 0x90);
+}
+
+TEST(MemoryPatchTransactionTests, FailsWhenTheProtectionCannotBeQueried)
+{
+	FakeMemoryPatchTarget target;
+	MemoryPatchTransaction transaction;
+
+	transaction.Add("outside", target.GetAddress(0) + (kFakePageCount * kFakePageSize) + kFakePageSize, "90", "20");
+
+	std::vector<MemoryPageRange> pageRanges;
+
+	EXPECT_FALSE(transaction.PlanPageRanges(target, pageRanges));
+}
+
+TEST(MemoryPatchTransactionTests, VerifiesThePatchesBeforeWriting)
+{
+	FakeMemoryPatchTarget target;
+	target.memory[kFakePageSize] = 0x20;
+
+	MemoryPatchTransaction transaction;
+	transaction.Add("applied", target.GetAddress(kFakePageSize), "90", "20");
+	transaction.Add("mismatch", target.GetAddress(2 * kFakePageSize), "6A", "20");
+	transaction.Add("valid", target.GetAddress(10), "90", "20");
+
+	MemoryPatchResult result = transaction.Commit(target);
+
+	EXPECT_EQ(result.status, MemoryPatchStatus::VerificationFailed);
+	EXPECT_EQ(result.failedPatchName, "mismatch");
+	EXPECT_TRUE(target.makeWritableCalls.empty());
+	EXPECT_EQ(target.memory[10], 0x90);
+
+	transaction.Add("first", target.GetAddress(10), "90 90", "01 02");
+	transaction.Add("overlapping", target.GetAddress(11), "90", "03");
+
+	result = transaction.Commit(target);
+
+	EXPECT_EQ(result.status, MemoryPatchStatus::OverlappingPatches);
+	EXPECT_EQ(result.failedPatchName, "overlapping");
+
+	transaction.Add("applied", target.GetAddress(kFakePageSize), "90", "20");
+	transaction.Add("valid", target.GetAddress(10), "90", "20");
+
+	result = transaction.Commit(target);
+
+	EXPECT_EQ(result.status, MemoryPatchStatus::Succeeded);
+	EXPECT_EQ(result.appliedCount, 1U);
+	EXPECT_EQ(result.alreadyAppliedCount, 1U);
+	EXPECT_EQ(result.pageRangeCount, 1U);
+}
+
+TEST(MemoryPatchTransactionTests, KeepsTheProtectionOfProcessPages)
+{
+	const size_t pageSize = Platform::GetMemoryPageSize();
+	void* mapping = mmap(nullptr, pageSize * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	ASSERT_NE(mapping, MAP_FAILED);
+
+	const uintptr_t base = reinterpret_cast<uintptr_t>(mapping);
+	std::memset(mapping, 0x90, pageSize * 2);
+	ASSERT_EQ(mprotect(mapping, pageSize, PROT_READ), 0);
+
+	MemoryPatchTransaction transaction;
+	transaction.Add("spanning", base + pageSize - 1, "90 90", "01 02");
+
+	ProcessMemoryPatchTarget target;
+	const MemoryPatchResult result = transaction.Commit(target);
+
+	EXPECT_EQ(result.status, MemoryPatchStatus::Succeeded);
+	EXPECT_EQ(result.pageRangeCount, 2U);
+
+	uint32_t protection = 0;
+	uintptr_t regionEnd = 0;
+
+	ASSERT_TRUE(Platform::QueryMemoryProtection(base, protection, regionEnd));
+	EXPECT_EQ(protection, static_cast<uint32_t>(PROT_READ));
+	EXPECT_EQ(regionEnd, base + pageSize);
+
+	ASSERT_TRUE(Platform::QueryMemoryProtection(base + pageSize, protection, regionEnd));
+	EXPECT_EQ(protection, static_cast<uint32_t>(PROT_READ | PROT_WRITE));
+
+	EXPECT_EQ(static_cast<const uint8_t*>(mapping)[pageSize - 1], 0x01);
+	EXPECT_EQ(static_cast<const uint8_t*>(mapping)[pageSize], 0x02);
+
+	munmap(mapping, pageSize * 2);
+}
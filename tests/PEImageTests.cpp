@@ -0,0 +1,271 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "PEImage.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	// The layout of the synthetic 32-bit image that the tests use.
+	constexpr size_t kImageSize = 0x3000;
+	constexpr size_t kNtHeadersOffset = 0x80;
+	constexpr size_t kFileHeaderOffset = kNtHeadersOffset + 4;
+	constexpr size_t kOptionalHeaderOffset = kFileHeaderOffset + 20;
+	constexpr size_t kOptionalHeaderSize = 224;
+	constexpr size_t kSectionTableOffset = kOptionalHeaderOffset + kOptionalHeaderSize;
+	constexpr size_t kSectionHeaderSize = 40;
+	constexpr size_t kHeadersEnd = kSectionTableOffset + (2 * kSectionHeaderSize);
+	constexpr size_t kResourceDirectoryOffset = 0x2000;
+	constexpr size_t kVersionResourceOffset = 0x2100;
+
+	constexpr uint16_t kLargeAddressAware = 0x0020;
+
+	template <typename T>
+	void Write(std::vector<uint8_t>& image, size_t offset, T value)
+	{
+		std::memcpy(image.data() + offset, &value, sizeof(value));
+	}
+
+	void WriteSectionHeader(std::vector<uint8_t>& image, size_t index, const char* name, uint32_t rva, uint32_t virtualSize)
+	{
+		const size_t offset = kSectionTableOffset + (index * kSectionHeaderSize);
+
+		std::memcpy(image.data() + offset, name, std::strlen(name));
+		Write<uint32_t>(image, offset + 8, virtualSize);
+		Write<uint32_t>(image, offset + 12, rva);
+	}
+
+	// A resource directory with a single entry, which points to the next level.
+	void WriteResourceDirectory(std::vector<uint8_t>& image, size_t offset, uint32_t id, uint32_t entryValue)
+	{
+		Write<uint16_t>(image, offset + 14, 1);
+		Write<uint32_t>(image, offset + 16, id);
+		Write<uint32_t>(image, offset + 20, entryValue);
+	}
+
+	// Builds a mapped 32-bit image with a .text section and a .rsrc section that contains
+	// the version resource of SimCity 4 version 1.1.641.0.
+	std::vector<uint8_t> CreateImage()
+	{
+		std::vector<uint8_t> image(kImageSize);
+
+		Write<uint16_t>(image, 0, 0x5A4D);
+		Write<uint32_t>(image, 0x3C, kNtHeadersOffset);
+		Write<uint32_t>(image, kNtHeadersOffset, 0x00004550);
+
+		Write<uint16_t>(image, kFileHeaderOffset, 0x014C);
+		Write<uint16_t>(image, kFileHeaderOffset + 2, 2);
+		Write<uint32_t>(image, kFileHeaderOffset + 4, 0x4123ABCD);
+		Write<uint16_t>(image, kFileHeaderOffset + 16, kOptionalHeaderSize);
+		Write<uint16_t>(image, kFileHeaderOffset + 18, 0x0102 | kLargeAddressAware);
+
+		Write<uint16_t>(image, kOptionalHeaderOffset, 0x010B);
+		Write<uint32_t>(image, kOptionalHeaderOffset + 28, 0x00400000);
+		Write<uint32_t>(image, kOptionalHeaderOffset + 56, kImageSize);
+		Write<uint32_t>(image, kOptionalHeaderOffset + 92, 16);
+		// The resource data directory.
+		Write<uint32_t>(image, kOptionalHeaderOffset + 96 + 16, kResourceDirectoryOffset);
+		Write<uint32_t>(image, kOptionalHeaderOffset + 96 + 20, 0x200);
+
+		WriteSectionHeader(image, 0, ".text", 0x1000, 0x1000);
+		WriteSectionHeader(image, 1, ".rsrc", 0x2000, 0x1000);
+
+		// RT_VERSION (16) -> name 1 -> language 0x409 -> data entry.
+		WriteResourceDirectory(image, kResourceDirectoryOffset, 16, 0x80000018);
+		WriteResourceDirectory(image, kResourceDirectoryOffset + 0x18, 1, 0x80000030);
+		WriteResourceDirectory(image, kResourceDirectoryOffset + 0x30, 0x409, 0x48);
+		Write<uint32_t>(image, kResourceDirectoryOffset + 0x48, kVersionResourceOffset);
+		Write<uint32_t>(image, kResourceDirectoryOffset + 0x4C, 92);
+
+		// VS_VERSIONINFO followed by VS_FIXEDFILEINFO.
+		constexpr char16_t kVersionInfoKey[] = u"VS_VERSION_INFO";
+
+		Write<uint16_t>(image, kVersionResourceOffset, 92);
+		Write<uint16_t>(image, kVersionResourceOffset + 2, 52);
+		std::memcpy(image.data() + kVersionResourceOffset + 6, kVersionInfoKey, sizeof(kVersionInfoKey));
+		Write<uint32_t>(image, kVersionResourceOffset + 40, 0xFEEF04BD);
+		Write<uint32_t>(image, kVersionResourceOffset + 48, 0x00010001);
+		Write<uint32_t>(image, kVersionResourceOffset + 52, 0x02810000);
+
+		return image;
+	}
+}
+
+TEST(PEImageTests, LoadsASyntheticImage)
+{
+	const std::vector<uint8_t> image = CreateImage();
+	PEImage pe;
+
+	ASSERT_TRUE(pe.Load(image.data(), image.size()));
+
+	EXPECT_FALSE(pe.Is64Bit());
+	EXPECT_TRUE(pe.IsLargeAddressAware());
+	EXPECT_EQ(pe.GetImageBase(), 0x00400000U);
+	EXPECT_EQ(pe.GetSizeOfImage(), kImageSize);
+	EXPECT_EQ(pe.GetTimeDateStamp(), 0x4123ABCDU);
+
+	ASSERT_EQ(pe.GetSections().size(), 2U);
+
+	const PESection* text = pe.FindSection(".text");
+
+	ASSERT_NE(text, nullptr);
+	EXPECT_EQ(text->virtualAddress, 0x1000U);
+	EXPECT_EQ(text->virtualSize, 0x1000U);
+	EXPECT_EQ(pe.GetDataAtRva(text->virtualAddress, text->virtualSize), image.data() + 0x1000);
+	EXPECT_EQ(pe.FindSection(".data"), nullptr);
+
+	uint64_t version = 0;
+
+	ASSERT_TRUE(pe.GetFileVersion(version));
+	EXPECT_EQ(version, 0x0001000102810000U);
+}
+
+TEST(PEImageTests, RejectsTruncatedHeaders)
+{
+	const std::vector<uint8_t> image = CreateImage();
+
+	// Every length that cuts off the DOS header, the NT headers or the section table.
+	for (size_t length = 0; length < kHeadersEnd; length++)
+	{
+		PEImage pe;
+
+		EXPECT_FALSE(pe.Load(image.data(), length)) << length;
+	}
+
+	PEImage pe;
+
+	EXPECT_TRUE(pe.Load(image.data(), kHeadersEnd));
+
+	// The resource data is outside of the readable range.
+	uint64_t version = 0;
+
+	EXPECT_FALSE(pe.GetFileVersion(version));
+}
+
+TEST(PEImageTests, RejectsInvalidHeaderValues)
+{
+	PEImage pe;
+
+	std::vector<uint8_t> image = CreateImage();
+	Write<uint16_t>(image, 0, 0x4D5A);
+	EXPECT_FALSE(pe.Load(image.data(), image.size()));
+
+	image = CreateImage();
+	Write<uint32_t>(image, 0x3C, 0xFFFFFFF0);
+	EXPECT_FALSE(pe.Load(image.data(), image.size()));
+
+	image = CreateImage();
+	Write<uint32_t>(image, kNtHeadersOffset, 0x00004E45);
+	EXPECT_FALSE(pe.Load(image.data(), image.size()));
+
+	image = CreateImage();
+	Write<uint16_t>(image, kOptionalHeaderOffset, 0x0107);
+	EXPECT_FALSE(pe.Load(image.data(), image.size()));
+
+	// The optional header is too small for its magic value.
+	image = CreateImage();
+	Write<uint16_t>(image, kFileHeaderOffset + 16, 64);
+	EXPECT_FALSE(pe.Load(image.data(), image.size()));
+
+	image = CreateImage();
+	Write<uint16_t>(image, kFileHeaderOffset + 16, 0xFFFF);
+	EXPECT_FALSE(pe.Load(image.data(), image.size()));
+
+	EXPECT_FALSE(pe.Load(nullptr, 0));
+}
+
+TEST(PEImageTests, RejectsAHugeNumberOfSections)
+{
+	std::vector<uint8_t> image = CreateImage();
+	Write<uint16_t>(image, kFileHeaderOffset + 2, 0xFFFF);
+
+	PEImage pe;
+
+	EXPECT_FALSE(pe.Load(image.data(), image.size()));
+	EXPECT_TRUE(pe.GetSections().empty());
+
+	// The section table fits when the image is large enough.
+	image.resize(kSectionTableOffset + (0xFFFF * kSectionHeaderSize));
+
+	ASSERT_TRUE(pe.Load(image.data(), image.size()));
+	EXPECT_EQ(pe.GetSections().size(), 0xFFFFU);
+}
+
+TEST(PEImageTests, SectionsPastTheEndOfTheImageAreNotReadable)
+{
+	std::vector<uint8_t> image = CreateImage();
+	WriteSectionHeader(image, 0, ".text", 0x1000, 0x00100000);
+	WriteSectionHeader(image, 1, ".rsrc", 0xFFFFF000, 0x2000);
+
+	PEImage pe;
+
+	ASSERT_TRUE(pe.Load(image.data(), image.size()));
+
+	const PESection* text = pe.FindSection(".text");
+	const PESection* resources = pe.FindSection(".rsrc");
+
+	ASSERT_NE(text, nullptr);
+	ASSERT_NE(resources, nullptr);
+
+	EXPECT_EQ(pe.GetDataAtRva(text->virtualAddress, text->virtualSize), nullptr);
+	EXPECT_EQ(pe.GetDataAtRva(resources->virtualAddress, resources->virtualSize), nullptr);
+	EXPECT_EQ(pe.GetDataAtRva(0xFFFFFFFF, 2), nullptr);
+	EXPECT_NE(pe.GetDataAtRva(kImageSize - 1, 1), nullptr);
+	EXPECT_EQ(pe.GetDataAtRva(kImageSize - 1, 2), nullptr);
+}
+
+TEST(PEImageTests, RejectsCorruptVersionResources)
+{
+	PEImage pe;
+	uint64_t version = 0;
+
+	// The resource data entry points outside of the image.
+	std::vector<uint8_t> image = CreateImage();
+	Write<uint32_t>(image, kResourceDirectoryOffset + 0x48, 0x0002FFF0);
+	ASSERT_TRUE(pe.Load(image.data(), image.size()));
+	EXPECT_FALSE(pe.GetFileVersion(version));
+
+	// The root directory claims more entries than the image holds.
+	image = CreateImage();
+	Write<uint16_t>(image, kResourceDirectoryOffset + 14, 0xFFFF);
+	ASSERT_TRUE(pe.Load(image.data(), image.size()));
+	EXPECT_FALSE(pe.GetFileVersion(version));
+
+	// The type directory entry points back to the root directory.
+	image = CreateImage();
+	Write<uint32_t>(image, kResourceDirectoryOffset + 0x18 + 20, 0x80000000);
+	ASSERT_TRUE(pe.Load(image.data(), image.size()));
+	EXPECT_FALSE(pe.GetFileVersion(version));
+
+	// The VS_FIXEDFILEINFO signature is wrong.
+	image = CreateImage();
+	Write<uint32_t>(image, kVersionResourceOffset + 40, 0);
+	ASSERT_TRUE(pe.Load(image.data(), image.size()));
+	EXPECT_FALSE(pe.GetFileVersion(version));
+
+	// The resource data directory is outside of the image.
+	image = CreateImage();
+	Write<uint32_t>(image, kOptionalHeaderOffset + 96 + 16, 0xFFFFFF00);
+	ASSERT_TRUE(pe.Load(image.data(), image.size()));
+	EXPECT_FALSE(pe.GetFileVersion(version));
+}
@@ -0,0 +1,329 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "ProcessSchedulingPolicy.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t kCoarsestTimerResolution = 156250;
+	constexpr uint32_t kFinestTimerResolution = 5000;
+	constexpr uint32_t kPreviousPriorityClass = 0x20;
+
+	// Records the calls that the policy makes, the OS functions succeed unless a test disables them.
+	class FakeProcessSchedulingControls final : public IProcessSchedulingControls
+	{
+	public:
+
+		FakeProcessSchedulingControls()
+			: calls(),
+			  queryTimerResolutionSucceeds(true),
+			  setTimerResolutionSucceeds(true),
+			  disableAllPowerThrottlingSucceeds(true),
+			  disableExecutionSpeedThrottlingSucceeds(true),
+			  setPriorityClassSucceeds(true)
+		{
+		}
+
+		bool QueryTimerResolution(uint32_t& coarsest, uint32_t& finest) override
+		{
+			calls.push_back("QueryTimerResolution");
+
+			coarsest = kCoarsestTimerResolution;
+			finest = kFinestTimerResolution;
+			return queryTimerResolutionSucceeds;
+		}
+
+		bool SetTimerResolution(uint32_t resolution, uint32_t& actualResolution) override
+		{
+			calls.push_back("SetTimerResolution " + std::to_string(resolution));
+
+			// The system rounds the resolution to a multiple of its clock interval.
+			actualResolution = resolution + 4;
+			return setTimerResolutionSucceeds;
+		}
+
+		bool ResetTimerResolution(uint32_t resolution) override
+		{
+			calls.push_back("ResetTimerResolution " + std::to_string(resolution));
+			return true;
+		}
+
+		bool DisablePowerThrottling(bool includeTimerResolution) override
+		{
+			calls.push_back(includeTimerResolution ? "DisablePowerThrottling true" : "DisablePowerThrottling false");
+
+			return includeTimerResolution ? disableAllPowerThrottlingSucceeds : disableExecutionSpeedThrottlingSucceeds;
+		}
+
+		bool RestorePowerThrottling() override
+		{
+			calls.push_back("RestorePowerThrottling");
+			return true;
+		}
+
+		bool SetPriorityClass(ProcessPriorityClass priorityClass, uint32_t& previousPriorityClass) override
+		{
+			calls.push_back(std::string("SetPriorityClass ") + GetProcessPriorityClassName(priorityClass));
+
+			previousPriorityClass = kPreviousPriorityClass;
+			return setPriorityClassSucceeds;
+		}
+
+		bool RestorePriorityClass(uint32_t previousPriorityClass) override
+		{
+			calls.push_back("RestorePriorityClass " + std::to_string(previousPriorityClass));
+			return true;
+		}
+
+		std::vector<std::string> calls;
+		bool queryTimerResolutionSucceeds;
+		bool setTimerResolutionSucceeds;
+		bool disableAllPowerThrottlingSucceeds;
+		bool disableExecutionSpeedThrottlingSucceeds;
+		bool setPriorityClassSucceeds;
+	};
+
+	ProcessSchedulingOptions TimerResolutionOptions(uint32_t microseconds)
+	{
+		return ProcessSchedulingOptions{ microseconds, false, ProcessPriorityClass::Default };
+	}
+
+	const ProcessSchedulingOptions kAllOptions{ 1000, true, ProcessPriorityClass::High };
+}
+
+TEST(ProcessSchedulingPolicyTests, UsesTheRequestedTimerResolutionWhenItIsSupported)
+{
+	FakeProcessSchedulingControls controls;
+	ProcessSchedulingPolicy policy(controls);
+
+	const ProcessSchedulingState& state = policy.Apply(TimerResolutionOptions(1000));
+
+	EXPECT_EQ(state.timerResolution, 10000u);
+	EXPECT_EQ(state.actualTimerResolution, 10004u);
+	EXPECT_FALSE(state.timerResolutionFailed);
+	EXPECT_EQ(FormatProcessSchedulingState(state), "timer resolution 1.0000 ms (system 1.0004 ms)");
+}
+
+TEST(ProcessSchedulingPolicyTests, ClampsTheTimerResolutionToTheFinestSupportedValue)
+{
+	FakeProcessSchedulingControls controls;
+	ProcessSchedulingPolicy policy(controls);
+
+	const ProcessSchedulingState& state = policy.Apply(TimerResolutionOptions(1));
+
+	EXPECT_EQ(state.timerResolution, kFinestTimerResolution);
+	EXPECT_EQ(controls.calls, (std::vector<std::string>{ "QueryTimerResolution", "SetTimerResolution 5000" }));
+}
+
+TEST(ProcessSchedulingPolicyTests, ClampsTheTimerResolutionToTheCoarsestSupportedValue)
+{
+	FakeProcessSchedulingControls controls;
+	ProcessSchedulingPolicy policy(controls);
+
+	const ProcessSchedulingState& state = policy.Apply(TimerResolutionOptions(100000));
+
+	EXPECT_EQ(state.timerResolution, kCoarsestTimerResolution);
+	EXPECT_EQ(controls.calls, (std::vector<std::string>{ "QueryTimerResolution", "SetTimerResolution 156250" }));
+}
+
+TEST(ProcessSchedulingPolicyTests, UsesTheRequestedTimerResolutionWhenTheRangeIsUnavailable)
+{
+	FakeProcessSchedulingControls controls;
+	controls.queryTimerResolutionSucceeds = false;
+	ProcessSchedulingPolicy policy(controls);
+
+	const ProcessSchedulingState& state = policy.Apply(TimerResolutionOptions(1));
+
+	EXPECT_EQ(state.timerResolution, 10u);
+}
+
+TEST(ProcessSchedulingPolicyTests, RecordsATimerResolutionFailure)
+{
+	FakeProcessSchedulingControls controls;
+	controls.setTimerResolutionSucceeds = false;
+	ProcessSchedulingPolicy policy(controls);
+
+	const ProcessSchedulingState& state = policy.Apply(TimerResolutionOptions(1000));
+
+	EXPECT_EQ(state.timerResolution, 0u);
+	EXPECT_TRUE(state.timerResolutionFailed);
+	EXPECT_EQ(FormatProcessSchedulingState(state), "timer resolution change failed");
+
+	policy.Restore();
+
+	EXPECT_EQ(controls.calls.back(), "SetTimerResolution 10000");
+}
+
+TEST(ProcessSchedulingPolicyTests, DisablesAllPowerThrottling)
+{
+	FakeProcessSchedulingControls controls;
+	ProcessSchedulingPolicy policy(controls);
+
+	const ProcessSchedulingState& state = policy.Apply(ProcessSchedulingOptions{ 0, true, ProcessPriorityClass::Default });
+
+	EXPECT_TRUE(state.powerThrottlingDisabled);
+	EXPECT_TRUE(state.timerResolutionThrottlingDisabled);
+	EXPECT_EQ(controls.calls, (std::vector<std::string>{ "DisablePowerThrottling true" }));
+	EXPECT_EQ(FormatProcessSchedulingState(state), "power throttling disabled");
+}
+
+TEST(ProcessSchedulingPolicyTests, FallsBackToDisablingOnlyExecutionSpeedThrottling)
+{
+	FakeProcessSchedulingControls controls;
+	controls.disableAllPowerThrottlingSucceeds = false;
+	ProcessSchedulingPolicy policy(controls);
+
+	const ProcessSchedulingState& state = policy.Apply(ProcessSchedulingOptions{ 0, true, ProcessPriorityClass::Default });
+
+	EXPECT_TRUE(state.powerThrottlingDisabled);
+	EXPECT_FALSE(state.timerResolutionThrottlingDisabled);
+	EXPECT_FALSE(state.powerThrottlingFailed);
+	EXPECT_EQ(
+		controls.calls,
+		(std::vector<std::string>{ "DisablePowerThrottling true", "DisablePowerThrottling false" }));
+	EXPECT_EQ(FormatProcessSchedulingState(state), "power throttling disabled (execution speed only)");
+
+	policy.Restore();
+
+	EXPECT_EQ(controls.calls.back(), "RestorePowerThrottling");
+}
+
+TEST(ProcessSchedulingPolicyTests, RecordsAPowerThrottlingFailure)
+{
+	FakeProcessSchedulingControls controls;
+	controls.disableAllPowerThrottlingSucceeds = false;
+	controls.disableExecutionSpeedThrottlingSucceeds = false;
+	ProcessSchedulingPolicy policy(controls);
+
+	const ProcessSchedulingState& state = policy.Apply(ProcessSchedulingOptions{ 0, true, ProcessPriorityClass::Default });
+
+	EXPECT_FALSE(state.powerThrottlingDisabled);
+	EXPECT_TRUE(state.powerThrottlingFailed);
+	EXPECT_EQ(FormatProcessSchedulingState(state), "power throttling opt-out failed");
+
+	const size_t callCount = controls.calls.size();
+	policy.Restore();
+
+	EXPECT_EQ(controls.calls.size(), callCount);
+}
+
+TEST(ProcessSchedulingPolicyTests, RestoresTheChangesInTheReverseOrder)
+{
+	FakeProcessSchedulingControls controls;
+	ProcessSchedulingPolicy policy(controls);
+
+	const ProcessSchedulingState& state = policy.Apply(kAllOptions);
+
+	EXPECT_EQ(
+		FormatProcessSchedulingState(state),
+		"timer resolution 1.0000 ms (system 1.0004 ms), power throttling disabled, priority class High");
+
+	controls.calls.clear();
+	policy.Restore();
+
+	EXPECT_EQ(
+		controls.calls,
+		(std::vector<std::string>
+		{
+			"RestorePriorityClass 32",
+			"RestorePowerThrottling",
+			"ResetTimerResolution 10000"
+		}));
+	EXPECT_TRUE(FormatProcessSchedulingState(policy.GetState()).empty());
+}
+
+TEST(ProcessSchedulingPolicyTests, RestoreIsIdempotent)
+{
+	FakeProcessSchedulingControls controls;
+	ProcessSchedulingPolicy policy(controls);
+
+	policy.Apply(kAllOptions);
+	policy.Restore();
+
+	const size_t callCount = controls.calls.size();
+
+	policy.Restore();
+	policy.Restore();
+
+	EXPECT_EQ(controls.calls.size(), callCount);
+}
+
+TEST(ProcessSchedulingPolicyTests, RestoreWithoutApplyDoesNothing)
+{
+	FakeProcessSchedulingControls controls;
+	ProcessSchedulingPolicy policy(controls);
+
+	policy.Restore();
+
+	EXPECT_TRUE(controls.calls.empty());
+}
+
+TEST(ProcessSchedulingPolicyTests, OnlyRestoresTheChangesThatSucceeded)
+{
+	FakeProcessSchedulingControls controls;
+	controls.setTimerResolutionSucceeds = false;
+	controls.setPriorityClassSucceeds = false;
+	ProcessSchedulingPolicy policy(controls);
+
+	policy.Apply(kAllOptions);
+	controls.calls.clear();
+	policy.Restore();
+
+	EXPECT_EQ(controls.calls, (std::vector<std::string>{ "RestorePowerThrottling" }));
+}
+
+TEST(ProcessSchedulingPolicyTests, ApplyRestoresThePreviousChangesFirst)
+{
+	FakeProcessSchedulingControls controls;
+	ProcessSchedulingPolicy policy(controls);
+
+	policy.Apply(kAllOptions);
+	controls.calls.clear();
+
+	const ProcessSchedulingState& state = policy.Apply(TimerResolutionOptions(2000));
+
+	EXPECT_EQ(
+		controls.calls,
+		(std::vector<std::string>
+		{
+			"RestorePriorityClass 32",
+			"RestorePowerThrottling",
+			"ResetTimerResolution 10000",
+			"QueryTimerResolution",
+			"SetTimerResolution 20000"
+		}));
+	EXPECT_FALSE(state.powerThrottlingDisabled);
+	EXPECT_EQ(state.priorityClass, ProcessPriorityClass::Default);
+}
+
+TEST(ProcessSchedulingPolicyTests, DefaultOptionsChangeNothing)
+{
+	FakeProcessSchedulingControls controls;
+	ProcessSchedulingPolicy policy(controls);
+
+	const ProcessSchedulingState& state = policy.Apply(ProcessSchedulingOptions{ 0, false, ProcessPriorityClass::Default });
+
+	EXPECT_TRUE(controls.calls.empty());
+	EXPECT_TRUE(FormatProcessSchedulingState(state).empty());
+}
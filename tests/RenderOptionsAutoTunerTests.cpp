@@ -0,0 +1,263 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "RenderOptionsAutoTuner.h"
+#include "TestDirectory.h"
+#include <gtest/gtest.h>
+#include <functional>
+#include <string>
+
+namespace
+{
+	constexpr uint32_t kWarmupFrames = 5;
+	constexpr uint32_t kFramesPerRound = 20;
+	constexpr uint32_t kRoundCount = 2;
+	constexpr RenderOptionsCandidate kGameOptions{ false, 0 };
+
+	const AutoTuneCacheKey kCacheKey{ "DirectX", 1920, 1080, 32, 1 };
+
+	// Records frames with the time that the function returns for the current candidate,
+	// until the search finishes. Returns the number of candidate changes.
+	uint32_t RunToCompletion(
+		RenderOptionsAutoTuner& tuner,
+		const std::function<uint64_t(const RenderOptionsCandidate&)>& getFrameTime)
+	{
+		uint32_t changeCount = 0;
+
+		for (uint32_t i = 0; i < 100000; i++)
+		{
+			const AutoTuneStep step = tuner.RecordFrame(getFrameTime(tuner.GetCurrentCandidate()));
+
+			if (step == AutoTuneStep::Finished)
+			{
+				break;
+			}
+			else if (step == AutoTuneStep::ApplyCandidate)
+			{
+				changeCount++;
+			}
+		}
+
+		return changeCount;
+	}
+
+	std::string GetCacheFileText(const AutoTuneCacheKey& key, uint32_t version, bool includeDirtyRectMergeFrames)
+	{
+		std::string text = "[AutoTune]\n";
+		text += "Version=" + std::to_string(version) + "\n";
+		text += "Driver=" + key.driver + "\n";
+		text += "Width=" + std::to_string(key.width) + "\n";
+		text += "Height=" + std::to_string(key.height) + "\n";
+		text += "ColorDepth=" + std::to_string(key.colorDepth) + "\n";
+		text += "WindowMode=" + std::to_string(key.windowMode) + "\n";
+		text += "NoPartialBackingStoreCopies=1\n";
+
+		if (includeDirtyRectMergeFrames)
+		{
+			text += "DirtyRectMergeFrames=4\n";
+		}
+
+		return text;
+	}
+}
+
+TEST(RenderOptionsAutoTunerTests, MeasuresTheGameOptionsFirstAndEachCandidateOnce)
+{
+	const RenderOptionsCandidate gameOptions{ true, 8 };
+	RenderOptionsAutoTuner tuner(gameOptions, 0, 1, 1);
+
+	std::vector<RenderOptionsCandidate> measured{ tuner.GetCurrentCandidate() };
+
+	while (tuner.RecordFrame(10000) == AutoTuneStep::ApplyCandidate)
+	{
+		measured.push_back(tuner.GetCurrentCandidate());
+	}
+
+	ASSERT_EQ(measured.size(), 8u);
+	EXPECT_EQ(measured[0], gameOptions);
+
+	for (size_t i = 0; i < measured.size(); i++)
+	{
+		for (size_t j = i + 1; j < measured.size(); j++)
+		{
+			EXPECT_NE(measured[i], measured[j]);
+		}
+	}
+}
+
+TEST(RenderOptionsAutoTunerTests, ConvergesOnTheFastestCandidate)
+{
+	constexpr RenderOptionsCandidate kFastest{ true, 4 };
+
+	RenderOptionsAutoTuner tuner(kGameOptions, kWarmupFrames, kFramesPerRound, kRoundCount);
+
+	const uint32_t changeCount = RunToCompletion(
+		tuner,
+		[&](const RenderOptionsCandidate& candidate) { return candidate == kFastest ? 12000u : 20000u; });
+
+	ASSERT_TRUE(tuner.IsFinished());
+	EXPECT_EQ(changeCount, (8 * kRoundCount) - 1);
+	EXPECT_EQ(tuner.GetBestCandidate(), kFastest);
+	EXPECT_EQ(tuner.GetCurrentCandidate(), kFastest);
+
+	const std::vector<RenderOptionsResult>& results = tuner.GetResults();
+	ASSERT_EQ(results.size(), 8u);
+
+	for (const RenderOptionsResult& result : results)
+	{
+		EXPECT_EQ(result.frameCount, kFramesPerRound * kRoundCount);
+	}
+}
+
+TEST(RenderOptionsAutoTunerTests, KeepsTheGameOptionsWithoutAClearImprovement)
+{
+	// 1% faster is within the measurement noise.
+	RenderOptionsAutoTuner tuner(kGameOptions, kWarmupFrames, kFramesPerRound, kRoundCount);
+
+	RunToCompletion(
+		tuner,
+		[](const RenderOptionsCandidate& candidate) { return candidate.dirtyRectMergeFrames == 2 ? 19800u : 20000u; });
+
+	EXPECT_EQ(tuner.GetBestCandidate(), kGameOptions);
+}
+
+TEST(RenderOptionsAutoTunerTests, BreaksAPercentileTieWithTheMedian)
+{
+	// Every fifth frame is slow, so every candidate has the same 95th percentile.
+	RenderOptionsAutoTuner tuner(kGameOptions, 0, kFramesPerRound, 1);
+	uint32_t frame = 0;
+
+	RunToCompletion(
+		tuner,
+		[&](const RenderOptionsCandidate& candidate)
+		{
+			frame++;
+
+			if ((frame % 5) == 0)
+			{
+				return 40000u;
+			}
+
+			return candidate == RenderOptionsCandidate{ false, 8 } ? 15000u : 20000u;
+		});
+
+	EXPECT_EQ(tuner.GetBestCandidate(), (RenderOptionsCandidate{ false, 8 }));
+}
+
+TEST(RenderOptionsAutoTunerTests, DoesNotMeasureWarmupOrSlowFrames)
+{
+	RenderOptionsAutoTuner tuner(kGameOptions, kWarmupFrames, kFramesPerRound, 1);
+	uint32_t framesSinceChange = 0;
+
+	for (uint32_t i = 0; i < 100000 && !tuner.IsFinished(); i++)
+	{
+		// The warm-up frames and the frames over the limit would make the game options the slowest.
+		uint64_t frameTime = tuner.GetCurrentCandidate() == kGameOptions ? 10000 : 20000;
+
+		if (framesSinceChange < kWarmupFrames)
+		{
+			frameTime = 200000;
+		}
+		else if (((framesSinceChange - kWarmupFrames) % 4) == 0)
+		{
+			frameTime = RenderOptionsAutoTuner::kMaxMeasuredFrameTime + 1;
+		}
+
+		framesSinceChange++;
+
+		if (tuner.RecordFrame(frameTime) == AutoTuneStep::ApplyCandidate)
+		{
+			framesSinceChange = 0;
+		}
+	}
+
+	ASSERT_TRUE(tuner.IsFinished());
+	EXPECT_EQ(tuner.GetBestCandidate(), kGameOptions);
+
+	for (const RenderOptionsResult& result : tuner.GetResults())
+	{
+		EXPECT_EQ(result.frameCount, kFramesPerRound);
+		EXPECT_LE(result.p95FrameTime, 20500u);
+	}
+}
+
+TEST(RenderOptionsAutoTunerTests, StaysFinished)
+{
+	RenderOptionsAutoTuner tuner(kGameOptions, 0, 1, 1);
+
+	RunToCompletion(tuner, [](const RenderOptionsCandidate&) { return 10000u; });
+
+	ASSERT_TRUE(tuner.IsFinished());
+	EXPECT_EQ(tuner.RecordFrame(10000), AutoTuneStep::Finished);
+	EXPECT_EQ(tuner.GetBestCandidate(), kGameOptions);
+}
+
+TEST(AutoTuneCacheTests, RoundTrip)
+{
+	TestDirectory directory;
+	const std::filesystem::path path = directory.GetPath() / "AutoTune.ini";
+
+	ASSERT_TRUE(SaveAutoTuneCache(path, kCacheKey, RenderOptionsCandidate{ true, 4 }));
+
+	RenderOptionsCandidate candidate{};
+	ASSERT_TRUE(LoadAutoTuneCache(path, kCacheKey, candidate));
+	EXPECT_EQ(candidate, (RenderOptionsCandidate{ true, 4 }));
+}
+
+TEST(AutoTuneCacheTests, IgnoresAFileForOtherGraphicsOptions)
+{
+	TestDirectory directory;
+	const std::filesystem::path path = directory.GetPath() / "AutoTune.ini";
+
+	ASSERT_TRUE(SaveAutoTuneCache(path, kCacheKey, RenderOptionsCandidate{ true, 4 }));
+
+	AutoTuneCacheKey keys[5] = { kCacheKey, kCacheKey, kCacheKey, kCacheKey, kCacheKey };
+	keys[0].driver = "OpenGL";
+	keys[1].width = 2560;
+	keys[2].height = 1440;
+	keys[3].colorDepth = 16;
+	keys[4].windowMode = 2;
+
+	for (const AutoTuneCacheKey& key : keys)
+	{
+		RenderOptionsCandidate candidate{ false, 0 };
+
+		EXPECT_FALSE(LoadAutoTuneCache(path, key, candidate));
+		EXPECT_EQ(candidate, (RenderOptionsCandidate{ false, 0 }));
+	}
+}
+
+TEST(AutoTuneCacheTests, IgnoresAStaleOrDamagedFile)
+{
+	TestDirectory directory;
+	RenderOptionsCandidate candidate{};
+
+	EXPECT_FALSE(LoadAutoTuneCache(directory.GetPath() / "Missing.ini", kCacheKey, candidate));
+
+	ASSERT_TRUE(LoadAutoTuneCache(directory.WriteFile("Current.ini", GetCacheFileText(kCacheKey, 1, true)), kCacheKey, candidate));
+	EXPECT_EQ(candidate, (RenderOptionsCandidate{ true, 4 }));
+
+	EXPECT_FALSE(LoadAutoTuneCache(directory.WriteFile("OldVersion.ini", GetCacheFileText(kCacheKey, 0, true)), kCacheKey, candidate));
+	EXPECT_FALSE(LoadAutoTuneCache(directory.WriteFile("NewVersion.ini", GetCacheFileText(kCacheKey, 2, true)), kCacheKey, candidate));
+	EXPECT_FALSE(LoadAutoTuneCache(directory.WriteFile("MissingValue.ini", GetCacheFileText(kCacheKey, 1, false)), kCacheKey, candidate));
+	EXPECT_FALSE(LoadAutoTuneCache(directory.WriteFile("BadValue.ini", GetCacheFileText(kCacheKey, 1, true) + "Width=wide\n"), kCacheKey, candidate));
+	EXPECT_FALSE(LoadAutoTuneCache(directory.WriteFile("SyntaxError.ini", "[AutoTune\nVersion=1\n"), kCacheKey, candidate));
+}
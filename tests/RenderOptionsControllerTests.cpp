@@ -0,0 +1,321 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "RenderOptionsController.h"
+#include "FakeSC4RenderProperties.h"
+#include "Settings.h"
+#include "TestDirectory.h"
+#include <gtest/gtest.h>
+#include <functional>
+
+namespace
+{
+	constexpr size_t kForceDrawOnScrollIndex = GetSettingIndex("GraphicsOptions", "ForceDrawOnScroll");
+	constexpr size_t kAutoTuneRenderOptionsIndex = GetSettingIndex("GraphicsOptions", "AutoTuneRenderOptions");
+	constexpr size_t kMaxFrameRateIndex = GetSettingIndex("GraphicsOptions", "MaxFrameRate");
+
+	// The present counter is a 1 MHz clock, so the frame times are in microseconds.
+	constexpr int64_t kCounterFrequency = 1000000;
+
+	constexpr uint32_t kFramesPerCandidate =
+		RenderOptionsController::kAutoTuneWarmupFrames + RenderOptionsController::kAutoTuneFramesPerRound;
+
+	class FakePresentClock
+	{
+	public:
+
+		FakePresentClock()
+			: counter(1000000)
+		{
+		}
+
+		// Presents frames that take the time that the function returns for the current render properties.
+		void Present(
+			RenderOptionsController& controller,
+			const FakeSC4RenderProperties& renderProperties,
+			uint32_t frameCount,
+			const std::function<int64_t(bool, int32_t)>& getFrameTime)
+		{
+			for (uint32_t i = 0; i < frameCount; i++)
+			{
+				controller.OnPresent(counter, kCounterFrequency);
+
+				counter += getFrameTime(
+					renderProperties.GetValue("NoPartialBackingStoreCopies") != 0,
+					renderProperties.GetValue("DirtyRectMergeFrames"));
+			}
+		}
+
+		// Presents frames until the auto-tune finishes, returns false if it does not finish.
+		bool PresentUntilFinished(
+			RenderOptionsController& controller,
+			const FakeSC4RenderProperties& renderProperties,
+			const std::function<int64_t(bool, int32_t)>& getFrameTime)
+		{
+			for (uint32_t i = 0; i < 100000 && controller.IsAutoTuning(); i++)
+			{
+				Present(controller, renderProperties, 1, getFrameTime);
+			}
+
+			return !controller.IsAutoTuning();
+		}
+
+	private:
+
+		int64_t counter;
+	};
+
+	int64_t UniformFrameTime(bool, int32_t)
+	{
+		return 16667;
+	}
+
+	Settings GetAutoTuneSettings()
+	{
+		Settings settings;
+		settings.SetValue(kAutoTuneRenderOptionsIndex, 1);
+
+		return settings;
+	}
+}
+
+TEST(RenderOptionsControllerTests, AutoTuneConvergesAndSavesTheResult)
+{
+	TestDirectory directory;
+	const std::filesystem::path cacheFilePath = directory.GetPath() / "AutoTune.ini";
+	const Settings settings = GetAutoTuneSettings();
+
+	FakeSC4RenderProperties renderProperties;
+	RenderOptionsController controller;
+	controller.Start(settings, &renderProperties, cacheFilePath);
+
+	ASSERT_TRUE(controller.IsAutoTuning());
+
+	FakePresentClock clock;
+	ASSERT_TRUE(clock.PresentUntilFinished(
+		controller,
+		renderProperties,
+		[](bool noPartialBackingStoreCopies, int32_t dirtyRectMergeFrames)
+		{
+			return noPartialBackingStoreCopies && dirtyRectMergeFrames == 4 ? 10000 : 20000;
+		}));
+
+	EXPECT_EQ(renderProperties.GetValue("NoPartialBackingStoreCopies"), 1);
+	EXPECT_EQ(renderProperties.GetValue("DirtyRectMergeFrames"), 4);
+
+	// The next start uses the saved result without measuring again.
+	FakeSC4RenderProperties nextRenderProperties;
+	RenderOptionsController nextController;
+	nextController.Start(settings, &nextRenderProperties, cacheFilePath);
+
+	EXPECT_FALSE(nextController.IsAutoTuning());
+	EXPECT_EQ(nextRenderProperties.GetValue("NoPartialBackingStoreCopies"), 1);
+	EXPECT_EQ(nextRenderProperties.GetValue("DirtyRectMergeFrames"), 4);
+}
+
+TEST(RenderOptionsControllerTests, MaxFrameRateStopsTheAutoTuneAndRestoresTheGameOptions)
+{
+	TestDirectory directory;
+	const std::filesystem::path cacheFilePath = directory.GetPath() / "AutoTune.ini";
+	Settings settings = GetAutoTuneSettings();
+
+	FakeSC4RenderProperties renderProperties;
+	RenderOptionsController controller;
+	controller.Start(settings, &renderProperties, cacheFilePath);
+
+	// The second candidate is being measured.
+	FakePresentClock clock;
+	clock.Present(controller, renderProperties, kFramesPerCandidate + 2, UniformFrameTime);
+
+	ASSERT_TRUE(controller.IsAutoTuning());
+	ASSERT_EQ(renderProperties.GetValue("DirtyRectMergeFrames"), 2);
+
+	settings.SetValue(kMaxFrameRateIndex, 60);
+	controller.OnMaxFrameRateChanged(settings);
+
+	EXPECT_FALSE(controller.IsAutoTuning());
+	EXPECT_EQ(renderProperties.GetValue("NoPartialBackingStoreCopies"), 0);
+	EXPECT_EQ(renderProperties.GetValue("DirtyRectMergeFrames"), 0);
+	EXPECT_FALSE(std::filesystem::exists(cacheFilePath));
+
+	const uint32_t setValueCount = renderProperties.setValueCount;
+	clock.Present(controller, renderProperties, 10 * kFramesPerCandidate, UniformFrameTime);
+
+	EXPECT_EQ(renderProperties.setValueCount, setValueCount);
+}
+
+TEST(RenderOptionsControllerTests, RemovingTheMaxFrameRateDoesNotStopTheAutoTune)
+{
+	TestDirectory directory;
+	Settings settings = GetAutoTuneSettings();
+
+	FakeSC4RenderProperties renderProperties;
+	RenderOptionsController controller;
+	controller.Start(settings, &renderProperties, directory.GetPath() / "AutoTune.ini");
+
+	settings.SetValue(kMaxFrameRateIndex, 0);
+	controller.OnMaxFrameRateChanged(settings);
+
+	EXPECT_TRUE(controller.IsAutoTuning());
+}
+
+TEST(RenderOptionsControllerTests, ForceDrawOnScrollChangeStopsTheAutoTune)
+{
+	TestDirectory directory;
+	const std::filesystem::path cacheFilePath = directory.GetPath() / "AutoTune.ini";
+	Settings settings = GetAutoTuneSettings();
+
+	FakeSC4RenderProperties renderProperties;
+	RenderOptionsController controller;
+	controller.Start(settings, &renderProperties, cacheFilePath);
+
+	FakePresentClock clock;
+	clock.Present(controller, renderProperties, kFramesPerCandidate + 2, UniformFrameTime);
+
+	settings.SetValue(kForceDrawOnScrollIndex, 1);
+	controller.OnForceDrawOnScrollChanged(settings);
+
+	EXPECT_FALSE(controller.IsAutoTuning());
+	EXPECT_EQ(renderProperties.GetValue("NoPartialBackingStoreCopies"), 1);
+	EXPECT_EQ(renderProperties.GetValue("DirtyRectMergeFrames"), 8);
+	EXPECT_EQ(renderProperties.GetValue("CursorType"), 0);
+	EXPECT_FALSE(std::filesystem::exists(cacheFilePath));
+
+	settings.SetValue(kForceDrawOnScrollIndex, 0);
+	controller.OnForceDrawOnScrollChanged(settings);
+
+	EXPECT_EQ(renderProperties.GetValue("NoPartialBackingStoreCopies"), 0);
+	EXPECT_EQ(renderProperties.GetValue("DirtyRectMergeFrames"), 0);
+	EXPECT_EQ(renderProperties.GetValue("CursorType"), 1);
+}
+
+TEST(RenderOptionsControllerTests, ForceDrawOnScrollChangeKeepsTheTunedOptions)
+{
+	TestDirectory directory;
+	const std::filesystem::path cacheFilePath = directory.GetPath() / "AutoTune.ini";
+	Settings settings = GetAutoTuneSettings();
+	settings.SetValue(kForceDrawOnScrollIndex, 1);
+
+	const AutoTuneCacheKey key
+	{
+		settings.GetGDriverDescription().GetName(),
+		settings.GetWindowWidth(),
+		settings.GetWindowHeight(),
+		settings.GetColorDepth(),
+		static_cast<uint32_t>(settings.GetWindowMode())
+	};
+	ASSERT_TRUE(SaveAutoTuneCache(cacheFilePath, key, RenderOptionsCandidate{ false, 2 }));
+
+	FakeSC4RenderProperties renderProperties;
+	RenderOptionsController controller;
+	controller.Start(settings, &renderProperties, cacheFilePath);
+
+	ASSERT_FALSE(controller.IsAutoTuning());
+	EXPECT_EQ(renderProperties.GetValue("NoPartialBackingStoreCopies"), 0);
+	EXPECT_EQ(renderProperties.GetValue("DirtyRectMergeFrames"), 2);
+	EXPECT_EQ(renderProperties.GetValue("CursorType"), 0);
+
+	settings.SetValue(kForceDrawOnScrollIndex, 0);
+	controller.OnForceDrawOnScrollChanged(settings);
+
+	EXPECT_EQ(renderProperties.GetValue("NoPartialBackingStoreCopies"), 0);
+	EXPECT_EQ(renderProperties.GetValue("DirtyRectMergeFrames"), 2);
+	EXPECT_EQ(renderProperties.GetValue("CursorType"), 1);
+
+	settings.SetValue(kForceDrawOnScrollIndex, 1);
+	controller.OnForceDrawOnScrollChanged(settings);
+
+	EXPECT_EQ(renderProperties.GetValue("NoPartialBackingStoreCopies"), 0);
+	EXPECT_EQ(renderProperties.GetValue("DirtyRectMergeFrames"), 2);
+	EXPECT_EQ(renderProperties.GetValue("CursorType"), 0);
+}
+
+TEST(RenderOptionsControllerTests, RenderPropertyOverridesOfATunedOptionPreventTheAutoTune)
+{
+	TestDirectory directory;
+	Settings settings = GetAutoTuneSettings();
+	settings.SetRenderPropertyOverrides({ { "DirtyRectMergeFrames", 6 } });
+
+	FakeSC4RenderProperties renderProperties;
+	RenderOptionsController controller;
+	controller.Start(settings, &renderProperties, directory.GetPath() / "AutoTune.ini");
+
+	EXPECT_FALSE(controller.IsAutoTuning());
+	EXPECT_EQ(renderProperties.GetValue("DirtyRectMergeFrames"), 6);
+}
+
+TEST(RenderOptionsControllerTests, ReloadedOverridesOfATunedOptionStopTheAutoTune)
+{
+	TestDirectory directory;
+	Settings settings = GetAutoTuneSettings();
+
+	FakeSC4RenderProperties renderProperties;
+	RenderOptionsController controller;
+	controller.Start(settings, &renderProperties, directory.GetPath() / "AutoTune.ini");
+
+	FakePresentClock clock;
+	clock.Present(controller, renderProperties, kFramesPerCandidate + 2, UniformFrameTime);
+
+	settings.SetRenderPropertyOverrides({ { "ShadowQuality", 0 } });
+	controller.OnRenderPropertyOverridesChanged(settings);
+
+	ASSERT_TRUE(controller.IsAutoTuning());
+	EXPECT_EQ(renderProperties.GetValue("DirtyRectMergeFrames"), 2);
+	EXPECT_EQ(renderProperties.GetValue("ShadowQuality"), 0);
+
+	settings.SetRenderPropertyOverrides({ { "DirtyRectMergeFrames", 6 } });
+	controller.OnRenderPropertyOverridesChanged(settings);
+
+	EXPECT_FALSE(controller.IsAutoTuning());
+	EXPECT_EQ(renderProperties.GetValue("NoPartialBackingStoreCopies"), 0);
+	EXPECT_EQ(renderProperties.GetValue("DirtyRectMergeFrames"), 6);
+	EXPECT_EQ(renderProperties.GetValue("ShadowQuality"), 2);
+}
+
+TEST(RenderOptionsControllerTests, MaxFrameRatePreventsTheAutoTune)
+{
+	TestDirectory directory;
+	Settings settings = GetAutoTuneSettings();
+	settings.SetValue(kMaxFrameRateIndex, 60);
+
+	FakeSC4RenderProperties renderProperties;
+	RenderOptionsController controller;
+	controller.Start(settings, &renderProperties, directory.GetPath() / "AutoTune.ini");
+
+	EXPECT_FALSE(controller.IsAutoTuning());
+	EXPECT_EQ(renderProperties.setValueCount, 0u);
+}
+
+TEST(RenderOptionsControllerTests, DoesNothingWithoutRenderProperties)
+{
+	TestDirectory directory;
+	Settings settings = GetAutoTuneSettings();
+	settings.SetValue(kForceDrawOnScrollIndex, 1);
+
+	RenderOptionsController controller;
+	controller.Start(settings, nullptr, directory.GetPath() / "AutoTune.ini");
+
+	EXPECT_FALSE(controller.IsAutoTuning());
+
+	settings.SetValue(kForceDrawOnScrollIndex, 0);
+	controller.OnForceDrawOnScrollChanged(settings);
+	controller.OnRenderPropertyOverridesChanged(settings);
+}
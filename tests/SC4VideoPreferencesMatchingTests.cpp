@@ -0,0 +1,56 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SC4GDriverDescription.h"
+#include "SC4GDriverCLSIDDefs.h"
+#include "SC4VideoPreferencesMatching.h"
+#include <gtest/gtest.h>
+
+TEST(SC4VideoPreferencesMatchingTests, DriverDescriptions)
+{
+	EXPECT_EQ(SC4GDriverDescription::DirectX().GetGZCLSID(), kSCGDriverDirectX);
+	EXPECT_EQ(SC4GDriverDescription::OpenGL().GetGZCLSID(), kSCGDriverOpenGL);
+	EXPECT_EQ(SC4GDriverDescription::Software().GetGZCLSID(), kSCGDriverSoftware);
+
+	EXPECT_TRUE(SC4GDriverDescription::DirectX().IsHardwareDriver());
+	EXPECT_TRUE(SC4GDriverDescription::OpenGL().IsHardwareDriver());
+	EXPECT_FALSE(SC4GDriverDescription::Software().IsHardwareDriver());
+}
+
+TEST(SC4VideoPreferencesMatchingTests, DriverTypesMatch)
+{
+	// The game stores 1 for the hardware drivers and 0 for the software driver.
+	EXPECT_TRUE(DriverTypesMatch(1, SC4GDriverDescription::DirectX()));
+	EXPECT_TRUE(DriverTypesMatch(1, SC4GDriverDescription::OpenGL()));
+	EXPECT_TRUE(DriverTypesMatch(0, SC4GDriverDescription::Software()));
+	EXPECT_FALSE(DriverTypesMatch(0, SC4GDriverDescription::DirectX()));
+	EXPECT_FALSE(DriverTypesMatch(1, SC4GDriverDescription::Software()));
+}
+
+TEST(SC4VideoPreferencesMatchingTests, WindowModesMatch)
+{
+	EXPECT_TRUE(WindowModesMatch(false, SC4WindowMode::Windowed));
+	EXPECT_TRUE(WindowModesMatch(false, SC4WindowMode::BorderlessFullScreen));
+	EXPECT_TRUE(WindowModesMatch(true, SC4WindowMode::FullScreen));
+	EXPECT_FALSE(WindowModesMatch(true, SC4WindowMode::Windowed));
+	EXPECT_FALSE(WindowModesMatch(true, SC4WindowMode::BorderlessFullScreen));
+	EXPECT_FALSE(WindowModesMatch(false, SC4WindowMode::FullScreen));
+}
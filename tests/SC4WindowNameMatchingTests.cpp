@@ -0,0 +1,47 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SC4WindowNameMatching.h"
+#include <gtest/gtest.h>
+
+TEST(SC4WindowNameMatchingTests, MatchesTheGameWindowNames)
+{
+	EXPECT_TRUE(IsSC4AppWindowName("GDriverWindow--DirectX"));
+	EXPECT_TRUE(IsSC4AppWindowName("GDriverWindow--OpenGL"));
+	EXPECT_TRUE(IsSC4AppWindowName("GDriverWindow--Software"));
+
+	EXPECT_FALSE(IsSC4AppWindowName("GDriverWindow--Direct3"));
+	EXPECT_FALSE(IsSC4AppWindowName("GDriverWindow--DirectX9"));
+	EXPECT_FALSE(IsSC4AppWindowName("gdriverwindow--directx"));
+	EXPECT_FALSE(IsSC4AppWindowName("SimCity 4"));
+	EXPECT_FALSE(IsSC4AppWindowName(""));
+}
+
+TEST(SC4WindowNameMatchingTests, MatchesTheGameWindowClassNames)
+{
+	EXPECT_TRUE(IsSC4AppWindowClassName("GDriverClass--DirectX"));
+	EXPECT_TRUE(IsSC4AppWindowClassName("GDriverClass--OpenGL"));
+	EXPECT_TRUE(IsSC4AppWindowClassName("GDriverClass--Software"));
+
+	EXPECT_FALSE(IsSC4AppWindowClassName("GDriverWindow--DirectX"));
+	EXPECT_FALSE(IsSC4AppWindowClassName("GDriverClass--Softwar"));
+	EXPECT_FALSE(IsSC4AppWindowClassName("A class name that is longer than the game's class names"));
+}
@@ -0,0 +1,137 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SettingsReload.h"
+#include <gtest/gtest.h>
+
+namespace
+{
+	constexpr int64_t kDelayTicks = 500;
+
+	constexpr size_t kWindowWidthIndex = GetSettingIndex("GraphicsOptions", "WindowWidth");
+	constexpr size_t kMaxFrameRateIndex = GetSettingIndex("GraphicsOptions", "MaxFrameRate");
+	constexpr size_t kPauseGameOnFocusLossIndex = GetSettingIndex("GraphicsOptions", "PauseGameOnFocusLoss");
+	constexpr size_t kDriverIndex = GetSettingIndex("GraphicsOptions", "Driver");
+}
+
+TEST(SettingsChangeDebouncerTests, NothingIsPendingInitially)
+{
+	SettingsChangeDebouncer debouncer(kDelayTicks);
+
+	EXPECT_FALSE(debouncer.IsPending());
+	EXPECT_EQ(debouncer.GetRemainingTicks(1000), -1);
+	EXPECT_FALSE(debouncer.Poll(1000));
+}
+
+TEST(SettingsChangeDebouncerTests, FiresOnceAfterTheDelay)
+{
+	SettingsChangeDebouncer debouncer(kDelayTicks);
+	debouncer.OnChange(1000);
+
+	EXPECT_TRUE(debouncer.IsPending());
+	EXPECT_EQ(debouncer.GetRemainingTicks(1000), kDelayTicks);
+	EXPECT_FALSE(debouncer.Poll(1000 + kDelayTicks - 1));
+	EXPECT_EQ(debouncer.GetRemainingTicks(1000 + kDelayTicks - 1), 1);
+
+	EXPECT_TRUE(debouncer.Poll(1000 + kDelayTicks));
+	EXPECT_FALSE(debouncer.IsPending());
+
+	EXPECT_FALSE(debouncer.Poll(1000 + (2 * kDelayTicks)));
+}
+
+TEST(SettingsChangeDebouncerTests, CoalescesChangesInsideTheDelay)
+{
+	SettingsChangeDebouncer debouncer(kDelayTicks);
+
+	// An editor that saves a file in several writes.
+	debouncer.OnChange(1000);
+	debouncer.OnChange(1100);
+	EXPECT_FALSE(debouncer.Poll(1400));
+	debouncer.OnChange(1400);
+
+	// Each change restarts the delay.
+	EXPECT_FALSE(debouncer.Poll(1000 + kDelayTicks));
+	EXPECT_FALSE(debouncer.Poll(1400 + kDelayTicks - 1));
+	EXPECT_TRUE(debouncer.Poll(1400 + kDelayTicks));
+	EXPECT_FALSE(debouncer.Poll(1400 + kDelayTicks + 1));
+}
+
+TEST(SettingsChangeDebouncerTests, AChangeAfterTheDelayStartsANewReload)
+{
+	SettingsChangeDebouncer debouncer(kDelayTicks);
+	debouncer.OnChange(1000);
+
+	EXPECT_TRUE(debouncer.Poll(2000));
+
+	debouncer.OnChange(3000);
+
+	EXPECT_FALSE(debouncer.Poll(3000));
+	EXPECT_TRUE(debouncer.Poll(3000 + kDelayTicks));
+}
+
+TEST(SettingsDiffTests, IdenticalSettingsHaveNoChanges)
+{
+	const Settings current;
+	const Settings updated;
+
+	const SettingsDiff diff = DiffSettings(current, updated);
+
+	EXPECT_TRUE(diff.IsEmpty());
+	EXPECT_TRUE(diff.runtimeChanges.empty());
+	EXPECT_TRUE(diff.deferredChanges.empty());
+}
+
+TEST(SettingsDiffTests, ReportsOnlyTheChangedSettings)
+{
+	const Settings current;
+	Settings updated;
+	updated.SetValue(kMaxFrameRateIndex, 60);
+	updated.SetValue(kPauseGameOnFocusLossIndex, 1);
+	updated.SetValue(kWindowWidthIndex, 1280);
+
+	const SettingsDiff diff = DiffSettings(current, updated);
+
+	EXPECT_FALSE(diff.IsEmpty());
+	EXPECT_EQ(diff.runtimeChanges, (std::vector<size_t>{ kPauseGameOnFocusLossIndex, kMaxFrameRateIndex }));
+	EXPECT_EQ(diff.deferredChanges, (std::vector<size_t>{ kWindowWidthIndex }));
+}
+
+TEST(SettingsDiffTests, SeparatesTheSettingsThatNeedARestart)
+{
+	const Settings current;
+	Settings updated;
+	updated.SetValue(kDriverIndex, current.GetValue(kDriverIndex) + 1);
+
+	const SettingsDiff diff = DiffSettings(current, updated);
+
+	EXPECT_TRUE(diff.runtimeChanges.empty());
+	EXPECT_EQ(diff.deferredChanges, (std::vector<size_t>{ kDriverIndex }));
+}
+
+TEST(SettingsDiffTests, ASettingThatWasSetToTheSameValueIsNotAChange)
+{
+	Settings current;
+	current.SetValue(kMaxFrameRateIndex, 60);
+	Settings updated;
+	updated.SetValue(kMaxFrameRateIndex, 60);
+
+	EXPECT_TRUE(DiffSettings(current, updated).IsEmpty());
+}
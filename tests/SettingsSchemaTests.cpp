@@ -0,0 +1,119 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SettingsSchema.h"
+#include <gtest/gtest.h>
+
+TEST(SettingsSchemaTests, FindsEverySettingByName)
+{
+	for (size_t i = 0; i < kSettingCount; i++)
+	{
+		const SettingDefinition& definition = kSettingDefinitions[i];
+
+		EXPECT_EQ(FindSettingIndex(definition.section, definition.key), i) << definition.section << '.' << definition.key;
+	}
+}
+
+TEST(SettingsSchemaTests, NamesAreNotCaseSensitive)
+{
+	EXPECT_EQ(FindSettingIndex("graphicsoptions", "WINDOWMODE"), GetSettingIndex("GraphicsOptions", "WindowMode"));
+	EXPECT_EQ(FindSettingIndex("LOGGING", "general"), GetSettingIndex("Logging", "General"));
+}
+
+TEST(SettingsSchemaTests, UnknownNamesAreNotFound)
+{
+	EXPECT_EQ(FindSettingIndex("GraphicsOptions", "WindowModes"), kInvalidSettingIndex);
+	EXPECT_EQ(FindSettingIndex("Logging", "WindowMode"), kInvalidSettingIndex);
+	EXPECT_EQ(FindSettingIndex("", ""), kInvalidSettingIndex);
+}
+
+TEST(SettingsSchemaTests, ParsesBoolValues)
+{
+	const SettingDefinition& definition = kSettingDefinitions[GetSettingIndex("GraphicsOptions", "EnableIntroVideo")];
+	uint32_t value = 0;
+
+	EXPECT_EQ(ParseSettingValue(definition, "TRUE", value), SettingParseResult::Success);
+	EXPECT_EQ(value, 1U);
+	EXPECT_EQ(ParseSettingValue(definition, "0", value), SettingParseResult::Success);
+	EXPECT_EQ(value, 0U);
+	EXPECT_EQ(ParseSettingValue(definition, "yes", value), SettingParseResult::InvalidValue);
+	EXPECT_EQ(value, definition.defaultValue);
+}
+
+TEST(SettingsSchemaTests, ClampsNumbersToTheRange)
+{
+	const SettingDefinition& definition = kSettingDefinitions[GetSettingIndex("GraphicsOptions", "WindowWidth")];
+	uint32_t value = 0;
+
+	EXPECT_EQ(ParseSettingValue(definition, "1920", value), SettingParseResult::Success);
+	EXPECT_EQ(value, 1920U);
+	EXPECT_EQ(ParseSettingValue(definition, "640", value), SettingParseResult::OutOfRange);
+	EXPECT_EQ(value, 800U);
+	EXPECT_EQ(ParseSettingValue(definition, "99999999999", value), SettingParseResult::OutOfRange);
+	EXPECT_EQ(value, 65535U);
+	EXPECT_EQ(ParseSettingValue(definition, "1920px", value), SettingParseResult::InvalidValue);
+	EXPECT_EQ(value, definition.defaultValue);
+	EXPECT_EQ(ParseSettingValue(definition, "-1", value), SettingParseResult::InvalidValue);
+	EXPECT_EQ(ParseSettingValue(definition, "", value), SettingParseResult::InvalidValue);
+}
+
+TEST(SettingsSchemaTests, ZeroDisablesOutsideTheRange)
+{
+	const SettingDefinition& definition = kSettingDefinitions[GetSettingIndex("GraphicsOptions", "MaxFrameRate")];
+	uint32_t value = 1;
+
+	EXPECT_EQ(ParseSettingValue(definition, "0", value), SettingParseResult::Success);
+	EXPECT_EQ(value, 0U);
+	EXPECT_EQ(ParseSettingValue(definition, "5", value), SettingParseResult::OutOfRange);
+	EXPECT_EQ(value, 10U);
+}
+
+TEST(SettingsSchemaTests, ParsesEnumNamesAndAliases)
+{
+	const SettingDefinition& driver = kSettingDefinitions[GetSettingIndex("GraphicsOptions", "Driver")];
+	const SettingDefinition& windowMode = kSettingDefinitions[GetSettingIndex("GraphicsOptions", "WindowMode")];
+	uint32_t value = 0;
+
+	EXPECT_EQ(ParseSettingValue(driver, "scgl", value), SettingParseResult::Success);
+	EXPECT_EQ(value, kSCGDriverOpenGL);
+	EXPECT_EQ(ParseSettingValue(driver, "Software", value), SettingParseResult::Success);
+	EXPECT_EQ(value, kSCGDriverSoftware);
+	EXPECT_EQ(ParseSettingValue(driver, "Vulkan", value), SettingParseResult::InvalidValue);
+	EXPECT_EQ(value, kSCGDriverDirectX);
+
+	EXPECT_EQ(ParseSettingValue(windowMode, "BorderlessFullScreen", value), SettingParseResult::Success);
+	EXPECT_EQ(value, static_cast<uint32_t>(SC4WindowMode::BorderlessFullScreen));
+	EXPECT_EQ(ParseSettingValue(windowMode, "borderless", value), SettingParseResult::Success);
+	EXPECT_EQ(value, static_cast<uint32_t>(SC4WindowMode::BorderlessFullScreen));
+	EXPECT_EQ(ParseSettingValue(windowMode, "FullScreenBorderless", value), SettingParseResult::InvalidValue);
+	EXPECT_EQ(value, static_cast<uint32_t>(SC4WindowMode::Windowed));
+}
+
+TEST(SettingsSchemaTests, GetsValueNames)
+{
+	const SettingDefinition& driver = kSettingDefinitions[GetSettingIndex("GraphicsOptions", "Driver")];
+	const SettingDefinition& introVideo = kSettingDefinitions[GetSettingIndex("GraphicsOptions", "EnableIntroVideo")];
+	const SettingDefinition& width = kSettingDefinitions[GetSettingIndex("GraphicsOptions", "WindowWidth")];
+
+	EXPECT_EQ(GetSettingValueName(driver, kSCGDriverOpenGL), "OpenGL");
+	EXPECT_EQ(GetSettingValueName(introVideo, 0), "false");
+	EXPECT_TRUE(GetSettingValueName(width, 1024).empty());
+}
@@ -0,0 +1,223 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "IniParser.h"
+#include "Logger.h"
+#include "Settings.h"
+#include "TestDirectory.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+namespace
+{
+	// The POSIX platform layer reports this size for the primary monitor.
+	constexpr uint32_t kMonitorWidth = 1920;
+	constexpr uint32_t kMonitorHeight = 1080;
+
+	Settings LoadSettings(std::string_view text)
+	{
+		TestDirectory directory;
+		Settings settings;
+
+		settings.Load(directory.WriteFile("SC4GraphicsOptions.ini", text));
+
+		return settings;
+	}
+}
+
+TEST(SettingsTests, DefaultValues)
+{
+	const Settings settings;
+
+	EXPECT_TRUE(settings.EnableIntroVideo());
+	EXPECT_EQ(&settings.GetGDriverDescription(), &SC4GDriverDescription::DirectX());
+	EXPECT_EQ(settings.GetWindowWidth(), 1024U);
+	EXPECT_EQ(settings.GetWindowHeight(), 768U);
+	EXPECT_EQ(settings.GetColorDepth(), 32U);
+	EXPECT_EQ(settings.GetWindowMode(), SC4WindowMode::Windowed);
+	EXPECT_EQ(settings.GetMaxFrameRate(), 0U);
+	EXPECT_EQ(settings.GetLogLevel(LogCategory::Hooks), LogLevel::Error);
+	EXPECT_EQ(settings.GetPriorityClass(), ProcessPriorityClass::Default);
+	EXPECT_TRUE(settings.GetRenderPropertyOverrides().empty());
+}
+
+TEST(SettingsTests, LoadsTheShippedSettingsFile)
+{
+	Settings settings;
+	settings.Load(SC4GRAPHICSOPTIONS_SOURCE_DIR "/SC4GraphicsOptions.ini");
+
+	EXPECT_EQ(settings.GetWindowMode(), SC4WindowMode::FullScreen);
+	EXPECT_EQ(settings.GetWindowWidth(), 1920U);
+	EXPECT_EQ(settings.GetWindowHeight(), 1080U);
+	EXPECT_TRUE(settings.IsUsingGDriver(kSCGDriverDirectX));
+	EXPECT_FALSE(settings.HotReload());
+}
+
+TEST(SettingsTests, MissingFileThrows)
+{
+	TestDirectory directory;
+	Settings settings;
+
+	EXPECT_THROW(settings.Load(directory.GetPath() / "missing.ini"), std::runtime_error);
+}
+
+TEST(SettingsTests, ParseErrorKeepsTheDefaultValues)
+{
+	TestDirectory directory;
+	Settings settings;
+
+	EXPECT_THROW(
+		settings.Load(directory.WriteFile(
+			"SC4GraphicsOptions.ini",
+			"[GraphicsOptions]\n"
+			"WindowMode=Borderless\n"
+			"WindowWidth=5000\n"
+			"WindowHeight=4000\n"
+			"oops\n")),
+		IniParseError);
+
+	EXPECT_EQ(settings.GetWindowMode(), SC4WindowMode::Windowed);
+	EXPECT_EQ(settings.GetWindowWidth(), 1024U);
+	EXPECT_EQ(settings.GetWindowHeight(), 768U);
+}
+
+TEST(SettingsTests, ParseErrorKeepsThePreviousValues)
+{
+	TestDirectory directory;
+	Settings settings;
+
+	settings.Load(directory.WriteFile(
+		"SC4GraphicsOptions.ini",
+		"[GraphicsOptions]\n"
+		"WindowWidth=1280\n"
+		"WindowHeight=720\n"
+		"MaxFrameRate=60\n"
+		"[RenderProperties]\n"
+		"DirtyRectMergeFrames=8\n"));
+
+	EXPECT_THROW(
+		settings.Load(directory.WriteFile(
+			"SC4GraphicsOptions.ini",
+			"[GraphicsOptions]\n"
+			"WindowWidth=1600\n"
+			"MaxFrameRate=144\n"
+			"[RenderProperties\n")),
+		IniParseError);
+
+	EXPECT_EQ(settings.GetWindowWidth(), 1280U);
+	EXPECT_EQ(settings.GetWindowHeight(), 720U);
+	EXPECT_EQ(settings.GetMaxFrameRate(), 60U);
+	EXPECT_EQ(settings.GetRenderPropertyOverrides(), (std::vector<RenderPropertyOverride>{ { "DirtyRectMergeFrames", 8 } }));
+}
+
+TEST(SettingsTests, AppliesAliasesAndRanges)
+{
+	const Settings settings = LoadSettings(
+		"[graphicsoptions]\n"
+		"driver = SCGL\n"
+		"WindowWidth=640\n"
+		"WindowHeight=700\n"
+		"ColorDepth=24\n"
+		"MaxFrameRate=5000\n"
+		"[Logging]\n"
+		"Hooks=Trace\n");
+
+	EXPECT_EQ(&settings.GetGDriverDescription(), &SC4GDriverDescription::OpenGL());
+	EXPECT_EQ(settings.GetWindowWidth(), 800U);
+	EXPECT_EQ(settings.GetWindowHeight(), 700U);
+	EXPECT_EQ(settings.GetColorDepth(), 32U);
+	EXPECT_EQ(settings.GetMaxFrameRate(), 1000U);
+	EXPECT_EQ(settings.GetLogLevel(LogCategory::Hooks), LogLevel::Trace);
+	EXPECT_EQ(settings.GetLogLevel(LogCategory::Render), LogLevel::Error);
+}
+
+TEST(SettingsTests, BorderlessUsesTheMonitorSize)
+{
+	const Settings settings = LoadSettings(
+		"[GraphicsOptions]\n"
+		"WindowMode=Borderless\n"
+		"WindowWidth=800\n"
+		"WindowHeight=600\n");
+
+	EXPECT_EQ(settings.GetWindowMode(), SC4WindowMode::BorderlessFullScreen);
+	EXPECT_EQ(settings.GetWindowWidth(), kMonitorWidth);
+	EXPECT_EQ(settings.GetWindowHeight(), kMonitorHeight);
+}
+
+TEST(SettingsTests, WindowLargerThanTheMonitorIsReduced)
+{
+	const Settings settings = LoadSettings(
+		"[GraphicsOptions]\n"
+		"WindowMode=Windowed\n"
+		"WindowWidth=3840\n"
+		"WindowHeight=2160\n");
+
+	EXPECT_EQ(settings.GetWindowWidth(), kMonitorWidth);
+	EXPECT_EQ(settings.GetWindowHeight(), kMonitorHeight);
+}
+
+TEST(SettingsTests, LoadsRenderPropertyOverrides)
+{
+	const Settings settings = LoadSettings(
+		"[RenderProperties]\n"
+		"DirtyRectMergeFrames=8\n"
+		"NoPartialBackingStoreCopies=true\n"
+		"Invalid=maybe\n"
+		"dirtyrectmergeframes=4\n");
+
+	const std::vector<RenderPropertyOverride> expected
+	{
+		{ "DirtyRectMergeFrames", 4 },
+		{ "NoPartialBackingStoreCopies", 1 },
+	};
+
+	EXPECT_EQ(settings.GetRenderPropertyOverrides(), expected);
+}
+
+TEST(SettingsTests, IgnoresUnknownSettings)
+{
+	const Settings settings = LoadSettings(
+		"[GraphicsOptions]\n"
+		"UnknownKey=1\n"
+		"[UnknownSection]\n"
+		"WindowWidth=1280\n");
+
+	EXPECT_EQ(settings.GetWindowWidth(), 1024U);
+}
+
+TEST(SettingsTests, DebugLogShowsTheWindowModeName)
+{
+	TestDirectory directory;
+	const std::filesystem::path logFilePath = directory.GetPath() / "SC4GraphicsOptions.log";
+
+	Logger::GetInstance().Init(logFilePath, LogLevel::Debug, false, LogWriteMode::Synchronous, 64 * 1024, 0);
+
+	Settings settings;
+	settings.Load(directory.WriteFile(
+		"SC4GraphicsOptions.ini",
+		"[GraphicsOptions]\nDriver=OpenGL\nWindowMode=FullScreen\nWindowWidth=1280\nWindowHeight=720\nColorDepth=16\n"));
+
+	Logger::GetInstance().Shutdown();
+
+	EXPECT_NE(
+		directory.ReadFile(logFilePath).find("Loaded the settings: Driver=OpenGL, WindowMode=FullScreen, 1280x720x16."),
+		std::string::npos);
+}
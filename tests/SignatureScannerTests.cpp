@@ -0,0 +1,253 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SignatureScanner.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+	constexpr SignatureScannerMode kModes[] =
+	{
+		SignatureScannerMode::Scalar,
+		SignatureScannerMode::SSE2,
+		SignatureScannerMode::AVX2
+	};
+
+	std::vector<uint8_t> CreateRandomData(size_t size, uint32_t seed)
+	{
+		std::vector<uint8_t> data(size);
+		std::mt19937 random(seed);
+		std::uniform_int_distribution<int> distribution(0, 255);
+
+		for (uint8_t& value : data)
+		{
+			value = static_cast<uint8_t>(distribution(random));
+		}
+
+		return data;
+	}
+
+	size_t FindNaive(const std::vector<uint8_t>& data, const BytePattern& pattern, size_t start)
+	{
+		for (size_t i = start; i + pattern.GetLength() <= data.size(); i++)
+		{
+			if (pattern.Matches(data.data() + i))
+			{
+				return i;
+			}
+		}
+
+		return SignatureScanner::kNotFound;
+	}
+}
+
+TEST(SignatureScannerTests, ParsesPatterns)
+{
+	const BytePattern pattern("8b 44 24 ?? 6A 10");
+
+	EXPECT_EQ(pattern.GetLength(), 6U);
+	EXPECT_TRUE(pattern.HasWildcards());
+	EXPECT_EQ(pattern.GetFirstAnchorIndex(), 0U);
+	EXPECT_EQ(pattern.GetLastAnchorIndex(), 5U);
+	EXPECT_EQ(pattern.GetByte(0), 0x8B);
+
+	const BytePattern leadingWildcards("?? ?? 10 ??");
+
+	EXPECT_EQ(leadingWildcards.GetFirstAnchorIndex(), 2U);
+	EXPECT_EQ(leadingWildcards.GetLastAnchorIndex(), 2U);
+
+	const uint8_t data[] = { 0x8B, 0x44, 0x24, 0x99, 0x6A, 0x10 };
+
+	EXPECT_TRUE(pattern.Matches(data));
+	EXPECT_FALSE(BytePattern("8B 44 24 ?? 6A 20").Matches(data));
+}
+
+TEST(SignatureScannerTests, RejectsInvalidPatterns)
+{
+	EXPECT_THROW(BytePattern(""), std::invalid_argument);
+	EXPECT_THROW(BytePattern("?? ??"), std::invalid_argument);
+	EXPECT_THROW(BytePattern("8B4"), std::invalid_argument);
+	EXPECT_THROW(BytePattern("8B 4"), std::invalid_argument);
+	EXPECT_THROW(BytePattern("8G"), std::invalid_argument);
+	EXPECT_THROW(BytePattern("8B ?4"), std::invalid_argument);
+}
+
+TEST(SignatureScannerTests, AllModesFindTheSameMatches)
+{
+	std::vector<uint8_t> data = CreateRandomData(4096 + 37, 1);
+	const uint8_t patternBytes[] = { 0x8B, 0x44, 0x24, 0x0C, 0x6A, 0x10 };
+
+	// Matches at the start, across the 16 and 32 byte block boundaries and at the end.
+	for (size_t offset : { size_t(0), size_t(14), size_t(30), size_t(1000), data.size() - sizeof(patternBytes) })
+	{
+		std::memcpy(data.data() + offset, patternBytes, sizeof(patternBytes));
+	}
+
+	const BytePattern patterns[] =
+	{
+		BytePattern("8B 44 24 0C 6A 10"),
+		BytePattern("8B 44 24 ?? 6A 10"),
+		BytePattern("?? 44 ?? ?? 6A ??"),
+		BytePattern("10"),
+	};
+
+	for (const SignatureScannerMode mode : kModes)
+	{
+		if (mode > SignatureScanner::GetBestMode())
+		{
+			continue;
+		}
+
+		for (const BytePattern& pattern : patterns)
+		{
+			size_t start = 0;
+
+			while (true)
+			{
+				const size_t expected = FindNaive(data, pattern, start);
+				const size_t actual = SignatureScanner::Find(data.data(), data.size(), pattern, start, mode);
+
+				ASSERT_EQ(actual, expected) << "mode " << static_cast<int>(mode) << ", start " << start;
+
+				if (actual == SignatureScanner::kNotFound)
+				{
+					break;
+				}
+
+				start = actual + 1;
+			}
+		}
+	}
+}
+
+TEST(SignatureScannerTests, HandlesDataShorterThanThePattern)
+{
+	const uint8_t data[] = { 0x8B, 0x44 };
+	const BytePattern pattern("8B 44 24");
+
+	for (const SignatureScannerMode mode : kModes)
+	{
+		if (mode <= SignatureScanner::GetBestMode())
+		{
+			EXPECT_EQ(SignatureScanner::Find(data, sizeof(data), pattern, 0, mode), SignatureScanner::kNotFound);
+			EXPECT_EQ(SignatureScanner::Find(data, 0, pattern, 0, mode), SignatureScanner::kNotFound);
+		}
+	}
+}
+
+TEST(SignatureScannerTests, FindUniqueRejectsRepeatedMatches)
+{
+	std::vector<uint8_t> data = CreateRandomData(1024, 2);
+	const uint8_t patternBytes[] = { 0xDE, 0xAD, 0xBE, 0xEF, 0x01 };
+	const BytePattern pattern("DE AD BE EF 01");
+
+	EXPECT_EQ(SignatureScanner::FindUnique(data.data(), data.size(), pattern), SignatureScanner::kNotFound);
+
+	std::memcpy(data.data() + 100, patternBytes, sizeof(patternBytes));
+
+	EXPECT_EQ(SignatureScanner::FindUnique(data.data(), data.size(), pattern), 100U);
+
+	std::memcpy(data.data() + 900, patternBytes, sizeof(patternBytes));
+
+	EXPECT_EQ(SignatureScanner::FindUnique(data.data(), data.size(), pattern), SignatureScanner::kNotFound);
+}
+
+TEST(SignatureScannerTests, CreatesAUniquePatternForAPatchSite)
+{
+	std::vector<uint8_t> data = CreateRandomData(64 * 1024, 3);
+
+	// The code around the patch site is repeated in several places, the copies only differ
+	// in a byte that is 8 bytes after the code. The push 16 operand is the patch site.
+	const uint8_t code[] = { 0x8B, 0x44, 0x24, 0x0C, 0x6A, 0x10, 0x50, 0x68, 0x00, 0x10, 0x40, 0x00 };
+	constexpr size_t kSiteIndex = 5;
+	constexpr size_t kSiteOffset = 4000;
+	constexpr size_t kContextLength = 16;
+	constexpr size_t kDifferentByteIndex = sizeof(code) + 8;
+
+	std::memcpy(data.data() + kSiteOffset, code, sizeof(code));
+
+	for (size_t offset : { size_t(1000), size_t(20000), size_t(40000) })
+	{
+		std::memcpy(
+			data.data() + offset - kContextLength,
+			data.data() + kSiteOffset - kContextLength,
+			sizeof(code) + (2 * kContextLength));
+		data[offset + kDifferentByteIndex] = static_cast<uint8_t>(data[kSiteOffset + kDifferentByteIndex] + 1);
+	}
+
+	const size_t siteOffset = kSiteOffset + kSiteIndex;
+	GeneratedSignature signature{};
+
+	ASSERT_TRUE(SignatureScanner::CreateUniquePattern(
+		data.data(),
+		data.size(),
+		siteOffset,
+		1,
+		0x00400000,
+		0x00500000,
+		1,
+		64,
+		signature));
+
+	const BytePattern pattern(signature.pattern);
+
+	EXPECT_EQ(SignatureScanner::FindUnique(data.data(), data.size(), pattern), siteOffset - signature.siteOffset);
+	EXPECT_GT(pattern.GetLength(), kDifferentByteIndex - kSiteIndex);
+
+	// The patch site and the absolute address in the push instruction are wildcards.
+	const size_t patternSiteOffset = signature.siteOffset;
+
+	EXPECT_EQ(signature.pattern.substr(patternSiteOffset * 3, 2), "??");
+	EXPECT_EQ(signature.pattern.substr((patternSiteOffset + 3) * 3, 11), "?? ?? ?? ??");
+
+	// The pattern still matches after the site is patched.
+	data[siteOffset] = 0x20;
+
+	EXPECT_EQ(SignatureScanner::FindUnique(data.data(), data.size(), pattern), siteOffset - signature.siteOffset);
+}
+
+TEST(SignatureScannerTests, CreateUniquePatternUsesTheMinimumLength)
+{
+	const std::vector<uint8_t> data = CreateRandomData(64 * 1024, 4);
+	GeneratedSignature signature{};
+
+	ASSERT_TRUE(SignatureScanner::CreateUniquePattern(data.data(), data.size(), 30000, 1, 0, 0, 16, 64, signature));
+
+	const BytePattern pattern(signature.pattern);
+
+	EXPECT_EQ(pattern.GetLength(), 16U);
+	EXPECT_EQ(signature.siteOffset, 7U);
+	EXPECT_EQ(SignatureScanner::FindUnique(data.data(), data.size(), pattern), 30000U - signature.siteOffset);
+}
+
+TEST(SignatureScannerTests, CreateUniquePatternFailsForRepeatedData)
+{
+	std::vector<uint8_t> data(4096, 0x90);
+	GeneratedSignature signature{};
+
+	EXPECT_FALSE(SignatureScanner::CreateUniquePattern(data.data(), data.size(), 2048, 1, 0, 0, 1, 64, signature));
+	EXPECT_FALSE(SignatureScanner::CreateUniquePattern(data.data(), data.size(), data.size(), 1, 0, 0, 1, 64, signature));
+	EXPECT_FALSE(SignatureScanner::CreateUniquePattern(data.data(), data.size(), data.size() - 1, 2, 0, 0, 1, 64, signature));
+}
@@ -0,0 +1,89 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "TestDirectory.h"
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+	std::atomic<uint32_t> s_DirectoryCount = 0;
+}
+
+TestDirectory::TestDirectory() : path()
+{
+	std::random_device random;
+
+	const std::string name = "SC4GraphicsOptionsTests-"
+		+ std::to_string(random())
+		+ "-"
+		+ std::to_string(s_DirectoryCount.fetch_add(1));
+
+	path = std::filesystem::temp_directory_path() / name;
+
+	if (!std::filesystem::create_directory(path))
+	{
+		throw std::runtime_error("Failed to create the test directory.");
+	}
+}
+
+TestDirectory::~TestDirectory()
+{
+	std::error_code ec;
+	std::filesystem::remove_all(path, ec);
+}
+
+const std::filesystem::path& TestDirectory::GetPath() const
+{
+	return path;
+}
+
+std::filesystem::path TestDirectory::WriteFile(std::string_view name, std::string_view contents) const
+{
+	const std::filesystem::path filePath = path / name;
+
+	std::ofstream stream(filePath, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+	stream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+
+	if (!stream)
+	{
+		throw std::runtime_error("Failed to write the test file.");
+	}
+
+	return filePath;
+}
+
+std::string TestDirectory::ReadFile(const std::filesystem::path& filePath) const
+{
+	std::ifstream stream(path / filePath, std::ifstream::in | std::ifstream::binary);
+
+	if (!stream)
+	{
+		throw std::runtime_error("Failed to open the test file.");
+	}
+
+	return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
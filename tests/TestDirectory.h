@@ -0,0 +1,50 @@
+/*
+ *  SC4GraphicsOptions - a DLL plugin for SimCity 4 that sets
+ *  the game's rendering mode and resolution options.
+ *
+ *  Copyright (C) 2026 Nicholas Hayes
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation, under
+ *  version 2.1 of the License.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+// A uniquely named folder in the system's temporary folder, it is deleted
+// with its contents when the object is destroyed.
+class TestDirectory
+{
+public:
+
+	TestDirectory();
+	~TestDirectory();
+
+	TestDirectory(const TestDirectory&) = delete;
+	TestDirectory& operator=(const TestDirectory&) = delete;
+
+	const std::filesystem::path& GetPath() const;
+
+	// Writes the contents to a file in the folder and returns its path.
+	std::filesystem::path WriteFile(std::string_view name, std::string_view contents) const;
+
+	// Reads the contents of a file, the path can be absolute or relative to the folder.
+	std::string ReadFile(const std::filesystem::path& path) const;
+
+private:
+
+	std::filesystem::path path;
+};